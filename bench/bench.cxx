@@ -0,0 +1,636 @@
+#include <xtual.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+struct options
+{
+    std::string filter;
+    std::string output;
+    std::string baseline;
+    std::size_t size = 1 << 20;
+    double min_seconds = 0.02;
+    bool perf = false;
+};
+
+struct sample
+{
+    double seconds = 0;
+    double tsc_cycles = 0;
+    double cycles = 0;
+    double instructions = 0;
+    double branch_misses = 0;
+    bool has_perf = false;
+};
+
+class perf_counters
+{
+public:
+    perf_counters(bool enable)
+    {
+#if defined(__linux__)
+        if (!enable)
+        {
+            return;
+        }
+
+        const std::uint64_t configs[] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_BRANCH_MISSES
+        };
+
+        for (int k = 0; k < 3; ++k)
+        {
+            perf_event_attr attr {};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = configs[k];
+            attr.disabled = k == 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+
+            fds[k] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, k == 0 ? -1 : fds[0], 0));
+
+            if (fds[k] < 0)
+            {
+                close_all();
+                std::cerr << "bench: perf_event_open unavailable, hardware counters disabled" << std::endl;
+                return;
+            }
+        }
+
+        enabled = true;
+#else
+        if (enable)
+        {
+            std::cerr << "bench: hardware counters are only supported on Linux" << std::endl;
+        }
+#endif
+    }
+
+    ~perf_counters()
+    {
+        close_all();
+    }
+
+    bool active() const
+    {
+        return enabled;
+    }
+
+    void start()
+    {
+#if defined(__linux__)
+        if (enabled)
+        {
+            ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    void stop(sample &s)
+    {
+#if defined(__linux__)
+        if (enabled)
+        {
+            ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+            std::uint64_t values[4] = {};
+
+            if (read(fds[0], values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)))
+            {
+                s.cycles = static_cast<double>(values[1]);
+                s.instructions = static_cast<double>(values[2]);
+                s.branch_misses = static_cast<double>(values[3]);
+                s.has_perf = true;
+            }
+        }
+#endif
+    }
+
+private:
+    void close_all()
+    {
+#if defined(__linux__)
+        for (int &fd : fds)
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+                fd = -1;
+            }
+        }
+#endif
+        enabled = false;
+    }
+
+    int fds[3] = { -1, -1, -1 };
+    bool enabled = false;
+};
+
+inline std::uint64_t read_tsc()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+struct corpus
+{
+    std::string name;
+    std::u32string text;
+    std::uint32_t error_rate;
+};
+
+std::uint32_t next_random(std::uint32_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    return state;
+}
+
+std::u32string generate_text(std::size_t n, std::uint32_t seed, const std::vector<std::pair<char32_t, char32_t>> &ranges)
+{
+    std::u32string text;
+    text.reserve(n);
+
+    while (text.size() < n)
+    {
+        const auto &[lo, hi] = ranges[next_random(seed) % ranges.size()];
+        char32_t ch = lo + next_random(seed) % (hi - lo + 1);
+
+        if (xtual::is_code_point(ch))
+        {
+            text.push_back(ch);
+        }
+    }
+
+    return text;
+}
+
+std::vector<corpus> make_corpora(std::size_t n)
+{
+    std::vector<corpus> corpora;
+
+    corpora.push_back({ "ascii", generate_text(n, 1, { { U' ', U'~' }, { U'\n', U'\n' } }), 0 });
+    corpora.push_back({ "latin", generate_text(n, 2, { { U'a', U'z' }, { U'a', U'z' }, { U'\xc0', U'\xff' }, { U'\x100', U'\x17f' } }), 0 });
+    corpora.push_back({ "cjk", generate_text(n, 3, { { U'\x3041', U'\x3096' }, { U'\x4e00', U'\x9fff' }, { U'\x4e00', U'\x9fff' } }), 0 });
+    corpora.push_back({ "astral", generate_text(n, 4, { { U'\x1f300', U'\x1f64f' }, { U'\x20000', U'\x2a6df' } }), 0 });
+    corpora.push_back({ "mixed", generate_text(n, 5, { { U' ', U'~' }, { U'\x400', U'\x4ff' }, { U'\x4e00', U'\x9fff' }, { U'\x1f300', U'\x1f64f' } }), 0 });
+    corpora.push_back({ "errors", generate_text(n, 6, { { U' ', U'~' }, { U'\x400', U'\x4ff' }, { U'\x4e00', U'\x9fff' }, { U'\x1f300', U'\x1f64f' } }), 1000 });
+
+    return corpora;
+}
+
+template <typename Codec, typename decodeF, typename encodeF>
+struct encoding
+{
+    using codec = Codec;
+    using unit_type = typename Codec::unit_type;
+
+    const char *name;
+    decodeF decode;
+    encodeF encode;
+    std::vector<unit_type> error;
+};
+
+template <typename Codec, typename decodeF, typename encodeF>
+encoding<Codec, decodeF, encodeF> make_encoding(const char *name, decodeF decode, encodeF encode, std::initializer_list<int> error)
+{
+    std::vector<typename Codec::unit_type> units;
+
+    for (int u : error)
+    {
+        units.push_back(static_cast<typename Codec::unit_type>(u));
+    }
+
+    return { name, decode, encode, units };
+}
+
+template <typename Enc>
+std::vector<typename Enc::unit_type> encode_corpus(const Enc &enc, const corpus &c)
+{
+    using unitT = typename Enc::unit_type;
+
+    std::vector<unitT> buf(c.text.size() * Enc::codec::max_length);
+
+    auto r = xtual::transcode<xtual::u32_codec, typename Enc::codec>(c.text, buf);
+    buf.resize(r.written);
+
+    if (c.error_rate != 0)
+    {
+        std::uint32_t seed = 7;
+        std::size_t stride = enc.error.size();
+
+        for (std::size_t k = 0; k + stride <= buf.size(); k += stride * (1 + next_random(seed) % (2 * c.error_rate)))
+        {
+            std::copy(enc.error.begin(), enc.error.end(), buf.begin() + k);
+        }
+    }
+
+    return buf;
+}
+
+struct result
+{
+    std::string corpus;
+    std::string from;
+    std::string to;
+    std::string path;
+    std::size_t bytes;
+    sample s;
+
+    double gbps() const
+    {
+        return bytes / s.seconds / 1e9;
+    }
+
+    std::string key() const
+    {
+        return corpus + "," + from + "," + to + "," + path;
+    }
+};
+
+class runner
+{
+public:
+    runner(const options &opts)
+        : opts(opts), counters(opts.perf)
+    {
+    }
+
+    void run(const std::string &corpus, const std::string &from, const std::string &to, const std::string &path, std::size_t bytes, const std::function<std::size_t()> &f)
+    {
+        result r { corpus, from, to, path, bytes, {} };
+
+        if (!opts.filter.empty() && r.key().find(opts.filter) == std::string::npos)
+        {
+            return;
+        }
+
+        volatile std::size_t sink = f();
+        std::size_t iterations = 0;
+
+        counters.start();
+
+        auto t0 = std::chrono::steady_clock::now();
+        std::uint64_t c0 = read_tsc();
+        double elapsed = 0;
+
+        do
+        {
+            sink = sink + f();
+            ++iterations;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        } while (elapsed < opts.min_seconds);
+
+        std::uint64_t c1 = read_tsc();
+
+        counters.stop(r.s);
+
+        r.s.seconds = elapsed / iterations;
+        r.s.tsc_cycles = static_cast<double>(c1 - c0) / iterations;
+        r.s.cycles /= iterations;
+        r.s.instructions /= iterations;
+        r.s.branch_misses /= iterations;
+
+        results.push_back(r);
+        print(r);
+    }
+
+    const std::vector<result> &all() const
+    {
+        return results;
+    }
+
+private:
+    void print(const result &r) const
+    {
+        char line[256];
+
+        std::snprintf(line, sizeof(line), "%-8s %-6s -> %-6s %-10s %8.3f GB/s %7.3f tsc/B",
+                      r.corpus.c_str(), r.from.c_str(), r.to.c_str(), r.path.c_str(), r.gbps(), r.s.tsc_cycles / r.bytes);
+
+        std::cout << line;
+
+        if (r.s.has_perf)
+        {
+            std::snprintf(line, sizeof(line), " %7.3f cyc/B %7.3f ins/B %7.4f bmiss/B",
+                          r.s.cycles / r.bytes, r.s.instructions / r.bytes, r.s.branch_misses / r.bytes);
+            std::cout << line;
+        }
+
+        std::cout << std::endl;
+    }
+
+    const options &opts;
+    perf_counters counters;
+    std::vector<result> results;
+};
+
+template <typename From, typename To>
+void bench_pair(runner &run, const corpus &c, const From &from, const To &to, const std::vector<typename From::unit_type> &input)
+{
+    using inT = typename From::unit_type;
+    using outT = typename To::unit_type;
+
+    std::size_t bytes = input.size() * sizeof(inT);
+    std::vector<outT> output(input.size() * To::codec::max_length + To::codec::max_length);
+
+    run.run(c.name, from.name, to.name, "bulk", bytes, [&]() {
+        std::span<const inT> in = input;
+        std::size_t written = 0;
+
+        while (!in.empty())
+        {
+            auto r = xtual::transcode<typename From::codec, typename To::codec>(in, std::span<outT>(output).subspan(written));
+
+            written += r.written;
+            in = in.subspan(std::min(in.size(), r.status == xtual::transcode_status::ok ? r.read : r.read + from.error.size()));
+        }
+
+        return written;
+    });
+
+    if (c.error_rate != 0)
+    {
+        run.run(c.name, from.name, to.name, "replace", bytes, [&]() {
+            return xtual::transcode<typename From::codec, typename To::codec>(input, output, xtual::error_policy::replace).written;
+        });
+    }
+
+    run.run(c.name, from.name, to.name, "codepoint", bytes, [&]() {
+        auto i = input.data();
+        auto s = input.data() + input.size();
+        auto o = output.data();
+        auto oe = output.data() + output.size();
+
+        while (i != s)
+        {
+            auto j = i;
+            auto opt = from.decode(j, s);
+
+            if (opt.has_value())
+            {
+                to.encode(o, oe, opt.value());
+                i = j;
+            }
+            else
+            {
+                i += std::min<std::size_t>(s - i, from.error.size());
+            }
+        }
+
+        return static_cast<std::size_t>(o - output.data());
+    });
+}
+
+template <typename Enc, typename... Encs>
+void bench_from(runner &run, const corpus &c, const Enc &from, const Encs &...tos)
+{
+    auto input = encode_corpus(from, c);
+
+    (bench_pair(run, c, from, tos, input), ...);
+}
+
+void bench_kernels(runner &run, const corpus &c)
+{
+    std::vector<char8_t> u8(c.text.size() * 4);
+    std::vector<char16_t> u16(c.text.size() * 2);
+
+    u8.resize(xtual::transcode_u32_to_u8(c.text, u8).written);
+    u16.resize(xtual::transcode_u32_to_u16(c.text, u16).written);
+
+    run.run(c.name, "u8", "-", "validate", u8.size(), [&]() {
+        return xtual::validate_u8(u8);
+    });
+
+    run.run(c.name, "u8", "-", "count", u8.size(), [&]() {
+        return xtual::count_code_points_u8(u8);
+    });
+
+    run.run(c.name, "u8", "u16", "length", u8.size(), [&]() {
+        return xtual::utf16_length_from_u8(u8);
+    });
+
+    run.run(c.name, "u16", "u8", "length", u16.size() * 2, [&]() {
+        return xtual::utf8_length_from_u16(u16);
+    });
+
+    run.run(c.name, "u32", "u8", "length", c.text.size() * 4, [&]() {
+        return xtual::utf8_length_from_u32(c.text);
+    });
+}
+
+void write_csv(const std::string &path, const std::vector<result> &results)
+{
+    std::ofstream out(path);
+
+    out << "corpus,from,to,path,bytes,seconds,gbps,tsc_per_byte,cycles_per_byte,instructions_per_byte,branch_misses_per_byte\n";
+
+    for (const auto &r : results)
+    {
+        out << r.key() << ',' << r.bytes << ',' << r.s.seconds << ',' << r.gbps() << ',' << r.s.tsc_cycles / r.bytes;
+
+        if (r.s.has_perf)
+        {
+            out << ',' << r.s.cycles / r.bytes << ',' << r.s.instructions / r.bytes << ',' << r.s.branch_misses / r.bytes;
+        }
+        else
+        {
+            out << ",,,";
+        }
+
+        out << '\n';
+    }
+}
+
+int compare_baseline(const std::string &path, const std::vector<result> &results)
+{
+    std::ifstream in(path);
+    std::map<std::string, double> baseline;
+    std::string line;
+
+    std::getline(in, line);
+
+    while (std::getline(in, line))
+    {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+
+        while (std::getline(ss, field, ','))
+        {
+            fields.push_back(field);
+        }
+
+        if (fields.size() >= 7)
+        {
+            baseline[fields[0] + "," + fields[1] + "," + fields[2] + "," + fields[3]] = std::stod(fields[6]);
+        }
+    }
+
+    int regressions = 0;
+
+    for (const auto &r : results)
+    {
+        auto it = baseline.find(r.key());
+
+        if (it != baseline.end() && r.gbps() < it->second * 0.9)
+        {
+            std::cout << "regression: " << r.key() << ' ' << it->second << " -> " << r.gbps() << " GB/s" << std::endl;
+            ++regressions;
+        }
+    }
+
+    return regressions == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    options opts;
+
+    for (int k = 1; k < argc; ++k)
+    {
+        std::string arg = argv[k];
+
+        if (arg == "--perf")
+        {
+            opts.perf = true;
+        }
+        else if (arg == "--filter" && k + 1 < argc)
+        {
+            opts.filter = argv[++k];
+        }
+        else if (arg == "--output" && k + 1 < argc)
+        {
+            opts.output = argv[++k];
+        }
+        else if (arg == "--baseline" && k + 1 < argc)
+        {
+            opts.baseline = argv[++k];
+        }
+        else if (arg == "--size" && k + 1 < argc)
+        {
+            opts.size = std::stoul(argv[++k]);
+        }
+        else if (arg == "--min-time" && k + 1 < argc)
+        {
+            opts.min_seconds = std::stod(argv[++k]);
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--perf] [--filter KEY] [--output CSV] [--baseline CSV] [--size CODEPOINTS] [--min-time SECONDS]" << std::endl;
+            return 2;
+        }
+    }
+
+    auto u8 = make_encoding<xtual::u8_codec>(
+        "u8",
+        [](auto &i, auto s) { return xtual::decode_from_u8(i, s); },
+        [](auto &i, auto s, char32_t ch) { return xtual::encode_as_u8(i, s, ch); },
+        { 0xff });
+    auto u8dfa = make_encoding<xtual::utf8_codec<char8_t, xtual::utf8_dfa>>(
+        "u8dfa",
+        [](auto &i, auto s) { return xtual::decode_from_u8<xtual::utf8_dfa>(i, s); },
+        [](auto &i, auto s, char32_t ch) { return xtual::encode_as_u8(i, s, ch); },
+        { 0xff });
+    auto b8 = make_encoding<xtual::b8_codec<char>>(
+        "b8",
+        [](auto &i, auto s) { return xtual::decode_from_b8<char>(i, s); },
+        [](auto &i, auto s, char32_t ch) { return xtual::encode_as_b8<char>(i, s, ch); },
+        { 0xff });
+    auto u16 = make_encoding<xtual::u16_codec>(
+        "u16",
+        [](auto &i, auto s) { return xtual::decode_from_u16(i, s); },
+        [](auto &i, auto s, char32_t ch) { return xtual::encode_as_u16(i, s, ch); },
+        { 0xdc00 });
+    auto b16be = make_encoding<xtual::b16be_codec<char>>(
+        "b16be",
+        [](auto &i, auto s) { return xtual::decode_from_b16be<char>(i, s); },
+        [](auto &i, auto s, char32_t ch) { return xtual::encode_as_b16be<char>(i, s, ch); },
+        { 0xdc, 0x00 });
+    auto b16le = make_encoding<xtual::b16le_codec<char>>(
+        "b16le",
+        [](auto &i, auto s) { return xtual::decode_from_b16le<char>(i, s); },
+        [](auto &i, auto s, char32_t ch) { return xtual::encode_as_b16le<char>(i, s, ch); },
+        { 0x00, 0xdc });
+    auto u32 = make_encoding<xtual::u32_codec>(
+        "u32",
+        [](auto &i, auto s) { return xtual::decode_from_u32(i, s); },
+        [](auto &i, auto s, char32_t ch) { return xtual::encode_as_u32(i, s, ch); },
+        { 0xdc00 });
+    auto b32be = make_encoding<xtual::b32be_codec<char>>(
+        "b32be",
+        [](auto &i, auto s) { return xtual::decode_from_b32be<char>(i, s); },
+        [](auto &i, auto s, char32_t ch) { return xtual::encode_as_b32be<char>(i, s, ch); },
+        { 0x00, 0x00, 0xdc, 0x00 });
+    auto b32le = make_encoding<xtual::b32le_codec<char>>(
+        "b32le",
+        [](auto &i, auto s) { return xtual::decode_from_b32le<char>(i, s); },
+        [](auto &i, auto s, char32_t ch) { return xtual::encode_as_b32le<char>(i, s, ch); },
+        { 0x00, 0xdc, 0x00, 0x00 });
+
+    runner run(opts);
+
+    for (const auto &c : make_corpora(opts.size))
+    {
+        auto from_each = [&](const auto &from) {
+            bench_from(run, c, from, u8, b8, u16, b16be, b16le, u32, b32be, b32le);
+        };
+
+        from_each(u8);
+        bench_from(run, c, u8dfa, u16, u32);
+        from_each(b8);
+        from_each(u16);
+        from_each(b16be);
+        from_each(b16le);
+        from_each(u32);
+        from_each(b32be);
+        from_each(b32le);
+
+        bench_kernels(run, c);
+    }
+
+    if (!opts.output.empty())
+    {
+        write_csv(opts.output, run.all());
+    }
+
+    if (!opts.baseline.empty())
+    {
+        return compare_baseline(opts.baseline, run.all());
+    }
+
+    return 0;
+}
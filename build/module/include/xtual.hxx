@@ -0,0 +1,55 @@
+#ifndef XTUAL_INCLUDE_XTUAL_HXX_AFE2A99E_7F15_43E2_BF45_640942838743
+#define XTUAL_INCLUDE_XTUAL_HXX_AFE2A99E_7F15_43E2_BF45_640942838743
+
+#define XTUAL_MODULE
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && (!defined(XTUAL_MODULE) || defined(__AVX2__))
+#define XTUAL_X86_SIMD
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+// GCC cannot write functions with their own target options to a module
+// interface, so the module is compiled for AVX2 as a whole instead.
+#if defined(XTUAL_MODULE)
+#define XTUAL_TARGET(isa)
+#else
+#define XTUAL_TARGET(isa) [[gnu::target(isa)]]
+#endif
+
+// The dispatch state is defined once in the module object; GCC 12 neither
+// keeps the initialisers of inline variables nor inlines std::atomic
+// correctly into an importer.
+#if defined(XTUAL_MODULE)
+#define XTUAL_HEADER_INLINE
+#else
+#define XTUAL_HEADER_INLINE inline
+#endif
+
+import xtual;
+
+#endif
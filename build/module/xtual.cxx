@@ -0,0 +1,8374 @@
+
+// Copyright 2024 mpetx
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+module;
+
+#define XTUAL_MODULE
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && (!defined(XTUAL_MODULE) || defined(__AVX2__))
+#define XTUAL_X86_SIMD
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+// GCC cannot write functions with their own target options to a module
+// interface, so the module is compiled for AVX2 as a whole instead.
+#if defined(XTUAL_MODULE)
+#define XTUAL_TARGET(isa)
+#else
+#define XTUAL_TARGET(isa) [[gnu::target(isa)]]
+#endif
+
+// The dispatch state is defined once in the module object; GCC 12 neither
+// keeps the initialisers of inline variables nor inlines std::atomic
+// correctly into an importer.
+#if defined(XTUAL_MODULE)
+#define XTUAL_HEADER_INLINE
+#else
+#define XTUAL_HEADER_INLINE inline
+#endif
+
+
+export module xtual;
+
+export
+{
+
+
+namespace xtual
+{
+
+    template <typename T>
+    concept byte_like =
+        std::same_as<T, std::byte>
+        || std::same_as<T, char>
+        || std::same_as<T, unsigned char>
+        || std::same_as<T, signed char>
+        || std::same_as<T, std::uint8_t>
+        || std::same_as<T, std::int8_t>;
+
+    constexpr bool is_surrogate(char32_t ch)
+    {
+        return (ch >> 11) == 0x1b;
+    }
+
+    constexpr bool is_surrogate(char16_t ch)
+    {
+        return (ch >> 11) == 0x1b;
+    }
+    
+    constexpr bool is_high_surrogate(char32_t ch)
+    {
+        return (ch >> 10) == 0x36;
+    }
+
+    constexpr bool is_high_surrogate(char16_t ch)
+    {
+        return (ch >> 10) == 0x36;
+    }
+
+    constexpr bool is_low_surrogate(char32_t ch)
+    {
+        return (ch >> 10) == 0x37;
+    }
+
+    constexpr bool is_low_surrogate(char16_t ch)
+    {
+        return (ch >> 10) == 0x37;
+    }
+    
+    constexpr bool is_code_point(char32_t ch)
+    {
+        return !is_surrogate(ch) && ch <= U'\x10ffff';
+    }
+
+    enum class transcode_status
+    {
+        ok,
+        invalid,
+        incomplete,
+        insufficient
+    };
+
+    enum class error_policy
+    {
+        strict,
+        replace
+    };
+
+#if defined(XTUAL_ENABLE_STATS)
+    inline void stats_count_error(transcode_status status);
+#endif
+
+    // Counts a decoding failure of the given kind when statistics are
+    // enabled, and returns std::nullopt for the failing decoder to return.
+    constexpr std::nullopt_t decode_error(transcode_status status)
+    {
+#if defined(XTUAL_ENABLE_STATS)
+        if (!std::is_constant_evaluated())
+        {
+            stats_count_error(status);
+        }
+#else
+        static_cast<void>(status);
+#endif
+
+        return std::nullopt;
+    }
+
+    struct transcode_result
+    {
+        std::size_t read;
+        std::size_t written;
+        transcode_status status;
+    };
+
+    template <typename From, typename To>
+    struct transcode_kernel
+    {
+        static void run(const typename From::unit_type *&, const typename From::unit_type *, typename To::unit_type *&, typename To::unit_type *)
+        {
+        }
+    };
+
+    template <typename Codec>
+    constexpr bool can_encode(char32_t ch)
+    {
+        if constexpr (requires { Codec::can_encode(ch); })
+        {
+            return Codec::can_encode(ch);
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    template <typename Codec>
+    constexpr char32_t replacement_character()
+    {
+        if constexpr (requires { Codec::replacement; })
+        {
+            return Codec::replacement;
+        }
+        else
+        {
+            return U'\xfffd';
+        }
+    }
+
+    template <typename Codec>
+    constexpr std::size_t skip_length(const typename Codec::unit_type *p, const typename Codec::unit_type *e)
+    {
+        const auto *q = p;
+        char32_t ch;
+
+        if (Codec::decode(q, e, ch) == transcode_status::ok)
+        {
+            return static_cast<std::size_t>(q - p);
+        }
+
+        return Codec::ill_formed_length(p, e);
+    }
+
+    constexpr std::uint16_t byteswap(std::uint16_t u)
+    {
+        return static_cast<std::uint16_t>((u << 8) | (u >> 8));
+    }
+
+    constexpr std::uint32_t byteswap(std::uint32_t u)
+    {
+        return (u << 24) | ((u & 0xff00) << 8) | ((u >> 8) & 0xff00) | (u >> 24);
+    }
+
+    template <typename Iter, typename Sent, typename unitT>
+    concept contiguous_units =
+        std::contiguous_iterator<Iter>
+        && std::sized_sentinel_for<Sent, Iter>
+        && std::same_as<std::iter_value_t<Iter>, unitT>;
+
+    template <typename Codec, std::contiguous_iterator Iter, std::sized_sentinel_for<Iter> Sent>
+    constexpr std::optional<char32_t> decode_contiguous(Iter &i, Sent s)
+    {
+        if (i == s)
+        {
+            return std::nullopt;
+        }
+
+        const typename Codec::unit_type *p = std::to_address(i);
+        const typename Codec::unit_type *q = p;
+        char32_t ch;
+
+        if (Codec::decode(q, p + (s - i), ch) != transcode_status::ok)
+        {
+            return std::nullopt;
+        }
+
+        i += q - p;
+
+        return ch;
+    }
+
+    template <typename Codec, std::contiguous_iterator Iter, std::sized_sentinel_for<Iter> Sent>
+    constexpr bool encode_contiguous(Iter &i, Sent s, char32_t ch)
+    {
+        if (i == s || !is_code_point(ch))
+        {
+            return false;
+        }
+
+        typename Codec::unit_type *p = std::to_address(i);
+        typename Codec::unit_type *q = p;
+
+        if (!Codec::encode(q, p + (s - i), ch))
+        {
+            return false;
+        }
+
+        i += q - p;
+
+        return true;
+    }
+
+    template <std::bidirectional_iterator Iter, std::sentinel_for<Iter> Sent, typename Tail, typename Decode>
+    constexpr std::optional<char32_t> decode_backward(Iter &i, Sent s, std::size_t width, std::size_t max_length, Tail is_tail, Decode decode)
+    {
+        Iter j = i;
+
+        for (std::size_t n = 0; n < max_length; ++n)
+        {
+            for (std::size_t k = 0; k < width; ++k)
+            {
+                if (j == s)
+                {
+                    return std::nullopt;
+                }
+
+                --j;
+            }
+
+            if (j == s || !is_tail(j))
+            {
+                break;
+            }
+        }
+
+        Iter k = j;
+        auto ch = decode(k, i);
+
+        if (!ch.has_value() || k != i)
+        {
+            return std::nullopt;
+        }
+
+        i = j;
+
+        return ch;
+    }
+
+}
+
+namespace xtual
+{
+
+    enum class simd_level
+    {
+        scalar,
+        sse2,
+        ssse3,
+        avx2,
+    };
+
+    constexpr std::string_view simd_level_name(simd_level level)
+    {
+        switch (level)
+        {
+        case simd_level::sse2:
+            return "sse2";
+        case simd_level::ssse3:
+            return "ssse3";
+        case simd_level::avx2:
+            return "avx2";
+        default:
+            return "scalar";
+        }
+    }
+
+    constexpr std::optional<simd_level> parse_simd_level(std::string_view name)
+    {
+        for (simd_level level : { simd_level::scalar, simd_level::sse2, simd_level::ssse3, simd_level::avx2 })
+        {
+            // std::ranges::equal rather than ==, which GCC 12 cannot
+            // instantiate in a module importer that includes <string_view>.
+            if (std::ranges::equal(simd_level_name(level), name))
+            {
+                return level;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    // Reads the CPUID feature bits directly; AVX2 also needs the OS to save
+    // the YMM registers, which XGETBV reports.
+    inline simd_level detect_simd_level()
+    {
+#if defined(XTUAL_X86_SIMD)
+        unsigned int a, b, c, d;
+
+        if (__get_cpuid(1, &a, &b, &c, &d) == 0)
+        {
+            return simd_level::scalar;
+        }
+
+        bool sse2 = (d >> 26 & 1) != 0;
+        bool ssse3 = (c >> 9 & 1) != 0;
+        bool avx = (c >> 27 & 1) != 0 && (c >> 28 & 1) != 0;
+
+        if (avx)
+        {
+            unsigned int low, high;
+
+            __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+            avx = (low & 6) == 6;
+        }
+
+        if (avx && __get_cpuid_count(7, 0, &a, &b, &c, &d) != 0 && (b >> 5 & 1) != 0)
+        {
+            return simd_level::avx2;
+        }
+
+        if (ssse3)
+        {
+            return simd_level::ssse3;
+        }
+
+        if (sse2)
+        {
+            return simd_level::sse2;
+        }
+#endif
+
+        return simd_level::scalar;
+    }
+
+    XTUAL_HEADER_INLINE std::atomic<int> simd_level_state = -1;
+
+    XTUAL_HEADER_INLINE simd_level set_simd_level(simd_level level)
+    {
+        level = std::min(level, detect_simd_level());
+        simd_level_state.store(static_cast<int>(level), std::memory_order_relaxed);
+
+        return level;
+    }
+
+    XTUAL_HEADER_INLINE simd_level active_simd_level()
+    {
+        int state = simd_level_state.load(std::memory_order_relaxed);
+
+        if (state >= 0)
+        {
+            return static_cast<simd_level>(state);
+        }
+
+        simd_level level = simd_level::avx2;
+
+        if (const char *name = std::getenv("XTUAL_SIMD_LEVEL"))
+        {
+            level = parse_simd_level(name).value_or(level);
+        }
+
+        return set_simd_level(level);
+    }
+
+}
+
+
+namespace xtual
+{
+
+    struct u32_codec;
+
+    template <byte_like byteT, std::endian order>
+    struct b32_codec;
+
+    template <typename charT, std::output_iterator<charT> Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent, char32_t> Writ>
+    constexpr bool utf32_encode(Iter &i, Sent s, char32_t ch, Writ write)
+    {
+        if (!is_code_point(ch))
+        {
+            return false;
+        }
+
+        return write(i, s, ch);
+    }
+
+    template <std::output_iterator<char32_t> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool encode_as_u32(Iter &i, Sent s, char32_t ch)
+    {
+        if constexpr (contiguous_units<Iter, Sent, char32_t>)
+        {
+            if (encode_contiguous<u32_codec>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
+        return utf32_encode<char32_t>(i, s, ch, [](Iter &i, Sent s, char32_t ch) {
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = ch;
+
+            return true;
+        });
+    }
+
+    template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool encode_as_b32be(Iter &i, Sent s, char32_t ch)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (encode_contiguous<b32_codec<byteT, std::endian::big>>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
+        return utf32_encode<byteT>(i, s, ch, [](Iter &i, Sent s, char32_t ch) {
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>((ch >> 24) & 0xff));
+
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>((ch >> 16) & 0xff));
+
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>((ch >> 8) & 0xff));
+
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>(ch & 0xff));
+
+            return true;
+        });
+    }
+
+    template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool encode_as_b32le(Iter &i, Sent s, char32_t ch)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (encode_contiguous<b32_codec<byteT, std::endian::little>>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
+        return utf32_encode<byteT>(i, s, ch, [](Iter &i, Sent s, char32_t ch) {
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>(ch & 0xff));
+
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>((ch >> 8) & 0xff));
+
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>((ch >> 16) & 0xff));
+
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>((ch >> 24) & 0xff));
+
+            return true;
+        });
+    }
+
+    template <std::input_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
+    constexpr std::optional<char32_t> utf32_decode(Iter &i, Sent s, Rdr read)
+    {
+        bool empty = i == s;
+        auto opt = read(i, s);
+
+        if (!opt.has_value())
+        {
+            return empty ? std::nullopt : decode_error(transcode_status::incomplete);
+        }
+
+        char32_t ch = opt.value();
+
+        if (!is_code_point(ch))
+        {
+            return decode_error(transcode_status::invalid);
+        }
+        else
+        {
+            return ch;
+        }
+    }
+
+    template <std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, char32_t>
+    constexpr std::optional<char32_t> decode_from_u32(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, char32_t>)
+        {
+            if (auto ch = decode_contiguous<u32_codec>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf32_decode(i, s, [](Iter &i, Sent s) -> std::optional<char32_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            return *i++;
+        });
+    }
+
+    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_from_b32be(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b32_codec<byteT, std::endian::big>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf32_decode(i, s, [](Iter &i, Sent s) -> std::optional<char32_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b1 = *i++;
+            char32_t c1 = static_cast<char32_t>(static_cast<std::byte>(b1));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b2 = *i++;
+            char32_t c2 = static_cast<char32_t>(static_cast<std::byte>(b2));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b3 = *i++;
+            char32_t c3 = static_cast<char32_t>(static_cast<std::byte>(b3));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b4 = *i++;
+            char32_t c4 = static_cast<char32_t>(static_cast<std::byte>(b4));
+
+            return (c1 << 24) | (c2 << 16) | (c3 << 8) | c4;
+        });
+    }
+
+    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_from_b32le(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b32_codec<byteT, std::endian::little>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf32_decode(i, s, [](Iter &i, Sent s) -> std::optional<char32_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b1 = *i++;
+            char32_t c1 = static_cast<char32_t>(static_cast<std::byte>(b1));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b2 = *i++;
+            char32_t c2 = static_cast<char32_t>(static_cast<std::byte>(b2));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b3 = *i++;
+            char32_t c3 = static_cast<char32_t>(static_cast<std::byte>(b3));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b4 = *i++;
+            char32_t c4 = static_cast<char32_t>(static_cast<std::byte>(b4));
+
+            return c1 | (c2 << 8) | (c3 << 16) | (c4 << 24);
+        });
+    }
+
+    template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
+    constexpr std::optional<char32_t> utf32_decode_lossy(Iter &i, Sent s, Rdr read)
+    {
+        if (i == s)
+        {
+            return std::nullopt;
+        }
+
+        Iter j = i;
+        auto opt = utf32_decode(j, s, read);
+
+        if (opt.has_value())
+        {
+            i = j;
+
+            return opt;
+        }
+
+        read(i, s);
+
+        return U'\xfffd';
+    }
+
+    template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, char32_t>
+    constexpr std::optional<char32_t> decode_lossy_from_u32(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, char32_t>)
+        {
+            if (auto ch = decode_contiguous<u32_codec>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf32_decode_lossy(i, s, [](Iter &i, Sent s) -> std::optional<char32_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            return *i++;
+        });
+    }
+    template <byte_like byteT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_b32be(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b32_codec<byteT, std::endian::big>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf32_decode_lossy(i, s, [](Iter &i, Sent s) -> std::optional<char32_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b1 = *i++;
+            char32_t c1 = static_cast<char32_t>(static_cast<std::byte>(b1));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b2 = *i++;
+            char32_t c2 = static_cast<char32_t>(static_cast<std::byte>(b2));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b3 = *i++;
+            char32_t c3 = static_cast<char32_t>(static_cast<std::byte>(b3));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b4 = *i++;
+            char32_t c4 = static_cast<char32_t>(static_cast<std::byte>(b4));
+
+            return (c1 << 24) | (c2 << 16) | (c3 << 8) | c4;
+        });
+    }
+    template <byte_like byteT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_b32le(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b32_codec<byteT, std::endian::little>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf32_decode_lossy(i, s, [](Iter &i, Sent s) -> std::optional<char32_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b1 = *i++;
+            char32_t c1 = static_cast<char32_t>(static_cast<std::byte>(b1));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b2 = *i++;
+            char32_t c2 = static_cast<char32_t>(static_cast<std::byte>(b2));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b3 = *i++;
+            char32_t c3 = static_cast<char32_t>(static_cast<std::byte>(b3));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b4 = *i++;
+            char32_t c4 = static_cast<char32_t>(static_cast<std::byte>(b4));
+
+            return c1 | (c2 << 8) | (c3 << 16) | (c4 << 24);
+        });
+    }
+
+    struct u32_codec
+    {
+        using unit_type = char32_t;
+
+        static constexpr std::size_t max_length = 1;
+
+        static constexpr const char32_t *resync(const char32_t *, const char32_t *p, const char32_t *)
+        {
+            return p;
+        }
+
+        static constexpr std::size_t ill_formed_length(const char32_t *, const char32_t *)
+        {
+            return 1;
+        }
+
+        static constexpr transcode_status decode(const char32_t *&p, const char32_t *, char32_t &ch)
+        {
+            if (!is_code_point(*p))
+            {
+                return transcode_status::invalid;
+            }
+
+            ch = *p++;
+
+            return transcode_status::ok;
+        }
+
+        static constexpr bool encode(char32_t *&p, char32_t *e, char32_t ch)
+        {
+            if (p == e)
+            {
+                return false;
+            }
+
+            *p++ = ch;
+
+            return true;
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct b32_codec
+    {
+        using unit_type = byteT;
+
+        static constexpr std::size_t max_length = 4;
+
+        static constexpr char32_t load(const byteT *p)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                std::uint32_t u;
+                std::memcpy(&u, p, 4);
+
+                return static_cast<char32_t>(order == std::endian::native ? u : byteswap(u));
+            }
+
+            char32_t c1 = static_cast<char32_t>(static_cast<std::byte>(p[0]));
+            char32_t c2 = static_cast<char32_t>(static_cast<std::byte>(p[1]));
+            char32_t c3 = static_cast<char32_t>(static_cast<std::byte>(p[2]));
+            char32_t c4 = static_cast<char32_t>(static_cast<std::byte>(p[3]));
+
+            if constexpr (order == std::endian::big)
+            {
+                return (c1 << 24) | (c2 << 16) | (c3 << 8) | c4;
+            }
+            else
+            {
+                return c1 | (c2 << 8) | (c3 << 16) | (c4 << 24);
+            }
+        }
+
+        static constexpr void store(byteT *p, char32_t ch)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                std::uint32_t u = static_cast<std::uint32_t>(ch);
+
+                if constexpr (order != std::endian::native)
+                {
+                    u = byteswap(u);
+                }
+
+                std::memcpy(p, &u, 4);
+
+                return;
+            }
+
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                std::size_t shift = order == std::endian::big ? 24 - 8 * k : 8 * k;
+
+                p[k] = static_cast<byteT>(static_cast<std::byte>((ch >> shift) & 0xff));
+            }
+        }
+
+        static constexpr const byteT *resync(const byteT *b, const byteT *p, const byteT *)
+        {
+            return b + ((p - b) & ~std::ptrdiff_t(3));
+        }
+
+        static constexpr std::size_t ill_formed_length(const byteT *p, const byteT *e)
+        {
+            return e - p < 4 ? static_cast<std::size_t>(e - p) : 4;
+        }
+
+        static constexpr transcode_status decode(const byteT *&p, const byteT *e, char32_t &ch)
+        {
+            if (e - p < 4)
+            {
+                return transcode_status::incomplete;
+            }
+
+            char32_t u = load(p);
+
+            if (!is_code_point(u))
+            {
+                return transcode_status::invalid;
+            }
+
+            ch = u;
+            p += 4;
+
+            return transcode_status::ok;
+        }
+
+        static constexpr bool encode(byteT *&p, byteT *e, char32_t ch)
+        {
+            if (e - p < 4)
+            {
+                return false;
+            }
+
+            store(p, ch);
+            p += 4;
+
+            return true;
+        }
+    };
+
+    template <byte_like byteT>
+    using b32be_codec = b32_codec<byteT, std::endian::big>;
+
+    template <byte_like byteT>
+    using b32le_codec = b32_codec<byteT, std::endian::little>;
+    
+}
+
+
+namespace xtual
+{
+
+    struct u16_codec;
+
+    template <byte_like byteT, std::endian order>
+    struct b16_codec;
+
+    template <typename charT, std::output_iterator<charT> Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent, char16_t> Writ>
+    constexpr bool utf16_encode(Iter &i, Sent s, char32_t ch, Writ write)
+    {
+        if (!is_code_point(ch))
+        {
+            return false;
+        }
+        
+        if ((ch & ~U'\xffff') == 0)
+        {
+            return write(i, s, static_cast<char16_t>(ch));
+        }
+        else
+        {
+            char32_t u = ch - U'\x10000';
+            
+            char16_t w1 = u'\xd800';
+            char16_t w2 = u'\xdc00';
+
+            w1 |= static_cast<char16_t>((u >> 10) & U'\x3ff');
+            w2 |= static_cast<char16_t>(u & U'\x3ff');
+
+            return write(i, s, w1) && write(i, s, w2);
+        }
+    }
+
+    template <std::output_iterator<char16_t> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool encode_as_u16(Iter &i, Sent s, char32_t ch)
+    {
+        if constexpr (contiguous_units<Iter, Sent, char16_t>)
+        {
+            if (encode_contiguous<u16_codec>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
+        return utf16_encode<char16_t>(i, s, ch, [](Iter &i, Sent s, char16_t ch) {
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = ch;
+
+            return true;
+        });
+    }
+
+    template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool encode_as_b16be(Iter &i, Sent s, char32_t ch)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (encode_contiguous<b16_codec<byteT, std::endian::big>>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
+        return utf16_encode<byteT>(i, s, ch, [](Iter &i, Sent s, char16_t ch) {
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>((ch >> 8) & 0xff));
+            
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>(ch & 0xff));
+
+            return true;
+        });
+    }
+
+    template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool encode_as_b16le(Iter &i, Sent s, char32_t ch)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (encode_contiguous<b16_codec<byteT, std::endian::little>>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
+        return utf16_encode<byteT>(i, s, ch, [](Iter &i, Sent s, char16_t ch) {
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>(ch & 0xff));
+            
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>((ch >> 8) & 0xff));
+
+            return true;
+        });
+    }
+
+    constexpr char32_t decode_utf16_2(char16_t w1, char16_t w2)
+    {
+        char32_t u = ((static_cast<char32_t>(w1) & U'\x3ff') << 10)
+            | (static_cast<char32_t>(w2) & U'\x3ff');
+
+        return u + U'\x10000';
+    }
+
+    template <typename charT, std::input_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
+    requires std::convertible_to<std::iter_value_t<Iter>, charT>
+    constexpr std::optional<char32_t> utf16_decode(Iter &i, Sent s, Rdr read)
+    {
+        bool empty = i == s;
+        auto opt1 = read(i, s);
+
+        if (!opt1.has_value())
+        {
+            return empty ? std::nullopt : decode_error(transcode_status::incomplete);
+        }
+
+        char16_t w1 = opt1.value();
+
+        if (!is_surrogate(w1))
+        {
+            return static_cast<char32_t>(w1);
+        }
+        
+        if (!is_high_surrogate(w1))
+        {
+            return decode_error(transcode_status::invalid);
+        }
+
+        auto opt2 = read(i, s);
+
+        if (!opt2.has_value())
+        {
+            return decode_error(transcode_status::incomplete);
+        }
+
+        char16_t w2 = opt2.value();
+
+        if (!is_low_surrogate(w2))
+        {
+            return decode_error(transcode_status::invalid);
+        }
+
+        return decode_utf16_2(w1, w2);
+    }
+
+    template <std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, char16_t>
+    constexpr std::optional<char32_t> decode_from_u16(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, char16_t>)
+        {
+            if (auto ch = decode_contiguous<u16_codec>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf16_decode<char16_t>(i, s, [](Iter &i, Sent s) -> std::optional<char16_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            return *i++;
+        });
+    }
+
+    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_from_b16be(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b16_codec<byteT, std::endian::big>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf16_decode<byteT>(i, s, [](Iter &i, Sent s) -> std::optional<char16_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b1 = *i++;
+            char16_t c1 = static_cast<char16_t>(static_cast<std::byte>(b1));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b2 = *i++;
+            char16_t c2 = static_cast<char16_t>(static_cast<std::byte>(b2));
+
+            return (c1 << 8) | c2;
+        });
+    }
+
+    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_from_b16le(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b16_codec<byteT, std::endian::little>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf16_decode<byteT>(i, s, [](Iter &i, Sent s) -> std::optional<char16_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b1 = *i++;
+            char16_t c1 = static_cast<char16_t>(static_cast<std::byte>(b1));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b2 = *i++;
+            char16_t c2 = static_cast<char16_t>(static_cast<std::byte>(b2));
+
+            return c1 | (c2 << 8);
+        });
+    }
+    
+    template <std::bidirectional_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, char16_t>
+    constexpr std::optional<char32_t> decode_backward_from_u16(Iter &i, Sent s)
+    {
+        return decode_backward(i, s, 1, 2, [](const Iter &j) {
+            return is_low_surrogate(static_cast<char16_t>(*j));
+        }, [](Iter &k, const Iter &e) {
+            return decode_from_u16(k, e);
+        });
+    }
+
+    template <byte_like byteT, std::bidirectional_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_backward_from_b16be(Iter &i, Sent s)
+    {
+        return decode_backward(i, s, 2, 2, [](const Iter &j) {
+            char16_t c1 = static_cast<char16_t>(static_cast<std::byte>(static_cast<byteT>(*j)));
+            char16_t c2 = static_cast<char16_t>(static_cast<std::byte>(static_cast<byteT>(*std::next(j))));
+
+            return is_low_surrogate(static_cast<char16_t>((c1 << 8) | c2));
+        }, [](Iter &k, const Iter &e) {
+            return decode_from_b16be<byteT>(k, e);
+        });
+    }
+
+    template <byte_like byteT, std::bidirectional_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_backward_from_b16le(Iter &i, Sent s)
+    {
+        return decode_backward(i, s, 2, 2, [](const Iter &j) {
+            char16_t c1 = static_cast<char16_t>(static_cast<std::byte>(static_cast<byteT>(*j)));
+            char16_t c2 = static_cast<char16_t>(static_cast<std::byte>(static_cast<byteT>(*std::next(j))));
+
+            return is_low_surrogate(static_cast<char16_t>(c1 | (c2 << 8)));
+        }, [](Iter &k, const Iter &e) {
+            return decode_from_b16le<byteT>(k, e);
+        });
+    }
+
+    template <typename charT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
+    requires std::convertible_to<std::iter_value_t<Iter>, charT>
+    constexpr std::optional<char32_t> utf16_decode_lossy(Iter &i, Sent s, Rdr read)
+    {
+        if (i == s)
+        {
+            return std::nullopt;
+        }
+
+        Iter j = i;
+        auto opt = utf16_decode<charT>(j, s, read);
+
+        if (opt.has_value())
+        {
+            i = j;
+
+            return opt;
+        }
+
+        read(i, s);
+
+        return U'\xfffd';
+    }
+
+    template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, char16_t>
+    constexpr std::optional<char32_t> decode_lossy_from_u16(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, char16_t>)
+        {
+            if (auto ch = decode_contiguous<u16_codec>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf16_decode_lossy<char16_t>(i, s, [](Iter &i, Sent s) -> std::optional<char16_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            return *i++;
+        });
+    }
+    template <byte_like byteT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_b16be(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b16_codec<byteT, std::endian::big>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf16_decode_lossy<byteT>(i, s, [](Iter &i, Sent s) -> std::optional<char16_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b1 = *i++;
+            char16_t c1 = static_cast<char16_t>(static_cast<std::byte>(b1));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b2 = *i++;
+            char16_t c2 = static_cast<char16_t>(static_cast<std::byte>(b2));
+
+            return (c1 << 8) | c2;
+        });
+    }
+    template <byte_like byteT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_b16le(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b16_codec<byteT, std::endian::little>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf16_decode_lossy<byteT>(i, s, [](Iter &i, Sent s) -> std::optional<char16_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b1 = *i++;
+            char16_t c1 = static_cast<char16_t>(static_cast<std::byte>(b1));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b2 = *i++;
+            char16_t c2 = static_cast<char16_t>(static_cast<std::byte>(b2));
+
+            return c1 | (c2 << 8);
+        });
+    }
+
+    struct u16_codec
+    {
+        using unit_type = char16_t;
+
+        static constexpr std::size_t max_length = 2;
+
+        static constexpr const char16_t *resync(const char16_t *b, const char16_t *p, const char16_t *)
+        {
+            return p != b && is_low_surrogate(p[0]) && is_high_surrogate(p[-1]) ? p - 1 : p;
+        }
+
+        static constexpr std::size_t ill_formed_length(const char16_t *, const char16_t *)
+        {
+            return 1;
+        }
+
+        static constexpr transcode_status decode(const char16_t *&p, const char16_t *e, char32_t &ch)
+        {
+            char16_t w1 = p[0];
+
+            if (!is_surrogate(w1))
+            {
+                ch = static_cast<char32_t>(w1);
+                p += 1;
+
+                return transcode_status::ok;
+            }
+
+            if (!is_high_surrogate(w1))
+            {
+                return transcode_status::invalid;
+            }
+
+            if (e - p < 2)
+            {
+                return transcode_status::incomplete;
+            }
+
+            char16_t w2 = p[1];
+
+            if (!is_low_surrogate(w2))
+            {
+                return transcode_status::invalid;
+            }
+
+            ch = decode_utf16_2(w1, w2);
+            p += 2;
+
+            return transcode_status::ok;
+        }
+
+        static constexpr bool encode(char16_t *&p, char16_t *e, char32_t ch)
+        {
+            if ((ch & ~U'\xffff') == 0)
+            {
+                if (p == e)
+                {
+                    return false;
+                }
+
+                *p++ = static_cast<char16_t>(ch);
+
+                return true;
+            }
+
+            if (e - p < 2)
+            {
+                return false;
+            }
+
+            char32_t u = ch - U'\x10000';
+
+            *p++ = static_cast<char16_t>(0xd800 | ((u >> 10) & 0x3ff));
+            *p++ = static_cast<char16_t>(0xdc00 | (u & 0x3ff));
+
+            return true;
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct b16_codec
+    {
+        using unit_type = byteT;
+
+        static constexpr std::size_t max_length = 4;
+
+        static constexpr char16_t load(const byteT *p)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                std::uint16_t u;
+                std::memcpy(&u, p, 2);
+
+                return static_cast<char16_t>(order == std::endian::native ? u : byteswap(u));
+            }
+
+            char16_t c1 = static_cast<char16_t>(static_cast<std::byte>(p[0]));
+            char16_t c2 = static_cast<char16_t>(static_cast<std::byte>(p[1]));
+
+            if constexpr (order == std::endian::big)
+            {
+                return (c1 << 8) | c2;
+            }
+            else
+            {
+                return c1 | (c2 << 8);
+            }
+        }
+
+        static constexpr void store(byteT *p, char16_t ch)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                std::uint16_t u = static_cast<std::uint16_t>(ch);
+
+                if constexpr (order != std::endian::native)
+                {
+                    u = byteswap(u);
+                }
+
+                std::memcpy(p, &u, 2);
+
+                return;
+            }
+
+            std::byte hi = static_cast<std::byte>((ch >> 8) & 0xff);
+            std::byte lo = static_cast<std::byte>(ch & 0xff);
+
+            if constexpr (order == std::endian::big)
+            {
+                p[0] = static_cast<byteT>(hi);
+                p[1] = static_cast<byteT>(lo);
+            }
+            else
+            {
+                p[0] = static_cast<byteT>(lo);
+                p[1] = static_cast<byteT>(hi);
+            }
+        }
+
+        static constexpr const byteT *resync(const byteT *b, const byteT *p, const byteT *e)
+        {
+            p = b + ((p - b) & ~std::ptrdiff_t(1));
+
+            if (e - p < 2)
+            {
+                return p;
+            }
+
+            return p != b && is_low_surrogate(load(p)) && is_high_surrogate(load(p - 2)) ? p - 2 : p;
+        }
+
+        static constexpr std::size_t ill_formed_length(const byteT *p, const byteT *e)
+        {
+            return e - p < 2 ? static_cast<std::size_t>(e - p) : 2;
+        }
+
+        static constexpr transcode_status decode(const byteT *&p, const byteT *e, char32_t &ch)
+        {
+            if (e - p < 2)
+            {
+                return transcode_status::incomplete;
+            }
+
+            char16_t w1 = load(p);
+
+            if (!is_surrogate(w1))
+            {
+                ch = static_cast<char32_t>(w1);
+                p += 2;
+
+                return transcode_status::ok;
+            }
+
+            if (!is_high_surrogate(w1))
+            {
+                return transcode_status::invalid;
+            }
+
+            if (e - p < 4)
+            {
+                return transcode_status::incomplete;
+            }
+
+            char16_t w2 = load(p + 2);
+
+            if (!is_low_surrogate(w2))
+            {
+                return transcode_status::invalid;
+            }
+
+            ch = decode_utf16_2(w1, w2);
+            p += 4;
+
+            return transcode_status::ok;
+        }
+
+        static constexpr bool encode(byteT *&p, byteT *e, char32_t ch)
+        {
+            if ((ch & ~U'\xffff') == 0)
+            {
+                if (e - p < 2)
+                {
+                    return false;
+                }
+
+                store(p, static_cast<char16_t>(ch));
+                p += 2;
+
+                return true;
+            }
+
+            if (e - p < 4)
+            {
+                return false;
+            }
+
+            char32_t u = ch - U'\x10000';
+
+            store(p, static_cast<char16_t>(0xd800 | ((u >> 10) & 0x3ff)));
+            store(p + 2, static_cast<char16_t>(0xdc00 | (u & 0x3ff)));
+            p += 4;
+
+            return true;
+        }
+    };
+
+    template <byte_like byteT>
+    using b16be_codec = b16_codec<byteT, std::endian::big>;
+
+    template <byte_like byteT>
+    using b16le_codec = b16_codec<byteT, std::endian::little>;
+    
+}
+
+
+namespace xtual
+{
+
+    struct utf8_branchy
+    {
+    };
+
+    // Namespace-scope tables rather than static members, which GCC 12 does
+    // not emit for importers of the module.
+    inline constexpr std::uint8_t utf8_dfa_classes[256] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+        7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+        8, 8, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        10, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 4, 3, 3, 11, 6, 6, 6, 5, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8
+    };
+
+    inline constexpr std::uint8_t utf8_dfa_transitions[108] = {
+        0, 12, 24, 36, 60, 96, 72, 12, 12, 12, 48, 84,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 0, 12, 12, 12, 12, 12, 0, 12, 0, 12, 12,
+        12, 24, 12, 12, 12, 12, 12, 24, 12, 24, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 24, 12, 12, 12, 12,
+        12, 24, 12, 12, 12, 12, 12, 12, 12, 24, 12, 12,
+        12, 36, 12, 12, 12, 12, 12, 36, 12, 36, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 36, 12, 36, 12, 12,
+        12, 36, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12
+    };
+
+    struct utf8_dfa
+    {
+        static constexpr std::uint8_t accept = 0;
+        static constexpr std::uint8_t reject = 12;
+
+        static constexpr std::uint8_t step(std::uint8_t state, char32_t &ch, char8_t w)
+        {
+            std::uint8_t type = utf8_dfa_classes[w];
+
+            ch = state == accept ? (0xffu >> type) & w : (w & 0x3fu) | (ch << 6);
+
+            return utf8_dfa_transitions[state + type];
+        }
+    };
+
+    template <typename charT, typename Engine = utf8_branchy>
+    struct utf8_codec;
+
+    template <typename charT, std::output_iterator<charT> Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent, char8_t> Writ>
+    constexpr bool utf8_encode(Iter &i, Sent s, char32_t ch, Writ write)
+    {
+        if (!is_code_point(ch))
+        {
+            return false;
+        }
+
+        if ((ch & ~U'\x7f') == 0)
+        {
+            return write(i, s, static_cast<char8_t>(ch));
+        }
+        else if ((ch & ~U'\x7ff') == 0)
+        {
+            char8_t c1 = static_cast<char8_t>(0xc0);
+            char8_t c2 = static_cast<char8_t>(0x80);
+
+            c1 |= static_cast<char8_t>((ch >> 6) & 0x1f);
+            c2 |= static_cast<char8_t>(ch & 0x3f);
+
+            return write(i, s, c1) && write(i, s, c2);
+        }
+        else if ((ch & ~U'\xffff') == 0)
+        {
+            char8_t c1 = static_cast<char8_t>(0xe0);
+            char8_t c2 = static_cast<char8_t>(0x80);
+            char8_t c3 = static_cast<char8_t>(0x80);
+
+            c1 |= static_cast<char8_t>((ch >> 12) & 0x0f);
+            c2 |= static_cast<char8_t>((ch >> 6) & 0x3f);
+            c3 |= static_cast<char8_t>(ch & 0x3f);
+
+            return write(i, s, c1)
+                && write(i, s, c2)
+                && write(i, s, c3);
+        }
+        else
+        {
+            char8_t c1 = static_cast<char8_t>(0xf0);
+            char8_t c2 = static_cast<char8_t>(0x80);
+            char8_t c3 = static_cast<char8_t>(0x80);
+            char8_t c4 = static_cast<char8_t>(0x80);
+
+            c1 |= static_cast<char8_t>((ch >> 18) & 0x07);
+            c2 |= static_cast<char8_t>((ch >> 12) & 0x3f);
+            c3 |= static_cast<char8_t>((ch >> 6) & 0x3f);
+            c4 |= static_cast<char8_t>(ch & 0x3f);
+
+            return write(i, s, c1)
+                && write(i, s, c2)
+                && write(i, s, c3)
+                && write(i, s, c4);
+        }
+    }
+    
+    template <std::output_iterator<char8_t> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool encode_as_u8(Iter &i, Sent s, char32_t ch)
+    {
+        if constexpr (contiguous_units<Iter, Sent, char8_t>)
+        {
+            if (encode_contiguous<utf8_codec<char8_t>>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
+        return utf8_encode<char8_t>(i, s, ch, [](Iter &i, Sent s, char8_t ch) {
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = ch;
+
+            return true;
+        });
+    }
+
+    template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool encode_as_b8(Iter &i, Sent s, char32_t ch)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (encode_contiguous<utf8_codec<byteT>>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
+        return utf8_encode<byteT>(i, s, ch, [](Iter &i, Sent s, char8_t ch) {
+            if (i == s)
+            {
+                return false;
+            }
+
+            *i++ = static_cast<byteT>(static_cast<std::byte>(ch));
+
+            return true;
+        });
+    }
+
+    constexpr bool is_ascii(char8_t ch)
+    {
+        return (ch >> 7) == static_cast<char8_t>(0);
+    }
+
+    constexpr bool is_utf8_2_prefix(char8_t ch)
+    {
+        return (ch >> 5) == static_cast<char8_t>(0x06);
+    }
+
+    constexpr bool is_utf8_3_prefix(char8_t ch)
+    {
+        return (ch >> 4) == static_cast<char8_t>(0x0e);
+    }
+
+    constexpr bool is_utf8_4_prefix(char8_t ch)
+    {
+        return (ch >> 3) == static_cast<char8_t>(0x1e);
+    }
+
+    constexpr bool is_utf8_tail(char8_t ch)
+    {
+        return (ch >> 6) == static_cast<char8_t>(0x02);
+    }
+
+    constexpr char32_t decode_utf8_2(char8_t w1, char8_t w2)
+    {
+        return ((static_cast<char32_t>(w1) & U'\x1f') << 6)
+            | (static_cast<char32_t>(w2) & U'\x3f');
+    }
+
+    constexpr char32_t decode_utf8_3(char8_t w1, char8_t w2, char8_t w3)
+    {
+        return ((static_cast<char32_t>(w1) & U'\x0f') << 12)
+            | ((static_cast<char32_t>(w2) & U'\x3f') << 6)
+            | (static_cast<char32_t>(w3) & U'\x3f');
+    }
+
+    constexpr char32_t decode_utf8_4(char8_t w1, char8_t w2, char8_t w3, char8_t w4)
+    {
+        return ((static_cast<char32_t>(w1) & U'\x07') << 18)
+            | ((static_cast<char32_t>(w2) & U'\x3f') << 12)
+            | ((static_cast<char32_t>(w3) & U'\x3f') << 6)
+            | (static_cast<char32_t>(w4) & U'\x3f');
+    }
+    
+    constexpr bool is_valid_utf8_2_value(char32_t ch)
+    {
+        return (ch & ~U'\x7f') != U'\0' && is_code_point(ch);
+    }
+
+    constexpr bool is_valid_utf8_3_value(char32_t ch)
+    {
+        return (ch & ~U'\x7ff') != U'\0' && is_code_point(ch);
+    }
+
+    constexpr bool is_valid_utf8_4_value(char32_t ch)
+    {
+        return (ch & ~U'\xffff') != U'\0' && is_code_point(ch);
+    }
+    
+    constexpr std::size_t utf8_sequence_length(char8_t w1)
+    {
+        if (is_ascii(w1))
+        {
+            return 1;
+        }
+        else if (is_utf8_2_prefix(w1))
+        {
+            return w1 < static_cast<char8_t>(0xc2) ? 0 : 2;
+        }
+        else if (is_utf8_3_prefix(w1))
+        {
+            return 3;
+        }
+        else if (is_utf8_4_prefix(w1))
+        {
+            return w1 > static_cast<char8_t>(0xf4) ? 0 : 4;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    constexpr bool is_utf8_second(char8_t w1, char8_t w2)
+    {
+        if (w1 == static_cast<char8_t>(0xe0))
+        {
+            return w2 >= static_cast<char8_t>(0xa0) && w2 <= static_cast<char8_t>(0xbf);
+        }
+        else if (w1 == static_cast<char8_t>(0xed))
+        {
+            return w2 >= static_cast<char8_t>(0x80) && w2 <= static_cast<char8_t>(0x9f);
+        }
+        else if (w1 == static_cast<char8_t>(0xf0))
+        {
+            return w2 >= static_cast<char8_t>(0x90) && w2 <= static_cast<char8_t>(0xbf);
+        }
+        else if (w1 == static_cast<char8_t>(0xf4))
+        {
+            return w2 >= static_cast<char8_t>(0x80) && w2 <= static_cast<char8_t>(0x8f);
+        }
+        else
+        {
+            return is_utf8_tail(w2);
+        }
+    }
+
+    constexpr std::size_t utf8_width(char32_t ch)
+    {
+        if ((ch & ~U'\x7f') == 0)
+        {
+            return 1;
+        }
+        else if ((ch & ~U'\x7ff') == 0)
+        {
+            return 2;
+        }
+        else if ((ch & ~U'\xffff') == 0)
+        {
+            return 3;
+        }
+        else
+        {
+            return 4;
+        }
+    }
+    
+    template <std::input_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
+    constexpr transcode_status read_utf8_tail(Iter &i, Sent s, char8_t buf[], std::size_t n, Rdr read)
+    {
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            auto opt = read(i, s);
+
+            if (!opt.has_value())
+            {
+                return transcode_status::incomplete;
+            }
+
+            char8_t ch = opt.value();
+
+            if (!is_utf8_tail(ch))
+            {
+                return transcode_status::invalid;
+            }
+
+            buf[k] = ch;
+        }
+
+        return transcode_status::ok;
+    }
+    
+    template <typename charT, std::input_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
+    requires std::convertible_to<std::iter_value_t<Iter>, charT>
+    constexpr std::optional<char32_t> utf8_decode(Iter &i, Sent s, Rdr read)
+    {
+        auto opt1 = read(i, s);
+
+        if (!opt1.has_value())
+        {
+            return std::nullopt;
+        }
+
+        char8_t w1 = opt1.value();
+
+        if (is_ascii(w1))
+        {
+            return static_cast<char32_t>(w1);
+        }
+        else if (is_utf8_2_prefix(w1))
+        {
+            char8_t ws[1];
+
+            if (transcode_status status = read_utf8_tail(i, s, ws, 1, read); status != transcode_status::ok)
+            {
+                return decode_error(status);
+            }
+
+            char32_t ch = decode_utf8_2(w1, ws[0]);
+
+            if (!is_valid_utf8_2_value(ch))
+            {
+                return decode_error(transcode_status::invalid);
+            }
+
+            return ch;
+        }
+        else if (is_utf8_3_prefix(w1))
+        {
+            char8_t ws[2];
+
+            if (transcode_status status = read_utf8_tail(i, s, ws, 2, read); status != transcode_status::ok)
+            {
+                return decode_error(status);
+            }
+
+            char32_t ch = decode_utf8_3(w1, ws[0], ws[1]);
+
+            if (!is_valid_utf8_3_value(ch))
+            {
+                return decode_error(transcode_status::invalid);
+            }
+
+            return ch;
+        }
+        else if (is_utf8_4_prefix(w1))
+        {
+            char8_t ws[3];
+
+            if (transcode_status status = read_utf8_tail(i, s, ws, 3, read); status != transcode_status::ok)
+            {
+                return decode_error(status);
+            }
+            
+            char32_t ch = decode_utf8_4(w1, ws[0], ws[1], ws[2]);
+
+            if (!is_valid_utf8_4_value(ch))
+            {
+                return decode_error(transcode_status::invalid);
+            }
+
+            return ch;
+        }
+        else
+        {
+            return decode_error(transcode_status::invalid);
+        }
+    }
+
+    template <std::input_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
+    constexpr std::optional<char32_t> utf8_decode_dfa(Iter &i, Sent s, Rdr read)
+    {
+        std::uint8_t state = utf8_dfa::accept;
+        char32_t ch = 0;
+
+        do
+        {
+            auto opt = read(i, s);
+
+            if (!opt.has_value())
+            {
+                return state == utf8_dfa::accept ? std::nullopt : decode_error(transcode_status::incomplete);
+            }
+
+            state = utf8_dfa::step(state, ch, opt.value());
+        }
+        while (state > utf8_dfa::reject);
+
+        if (state == utf8_dfa::reject)
+        {
+            return decode_error(transcode_status::invalid);
+        }
+
+        return ch;
+    }
+
+    // The deduced parameters carry defaults only because GCC 12 drops the
+    // Engine default from a module interface when parameters without one
+    // follow it.
+    template <typename Engine = utf8_branchy, std::input_iterator Iter = const char8_t *, std::sentinel_for<Iter> Sent = Iter>
+    requires std::convertible_to<std::iter_value_t<Iter>, char8_t>
+    constexpr std::optional<char32_t> decode_from_u8(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, char8_t>)
+        {
+            if (auto ch = decode_contiguous<utf8_codec<char8_t, Engine>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        auto read = [](Iter &i, Sent s) -> std::optional<char8_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            return *i++;
+        };
+
+        if constexpr (std::same_as<Engine, utf8_dfa>)
+        {
+            return utf8_decode_dfa(i, s, read);
+        }
+        else
+        {
+            return utf8_decode<char8_t>(i, s, read);
+        }
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy, std::input_iterator Iter = const byteT *, std::sentinel_for<Iter> Sent = Iter>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_from_b8(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<utf8_codec<byteT, Engine>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        auto read = [](Iter &i, Sent s) -> std::optional<char8_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            return static_cast<char8_t>(static_cast<std::byte>(*i++));
+        };
+
+        if constexpr (std::same_as<Engine, utf8_dfa>)
+        {
+            return utf8_decode_dfa(i, s, read);
+        }
+        else
+        {
+            return utf8_decode<byteT>(i, s, read);
+        }
+    }
+    
+    template <typename Engine = utf8_branchy, std::bidirectional_iterator Iter = const char8_t *, std::sentinel_for<Iter> Sent = Iter>
+    requires std::convertible_to<std::iter_value_t<Iter>, char8_t>
+    constexpr std::optional<char32_t> decode_backward_from_u8(Iter &i, Sent s)
+    {
+        return decode_backward(i, s, 1, 4, [](const Iter &j) {
+            return is_utf8_tail(static_cast<char8_t>(*j));
+        }, [](Iter &k, const Iter &e) {
+            return decode_from_u8<Engine>(k, e);
+        });
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy, std::bidirectional_iterator Iter = const byteT *, std::sentinel_for<Iter> Sent = Iter>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_backward_from_b8(Iter &i, Sent s)
+    {
+        return decode_backward(i, s, 1, 4, [](const Iter &j) {
+            return is_utf8_tail(static_cast<char8_t>(static_cast<std::byte>(static_cast<byteT>(*j))));
+        }, [](Iter &k, const Iter &e) {
+            return decode_from_b8<byteT, Engine>(k, e);
+        });
+    }
+
+    template <typename charT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
+    requires std::convertible_to<std::iter_value_t<Iter>, charT>
+    constexpr std::optional<char32_t> utf8_decode_lossy(Iter &i, Sent s, Rdr read)
+    {
+        if (i == s)
+        {
+            return std::nullopt;
+        }
+
+        Iter j = i;
+        auto opt = utf8_decode<charT>(j, s, read);
+
+        if (opt.has_value())
+        {
+            i = j;
+
+            return opt;
+        }
+
+        char8_t w1 = read(i, s).value();
+        std::size_t n = utf8_sequence_length(w1);
+
+        for (std::size_t k = 1; k < n; ++k)
+        {
+            Iter t = i;
+            auto next = read(t, s);
+
+            if (!next.has_value())
+            {
+                break;
+            }
+
+            if (k == 1 ? !is_utf8_second(w1, next.value()) : !is_utf8_tail(next.value()))
+            {
+                break;
+            }
+
+            i = t;
+        }
+
+        return U'\xfffd';
+    }
+
+    template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, char8_t>
+    constexpr std::optional<char32_t> decode_lossy_from_u8(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, char8_t>)
+        {
+            if (auto ch = decode_contiguous<utf8_codec<char8_t>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf8_decode_lossy<char8_t>(i, s, [](Iter &i, Sent s) -> std::optional<char8_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            return *i++;
+        });
+    }
+
+    template <byte_like byteT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_b8(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<utf8_codec<byteT>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf8_decode_lossy<byteT>(i, s, [](Iter &i, Sent s) -> std::optional<char8_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            return static_cast<char8_t>(static_cast<std::byte>(*i++));
+        });
+    }
+
+    template <typename charT, typename Engine>
+    struct utf8_codec
+    {
+        using unit_type = charT;
+
+        static constexpr std::size_t max_length = 4;
+
+        static constexpr char8_t load(const charT *p)
+        {
+            return static_cast<char8_t>(static_cast<std::byte>(*p));
+        }
+
+        static constexpr void store(charT *p, char32_t ch)
+        {
+            *p = static_cast<charT>(static_cast<std::byte>(ch & 0xff));
+        }
+
+        static constexpr const charT *resync(const charT *b, const charT *p, const charT *)
+        {
+            const charT *q = p;
+
+            for (std::size_t k = 0; k < 3 && q != b && is_utf8_tail(load(q)); ++k)
+            {
+                --q;
+            }
+
+            return q + utf8_sequence_length(load(q)) > p ? q : p;
+        }
+
+        static constexpr std::size_t prefix_length(const charT *p, const charT *e)
+        {
+            char8_t w1 = load(p);
+            std::size_t n = utf8_sequence_length(w1);
+
+            if (n == 0)
+            {
+                return 0;
+            }
+
+            std::size_t k = 1;
+
+            if (k < n && p + k != e && is_utf8_second(w1, load(p + k)))
+            {
+                ++k;
+
+                while (k < n && p + k != e && is_utf8_tail(load(p + k)))
+                {
+                    ++k;
+                }
+            }
+
+            return k;
+        }
+
+        static constexpr std::size_t ill_formed_length(const charT *p, const charT *e)
+        {
+            std::size_t m = prefix_length(p, e);
+
+            return m == 0 ? 1 : m;
+        }
+
+        static constexpr transcode_status decode(const charT *&p, const charT *e, char32_t &ch)
+        {
+            if constexpr (std::same_as<Engine, utf8_dfa>)
+            {
+                const charT *q = p;
+                char32_t u = 0;
+                std::uint8_t state = utf8_dfa::step(utf8_dfa::accept, u, load(q++));
+
+                if (e - p >= 4)
+                {
+                    while (state > utf8_dfa::reject)
+                    {
+                        state = utf8_dfa::step(state, u, load(q++));
+                    }
+                }
+                else
+                {
+                    while (state > utf8_dfa::reject)
+                    {
+                        if (q == e)
+                        {
+                            return transcode_status::incomplete;
+                        }
+
+                        state = utf8_dfa::step(state, u, load(q++));
+                    }
+                }
+
+                if (state == utf8_dfa::reject)
+                {
+                    return transcode_status::invalid;
+                }
+
+                ch = u;
+                p = q;
+
+                return transcode_status::ok;
+            }
+
+            char8_t w1 = load(p);
+
+            if (is_ascii(w1))
+            {
+                ch = static_cast<char32_t>(w1);
+                p += 1;
+
+                return transcode_status::ok;
+            }
+
+            std::size_t n = utf8_sequence_length(w1);
+
+            if (n == 0)
+            {
+                return transcode_status::invalid;
+            }
+
+            std::size_t m = prefix_length(p, e);
+
+            if (m < n)
+            {
+                return p + m == e ? transcode_status::incomplete : transcode_status::invalid;
+            }
+
+            if (n == 2)
+            {
+                ch = decode_utf8_2(w1, load(p + 1));
+            }
+            else if (n == 3)
+            {
+                ch = decode_utf8_3(w1, load(p + 1), load(p + 2));
+            }
+            else
+            {
+                ch = decode_utf8_4(w1, load(p + 1), load(p + 2), load(p + 3));
+            }
+
+            p += n;
+
+            return transcode_status::ok;
+        }
+
+        static constexpr bool encode(charT *&p, charT *e, char32_t ch)
+        {
+            std::size_t n = utf8_width(ch);
+
+            if (static_cast<std::size_t>(e - p) < n)
+            {
+                return false;
+            }
+
+            if (n == 1)
+            {
+                store(p, ch);
+            }
+            else if (n == 2)
+            {
+                store(p, 0xc0 | (ch >> 6));
+                store(p + 1, 0x80 | (ch & 0x3f));
+            }
+            else if (n == 3)
+            {
+                store(p, 0xe0 | (ch >> 12));
+                store(p + 1, 0x80 | ((ch >> 6) & 0x3f));
+                store(p + 2, 0x80 | (ch & 0x3f));
+            }
+            else
+            {
+                store(p, 0xf0 | (ch >> 18));
+                store(p + 1, 0x80 | ((ch >> 12) & 0x3f));
+                store(p + 2, 0x80 | ((ch >> 6) & 0x3f));
+                store(p + 3, 0x80 | (ch & 0x3f));
+            }
+
+            p += n;
+
+            return true;
+        }
+    };
+
+    using u8_codec = utf8_codec<char8_t>;
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    using b8_codec = utf8_codec<byteT, Engine>;
+    
+}
+
+namespace xtual
+{
+
+#if defined(XTUAL_X86_SIMD)
+
+    XTUAL_TARGET("sse2") inline __m128i byteswap_epi16_sse2(__m128i x)
+    {
+        return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+    }
+
+    XTUAL_TARGET("sse2") inline __m128i byteswap_epi32_sse2(__m128i x)
+    {
+        return _mm_shufflehi_epi16(_mm_shufflelo_epi16(byteswap_epi16_sse2(x), 0xb1), 0xb1);
+    }
+
+    XTUAL_TARGET("ssse3") inline __m128i byteswap_epi16_ssse3(__m128i x)
+    {
+        return _mm_shuffle_epi8(x, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+    }
+
+    XTUAL_TARGET("ssse3") inline __m128i byteswap_epi32_ssse3(__m128i x)
+    {
+        return _mm_shuffle_epi8(x, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+    }
+
+    XTUAL_TARGET("avx2") inline __m256i byteswap_epi16_avx2(__m256i x)
+    {
+        return _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+            1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+            1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+    }
+
+    XTUAL_TARGET("avx2") inline __m256i byteswap_epi32_avx2(__m256i x)
+    {
+        return _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+    }
+
+    XTUAL_TARGET("sse2") inline bool is_valid_utf16_block(__m128i x)
+    {
+        __m128i masked = _mm_and_si128(x, _mm_set1_epi16(static_cast<short>(0xf800)));
+        __m128i surrogates = _mm_cmpeq_epi16(masked, _mm_set1_epi16(static_cast<short>(0xd800)));
+
+        return _mm_movemask_epi8(surrogates) == 0;
+    }
+
+    XTUAL_TARGET("sse2") inline bool is_valid_utf32_block(__m128i x)
+    {
+        const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000));
+
+        __m128i masked = _mm_and_si128(x, _mm_set1_epi32(static_cast<int>(0xfffff800)));
+        __m128i surrogates = _mm_cmpeq_epi32(masked, _mm_set1_epi32(0xd800));
+        __m128i above = _mm_cmpgt_epi32(_mm_xor_si128(x, bias), _mm_xor_si128(_mm_set1_epi32(0x10ffff), bias));
+
+        return _mm_movemask_epi8(_mm_or_si128(surrogates, above)) == 0;
+    }
+
+    XTUAL_TARGET("avx2") inline bool is_valid_utf16_block(__m256i x)
+    {
+        __m256i masked = _mm256_and_si256(x, _mm256_set1_epi16(static_cast<short>(0xf800)));
+        __m256i surrogates = _mm256_cmpeq_epi16(masked, _mm256_set1_epi16(static_cast<short>(0xd800)));
+
+        return _mm256_testz_si256(surrogates, surrogates);
+    }
+
+    XTUAL_TARGET("avx2") inline bool is_valid_utf32_block(__m256i x)
+    {
+        __m256i masked = _mm256_and_si256(x, _mm256_set1_epi32(static_cast<int>(0xfffff800)));
+        __m256i surrogates = _mm256_cmpeq_epi32(masked, _mm256_set1_epi32(0xd800));
+        __m256i above = _mm256_cmpeq_epi32(_mm256_max_epu32(x, _mm256_set1_epi32(0x110000)), x);
+        __m256i errors = _mm256_or_si256(surrogates, above);
+
+        return _mm256_testz_si256(errors, errors);
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("sse2") inline __m128i byteswap_sse2(__m128i x)
+    {
+        return width == 2 ? byteswap_epi16_sse2(x) : byteswap_epi32_sse2(x);
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("ssse3") inline __m128i byteswap_ssse3(__m128i x)
+    {
+        return width == 2 ? byteswap_epi16_ssse3(x) : byteswap_epi32_ssse3(x);
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("avx2") inline __m256i byteswap_avx2(__m256i x)
+    {
+        return width == 2 ? byteswap_epi16_avx2(x) : byteswap_epi32_avx2(x);
+    }
+
+    constexpr std::size_t utf16_pass_lanes(std::uint32_t high, std::uint32_t low, std::size_t lanes)
+    {
+        std::uint32_t last = std::uint32_t(3) << (2 * lanes - 2);
+        std::size_t n = (high & last) != 0 ? lanes - 1 : lanes;
+
+        high &= ~last;
+
+        return low == high << 2 ? n : 0;
+    }
+
+    XTUAL_TARGET("sse2") inline std::size_t utf16_pass_lanes(__m128i x)
+    {
+        __m128i masked = _mm_and_si128(x, _mm_set1_epi16(static_cast<short>(0xfc00)));
+        auto high = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(masked, _mm_set1_epi16(static_cast<short>(0xd800)))));
+        auto low = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(masked, _mm_set1_epi16(static_cast<short>(0xdc00)))));
+
+        return utf16_pass_lanes(high, low, 8);
+    }
+
+    XTUAL_TARGET("avx2") inline std::size_t utf16_pass_lanes(__m256i x)
+    {
+        __m256i masked = _mm256_and_si256(x, _mm256_set1_epi16(static_cast<short>(0xfc00)));
+        auto high = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(masked, _mm256_set1_epi16(static_cast<short>(0xd800)))));
+        auto low = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(masked, _mm256_set1_epi16(static_cast<short>(0xdc00)))));
+
+        return utf16_pass_lanes(high, low, 16);
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("sse2") inline std::size_t pass_lanes(__m128i x)
+    {
+        if constexpr (width == 2)
+        {
+            return utf16_pass_lanes(x);
+        }
+        else
+        {
+            return is_valid_utf32_block(x) ? 4 : 0;
+        }
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("avx2") inline std::size_t pass_lanes(__m256i x)
+    {
+        if constexpr (width == 2)
+        {
+            return utf16_pass_lanes(x);
+        }
+        else
+        {
+            return is_valid_utf32_block(x) ? 8 : 0;
+        }
+    }
+
+    template <std::size_t width, std::endian from, std::endian to, typename inT, typename outT>
+    XTUAL_TARGET("sse2") void byteorder_kernel_sse2(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+        constexpr std::ptrdiff_t in_step = 16 / sizeof(inT);
+        constexpr std::ptrdiff_t out_step = 16 / sizeof(outT);
+
+        while (ie - i >= in_step && oe - o >= out_step)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i));
+
+            std::size_t lanes = pass_lanes<width>(from != std::endian::native ? byteswap_sse2<width>(x) : x);
+
+            if (lanes == 0)
+            {
+                break;
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(o), from != to ? byteswap_sse2<width>(x) : x);
+            i += lanes * width / sizeof(inT);
+            o += lanes * width / sizeof(outT);
+        }
+    }
+
+    template <std::size_t width, std::endian from, std::endian to, typename inT, typename outT>
+    XTUAL_TARGET("ssse3") void byteorder_kernel_ssse3(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+        constexpr std::ptrdiff_t in_step = 16 / sizeof(inT);
+        constexpr std::ptrdiff_t out_step = 16 / sizeof(outT);
+
+        while (ie - i >= in_step && oe - o >= out_step)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i));
+
+            std::size_t lanes = pass_lanes<width>(from != std::endian::native ? byteswap_ssse3<width>(x) : x);
+
+            if (lanes == 0)
+            {
+                break;
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(o), from != to ? byteswap_ssse3<width>(x) : x);
+            i += lanes * width / sizeof(inT);
+            o += lanes * width / sizeof(outT);
+        }
+    }
+
+    template <std::size_t width, std::endian from, std::endian to, typename inT, typename outT>
+    XTUAL_TARGET("avx2") void byteorder_kernel_avx2(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+        constexpr std::ptrdiff_t in_step = 32 / sizeof(inT);
+        constexpr std::ptrdiff_t out_step = 32 / sizeof(outT);
+
+        while (ie - i >= in_step && oe - o >= out_step)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(i));
+
+            std::size_t lanes = pass_lanes<width>(from != std::endian::native ? byteswap_avx2<width>(x) : x);
+
+            if (lanes == 0)
+            {
+                break;
+            }
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(o), from != to ? byteswap_avx2<width>(x) : x);
+            i += lanes * width / sizeof(inT);
+            o += lanes * width / sizeof(outT);
+        }
+
+        byteorder_kernel_ssse3<width, from, to>(i, ie, o, oe);
+    }
+
+#endif
+
+    template <std::size_t width, std::endian from, std::endian to, typename inT, typename outT>
+    void byteorder_kernel(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+#if defined(XTUAL_X86_SIMD)
+        switch (active_simd_level())
+        {
+        case simd_level::avx2:
+            byteorder_kernel_avx2<width, from, to>(i, ie, o, oe);
+            break;
+        case simd_level::ssse3:
+            byteorder_kernel_ssse3<width, from, to>(i, ie, o, oe);
+            break;
+        case simd_level::sse2:
+            byteorder_kernel_sse2<width, from, to>(i, ie, o, oe);
+            break;
+        default:
+            break;
+        }
+#endif
+    }
+
+    template <byte_like byteT, std::endian order>
+    struct transcode_kernel<b16_codec<byteT, order>, u16_codec>
+    {
+        static void run(const byteT *&i, const byteT *ie, char16_t *&o, char16_t *oe)
+        {
+            byteorder_kernel<2, order, std::endian::native>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct transcode_kernel<u16_codec, b16_codec<byteT, order>>
+    {
+        static void run(const char16_t *&i, const char16_t *ie, byteT *&o, byteT *oe)
+        {
+            byteorder_kernel<2, std::endian::native, order>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct transcode_kernel<b32_codec<byteT, order>, u32_codec>
+    {
+        static void run(const byteT *&i, const byteT *ie, char32_t *&o, char32_t *oe)
+        {
+            byteorder_kernel<4, order, std::endian::native>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct transcode_kernel<u32_codec, b32_codec<byteT, order>>
+    {
+        static void run(const char32_t *&i, const char32_t *ie, byteT *&o, byteT *oe)
+        {
+            byteorder_kernel<4, std::endian::native, order>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like inT, std::endian from, byte_like outT, std::endian to>
+    struct transcode_kernel<b16_codec<inT, from>, b16_codec<outT, to>>
+    {
+        static void run(const inT *&i, const inT *ie, outT *&o, outT *oe)
+        {
+            byteorder_kernel<2, from, to>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like inT, std::endian from, byte_like outT, std::endian to>
+    struct transcode_kernel<b32_codec<inT, from>, b32_codec<outT, to>>
+    {
+        static void run(const inT *&i, const inT *ie, outT *&o, outT *oe)
+        {
+            byteorder_kernel<4, from, to>(i, ie, o, oe);
+        }
+    };
+
+}
+
+namespace xtual
+{
+
+    template <byte_like byteT, char32_t max>
+    struct single_byte_codec
+    {
+        using unit_type = byteT;
+
+        static constexpr std::size_t max_length = 1;
+
+        static constexpr char32_t replacement = U'?';
+
+        static constexpr bool can_encode(char32_t ch)
+        {
+            return ch <= max;
+        }
+
+        static constexpr const byteT *resync(const byteT *, const byteT *p, const byteT *)
+        {
+            return p;
+        }
+
+        static constexpr std::size_t ill_formed_length(const byteT *, const byteT *)
+        {
+            return 1;
+        }
+
+        static constexpr transcode_status decode(const byteT *&p, const byteT *, char32_t &ch)
+        {
+            char32_t u = static_cast<char32_t>(static_cast<std::byte>(*p));
+
+            if (u > max)
+            {
+                return transcode_status::invalid;
+            }
+
+            ch = u;
+            ++p;
+
+            return transcode_status::ok;
+        }
+
+        static constexpr bool encode(byteT *&p, byteT *e, char32_t ch)
+        {
+            if (p == e || ch > max)
+            {
+                return false;
+            }
+
+            *p++ = static_cast<byteT>(static_cast<std::byte>(ch));
+
+            return true;
+        }
+    };
+
+    template <byte_like byteT>
+    using latin1_codec = single_byte_codec<byteT, U'\xff'>;
+
+    template <byte_like byteT>
+    using ascii_codec = single_byte_codec<byteT, U'\x7f'>;
+
+    template <byte_like byteT, char32_t max, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool single_byte_encode(Iter &i, Sent s, char32_t ch)
+    {
+        if (i == s || ch > max)
+        {
+            return false;
+        }
+
+        *i++ = static_cast<byteT>(static_cast<std::byte>(ch));
+
+        return true;
+    }
+
+    template <byte_like byteT, char32_t max, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    constexpr std::optional<char32_t> single_byte_decode(Iter &i, Sent s)
+    {
+        if (i == s)
+        {
+            return std::nullopt;
+        }
+
+        char32_t ch = static_cast<char32_t>(static_cast<std::byte>(static_cast<byteT>(*i)));
+
+        if (ch > max)
+        {
+            return decode_error(transcode_status::invalid);
+        }
+
+        ++i;
+
+        return ch;
+    }
+
+    template <byte_like byteT, char32_t max, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    constexpr std::optional<char32_t> single_byte_decode_lossy(Iter &i, Sent s)
+    {
+        if (i == s)
+        {
+            return std::nullopt;
+        }
+
+        char32_t ch = static_cast<char32_t>(static_cast<std::byte>(static_cast<byteT>(*i++)));
+
+        if (ch > max)
+        {
+            decode_error(transcode_status::invalid);
+
+            return U'\xfffd';
+        }
+
+        return ch;
+    }
+
+    template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool encode_as_latin1(Iter &i, Sent s, char32_t ch)
+    {
+        return single_byte_encode<byteT, U'\xff'>(i, s, ch);
+    }
+
+    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_from_latin1(Iter &i, Sent s)
+    {
+        return single_byte_decode<byteT, U'\xff'>(i, s);
+    }
+
+    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_latin1(Iter &i, Sent s)
+    {
+        return single_byte_decode_lossy<byteT, U'\xff'>(i, s);
+    }
+
+    template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool encode_as_ascii(Iter &i, Sent s, char32_t ch)
+    {
+        return single_byte_encode<byteT, U'\x7f'>(i, s, ch);
+    }
+
+    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_from_ascii(Iter &i, Sent s)
+    {
+        return single_byte_decode<byteT, U'\x7f'>(i, s);
+    }
+
+    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_ascii(Iter &i, Sent s)
+    {
+        return single_byte_decode_lossy<byteT, U'\x7f'>(i, s);
+    }
+
+    template <typename unitT>
+    constexpr char32_t unit_value(const unitT *p)
+    {
+        if constexpr (sizeof(unitT) == 1)
+        {
+            return static_cast<char32_t>(static_cast<std::byte>(*p));
+        }
+        else
+        {
+            return static_cast<char32_t>(*p);
+        }
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <typename unitT>
+    XTUAL_TARGET("sse2") inline bool is_below_sse2(__m128i x, char32_t limit)
+    {
+        __m128i high;
+
+        if constexpr (sizeof(unitT) == 1)
+        {
+            high = _mm_set1_epi8(static_cast<char>(~limit & 0xff));
+        }
+        else if constexpr (sizeof(unitT) == 2)
+        {
+            high = _mm_set1_epi16(static_cast<short>(~limit & 0xffff));
+        }
+        else
+        {
+            high = _mm_set1_epi32(static_cast<int>(~limit));
+        }
+
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(x, high), _mm_setzero_si128())) == 0xffff;
+    }
+
+    template <typename unitT>
+    XTUAL_TARGET("sse2") const unitT *ascii_prefix_sse2(const unitT *p, const unitT *e)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(unitT);
+
+        for (; e - p >= step; p += step)
+        {
+            if (!is_below_sse2<unitT>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), U'\x7f'))
+            {
+                break;
+            }
+        }
+
+        return p;
+    }
+
+    template <typename unitT>
+    XTUAL_TARGET("avx2") const unitT *ascii_prefix_avx2(const unitT *p, const unitT *e)
+    {
+        constexpr std::ptrdiff_t step = 32 / sizeof(unitT);
+
+        __m256i high;
+
+        if constexpr (sizeof(unitT) == 1)
+        {
+            high = _mm256_set1_epi8(static_cast<char>(0x80));
+        }
+        else if constexpr (sizeof(unitT) == 2)
+        {
+            high = _mm256_set1_epi16(static_cast<short>(0xff80));
+        }
+        else
+        {
+            high = _mm256_set1_epi32(static_cast<int>(0xffffff80));
+        }
+
+        for (; e - p >= 2 * step; p += 2 * step)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + step));
+
+            if (!_mm256_testz_si256(_mm256_or_si256(x, y), high))
+            {
+                break;
+            }
+        }
+
+        for (; e - p >= step; p += step)
+        {
+            if (!_mm256_testz_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), high))
+            {
+                break;
+            }
+        }
+
+        return ascii_prefix_sse2(p, e);
+    }
+
+    template <char32_t limit, typename inT, typename outT>
+    XTUAL_TARGET("sse2") void single_byte_kernel_sse2(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+        constexpr std::size_t in_size = sizeof(inT);
+        constexpr std::size_t out_size = sizeof(outT);
+        constexpr bool check = in_size != 1 || limit < U'\xff';
+
+        const __m128i zero = _mm_setzero_si128();
+
+        while (ie - i >= 16 && oe - o >= 16)
+        {
+            __m128i v[in_size];
+            __m128i any = zero;
+
+            for (std::size_t k = 0; k < in_size; ++k)
+            {
+                v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i) + k);
+                any = _mm_or_si128(any, v[k]);
+            }
+
+            if (check && !is_below_sse2<inT>(any, limit))
+            {
+                break;
+            }
+
+            __m128i bytes;
+
+            if constexpr (in_size == 1)
+            {
+                bytes = v[0];
+            }
+            else if constexpr (in_size == 2)
+            {
+                bytes = _mm_packus_epi16(v[0], v[1]);
+            }
+            else
+            {
+                bytes = _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3]));
+            }
+
+            auto *q = reinterpret_cast<__m128i *>(o);
+
+            if constexpr (out_size == 1)
+            {
+                _mm_storeu_si128(q, bytes);
+            }
+            else if constexpr (out_size == 2)
+            {
+                _mm_storeu_si128(q, _mm_unpacklo_epi8(bytes, zero));
+                _mm_storeu_si128(q + 1, _mm_unpackhi_epi8(bytes, zero));
+            }
+            else
+            {
+                __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+                __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+
+                _mm_storeu_si128(q, _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128(q + 1, _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128(q + 2, _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128(q + 3, _mm_unpackhi_epi16(hi, zero));
+            }
+
+            i += 16;
+            o += 16;
+        }
+    }
+
+    template <char32_t limit, typename inT, typename outT>
+    XTUAL_TARGET("avx2") void single_byte_kernel_avx2(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+        if constexpr (sizeof(inT) == 1 && sizeof(outT) == 1)
+        {
+            const __m256i high = _mm256_set1_epi8(static_cast<char>(~limit & 0xff));
+
+            while (ie - i >= 32 && oe - o >= 32)
+            {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(i));
+
+                if (limit < U'\xff' && !_mm256_testz_si256(x, high))
+                {
+                    break;
+                }
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(o), x);
+                i += 32;
+                o += 32;
+            }
+        }
+
+        single_byte_kernel_sse2<limit>(i, ie, o, oe);
+    }
+
+    constexpr std::array<std::array<std::int8_t, 16>, 256> make_latin1_expand_table()
+    {
+        std::array<std::array<std::int8_t, 16>, 256> table {};
+
+        for (std::size_t mask = 0; mask < 256; ++mask)
+        {
+            std::size_t n = 0;
+
+            for (std::size_t k = 0; k < 8; ++k)
+            {
+                table[mask][n++] = static_cast<std::int8_t>(2 * k);
+
+                if ((mask >> k & 1) != 0)
+                {
+                    table[mask][n++] = static_cast<std::int8_t>(2 * k + 1);
+                }
+            }
+
+            for (; n < 16; ++n)
+            {
+                table[mask][n] = -1;
+            }
+        }
+
+        return table;
+    }
+
+    inline constexpr auto latin1_expand_table = make_latin1_expand_table();
+
+    template <typename outT>
+    XTUAL_TARGET("ssse3") inline void latin1_expand_ssse3(__m128i x, unsigned mask, outT *&o)
+    {
+        __m128i wide = _mm_unpacklo_epi8(x, _mm_setzero_si128());
+        __m128i lead = _mm_or_si128(_mm_srli_epi16(wide, 6), _mm_set1_epi16(0xc0));
+        __m128i tail = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(wide, _mm_set1_epi16(0x3f)), 8), _mm_set1_epi16(static_cast<short>(0x8000)));
+        __m128i ascii = _mm_cmplt_epi16(wide, _mm_set1_epi16(0x80));
+        __m128i words = _mm_or_si128(_mm_and_si128(ascii, wide), _mm_andnot_si128(ascii, _mm_or_si128(lead, tail)));
+        __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(latin1_expand_table[mask].data()));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm_shuffle_epi8(words, shuffle));
+        o += 8 + std::popcount(mask);
+    }
+
+    template <typename inT, typename outT>
+    XTUAL_TARGET("ssse3") void latin1_to_utf8_kernel_ssse3(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+        while (ie - i >= 16 && oe - o >= 32)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i));
+            auto mask = static_cast<unsigned>(_mm_movemask_epi8(x));
+
+            if (mask == 0)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(o), x);
+                o += 16;
+            }
+            else
+            {
+                latin1_expand_ssse3(x, mask & 0xff, o);
+                latin1_expand_ssse3(_mm_srli_si128(x, 8), mask >> 8, o);
+            }
+
+            i += 16;
+        }
+    }
+
+#endif
+
+    template <typename inT, typename outT>
+    void latin1_to_utf8_kernel(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+#if defined(XTUAL_X86_SIMD)
+        switch (active_simd_level())
+        {
+        case simd_level::avx2:
+            single_byte_kernel_avx2<U'\x7f'>(i, ie, o, oe);
+            latin1_to_utf8_kernel_ssse3(i, ie, o, oe);
+            break;
+        case simd_level::ssse3:
+            latin1_to_utf8_kernel_ssse3(i, ie, o, oe);
+            break;
+        case simd_level::sse2:
+            single_byte_kernel_sse2<U'\x7f'>(i, ie, o, oe);
+            break;
+        default:
+            break;
+        }
+#endif
+    }
+
+    template <typename unitT>
+    constexpr const unitT *ascii_prefix(const unitT *p, const unitT *e)
+    {
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                p = ascii_prefix_avx2(p, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                p = ascii_prefix_sse2(p, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        for (; p != e && unit_value(p) <= U'\x7f'; ++p)
+        {
+        }
+
+        return p;
+    }
+
+    constexpr bool is_ascii(std::span<const char8_t> in)
+    {
+        return ascii_prefix(in.data(), in.data() + in.size()) == in.data() + in.size();
+    }
+
+    constexpr bool is_ascii(std::span<const char16_t> in)
+    {
+        return ascii_prefix(in.data(), in.data() + in.size()) == in.data() + in.size();
+    }
+
+    constexpr bool is_ascii(std::span<const char32_t> in)
+    {
+        return ascii_prefix(in.data(), in.data() + in.size()) == in.data() + in.size();
+    }
+
+    template <byte_like byteT>
+    constexpr bool is_ascii(std::span<const byteT> in)
+    {
+        return ascii_prefix(in.data(), in.data() + in.size()) == in.data() + in.size();
+    }
+
+    template <char32_t limit, typename inT, typename outT>
+    void single_byte_kernel(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+#if defined(XTUAL_X86_SIMD)
+        switch (active_simd_level())
+        {
+        case simd_level::avx2:
+            single_byte_kernel_avx2<limit>(i, ie, o, oe);
+            break;
+        case simd_level::ssse3:
+        case simd_level::sse2:
+            single_byte_kernel_sse2<limit>(i, ie, o, oe);
+            break;
+        default:
+            break;
+        }
+#endif
+    }
+
+    template <byte_like byteT, char32_t max, typename charT, typename Engine>
+    struct transcode_kernel<single_byte_codec<byteT, max>, utf8_codec<charT, Engine>>
+    {
+        static void run(const byteT *&i, const byteT *ie, charT *&o, charT *oe)
+        {
+            if constexpr (max == U'\xff')
+            {
+                latin1_to_utf8_kernel(i, ie, o, oe);
+            }
+            else
+            {
+                single_byte_kernel<U'\x7f'>(i, ie, o, oe);
+            }
+        }
+    };
+
+    template <typename charT, typename Engine, byte_like byteT, char32_t max>
+    struct transcode_kernel<utf8_codec<charT, Engine>, single_byte_codec<byteT, max>>
+    {
+        static void run(const charT *&i, const charT *ie, byteT *&o, byteT *oe)
+        {
+            single_byte_kernel<U'\x7f'>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like inT, char32_t in_max, byte_like outT, char32_t out_max>
+    struct transcode_kernel<single_byte_codec<inT, in_max>, single_byte_codec<outT, out_max>>
+    {
+        static void run(const inT *&i, const inT *ie, outT *&o, outT *oe)
+        {
+            single_byte_kernel<std::min(in_max, out_max)>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, char32_t max>
+    struct transcode_kernel<single_byte_codec<byteT, max>, u16_codec>
+    {
+        static void run(const byteT *&i, const byteT *ie, char16_t *&o, char16_t *oe)
+        {
+            single_byte_kernel<max>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, char32_t max>
+    struct transcode_kernel<u16_codec, single_byte_codec<byteT, max>>
+    {
+        static void run(const char16_t *&i, const char16_t *ie, byteT *&o, byteT *oe)
+        {
+            single_byte_kernel<max>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, char32_t max>
+    struct transcode_kernel<single_byte_codec<byteT, max>, u32_codec>
+    {
+        static void run(const byteT *&i, const byteT *ie, char32_t *&o, char32_t *oe)
+        {
+            single_byte_kernel<max>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, char32_t max>
+    struct transcode_kernel<u32_codec, single_byte_codec<byteT, max>>
+    {
+        static void run(const char32_t *&i, const char32_t *ie, byteT *&o, byteT *oe)
+        {
+            single_byte_kernel<max>(i, ie, o, oe);
+        }
+    };
+
+}
+
+namespace xtual
+{
+
+#if defined(XTUAL_X86_SIMD)
+
+    struct utf8_compress_entry
+    {
+        std::array<std::uint8_t, 16> shuffle;
+        std::uint8_t length;
+    };
+
+    constexpr std::array<utf8_compress_entry, 256> make_utf8_pair_table()
+    {
+        std::array<utf8_compress_entry, 256> table {};
+
+        for (std::size_t key = 0; key < 256; ++key)
+        {
+            utf8_compress_entry &entry = table[key];
+            std::uint8_t n = 0;
+
+            for (std::uint8_t k = 0; k < 8; ++k)
+            {
+                entry.shuffle[n++] = static_cast<std::uint8_t>(2 * k);
+
+                if ((key >> k & 1) == 0)
+                {
+                    entry.shuffle[n++] = static_cast<std::uint8_t>(2 * k + 1);
+                }
+            }
+
+            entry.length = n;
+
+            while (n < 16)
+            {
+                entry.shuffle[n++] = 0x80;
+            }
+        }
+
+        return table;
+    }
+
+    constexpr std::array<utf8_compress_entry, 256> make_utf8_triple_table()
+    {
+        std::array<utf8_compress_entry, 256> table {};
+
+        for (std::size_t key = 0; key < 256; ++key)
+        {
+            utf8_compress_entry &entry = table[key];
+            std::uint8_t n = 0;
+
+            for (std::uint8_t k = 0; k < 4; ++k)
+            {
+                std::size_t length = 1 + (key >> k & 1) + (key >> (k + 4) & 1);
+
+                for (std::uint8_t j = 0; j < length; ++j)
+                {
+                    entry.shuffle[n++] = static_cast<std::uint8_t>(4 * k + j);
+                }
+            }
+
+            entry.length = n;
+
+            while (n < 16)
+            {
+                entry.shuffle[n++] = 0x80;
+            }
+        }
+
+        return table;
+    }
+
+    inline constexpr std::array<utf8_compress_entry, 256> utf8_pair_table = make_utf8_pair_table();
+
+    inline constexpr std::array<utf8_compress_entry, 256> utf8_triple_table = make_utf8_triple_table();
+
+    struct utf8_expand_shape
+    {
+        std::array<std::uint8_t, 16> shuffle;
+        std::array<std::uint8_t, 16> mask;
+        std::array<std::uint8_t, 16> expect;
+        std::array<std::uint8_t, 16> minimum;
+    };
+
+    struct utf8_expand_entry
+    {
+        std::uint8_t consumed;
+        std::uint8_t units;
+        std::uint16_t shape;
+    };
+
+    inline constexpr std::size_t utf8_pair_shapes = 64;
+
+    constexpr void set_utf8_lane(std::array<std::uint8_t, 16> &lanes, std::size_t offset, std::size_t width, std::uint32_t value)
+    {
+        for (std::size_t k = 0; k < width; ++k)
+        {
+            lanes[offset + k] = static_cast<std::uint8_t>(value >> (8 * k));
+        }
+    }
+
+    constexpr utf8_expand_shape make_utf8_expand_shape(const std::size_t lengths[], std::size_t count, std::size_t width)
+    {
+        constexpr std::uint32_t masks[] = { 0, 0xffffff80, 0xffffe0c0, 0xfff0c0c0 };
+        constexpr std::uint32_t expects[] = { 0, 0, 0xc080, 0xe08080 };
+        constexpr std::uint32_t minimums[] = { 0, 0, 0x80, 0x800 };
+
+        utf8_expand_shape shape {};
+        std::size_t position = 0;
+
+        shape.shuffle.fill(0x80);
+
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            std::size_t length = lengths[k];
+
+            for (std::size_t j = 0; j < length; ++j)
+            {
+                shape.shuffle[width * k + j] = static_cast<std::uint8_t>(position + length - 1 - j);
+            }
+
+            set_utf8_lane(shape.mask, width * k, width, masks[length]);
+            set_utf8_lane(shape.expect, width * k, width, expects[length]);
+            set_utf8_lane(shape.minimum, width * k, width, minimums[length]);
+            position += length;
+        }
+
+        return shape;
+    }
+
+    constexpr std::array<utf8_expand_shape, utf8_pair_shapes + 256> make_utf8_expand_shapes()
+    {
+        std::array<utf8_expand_shape, utf8_pair_shapes + 256> shapes {};
+
+        for (std::size_t key = 0; key < utf8_pair_shapes; ++key)
+        {
+            std::size_t lengths[6] {};
+
+            for (std::size_t k = 0; k < 6; ++k)
+            {
+                lengths[k] = 1 + (key >> k & 1);
+            }
+
+            shapes[key] = make_utf8_expand_shape(lengths, 6, 2);
+        }
+
+        for (std::size_t key = 0; key < 256; ++key)
+        {
+            std::size_t lengths[4] {};
+            std::size_t count = 0;
+
+            for (; count < 4 && (key >> (2 * count) & 3) != 0; ++count)
+            {
+                lengths[count] = key >> (2 * count) & 3;
+            }
+
+            shapes[utf8_pair_shapes + key] = make_utf8_expand_shape(lengths, count, 4);
+        }
+
+        return shapes;
+    }
+
+    constexpr std::array<utf8_expand_entry, 4096> make_utf8_expand_table()
+    {
+        std::array<utf8_expand_entry, 4096> table {};
+
+        for (std::size_t ends = 0; ends < 4096; ++ends)
+        {
+            std::size_t lengths[12] {};
+            std::size_t count = 0;
+            std::size_t position = 0;
+
+            for (std::size_t k = 0; k < 12; ++k)
+            {
+                if ((ends >> k & 1) != 0)
+                {
+                    lengths[count++] = k + 1 - position;
+                    position = k + 1;
+                }
+            }
+
+            std::size_t pairs = 0;
+            std::size_t triples = 0;
+
+            for (; pairs < std::min<std::size_t>(count, 6) && lengths[pairs] <= 2; ++pairs)
+            {
+            }
+
+            for (; triples < std::min<std::size_t>(count, 4) && lengths[triples] <= 3; ++triples)
+            {
+            }
+
+            utf8_expand_entry &entry = table[ends];
+            std::size_t key = 0;
+
+            if (pairs == 6)
+            {
+                for (std::size_t k = 0; k < 6; ++k)
+                {
+                    key |= (lengths[k] - 1) << k;
+                }
+
+                entry.units = 6;
+                entry.shape = static_cast<std::uint16_t>(key);
+            }
+            else
+            {
+                for (std::size_t k = 0; k < triples; ++k)
+                {
+                    key |= lengths[k] << (2 * k);
+                }
+
+                entry.units = static_cast<std::uint8_t>(triples);
+                entry.shape = static_cast<std::uint16_t>(utf8_pair_shapes + key);
+            }
+
+            for (std::size_t k = 0; k < entry.units; ++k)
+            {
+                entry.consumed = static_cast<std::uint8_t>(entry.consumed + lengths[k]);
+            }
+        }
+
+        return table;
+    }
+
+    inline constexpr std::array<utf8_expand_shape, utf8_pair_shapes + 256> utf8_expand_shapes = make_utf8_expand_shapes();
+
+    inline constexpr std::array<utf8_expand_entry, 4096> utf8_expand_table = make_utf8_expand_table();
+
+    XTUAL_TARGET("sse2") inline __m128i load_table_sse2(const std::array<std::uint8_t, 16> &table)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(table.data()));
+    }
+
+    template <std::endian order, typename unitT>
+    XTUAL_TARGET("sse2") inline __m128i load_utf16_sse2(const unitT *p)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+        return order == std::endian::native ? x : byteswap_epi16_sse2(x);
+    }
+
+    template <std::endian order, typename unitT>
+    XTUAL_TARGET("sse2") inline void store_utf16_sse2(unitT *p, __m128i x)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), order == std::endian::native ? x : byteswap_epi16_sse2(x));
+    }
+
+    template <typename From, typename To>
+    bool transcode_block_scalar(const typename From::unit_type *&i, const typename From::unit_type *e, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        while (i < e)
+        {
+            const auto *j = i;
+            char32_t ch;
+
+            if (From::decode(j, ie, ch) != transcode_status::ok || !To::encode(o, oe, ch))
+            {
+                return false;
+            }
+
+            i = j;
+        }
+
+        return true;
+    }
+
+    template <typename inT, typename outT>
+    XTUAL_TARGET("sse2") inline void utf16_to_utf8_ascii_sse2(const inT *&i, outT *&o, __m128i x, __m128i y)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm_packus_epi16(x, y));
+        i += 32 / sizeof(inT);
+        o += 16;
+    }
+
+    // Eight units holding surrogate pairs: each half of a pair carries two
+    // bytes of the four-byte sequence, so every lane is one to three bytes
+    // and the triple table compresses them. A high surrogate in the last
+    // lane is left for the next block.
+    template <typename inT, typename outT>
+    XTUAL_TARGET("ssse3") inline bool utf16_to_utf8_pairs_ssse3(const inT *&i, outT *&o, __m128i x)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i prefix = _mm_set1_epi16(static_cast<short>(0xfc00));
+
+        __m128i highs = _mm_cmpeq_epi16(_mm_and_si128(x, prefix), _mm_set1_epi16(static_cast<short>(0xd800)));
+        __m128i lows = _mm_cmpeq_epi16(_mm_and_si128(x, prefix), _mm_set1_epi16(static_cast<short>(0xdc00)));
+
+        auto high_bits = static_cast<std::uint32_t>(_mm_movemask_epi8(highs));
+        auto low_bits = static_cast<std::uint32_t>(_mm_movemask_epi8(lows));
+        std::size_t held = high_bits >> 15;
+
+        if (low_bits != (high_bits << 2 & 0xffff))
+        {
+            return false;
+        }
+
+        __m128i previous = _mm_slli_si128(x, 2);
+
+        for (std::size_t half = 0; half < 2; ++half)
+        {
+            const __m128i low6 = _mm_set1_epi32(0x3f);
+
+            __m128i w = half == 0 ? _mm_unpacklo_epi16(x, zero) : _mm_unpackhi_epi16(x, zero);
+            __m128i v = half == 0 ? _mm_unpacklo_epi16(previous, zero) : _mm_unpackhi_epi16(previous, zero);
+            __m128i h = half == 0 ? _mm_unpacklo_epi16(highs, highs) : _mm_unpackhi_epi16(highs, highs);
+            __m128i l = half == 0 ? _mm_unpacklo_epi16(lows, lows) : _mm_unpackhi_epi16(lows, lows);
+
+            __m128i two = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(w, 6), _mm_slli_epi32(_mm_and_si128(w, low6), 8)), _mm_set1_epi32(0x80c0));
+            __m128i three = _mm_or_si128(_mm_srli_epi32(w, 12), _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(w, 6), low6), 8));
+
+            three = _mm_or_si128(_mm_or_si128(three, _mm_slli_epi32(_mm_and_si128(w, low6), 16)), _mm_set1_epi32(0x8080e0));
+
+            // The plane plus one is bits 6-10 of the high surrogate; its low
+            // two bits are unchanged by the carry and reappear in the low lane.
+            __m128i plane = _mm_add_epi32(_mm_and_si128(w, _mm_set1_epi32(0x3ff)), _mm_set1_epi32(0x40));
+            __m128i lead = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(plane, 8), _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(plane, 2), low6), 8)), _mm_set1_epi32(0x80f0));
+            __m128i trail = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(3)), 4), _mm_and_si128(_mm_srli_epi32(w, 6), _mm_set1_epi32(0xf)));
+
+            trail = _mm_or_si128(_mm_or_si128(trail, _mm_slli_epi32(_mm_and_si128(w, low6), 8)), _mm_set1_epi32(0x8080));
+
+            __m128i pairs = _mm_or_si128(h, l);
+            __m128i ge80 = _mm_or_si128(_mm_cmpgt_epi32(w, _mm_set1_epi32(0x7f)), pairs);
+            __m128i ge800 = _mm_andnot_si128(pairs, _mm_cmpgt_epi32(w, _mm_set1_epi32(0x7ff)));
+            __m128i lanes = _mm_or_si128(_mm_and_si128(ge80, two), _mm_andnot_si128(ge80, w));
+
+            lanes = _mm_or_si128(_mm_and_si128(ge800, three), _mm_andnot_si128(ge800, lanes));
+            lanes = _mm_or_si128(_mm_and_si128(h, lead), _mm_andnot_si128(h, lanes));
+            lanes = _mm_or_si128(_mm_and_si128(l, trail), _mm_andnot_si128(l, lanes));
+
+            auto key = static_cast<std::size_t>(_mm_movemask_ps(_mm_castsi128_ps(ge80)) | _mm_movemask_ps(_mm_castsi128_ps(ge800)) << 4);
+            const utf8_compress_entry &entry = utf8_triple_table[key];
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm_shuffle_epi8(lanes, load_table_sse2(entry.shuffle)));
+            o += entry.length;
+        }
+
+        o -= 2 * held;
+        i += (8 - held) * 2 / sizeof(inT);
+
+        return true;
+    }
+
+    template <typename inT, typename outT>
+    XTUAL_TARGET("ssse3") inline bool utf16_to_utf8_block_ssse3(const inT *&i, outT *&o, __m128i x)
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        if (is_below_sse2<char16_t>(x, U'\x7ff'))
+        {
+            __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(x, _mm_set1_epi16(static_cast<short>(0xff80))), zero);
+            __m128i lead = _mm_or_si128(_mm_srli_epi16(x, 6), _mm_set1_epi16(0xc0));
+            __m128i tail = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(x, _mm_set1_epi16(0x3f)), 8), _mm_set1_epi16(static_cast<short>(0x8000)));
+            __m128i lanes = _mm_or_si128(_mm_and_si128(ascii, x), _mm_andnot_si128(ascii, _mm_or_si128(lead, tail)));
+
+            const utf8_compress_entry &entry = utf8_pair_table[static_cast<std::size_t>(_mm_movemask_epi8(_mm_packs_epi16(ascii, zero)))];
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm_shuffle_epi8(lanes, load_table_sse2(entry.shuffle)));
+            o += entry.length;
+        }
+        else if (is_valid_utf16_block(x))
+        {
+            for (__m128i w : { _mm_unpacklo_epi16(x, zero), _mm_unpackhi_epi16(x, zero) })
+            {
+                const __m128i low6 = _mm_set1_epi32(0x3f);
+
+                __m128i two = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(w, 6), _mm_slli_epi32(_mm_and_si128(w, low6), 8)), _mm_set1_epi32(0x80c0));
+                __m128i three = _mm_or_si128(_mm_srli_epi32(w, 12), _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(w, 6), low6), 8));
+
+                three = _mm_or_si128(_mm_or_si128(three, _mm_slli_epi32(_mm_and_si128(w, low6), 16)), _mm_set1_epi32(0x8080e0));
+
+                __m128i ge80 = _mm_cmpgt_epi32(w, _mm_set1_epi32(0x7f));
+                __m128i ge800 = _mm_cmpgt_epi32(w, _mm_set1_epi32(0x7ff));
+                __m128i lanes = _mm_or_si128(_mm_and_si128(ge80, two), _mm_andnot_si128(ge80, w));
+
+                lanes = _mm_or_si128(_mm_and_si128(ge800, three), _mm_andnot_si128(ge800, lanes));
+
+                auto key = static_cast<std::size_t>(_mm_movemask_ps(_mm_castsi128_ps(ge80)) | _mm_movemask_ps(_mm_castsi128_ps(ge800)) << 4);
+                const utf8_compress_entry &entry = utf8_triple_table[key];
+
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm_shuffle_epi8(lanes, load_table_sse2(entry.shuffle)));
+                o += entry.length;
+            }
+        }
+        else
+        {
+            return utf16_to_utf8_pairs_ssse3(i, o, x);
+        }
+
+        i += 16 / sizeof(inT);
+
+        return true;
+    }
+
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("sse2") void utf16_to_utf8_kernel_sse2(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(typename From::unit_type);
+
+        while (ie - i >= 2 * step && oe - o >= 16)
+        {
+            __m128i x = load_utf16_sse2<order>(i);
+            __m128i y = load_utf16_sse2<order>(i + step);
+
+            if (is_below_sse2<char16_t>(_mm_or_si128(x, y), U'\x7f'))
+            {
+                utf16_to_utf8_ascii_sse2(i, o, x, y);
+            }
+            else if (!transcode_block_scalar<From, To>(i, i + 2 * step, ie, o, oe))
+            {
+                return;
+            }
+        }
+    }
+
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("ssse3") void utf16_to_utf8_kernel_ssse3(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(typename From::unit_type);
+
+        while (ie - i >= 2 * step && oe - o >= 32)
+        {
+            __m128i x = load_utf16_sse2<order>(i);
+            __m128i y = load_utf16_sse2<order>(i + step);
+
+            if (is_below_sse2<char16_t>(_mm_or_si128(x, y), U'\x7f'))
+            {
+                utf16_to_utf8_ascii_sse2(i, o, x, y);
+            }
+            else if (!utf16_to_utf8_block_ssse3(i, o, x) && !transcode_block_scalar<From, To>(i, i + 2 * step, ie, o, oe))
+            {
+                return;
+            }
+        }
+
+        utf16_to_utf8_kernel_sse2<order, From, To>(i, ie, o, oe);
+    }
+
+    // Converts 32 ASCII units with one pack; otherwise runs the SSSE3 block
+    // over all four 8-unit quarters. Only quarters with an unpaired
+    // surrogate take the scalar codec, which stops at the error.
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("avx2") void utf16_to_utf8_kernel_avx2(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        constexpr std::ptrdiff_t step = 32 / sizeof(typename From::unit_type);
+
+        const __m256i high = _mm256_set1_epi16(static_cast<short>(0xff80));
+
+        while (ie - i >= 2 * step && oe - o >= 32)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(i + step));
+
+            if constexpr (order != std::endian::native)
+            {
+                x = byteswap_epi16_avx2(x);
+                y = byteswap_epi16_avx2(y);
+            }
+
+            if (_mm256_testz_si256(_mm256_or_si256(x, y), high))
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(o), _mm256_permute4x64_epi64(_mm256_packus_epi16(x, y), 0xd8));
+                i += 2 * step;
+                o += 32;
+            }
+            else
+            {
+                constexpr std::ptrdiff_t half = step / 2;
+
+                for (const auto *e = i + 2 * step; e - i >= half && oe - o >= 32;)
+                {
+                    if (!utf16_to_utf8_block_ssse3(i, o, load_utf16_sse2<order>(i)) && !transcode_block_scalar<From, To>(i, i + half, ie, o, oe))
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+
+        utf16_to_utf8_kernel_ssse3<order, From, To>(i, ie, o, oe);
+    }
+
+    template <std::endian order, typename outT>
+    XTUAL_TARGET("ssse3") inline const utf8_expand_entry *utf8_to_utf16_block_ssse3(__m128i x, std::uint64_t starts, outT *o)
+    {
+        const utf8_expand_entry &entry = utf8_expand_table[starts >> 1 & 0xfff];
+
+        if ((starts & 1) == 0 || entry.units == 0)
+        {
+            return nullptr;
+        }
+
+        const utf8_expand_shape &shape = utf8_expand_shapes[entry.shape];
+
+        __m128i lanes = _mm_shuffle_epi8(x, load_table_sse2(shape.shuffle));
+        __m128i matched = _mm_cmpeq_epi8(_mm_and_si128(lanes, load_table_sse2(shape.mask)), load_table_sse2(shape.expect));
+
+        if (_mm_movemask_epi8(matched) != 0xffff)
+        {
+            return nullptr;
+        }
+
+        __m128i units;
+
+        if (entry.shape < utf8_pair_shapes)
+        {
+            units = _mm_or_si128(_mm_and_si128(lanes, _mm_set1_epi16(0x7f)), _mm_and_si128(_mm_srli_epi16(lanes, 2), _mm_set1_epi16(0x7c0)));
+
+            if (_mm_movemask_epi8(_mm_cmplt_epi16(units, load_table_sse2(shape.minimum))) != 0)
+            {
+                return nullptr;
+            }
+        }
+        else
+        {
+            units = _mm_or_si128(_mm_and_si128(lanes, _mm_set1_epi32(0x7f)), _mm_and_si128(_mm_srli_epi32(lanes, 2), _mm_set1_epi32(0xfc0)));
+            units = _mm_or_si128(units, _mm_and_si128(_mm_srli_epi32(lanes, 4), _mm_set1_epi32(0xf000)));
+
+            __m128i surrogates = _mm_cmpeq_epi32(_mm_and_si128(units, _mm_set1_epi32(0xf800)), _mm_set1_epi32(0xd800));
+
+            if (_mm_movemask_epi8(_mm_or_si128(_mm_cmplt_epi32(units, load_table_sse2(shape.minimum)), surrogates)) != 0)
+            {
+                return nullptr;
+            }
+
+            units = _mm_shuffle_epi8(units, _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1));
+        }
+
+        store_utf16_sse2<order>(o, units);
+
+        return &entry;
+    }
+
+    template <std::endian order, typename inT, typename outT>
+    XTUAL_TARGET("sse2") inline void utf8_to_utf16_ascii_sse2(const inT *&i, outT *&o, __m128i x)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(outT);
+
+        const __m128i zero = _mm_setzero_si128();
+
+        store_utf16_sse2<order>(o, _mm_unpacklo_epi8(x, zero));
+        store_utf16_sse2<order>(o + step, _mm_unpackhi_epi8(x, zero));
+        i += 16;
+        o += 2 * step;
+    }
+
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("ssse3") inline bool utf8_to_utf16_window_ssse3(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe, std::uint64_t high, std::uint64_t starts)
+    {
+        const auto *e = i + 48;
+
+        while (i <= e)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i));
+
+            if ((high & 0xffff) == 0)
+            {
+                utf8_to_utf16_ascii_sse2<order>(i, o, x);
+                high >>= 16;
+                starts >>= 16;
+
+                continue;
+            }
+
+            const auto *p = i;
+            const utf8_expand_entry *entry = utf8_to_utf16_block_ssse3<order>(x, starts, o);
+
+            if (entry != nullptr)
+            {
+                i += entry->consumed;
+                o += entry->units * (2 / sizeof(typename To::unit_type));
+            }
+            else if (!transcode_block_scalar<From, To>(i, i + 1, ie, o, oe))
+            {
+                return false;
+            }
+
+            high >>= i - p;
+            starts >>= i - p;
+        }
+
+        return true;
+    }
+
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("sse2") void utf8_to_utf16_kernel_sse2(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(typename To::unit_type);
+
+        while (ie - i >= 16 && oe - o >= 2 * step)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i));
+
+            if (_mm_movemask_epi8(x) == 0)
+            {
+                utf8_to_utf16_ascii_sse2<order>(i, o, x);
+            }
+            else if (!transcode_block_scalar<From, To>(i, i + 16, ie, o, oe))
+            {
+                return;
+            }
+        }
+    }
+
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("ssse3") void utf8_to_utf16_kernel_ssse3(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(typename To::unit_type);
+
+        const __m128i tails = _mm_set1_epi8(static_cast<char>(0xbf));
+
+        while (ie - i >= 64 && oe - o >= 8 * step)
+        {
+            std::uint64_t high = 0;
+            std::uint64_t starts = 0;
+
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i) + k);
+
+                high |= static_cast<std::uint64_t>(_mm_movemask_epi8(x)) << (16 * k);
+                starts |= static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(x, tails))) << (16 * k);
+            }
+
+            if (!utf8_to_utf16_window_ssse3<order, From, To>(i, ie, o, oe, high, starts))
+            {
+                return;
+            }
+        }
+
+        utf8_to_utf16_kernel_sse2<order, From, To>(i, ie, o, oe);
+    }
+
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("avx2") void utf8_to_utf16_kernel_avx2(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        constexpr std::ptrdiff_t step = 32 / sizeof(typename To::unit_type);
+
+        const __m256i tails = _mm256_set1_epi8(static_cast<char>(0xbf));
+
+        while (ie - i >= 64 && oe - o >= 4 * step)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(i + 32));
+
+            auto high = static_cast<std::uint32_t>(_mm256_movemask_epi8(x)) | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(y))) << 32;
+
+            if (high == 0)
+            {
+                for (__m256i z : { x, y })
+                {
+                    __m256i lo = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(z));
+                    __m256i hi = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(z, 1));
+
+                    if constexpr (order != std::endian::native)
+                    {
+                        lo = byteswap_epi16_avx2(lo);
+                        hi = byteswap_epi16_avx2(hi);
+                    }
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(o), lo);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(o + step), hi);
+                    o += 2 * step;
+                }
+
+                i += 64;
+
+                continue;
+            }
+
+            auto starts = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(x, tails))) | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(y, tails)))) << 32;
+
+            if (!utf8_to_utf16_window_ssse3<order, From, To>(i, ie, o, oe, high, starts))
+            {
+                return;
+            }
+        }
+
+        utf8_to_utf16_kernel_ssse3<order, From, To>(i, ie, o, oe);
+    }
+
+#endif
+
+    template <std::endian order, typename From, typename To>
+    void utf16_to_utf8_kernel(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+#if defined(XTUAL_X86_SIMD)
+        switch (active_simd_level())
+        {
+        case simd_level::avx2:
+            utf16_to_utf8_kernel_avx2<order, From, To>(i, ie, o, oe);
+            break;
+        case simd_level::ssse3:
+            utf16_to_utf8_kernel_ssse3<order, From, To>(i, ie, o, oe);
+            break;
+        case simd_level::sse2:
+            utf16_to_utf8_kernel_sse2<order, From, To>(i, ie, o, oe);
+            break;
+        default:
+            break;
+        }
+#endif
+    }
+
+    template <std::endian order, typename From, typename To>
+    void utf8_to_utf16_kernel(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+#if defined(XTUAL_X86_SIMD)
+        switch (active_simd_level())
+        {
+        case simd_level::avx2:
+            utf8_to_utf16_kernel_avx2<order, From, To>(i, ie, o, oe);
+            break;
+        case simd_level::ssse3:
+            utf8_to_utf16_kernel_ssse3<order, From, To>(i, ie, o, oe);
+            break;
+        case simd_level::sse2:
+            utf8_to_utf16_kernel_sse2<order, From, To>(i, ie, o, oe);
+            break;
+        default:
+            break;
+        }
+#endif
+    }
+
+    template <typename charT, typename Engine>
+    struct transcode_kernel<u16_codec, utf8_codec<charT, Engine>>
+    {
+        static void run(const char16_t *&i, const char16_t *ie, charT *&o, charT *oe)
+        {
+            utf16_to_utf8_kernel<std::endian::native, u16_codec, utf8_codec<charT, Engine>>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, std::endian order, typename charT, typename Engine>
+    struct transcode_kernel<b16_codec<byteT, order>, utf8_codec<charT, Engine>>
+    {
+        static void run(const byteT *&i, const byteT *ie, charT *&o, charT *oe)
+        {
+            utf16_to_utf8_kernel<order, b16_codec<byteT, order>, utf8_codec<charT, Engine>>(i, ie, o, oe);
+        }
+    };
+
+    template <typename charT, typename Engine>
+    struct transcode_kernel<utf8_codec<charT, Engine>, u16_codec>
+    {
+        static void run(const charT *&i, const charT *ie, char16_t *&o, char16_t *oe)
+        {
+            utf8_to_utf16_kernel<std::endian::native, utf8_codec<charT, Engine>, u16_codec>(i, ie, o, oe);
+        }
+    };
+
+    template <typename charT, typename Engine, byte_like byteT, std::endian order>
+    struct transcode_kernel<utf8_codec<charT, Engine>, b16_codec<byteT, order>>
+    {
+        static void run(const charT *&i, const charT *ie, byteT *&o, byteT *oe)
+        {
+            utf8_to_utf16_kernel<order, utf8_codec<charT, Engine>, b16_codec<byteT, order>>(i, ie, o, oe);
+        }
+    };
+
+}
+
+namespace xtual
+{
+
+    template <typename charT>
+    constexpr std::size_t utf8_count_scalar(const charT *p, const charT *e, bool astral_twice)
+    {
+        std::size_t n = 0;
+
+        for (; p != e; ++p)
+        {
+            char8_t ch = utf8_codec<charT>::load(p);
+
+            n += is_utf8_tail(ch) ? 0 : 1;
+            n += astral_twice && ch >= static_cast<char8_t>(0xf0) ? 1 : 0;
+        }
+
+        return n;
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <typename charT>
+    XTUAL_TARGET("sse2") std::size_t utf8_count_sse2(const charT *p, const charT *e, bool astral_twice)
+    {
+        const __m128i tail_limit = _mm_set1_epi8(-65);
+        const __m128i astral_lead = _mm_set1_epi8(char(0xf0));
+
+        std::size_t n = 0;
+
+        for (; e - p >= 16; p += 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+            n += std::popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(input, tail_limit))));
+
+            if (astral_twice)
+            {
+                __m128i astral = _mm_cmpeq_epi8(_mm_max_epu8(input, astral_lead), input);
+
+                n += std::popcount(static_cast<unsigned>(_mm_movemask_epi8(astral)));
+            }
+        }
+
+        return n + utf8_count_scalar(p, e, astral_twice);
+    }
+
+    template <typename charT>
+    XTUAL_TARGET("avx2") std::size_t utf8_count_avx2(const charT *p, const charT *e, bool astral_twice)
+    {
+        const __m256i tail_limit = _mm256_set1_epi8(-65);
+        const __m256i astral_lead = _mm256_set1_epi8(char(0xf0));
+
+        std::size_t n = 0;
+
+        for (; e - p >= 32; p += 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+
+            n += std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(input, tail_limit))));
+
+            if (astral_twice)
+            {
+                __m256i astral = _mm256_cmpeq_epi8(_mm256_max_epu8(input, astral_lead), input);
+
+                n += std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(astral)));
+            }
+        }
+
+        return n + utf8_count_sse2(p, e, astral_twice);
+    }
+
+#endif
+
+    template <typename charT>
+    constexpr std::size_t utf8_count(const charT *p, const charT *e, bool astral_twice)
+    {
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                return utf8_count_avx2(p, e, astral_twice);
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                return utf8_count_sse2(p, e, astral_twice);
+            default:
+                break;
+            }
+        }
+#endif
+
+        return utf8_count_scalar(p, e, astral_twice);
+    }
+
+    constexpr std::size_t count_code_points_u8(std::span<const char8_t> in)
+    {
+        return utf8_count(in.data(), in.data() + in.size(), false);
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t count_code_points_b8(std::span<const byteT> in)
+    {
+        return utf8_count(in.data(), in.data() + in.size(), false);
+    }
+
+    constexpr std::size_t utf16_length_from_u8(std::span<const char8_t> in)
+    {
+        return utf8_count(in.data(), in.data() + in.size(), true);
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t utf16_length_from_b8(std::span<const byteT> in)
+    {
+        return utf8_count(in.data(), in.data() + in.size(), true);
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    XTUAL_TARGET("sse2") inline std::size_t count_code_points_u16_sse2(const char16_t *&p, const char16_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m128i mask = _mm_set1_epi16(static_cast<short>(0xfc00));
+        const __m128i low = _mm_set1_epi16(static_cast<short>(0xdc00));
+
+        for (; e - p >= 8; p += 8)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i tails = _mm_cmpeq_epi16(_mm_and_si128(input, mask), low);
+
+            n += 8 - std::popcount(static_cast<unsigned>(_mm_movemask_epi8(tails))) / 2;
+        }
+
+        return n;
+    }
+
+    XTUAL_TARGET("avx2") inline std::size_t count_code_points_u16_avx2(const char16_t *&p, const char16_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m256i mask = _mm256_set1_epi16(static_cast<short>(0xfc00));
+        const __m256i low = _mm256_set1_epi16(static_cast<short>(0xdc00));
+
+        for (; e - p >= 16; p += 16)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i tails = _mm256_cmpeq_epi16(_mm256_and_si256(input, mask), low);
+
+            n += 16 - std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(tails))) / 2;
+        }
+
+        return n + count_code_points_u16_sse2(p, e);
+    }
+
+#endif
+
+    constexpr std::size_t count_code_points_u16(std::span<const char16_t> in)
+    {
+        std::size_t n = 0;
+        const char16_t *p = in.data();
+        const char16_t *e = p + in.size();
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                n += count_code_points_u16_avx2(p, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                n += count_code_points_u16_sse2(p, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        for (; p != e; ++p)
+        {
+            n += is_low_surrogate(*p) ? 0 : 1;
+        }
+
+        return n;
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    XTUAL_TARGET("sse2") inline std::size_t utf8_length_from_u16_sse2(const char16_t *&p, const char16_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i above_1 = _mm_set1_epi16(static_cast<short>(0xff80));
+        const __m128i above_2 = _mm_set1_epi16(static_cast<short>(0xf800));
+        const __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xd800));
+
+        for (; e - p >= 8; p += 8)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i narrow_1 = _mm_cmpeq_epi16(_mm_and_si128(input, above_1), zero);
+            __m128i narrow_2 = _mm_cmpeq_epi16(_mm_and_si128(input, above_2), zero);
+            __m128i surrogates = _mm_cmpeq_epi16(_mm_and_si128(input, above_2), surrogate);
+
+            std::size_t ones = std::popcount(static_cast<unsigned>(_mm_movemask_epi8(narrow_1))) / 2;
+            std::size_t twos = std::popcount(static_cast<unsigned>(_mm_movemask_epi8(narrow_2))) / 2;
+            std::size_t halves = std::popcount(static_cast<unsigned>(_mm_movemask_epi8(surrogates))) / 2;
+
+            n += 24 - ones - twos - halves;
+        }
+
+        return n;
+    }
+
+    XTUAL_TARGET("avx2") inline std::size_t utf8_length_from_u16_avx2(const char16_t *&p, const char16_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i above_1 = _mm256_set1_epi16(static_cast<short>(0xff80));
+        const __m256i above_2 = _mm256_set1_epi16(static_cast<short>(0xf800));
+        const __m256i surrogate = _mm256_set1_epi16(static_cast<short>(0xd800));
+
+        for (; e - p >= 16; p += 16)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i narrow_1 = _mm256_cmpeq_epi16(_mm256_and_si256(input, above_1), zero);
+            __m256i narrow_2 = _mm256_cmpeq_epi16(_mm256_and_si256(input, above_2), zero);
+            __m256i surrogates = _mm256_cmpeq_epi16(_mm256_and_si256(input, above_2), surrogate);
+
+            std::size_t ones = std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_1))) / 2;
+            std::size_t twos = std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_2))) / 2;
+            std::size_t halves = std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(surrogates))) / 2;
+
+            n += 48 - ones - twos - halves;
+        }
+
+        return n + utf8_length_from_u16_sse2(p, e);
+    }
+
+#endif
+
+    constexpr std::size_t utf8_length_from_u16(std::span<const char16_t> in)
+    {
+        std::size_t n = 0;
+        const char16_t *p = in.data();
+        const char16_t *e = p + in.size();
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                n += utf8_length_from_u16_avx2(p, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                n += utf8_length_from_u16_sse2(p, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        for (; p != e; ++p)
+        {
+            n += is_surrogate(*p) ? 2 : utf8_width(*p);
+        }
+
+        return n;
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    XTUAL_TARGET("sse2") inline std::size_t utf8_length_from_u32_sse2(const char32_t *&p, const char32_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i above_1 = _mm_set1_epi32(static_cast<int>(0xffffff80));
+        const __m128i above_2 = _mm_set1_epi32(static_cast<int>(0xfffff800));
+        const __m128i above_3 = _mm_set1_epi32(static_cast<int>(0xffff0000));
+
+        for (; e - p >= 4; p += 4)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i narrow_1 = _mm_cmpeq_epi32(_mm_and_si128(input, above_1), zero);
+            __m128i narrow_2 = _mm_cmpeq_epi32(_mm_and_si128(input, above_2), zero);
+            __m128i narrow_3 = _mm_cmpeq_epi32(_mm_and_si128(input, above_3), zero);
+
+            std::size_t narrow = std::popcount(static_cast<unsigned>(_mm_movemask_epi8(narrow_1)))
+                + std::popcount(static_cast<unsigned>(_mm_movemask_epi8(narrow_2)))
+                + std::popcount(static_cast<unsigned>(_mm_movemask_epi8(narrow_3)));
+
+            n += 16 - narrow / 4;
+        }
+
+        return n;
+    }
+
+    XTUAL_TARGET("avx2") inline std::size_t utf8_length_from_u32_avx2(const char32_t *&p, const char32_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i above_1 = _mm256_set1_epi32(static_cast<int>(0xffffff80));
+        const __m256i above_2 = _mm256_set1_epi32(static_cast<int>(0xfffff800));
+        const __m256i above_3 = _mm256_set1_epi32(static_cast<int>(0xffff0000));
+
+        for (; e - p >= 8; p += 8)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i narrow_1 = _mm256_cmpeq_epi32(_mm256_and_si256(input, above_1), zero);
+            __m256i narrow_2 = _mm256_cmpeq_epi32(_mm256_and_si256(input, above_2), zero);
+            __m256i narrow_3 = _mm256_cmpeq_epi32(_mm256_and_si256(input, above_3), zero);
+
+            std::size_t narrow = std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_1)))
+                + std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_2)))
+                + std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_3)));
+
+            n += 32 - narrow / 4;
+        }
+
+        return n + utf8_length_from_u32_sse2(p, e);
+    }
+
+#endif
+
+    constexpr std::size_t utf8_length_from_u32(std::span<const char32_t> in)
+    {
+        std::size_t n = 0;
+        const char32_t *p = in.data();
+        const char32_t *e = p + in.size();
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                n += utf8_length_from_u32_avx2(p, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                n += utf8_length_from_u32_sse2(p, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        for (; p != e; ++p)
+        {
+            n += utf8_width(*p);
+        }
+
+        return n;
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    XTUAL_TARGET("sse2") inline std::size_t utf16_length_from_u32_sse2(const char32_t *&p, const char32_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i above_bmp = _mm_set1_epi32(static_cast<int>(0xffff0000));
+
+        for (; e - p >= 4; p += 4)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i bmp = _mm_cmpeq_epi32(_mm_and_si128(input, above_bmp), zero);
+
+            n += 8 - std::popcount(static_cast<unsigned>(_mm_movemask_epi8(bmp))) / 4;
+        }
+
+        return n;
+    }
+
+    XTUAL_TARGET("avx2") inline std::size_t utf16_length_from_u32_avx2(const char32_t *&p, const char32_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i above_bmp = _mm256_set1_epi32(static_cast<int>(0xffff0000));
+
+        for (; e - p >= 8; p += 8)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i bmp = _mm256_cmpeq_epi32(_mm256_and_si256(input, above_bmp), zero);
+
+            n += 16 - std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(bmp))) / 4;
+        }
+
+        return n + utf16_length_from_u32_sse2(p, e);
+    }
+
+#endif
+
+    constexpr std::size_t utf16_length_from_u32(std::span<const char32_t> in)
+    {
+        std::size_t n = 0;
+        const char32_t *p = in.data();
+        const char32_t *e = p + in.size();
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                n += utf16_length_from_u32_avx2(p, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                n += utf16_length_from_u32_sse2(p, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        for (; p != e; ++p)
+        {
+            n += (*p & ~U'\xffff') == 0 ? 1 : 2;
+        }
+
+        return n;
+    }
+
+    struct unit_match
+    {
+        std::uint32_t mask;
+        std::uint32_t value;
+    };
+
+    // Rewrites a match on unit values as a match on width-byte units read
+    // from memory in native order, so byte-order codecs need no swap.
+    template <std::size_t width, std::endian order>
+    constexpr unit_match stored_match(unit_match m)
+    {
+        if constexpr (width == 2 && order != std::endian::native)
+        {
+            return { byteswap(static_cast<std::uint16_t>(m.mask)), byteswap(static_cast<std::uint16_t>(m.value)) };
+        }
+        else if constexpr (width == 4 && order != std::endian::native)
+        {
+            return { byteswap(m.mask), byteswap(m.value) };
+        }
+        else
+        {
+            return m;
+        }
+    }
+
+    template <std::size_t width>
+    std::uint32_t load_stored_unit(const std::byte *p)
+    {
+        if constexpr (width == 1)
+        {
+            return static_cast<std::uint32_t>(*p);
+        }
+        else if constexpr (width == 2)
+        {
+            std::uint16_t u;
+            std::memcpy(&u, p, 2);
+
+            return u;
+        }
+        else
+        {
+            std::uint32_t u;
+            std::memcpy(&u, p, 4);
+
+            return u;
+        }
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <std::size_t width>
+    XTUAL_TARGET("sse2") inline std::size_t match_bits_sse2(__m128i x, unit_match m)
+    {
+        __m128i masked = _mm_and_si128(x, _mm_set1_epi32(static_cast<int>(m.mask * (width == 1 ? 0x01010101 : width == 2 ? 0x10001 : 1))));
+        __m128i value = _mm_set1_epi32(static_cast<int>(m.value * (width == 1 ? 0x01010101 : width == 2 ? 0x10001 : 1)));
+        __m128i matched = width == 1 ? _mm_cmpeq_epi8(masked, value) : width == 2 ? _mm_cmpeq_epi16(masked, value) : _mm_cmpeq_epi32(masked, value);
+
+        return static_cast<std::size_t>(std::popcount(static_cast<unsigned>(_mm_movemask_epi8(matched))));
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("avx2") inline std::size_t match_bits_avx2(__m256i x, unit_match m)
+    {
+        __m256i masked = _mm256_and_si256(x, _mm256_set1_epi32(static_cast<int>(m.mask * (width == 1 ? 0x01010101 : width == 2 ? 0x10001 : 1))));
+        __m256i value = _mm256_set1_epi32(static_cast<int>(m.value * (width == 1 ? 0x01010101 : width == 2 ? 0x10001 : 1)));
+        __m256i matched = width == 1 ? _mm256_cmpeq_epi8(masked, value) : width == 2 ? _mm256_cmpeq_epi16(masked, value) : _mm256_cmpeq_epi32(masked, value);
+
+        return static_cast<std::size_t>(std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(matched))));
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("sse2") std::array<std::size_t, 2> count_matching_units_sse2(const std::byte *&p, const std::byte *e, unit_match first, unit_match second)
+    {
+        std::array<std::size_t, 2> n {};
+
+        for (; e - p >= 16; p += 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+            n[0] += match_bits_sse2<width>(input, first);
+            n[1] += match_bits_sse2<width>(input, second);
+        }
+
+        return { n[0] / width, n[1] / width };
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("avx2") std::array<std::size_t, 2> count_matching_units_avx2(const std::byte *&p, const std::byte *e, unit_match first, unit_match second)
+    {
+        std::array<std::size_t, 2> n {};
+
+        for (; e - p >= 32; p += 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+
+            n[0] += match_bits_avx2<width>(input, first);
+            n[1] += match_bits_avx2<width>(input, second);
+        }
+
+        return { n[0] / width, n[1] / width };
+    }
+
+#endif
+
+    // Counts, in one pass, the width-byte units in [b, e) matching each of
+    // two masks; order is the byte order the units are stored in.
+    template <std::size_t width, std::endian order, typename unitT>
+    std::array<std::size_t, 2> count_matching_units(const unitT *b, const unitT *e, unit_match first, unit_match second)
+    {
+        const auto *p = reinterpret_cast<const std::byte *>(b);
+        const auto *pe = reinterpret_cast<const std::byte *>(e);
+
+        first = stored_match<width, order>(first);
+        second = stored_match<width, order>(second);
+
+        std::array<std::size_t, 2> n {};
+
+#if defined(XTUAL_X86_SIMD)
+        switch (active_simd_level())
+        {
+        case simd_level::avx2:
+            n = count_matching_units_avx2<width>(p, pe, first, second);
+            break;
+        case simd_level::ssse3:
+        case simd_level::sse2:
+            n = count_matching_units_sse2<width>(p, pe, first, second);
+            break;
+        default:
+            break;
+        }
+#endif
+
+        for (; static_cast<std::size_t>(pe - p) >= width; p += width)
+        {
+            std::uint32_t u = load_stored_unit<width>(p);
+
+            n[0] += (u & first.mask) == first.value;
+            n[1] += (u & second.mask) == second.value;
+        }
+
+        return n;
+    }
+
+    template <typename Codec>
+    struct encoding_form;
+
+    template <typename charT, typename Engine>
+    struct encoding_form<utf8_codec<charT, Engine>>
+    {
+        static constexpr std::size_t bits = 8;
+        static constexpr std::size_t units = 1;
+    };
+
+    template <>
+    struct encoding_form<u16_codec>
+    {
+        static constexpr std::size_t bits = 16;
+        static constexpr std::size_t units = 1;
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct encoding_form<b16_codec<byteT, order>>
+    {
+        static constexpr std::size_t bits = 16;
+        static constexpr std::size_t units = 2;
+    };
+
+    template <>
+    struct encoding_form<u32_codec>
+    {
+        static constexpr std::size_t bits = 32;
+        static constexpr std::size_t units = 1;
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct encoding_form<b32_codec<byteT, order>>
+    {
+        static constexpr std::size_t bits = 32;
+        static constexpr std::size_t units = 4;
+    };
+
+    template <typename From, typename To>
+    concept countable_conversion = requires {
+        encoding_form<From>::bits;
+        encoding_form<To>::bits;
+    } && (encoding_form<From>::units == 1 || encoding_form<From>::bits == encoding_form<To>::bits);
+
+    template <typename From, typename To>
+        requires countable_conversion<From, To>
+    constexpr std::size_t converted_length(std::span<const typename From::unit_type> in)
+    {
+        constexpr std::size_t from = encoding_form<From>::bits;
+        constexpr std::size_t to = encoding_form<To>::bits;
+
+        std::size_t n = in.size();
+
+        if constexpr (from == to)
+        {
+            n = in.size() / encoding_form<From>::units;
+        }
+        else if constexpr (from == 8 && to == 16)
+        {
+            n = utf8_count(in.data(), in.data() + in.size(), true);
+        }
+        else if constexpr (from == 8 && to == 32)
+        {
+            n = utf8_count(in.data(), in.data() + in.size(), false);
+        }
+        else if constexpr (from == 16 && to == 8)
+        {
+            n = utf8_length_from_u16(in);
+        }
+        else if constexpr (from == 16 && to == 32)
+        {
+            n = count_code_points_u16(in);
+        }
+        else if constexpr (from == 32 && to == 8)
+        {
+            n = utf8_length_from_u32(in);
+        }
+        else if constexpr (from == 32 && to == 16)
+        {
+            n = utf16_length_from_u32(in);
+        }
+
+        return n * encoding_form<To>::units;
+    }
+
+}
+
+namespace xtual
+{
+
+    enum class stats_form
+    {
+        utf8,
+        utf16,
+        utf32,
+        single_byte,
+    };
+
+    template <typename Codec>
+    struct stats_form_of;
+
+    template <typename charT, typename Engine>
+    struct stats_form_of<utf8_codec<charT, Engine>>
+    {
+        static constexpr stats_form value = stats_form::utf8;
+        static constexpr std::size_t width = 1;
+        static constexpr std::endian byte_order = std::endian::native;
+    };
+
+    template <>
+    struct stats_form_of<u16_codec>
+    {
+        static constexpr stats_form value = stats_form::utf16;
+        static constexpr std::size_t width = 2;
+        static constexpr std::endian byte_order = std::endian::native;
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct stats_form_of<b16_codec<byteT, order>>
+    {
+        static constexpr stats_form value = stats_form::utf16;
+        static constexpr std::size_t width = 2;
+        static constexpr std::endian byte_order = order;
+    };
+
+    template <>
+    struct stats_form_of<u32_codec>
+    {
+        static constexpr stats_form value = stats_form::utf32;
+        static constexpr std::size_t width = 4;
+        static constexpr std::endian byte_order = std::endian::native;
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct stats_form_of<b32_codec<byteT, order>>
+    {
+        static constexpr stats_form value = stats_form::utf32;
+        static constexpr std::size_t width = 4;
+        static constexpr std::endian byte_order = order;
+    };
+
+    template <byte_like byteT, char32_t max>
+    struct stats_form_of<single_byte_codec<byteT, max>>
+    {
+        static constexpr stats_form value = stats_form::single_byte;
+        static constexpr std::size_t width = 1;
+        static constexpr std::endian byte_order = std::endian::native;
+    };
+
+    struct transcode_stats
+    {
+        std::array<std::uint64_t, 4> bytes_read {};
+        std::array<std::uint64_t, 4> bytes_written {};
+        std::uint64_t code_points = 0;
+        std::uint64_t ascii_code_points = 0;
+        std::array<std::uint64_t, 4> errors {};
+        std::array<std::uint64_t, 4> path_bytes {};
+
+        std::uint64_t read(stats_form form) const
+        {
+            return bytes_read[static_cast<std::size_t>(form)];
+        }
+
+        std::uint64_t written(stats_form form) const
+        {
+            return bytes_written[static_cast<std::size_t>(form)];
+        }
+
+        std::uint64_t error_count(transcode_status status) const
+        {
+            return errors[static_cast<std::size_t>(status)];
+        }
+
+        std::uint64_t path(simd_level level) const
+        {
+            return path_bytes[static_cast<std::size_t>(level)];
+        }
+
+        double ascii_fraction() const
+        {
+            return code_points == 0 ? 0.0 : static_cast<double>(ascii_code_points) / static_cast<double>(code_points);
+        }
+
+        transcode_stats &operator+=(const transcode_stats &other)
+        {
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                bytes_read[k] += other.bytes_read[k];
+                bytes_written[k] += other.bytes_written[k];
+                errors[k] += other.errors[k];
+                path_bytes[k] += other.path_bytes[k];
+            }
+
+            code_points += other.code_points;
+            ascii_code_points += other.ascii_code_points;
+
+            return *this;
+        }
+
+        transcode_stats &operator-=(const transcode_stats &other)
+        {
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                bytes_read[k] -= other.bytes_read[k];
+                bytes_written[k] -= other.bytes_written[k];
+                errors[k] -= other.errors[k];
+                path_bytes[k] -= other.path_bytes[k];
+            }
+
+            code_points -= other.code_points;
+            ascii_code_points -= other.ascii_code_points;
+
+            return *this;
+        }
+    };
+
+#if defined(XTUAL_ENABLE_STATS)
+
+    inline constexpr bool stats_enabled = true;
+
+    struct stats_counters
+    {
+        std::array<std::atomic<std::uint64_t>, 4> bytes_read {};
+        std::array<std::atomic<std::uint64_t>, 4> bytes_written {};
+        std::atomic<std::uint64_t> code_points = 0;
+        std::atomic<std::uint64_t> ascii_code_points = 0;
+        std::array<std::atomic<std::uint64_t>, 4> errors {};
+        std::array<std::atomic<std::uint64_t>, 4> path_bytes {};
+
+        // Only the owning thread adds, so a relaxed load and store is enough;
+        // other threads read the counters but never write them.
+        static void add(std::atomic<std::uint64_t> &counter, std::uint64_t n)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        static void set(std::array<std::uint64_t, 4> &out, const std::array<std::atomic<std::uint64_t>, 4> &in)
+        {
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                out[k] = in[k].load(std::memory_order_relaxed);
+            }
+        }
+
+        transcode_stats load() const
+        {
+            transcode_stats s;
+
+            set(s.bytes_read, bytes_read);
+            set(s.bytes_written, bytes_written);
+            set(s.errors, errors);
+            set(s.path_bytes, path_bytes);
+            s.code_points = code_points.load(std::memory_order_relaxed);
+            s.ascii_code_points = ascii_code_points.load(std::memory_order_relaxed);
+
+            return s;
+        }
+
+        // The counters at the last stats_reset, guarded by the registry mutex.
+        transcode_stats baseline;
+    };
+
+    struct stats_registry
+    {
+        std::mutex mutex;
+        std::vector<stats_counters *> live;
+        transcode_stats retired;
+
+        static stats_registry &instance()
+        {
+            static stats_registry registry;
+
+            return registry;
+        }
+    };
+
+    struct stats_thread_slot
+    {
+        stats_counters counters;
+
+        stats_thread_slot()
+        {
+            stats_registry &registry = stats_registry::instance();
+            std::lock_guard lock(registry.mutex);
+
+            registry.live.push_back(&counters);
+        }
+
+        ~stats_thread_slot()
+        {
+            stats_registry &registry = stats_registry::instance();
+            std::lock_guard lock(registry.mutex);
+
+            registry.retired += counters.load();
+            registry.retired -= counters.baseline;
+            std::erase(registry.live, &counters);
+        }
+    };
+
+    inline stats_counters &thread_stats()
+    {
+        thread_local stats_thread_slot slot;
+
+        return slot.counters;
+    }
+
+    inline transcode_stats stats_snapshot()
+    {
+        stats_registry &registry = stats_registry::instance();
+        std::lock_guard lock(registry.mutex);
+
+        transcode_stats s = registry.retired;
+
+        for (const stats_counters *counters : registry.live)
+        {
+            s += counters->load();
+            s -= counters->baseline;
+        }
+
+        return s;
+    }
+
+    inline void stats_reset()
+    {
+        stats_registry &registry = stats_registry::instance();
+        std::lock_guard lock(registry.mutex);
+
+        registry.retired = transcode_stats();
+
+        for (stats_counters *counters : registry.live)
+        {
+            counters->baseline = counters->load();
+        }
+    }
+
+    inline void stats_count_error(transcode_status status)
+    {
+        stats_counters &counters = thread_stats();
+
+        stats_counters::add(counters.errors[static_cast<std::size_t>(status)], 1);
+    }
+
+#else
+
+    inline constexpr bool stats_enabled = false;
+
+    inline transcode_stats stats_snapshot()
+    {
+        return transcode_stats();
+    }
+
+    inline void stats_reset()
+    {
+    }
+
+#endif
+
+    template <typename From, typename To>
+    struct transcode_probe
+    {
+        bool chunk = false;
+        std::uint64_t code_points = 0;
+        std::uint64_t ascii_code_points = 0;
+        std::uint64_t kernel_units = 0;
+
+        constexpr void decoded(char32_t ch)
+        {
+            ++code_points;
+            ascii_code_points += ch < U'\x80';
+        }
+
+        // Counts the units a bulk kernel converted with the count kernels;
+        // the converted span is well formed, so every unit that is not a
+        // UTF-8 tail or a low surrogate starts a code point.
+        void kernel(const typename From::unit_type *b, const typename From::unit_type *e)
+        {
+            using form = stats_form_of<From>;
+
+            constexpr std::uint32_t ascii_mask = static_cast<std::uint32_t>((std::uint64_t(1) << (8 * form::width)) - 1) & ~std::uint32_t(0x7f);
+            constexpr unit_match tails = form::value == stats_form::utf8 ? unit_match { 0xc0, 0x80 } : form::value == stats_form::utf16 ? unit_match { 0xfc00, 0xdc00 } : unit_match { 0, 1 };
+
+            auto n = count_matching_units<form::width, form::byte_order>(b, e, { ascii_mask, 0 }, tails);
+            auto units = static_cast<std::uint64_t>(e - b) * sizeof(typename From::unit_type) / form::width;
+
+            kernel_units += static_cast<std::uint64_t>(e - b);
+            code_points += units - n[1];
+            ascii_code_points += n[0];
+        }
+
+        constexpr transcode_result finish(transcode_result r) const
+        {
+#if defined(XTUAL_ENABLE_STATS)
+            if (!std::is_constant_evaluated())
+            {
+                constexpr std::uint64_t from_size = sizeof(typename From::unit_type);
+                constexpr std::uint64_t to_size = sizeof(typename To::unit_type);
+
+                stats_counters &counters = thread_stats();
+
+                stats_counters::add(counters.bytes_read[static_cast<std::size_t>(stats_form_of<From>::value)], r.read * from_size);
+                stats_counters::add(counters.bytes_written[static_cast<std::size_t>(stats_form_of<To>::value)], r.written * to_size);
+                stats_counters::add(counters.code_points, code_points);
+                stats_counters::add(counters.ascii_code_points, ascii_code_points);
+                stats_counters::add(counters.path_bytes[static_cast<std::size_t>(active_simd_level())], kernel_units * from_size);
+                stats_counters::add(counters.path_bytes[static_cast<std::size_t>(simd_level::scalar)], (r.read - kernel_units) * from_size);
+
+                if (r.status != transcode_status::ok && !(chunk && r.status == transcode_status::incomplete))
+                {
+                    stats_counters::add(counters.errors[static_cast<std::size_t>(r.status)], 1);
+                }
+            }
+#endif
+
+            return r;
+        }
+    };
+
+}
+
+namespace xtual
+{
+
+    // Transcodes until the first failure. A chunk is a piece of a longer
+    // input, so a sequence cut off by its end is not counted as an error.
+    template <typename From, typename To>
+    constexpr transcode_result transcode_units(std::span<const typename From::unit_type> in, std::span<typename To::unit_type> out, bool chunk)
+    {
+        const auto *i = in.data();
+        const auto *ie = i + in.size();
+        auto *o = out.data();
+        auto *oe = o + out.size();
+
+        [[maybe_unused]] transcode_probe<From, To> probe { chunk };
+
+        while (i != ie)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                [[maybe_unused]] const auto *k = i;
+
+                transcode_kernel<From, To>::run(i, ie, o, oe);
+
+                if constexpr (stats_enabled)
+                {
+                    probe.kernel(k, i);
+                }
+
+                if (i == ie)
+                {
+                    break;
+                }
+            }
+
+            const auto *j = i;
+            char32_t ch;
+
+            transcode_status status = From::decode(j, ie, ch);
+
+            if (status != transcode_status::ok)
+            {
+                return probe.finish({ static_cast<std::size_t>(i - in.data()), static_cast<std::size_t>(o - out.data()), status });
+            }
+
+            if (!To::encode(o, oe, ch))
+            {
+                transcode_status failure = can_encode<To>(ch) ? transcode_status::insufficient : transcode_status::invalid;
+
+                return probe.finish({ static_cast<std::size_t>(i - in.data()), static_cast<std::size_t>(o - out.data()), failure });
+            }
+
+            if constexpr (stats_enabled)
+            {
+                probe.decoded(ch);
+            }
+
+            i = j;
+        }
+
+        return probe.finish({ in.size(), static_cast<std::size_t>(o - out.data()), transcode_status::ok });
+    }
+
+    template <typename From, typename To>
+    constexpr transcode_result transcode_strict(std::span<const typename From::unit_type> in, std::span<typename To::unit_type> out)
+    {
+        return transcode_units<From, To>(in, out, false);
+    }
+
+    template <typename From, typename To>
+    constexpr transcode_result transcode(std::span<const typename From::unit_type> in, std::span<typename To::unit_type> out, error_policy policy = error_policy::strict)
+    {
+        transcode_result r = transcode_strict<From, To>(in, out);
+
+        if (policy == error_policy::strict)
+        {
+            return r;
+        }
+
+        std::size_t read = r.read;
+        std::size_t written = r.written;
+
+        while (r.status == transcode_status::invalid || r.status == transcode_status::incomplete)
+        {
+            auto *o = out.data() + written;
+
+            if (!To::encode(o, out.data() + out.size(), replacement_character<To>()))
+            {
+                return { read, written, transcode_status::insufficient };
+            }
+
+            written = static_cast<std::size_t>(o - out.data());
+            read += skip_length<From>(in.data() + read, in.data() + in.size());
+
+            r = transcode_strict<From, To>(in.subspan(read), out.subspan(written));
+            read += r.read;
+            written += r.written;
+        }
+
+        return { read, written, r.status };
+    }
+
+    template <typename Codec>
+    constexpr std::size_t find_code_point_boundary(std::span<const typename Codec::unit_type> in, std::size_t n)
+    {
+        if (n >= in.size())
+        {
+            return in.size();
+        }
+
+        return static_cast<std::size_t>(Codec::resync(in.data(), in.data() + n, in.data() + in.size()) - in.data());
+    }
+
+    template <typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_u8(std::span<const char8_t> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_b8(std::span<const char8_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, b8_codec<byteT>>(in, out, policy);
+    }
+
+    template <typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_u16(std::span<const char8_t> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_b16be(std::span<const char8_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, b16be_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_b16le(std::span<const char8_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, b16le_codec<byteT>>(in, out, policy);
+    }
+
+    template <typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_u32(std::span<const char8_t> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_b32be(std::span<const char8_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, b32be_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_b32le(std::span<const char8_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, b32le_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_u8(std::span<const byteT> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<byteT, Engine>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_b8(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<inT, Engine>, b8_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_u16(std::span<const byteT> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<byteT, Engine>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_b16be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<inT, Engine>, b16be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_b16le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<inT, Engine>, b16le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_u32(std::span<const byteT> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<byteT, Engine>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_b32be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<inT, Engine>, b32be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_b32le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<inT, Engine>, b32le_codec<outT>>(in, out, policy);
+    }
+
+    constexpr transcode_result transcode_u16_to_u8(std::span<const char16_t> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u16_to_b8(std::span<const char16_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, b8_codec<byteT>>(in, out, policy);
+    }
+
+    constexpr transcode_result transcode_u16_to_u16(std::span<const char16_t> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u16_to_b16be(std::span<const char16_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, b16be_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u16_to_b16le(std::span<const char16_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, b16le_codec<byteT>>(in, out, policy);
+    }
+
+    constexpr transcode_result transcode_u16_to_u32(std::span<const char16_t> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u16_to_b32be(std::span<const char16_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, b32be_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u16_to_b32le(std::span<const char16_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, b32le_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b16be_to_u8(std::span<const byteT> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<byteT>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16be_to_b8(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<inT>, b8_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b16be_to_u16(std::span<const byteT> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<byteT>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16be_to_b16be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<inT>, b16be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16be_to_b16le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<inT>, b16le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b16be_to_u32(std::span<const byteT> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<byteT>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16be_to_b32be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<inT>, b32be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16be_to_b32le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<inT>, b32le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b16le_to_u8(std::span<const byteT> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<byteT>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16le_to_b8(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<inT>, b8_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b16le_to_u16(std::span<const byteT> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<byteT>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16le_to_b16be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<inT>, b16be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16le_to_b16le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<inT>, b16le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b16le_to_u32(std::span<const byteT> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<byteT>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16le_to_b32be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<inT>, b32be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16le_to_b32le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<inT>, b32le_codec<outT>>(in, out, policy);
+    }
+
+    constexpr transcode_result transcode_u32_to_u8(std::span<const char32_t> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u32_to_b8(std::span<const char32_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, b8_codec<byteT>>(in, out, policy);
+    }
+
+    constexpr transcode_result transcode_u32_to_u16(std::span<const char32_t> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u32_to_b16be(std::span<const char32_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, b16be_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u32_to_b16le(std::span<const char32_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, b16le_codec<byteT>>(in, out, policy);
+    }
+
+    constexpr transcode_result transcode_u32_to_u32(std::span<const char32_t> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u32_to_b32be(std::span<const char32_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, b32be_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u32_to_b32le(std::span<const char32_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, b32le_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b32be_to_u8(std::span<const byteT> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<byteT>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32be_to_b8(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<inT>, b8_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b32be_to_u16(std::span<const byteT> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<byteT>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32be_to_b16be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<inT>, b16be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32be_to_b16le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<inT>, b16le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b32be_to_u32(std::span<const byteT> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<byteT>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32be_to_b32be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<inT>, b32be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32be_to_b32le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<inT>, b32le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b32le_to_u8(std::span<const byteT> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<byteT>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32le_to_b8(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<inT>, b8_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b32le_to_u16(std::span<const byteT> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<byteT>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32le_to_b16be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<inT>, b16be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32le_to_b16le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<inT>, b16le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b32le_to_u32(std::span<const byteT> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<byteT>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32le_to_b32be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<inT>, b32be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32le_to_b32le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<inT>, b32le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_latin1_to_u8(std::span<const byteT> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<latin1_codec<byteT>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_latin1_to_u16(std::span<const byteT> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<latin1_codec<byteT>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_latin1_to_u32(std::span<const byteT> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<latin1_codec<byteT>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u8_to_latin1(std::span<const char8_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u8_codec, latin1_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u16_to_latin1(std::span<const char16_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, latin1_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u32_to_latin1(std::span<const char32_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, latin1_codec<byteT>>(in, out, policy);
+    }
+
+}
+
+namespace xtual
+{
+
+    struct null_sentinel
+    {
+        template <std::input_iterator Iter>
+            requires std::equality_comparable<std::iter_value_t<Iter>>
+        friend constexpr bool operator==(const Iter &i, null_sentinel)
+        {
+            return *i == std::iter_value_t<Iter>();
+        }
+    };
+
+    struct null_scan
+    {
+        std::size_t length;
+        std::size_t ascii;
+        bool terminated;
+    };
+
+    template <typename unitT>
+    constexpr null_scan scan_null_terminated_scalar(const unitT *p, std::size_t limit)
+    {
+        null_scan scan { 0, limit, false };
+
+        for (std::size_t k = 0; k < limit; ++k)
+        {
+            auto u = unit_value(p + k);
+
+            if (u == 0)
+            {
+                scan.terminated = true;
+                scan.ascii = std::min(scan.ascii, k);
+                scan.length = k;
+
+                return scan;
+            }
+
+            if (u >= 0x80 && scan.ascii == limit)
+            {
+                scan.ascii = k;
+            }
+        }
+
+        scan.length = limit;
+
+        return scan;
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <typename unitT>
+    XTUAL_TARGET("sse2") inline __m128i cmpeq_units_sse2(__m128i x, __m128i y)
+    {
+        if constexpr (sizeof(unitT) == 1)
+        {
+            return _mm_cmpeq_epi8(x, y);
+        }
+        else if constexpr (sizeof(unitT) == 2)
+        {
+            return _mm_cmpeq_epi16(x, y);
+        }
+        else
+        {
+            return _mm_cmpeq_epi32(x, y);
+        }
+    }
+
+    template <typename unitT>
+    XTUAL_TARGET("avx2") inline __m256i cmpeq_units_avx2(__m256i x, __m256i y)
+    {
+        if constexpr (sizeof(unitT) == 1)
+        {
+            return _mm256_cmpeq_epi8(x, y);
+        }
+        else if constexpr (sizeof(unitT) == 2)
+        {
+            return _mm256_cmpeq_epi16(x, y);
+        }
+        else
+        {
+            return _mm256_cmpeq_epi32(x, y);
+        }
+    }
+
+    constexpr null_scan finish_null_scan(std::size_t zero, std::size_t ascii, std::size_t limit)
+    {
+        if (zero < limit)
+        {
+            return { zero, std::min(ascii, zero), true };
+        }
+
+        return { limit, std::min(ascii, limit), false };
+    }
+
+    template <typename unitT>
+    XTUAL_TARGET("sse2") [[gnu::no_sanitize_address]] null_scan scan_null_terminated_sse2(const unitT *p, std::size_t limit)
+    {
+        auto address = reinterpret_cast<std::uintptr_t>(p);
+        const auto *block = reinterpret_cast<const char *>(address & ~static_cast<std::uintptr_t>(15));
+        auto skip = static_cast<std::size_t>(address & 15);
+        std::size_t bytes = limit < SIZE_MAX / sizeof(unitT) - 64 ? limit * sizeof(unitT) + skip : SIZE_MAX;
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i high = sizeof(unitT) == 2 ? _mm_set1_epi16(static_cast<short>(0xff80)) : _mm_set1_epi32(~0x7f);
+
+        std::uint32_t keep = ~0u << skip;
+        std::size_t ascii = limit;
+
+        for (std::size_t offset = 0; offset < bytes; offset += 16)
+        {
+            __m128i x = _mm_load_si128(reinterpret_cast<const __m128i *>(block + offset));
+
+            auto zeros = static_cast<std::uint32_t>(_mm_movemask_epi8(cmpeq_units_sse2<unitT>(x, zero))) & keep;
+            std::uint32_t wide;
+
+            if constexpr (sizeof(unitT) == 1)
+            {
+                wide = static_cast<std::uint32_t>(_mm_movemask_epi8(x)) & keep;
+            }
+            else
+            {
+                wide = ~static_cast<std::uint32_t>(_mm_movemask_epi8(cmpeq_units_sse2<unitT>(_mm_and_si128(x, high), zero))) & 0xffff & keep;
+            }
+
+            keep = ~0u;
+
+            if (wide != 0 && ascii == limit)
+            {
+                ascii = (offset + std::countr_zero(wide) - skip) / sizeof(unitT);
+            }
+
+            if (zeros != 0)
+            {
+                return finish_null_scan((offset + std::countr_zero(zeros) - skip) / sizeof(unitT), ascii, limit);
+            }
+        }
+
+        return finish_null_scan(limit, ascii, limit);
+    }
+
+    template <typename unitT>
+    XTUAL_TARGET("avx2") [[gnu::no_sanitize_address]] null_scan scan_null_terminated_avx2(const unitT *p, std::size_t limit)
+    {
+        auto address = reinterpret_cast<std::uintptr_t>(p);
+        const auto *block = reinterpret_cast<const char *>(address & ~static_cast<std::uintptr_t>(31));
+        auto skip = static_cast<std::size_t>(address & 31);
+        std::size_t bytes = limit < SIZE_MAX / sizeof(unitT) - 64 ? limit * sizeof(unitT) + skip : SIZE_MAX;
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i high = sizeof(unitT) == 2 ? _mm256_set1_epi16(static_cast<short>(0xff80)) : _mm256_set1_epi32(~0x7f);
+
+        std::uint32_t keep = ~0u << skip;
+        std::size_t ascii = limit;
+
+        for (std::size_t offset = 0; offset < bytes; offset += 32)
+        {
+            __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i *>(block + offset));
+
+            auto zeros = static_cast<std::uint32_t>(_mm256_movemask_epi8(cmpeq_units_avx2<unitT>(x, zero))) & keep;
+            std::uint32_t wide;
+
+            if constexpr (sizeof(unitT) == 1)
+            {
+                wide = static_cast<std::uint32_t>(_mm256_movemask_epi8(x)) & keep;
+            }
+            else
+            {
+                wide = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(cmpeq_units_avx2<unitT>(_mm256_and_si256(x, high), zero))) & keep;
+            }
+
+            keep = ~0u;
+
+            if (wide != 0 && ascii == limit)
+            {
+                ascii = (offset + std::countr_zero(wide) - skip) / sizeof(unitT);
+            }
+
+            if (zeros != 0)
+            {
+                return finish_null_scan((offset + std::countr_zero(zeros) - skip) / sizeof(unitT), ascii, limit);
+            }
+        }
+
+        return finish_null_scan(limit, ascii, limit);
+    }
+
+#endif
+
+    template <typename unitT>
+    constexpr null_scan scan_null_terminated(const unitT *p, std::size_t limit = SIZE_MAX / sizeof(unitT))
+    {
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                return scan_null_terminated_avx2(p, limit);
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                return scan_null_terminated_sse2(p, limit);
+            default:
+                break;
+            }
+        }
+#endif
+
+        return scan_null_terminated_scalar(p, limit);
+    }
+
+    template <typename unitT>
+    constexpr std::size_t null_terminated_length(const unitT *p)
+    {
+        return scan_null_terminated(p).length;
+    }
+
+    template <typename Codec>
+    struct null_terminator
+    {
+        static constexpr std::size_t width = 1;
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct null_terminator<b16_codec<byteT, order>>
+    {
+        static constexpr std::size_t width = 2;
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct null_terminator<b32_codec<byteT, order>>
+    {
+        static constexpr std::size_t width = 4;
+    };
+
+    template <std::size_t width, byte_like byteT>
+    constexpr null_scan scan_null_terminated_bytes_scalar(const byteT *p, std::size_t limit)
+    {
+        for (std::size_t k = 0; k + width <= limit; k += width)
+        {
+            std::size_t z = 0;
+
+            while (z < width && static_cast<std::byte>(p[k + z]) == std::byte(0))
+            {
+                ++z;
+            }
+
+            if (z == width)
+            {
+                return { k, 0, true };
+            }
+        }
+
+        return { limit, 0, false };
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <std::size_t width>
+    constexpr std::uint64_t zero_unit_starts(std::uint64_t zeros, std::size_t skip)
+    {
+        std::uint64_t run = zeros & zeros >> 1;
+
+        if constexpr (width == 4)
+        {
+            run &= run >> 2;
+        }
+
+        std::uint64_t phase = width == 2 ? 0x5555555555555555 : 0x1111111111111111;
+
+        return run & phase << (skip % width);
+    }
+
+    template <std::size_t width, byte_like byteT>
+    XTUAL_TARGET("sse2") [[gnu::no_sanitize_address]] null_scan scan_null_terminated_bytes_sse2(const byteT *p, std::size_t limit)
+    {
+        auto address = reinterpret_cast<std::uintptr_t>(p);
+        const auto *block = reinterpret_cast<const char *>(address & ~static_cast<std::uintptr_t>(15));
+        auto skip = static_cast<std::size_t>(address & 15);
+        std::size_t bytes = limit < SIZE_MAX - 64 ? limit + skip : SIZE_MAX;
+
+        std::uint64_t keep = ~std::uint64_t(0) << skip;
+        std::uint64_t prev = 0;
+
+        for (std::size_t offset = 0; offset < bytes; offset += 16)
+        {
+            __m128i x = _mm_load_si128(reinterpret_cast<const __m128i *>(block + offset));
+            auto zeros = static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128()))) & keep;
+
+            keep = ~std::uint64_t(0);
+
+            std::uint64_t starts = zero_unit_starts<width>(prev | zeros << 16, skip) & (0xffffull << (17 - width));
+
+            if (starts != 0)
+            {
+                std::size_t k = offset - 16 + std::countr_zero(starts) - skip;
+
+                return k < limit ? null_scan { k, 0, true } : null_scan { limit, 0, false };
+            }
+
+            prev = zeros;
+        }
+
+        return { limit, 0, false };
+    }
+
+    template <std::size_t width, byte_like byteT>
+    XTUAL_TARGET("avx2") [[gnu::no_sanitize_address]] null_scan scan_null_terminated_bytes_avx2(const byteT *p, std::size_t limit)
+    {
+        auto address = reinterpret_cast<std::uintptr_t>(p);
+        const auto *block = reinterpret_cast<const char *>(address & ~static_cast<std::uintptr_t>(31));
+        auto skip = static_cast<std::size_t>(address & 31);
+        std::size_t bytes = limit < SIZE_MAX - 64 ? limit + skip : SIZE_MAX;
+
+        std::uint64_t keep = ~std::uint64_t(0) << skip;
+        std::uint64_t prev = 0;
+
+        for (std::size_t offset = 0; offset < bytes; offset += 32)
+        {
+            __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i *>(block + offset));
+            auto zeros = static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_setzero_si256())))) & keep;
+
+            keep = ~std::uint64_t(0);
+
+            std::uint64_t starts = zero_unit_starts<width>(prev | zeros << 32, skip) & (0xffffffffull << (33 - width));
+
+            if (starts != 0)
+            {
+                std::size_t k = offset - 32 + std::countr_zero(starts) - skip;
+
+                return k < limit ? null_scan { k, 0, true } : null_scan { limit, 0, false };
+            }
+
+            prev = zeros;
+        }
+
+        return { limit, 0, false };
+    }
+
+#endif
+
+    template <std::size_t width, byte_like byteT>
+    constexpr null_scan scan_null_terminated_bytes(const byteT *p, std::size_t limit)
+    {
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                return scan_null_terminated_bytes_avx2<width>(p, limit);
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                return scan_null_terminated_bytes_sse2<width>(p, limit);
+            default:
+                break;
+            }
+        }
+#endif
+
+        return scan_null_terminated_bytes_scalar<width>(p, limit);
+    }
+
+    template <typename From, typename To>
+    constexpr transcode_result transcode_null_terminated(const typename From::unit_type *in, std::span<typename To::unit_type> out, error_policy policy = error_policy::strict)
+    {
+        using unit_type = typename From::unit_type;
+
+        constexpr std::size_t width = null_terminator<From>::width;
+        constexpr std::size_t chunk = 4096;
+
+        std::size_t read = 0;
+        std::size_t written = 0;
+
+        for (;;)
+        {
+            const unit_type *p = in + read;
+            null_scan scan;
+
+            if constexpr (width == 1)
+            {
+                scan = scan_null_terminated(p, chunk);
+            }
+            else
+            {
+                scan = scan_null_terminated_bytes<width>(p, chunk);
+            }
+
+            std::size_t length = scan.length;
+            transcode_result r;
+
+            if constexpr (sizeof(unit_type) == 1 && width == 1)
+            {
+                if (scan.ascii == length && !std::is_constant_evaluated())
+                {
+                    std::span<const unsigned char> part(reinterpret_cast<const unsigned char *>(p), length);
+
+                    r = transcode<ascii_codec<unsigned char>, To>(part, out.subspan(written), policy);
+                    read += r.read;
+                    written += r.written;
+
+                    if (r.status != transcode_status::ok || scan.terminated)
+                    {
+                        return { read, written, r.status };
+                    }
+
+                    continue;
+                }
+            }
+
+            if (!scan.terminated)
+            {
+                length = static_cast<std::size_t>(From::resync(p, p + length - 1, p + length) - p);
+            }
+
+            r = transcode<From, To>(std::span<const unit_type>(p, length), out.subspan(written), policy);
+            read += r.read;
+            written += r.written;
+
+            if (r.status != transcode_status::ok || scan.terminated)
+            {
+                return { read, written, r.status };
+            }
+        }
+    }
+
+}
+
+namespace xtual
+{
+
+    template <std::size_t N>
+    struct u8_literal
+    {
+        consteval u8_literal(const char8_t (&s)[N])
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                data[k] = s[k];
+            }
+        }
+
+        constexpr std::span<const char8_t> units() const
+        {
+            return { data.data(), N - 1 };
+        }
+
+        std::array<char8_t, N> data {};
+    };
+
+    template <typename To, std::size_t N>
+    struct encoded_literal
+    {
+        std::array<typename To::unit_type, N> data {};
+        std::size_t size = 0;
+        transcode_status status = transcode_status::ok;
+    };
+
+    template <typename To, u8_literal s>
+    consteval auto encode_literal()
+    {
+        constexpr std::size_t n = s.units().size();
+
+        encoded_literal<To, n * To::max_length> result;
+        transcode_result r = transcode<u8_codec, To>(s.units(), result.data);
+
+        result.size = r.written;
+        result.status = r.status;
+
+        return result;
+    }
+
+    template <typename To, u8_literal s>
+    consteval auto literal_array()
+    {
+        constexpr auto encoded = encode_literal<To, s>();
+
+        static_assert(encoded.status == transcode_status::ok, "literal is not valid UTF-8");
+
+        std::array<typename To::unit_type, encoded.size> result {};
+
+        for (std::size_t k = 0; k < encoded.size; ++k)
+        {
+            result[k] = encoded.data[k];
+        }
+
+        return result;
+    }
+
+    template <u8_literal s>
+    inline constexpr auto u8_to_u8_array = literal_array<u8_codec, s>();
+
+    template <u8_literal s, byte_like byteT = std::byte>
+    inline constexpr auto u8_to_b8_array = literal_array<b8_codec<byteT>, s>();
+
+    template <u8_literal s>
+    inline constexpr auto u8_to_u16_array = literal_array<u16_codec, s>();
+
+    template <u8_literal s, byte_like byteT = std::byte>
+    inline constexpr auto u8_to_b16be_array = literal_array<b16be_codec<byteT>, s>();
+
+    template <u8_literal s, byte_like byteT = std::byte>
+    inline constexpr auto u8_to_b16le_array = literal_array<b16le_codec<byteT>, s>();
+
+    template <u8_literal s>
+    inline constexpr auto u8_to_u32_array = literal_array<u32_codec, s>();
+
+    template <u8_literal s, byte_like byteT = std::byte>
+    inline constexpr auto u8_to_b32be_array = literal_array<b32be_codec<byteT>, s>();
+
+    template <u8_literal s, byte_like byteT = std::byte>
+    inline constexpr auto u8_to_b32le_array = literal_array<b32le_codec<byteT>, s>();
+
+}
+
+namespace xtual
+{
+
+    template <typename Codec>
+    constexpr const typename Codec::unit_type *validate_scalar(const typename Codec::unit_type *p, const typename Codec::unit_type *e)
+    {
+        while (p != e)
+        {
+            char32_t ch;
+
+            if (Codec::decode(p, e, ch) != transcode_status::ok)
+            {
+                break;
+            }
+        }
+
+        return p;
+    }
+
+    template <typename charT>
+    constexpr const charT *utf8_boundary_before(const charT *b, const charT *p)
+    {
+        for (std::size_t k = 0; k < 3 && p != b && is_utf8_tail(utf8_codec<charT>::load(p - 1)); ++k)
+        {
+            --p;
+        }
+
+        if (p != b && utf8_codec<charT>::load(p - 1) >= static_cast<char8_t>(0xc0))
+        {
+            --p;
+        }
+
+        return p;
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    XTUAL_TARGET("avx2") inline __m256i utf8_block_errors(__m256i input, __m256i prev_input)
+    {
+        const __m256i byte_1_high_table = _mm256_setr_epi8(
+            0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+            char(0x80), char(0x80), char(0x80), char(0x80), 0x21, 0x01, 0x15, 0x49,
+            0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+            char(0x80), char(0x80), char(0x80), char(0x80), 0x21, 0x01, 0x15, 0x49);
+        const __m256i byte_1_low_table = _mm256_setr_epi8(
+            char(0xe7), char(0xa3), char(0x83), char(0x83), char(0x8b), char(0xcb), char(0xcb), char(0xcb),
+            char(0xcb), char(0xcb), char(0xcb), char(0xcb), char(0xcb), char(0xdb), char(0xcb), char(0xcb),
+            char(0xe7), char(0xa3), char(0x83), char(0x83), char(0x8b), char(0xcb), char(0xcb), char(0xcb),
+            char(0xcb), char(0xcb), char(0xcb), char(0xcb), char(0xcb), char(0xdb), char(0xcb), char(0xcb));
+        const __m256i byte_2_high_table = _mm256_setr_epi8(
+            0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+            char(0xe6), char(0xae), char(0xba), char(0xba), 0x01, 0x01, 0x01, 0x01,
+            0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+            char(0xe6), char(0xae), char(0xba), char(0xba), 0x01, 0x01, 0x01, 0x01);
+        const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+
+        __m256i carried = _mm256_permute2x128_si256(prev_input, input, 0x21);
+        __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+        __m256i prev2 = _mm256_alignr_epi8(input, carried, 14);
+        __m256i prev3 = _mm256_alignr_epi8(input, carried, 13);
+
+        __m256i byte_1_high = _mm256_shuffle_epi8(byte_1_high_table, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble));
+        __m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_table, _mm256_and_si256(prev1, low_nibble));
+        __m256i byte_2_high = _mm256_shuffle_epi8(byte_2_high_table, _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+        __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+        __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xe0 - 0x80));
+        __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xf0 - 0x80));
+        __m256i must_be_tail = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+
+        return _mm256_xor_si256(must_be_tail, special);
+    }
+
+    template <typename charT>
+    XTUAL_TARGET("avx2") const charT *utf8_validate_avx2(const charT *b, const charT *e)
+    {
+        const __m256i incomplete_limit = _mm256_setr_epi8(
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff),
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff),
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff),
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xef), char(0xdf), char(0xbf));
+
+        const charT *p = b;
+        __m256i prev_input = _mm256_setzero_si256();
+        __m256i prev_incomplete = _mm256_setzero_si256();
+
+        while (e - p >= 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+
+            if (_mm256_movemask_epi8(input) == 0)
+            {
+                if (!_mm256_testz_si256(prev_incomplete, prev_incomplete))
+                {
+                    break;
+                }
+            }
+            else
+            {
+                __m256i errors = utf8_block_errors(input, prev_input);
+
+                if (!_mm256_testz_si256(errors, errors))
+                {
+                    break;
+                }
+
+                prev_incomplete = _mm256_subs_epu8(input, incomplete_limit);
+            }
+
+            prev_input = input;
+            p += 32;
+        }
+
+        return validate_scalar<utf8_codec<charT>>(utf8_boundary_before(b, p), e);
+    }
+
+    XTUAL_TARGET("ssse3") inline __m128i utf8_block_errors(__m128i input, __m128i prev_input)
+    {
+        const __m128i byte_1_high_table = _mm_setr_epi8(
+            0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+            char(0x80), char(0x80), char(0x80), char(0x80), 0x21, 0x01, 0x15, 0x49);
+        const __m128i byte_1_low_table = _mm_setr_epi8(
+            char(0xe7), char(0xa3), char(0x83), char(0x83), char(0x8b), char(0xcb), char(0xcb), char(0xcb),
+            char(0xcb), char(0xcb), char(0xcb), char(0xcb), char(0xcb), char(0xdb), char(0xcb), char(0xcb));
+        const __m128i byte_2_high_table = _mm_setr_epi8(
+            0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+            char(0xe6), char(0xae), char(0xba), char(0xba), 0x01, 0x01, 0x01, 0x01);
+        const __m128i low_nibble = _mm_set1_epi8(0x0f);
+
+        __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+        __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+        __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+
+        __m128i byte_1_high = _mm_shuffle_epi8(byte_1_high_table, _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble));
+        __m128i byte_1_low = _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, low_nibble));
+        __m128i byte_2_high = _mm_shuffle_epi8(byte_2_high_table, _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+        __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+        __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(0xe0 - 0x80));
+        __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(0xf0 - 0x80));
+        __m128i must_be_tail = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(char(0x80)));
+
+        return _mm_xor_si128(must_be_tail, special);
+    }
+
+    template <typename charT>
+    XTUAL_TARGET("ssse3") const charT *utf8_validate_ssse3(const charT *b, const charT *e)
+    {
+        const __m128i incomplete_limit = _mm_setr_epi8(
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff),
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xef), char(0xdf), char(0xbf));
+        const __m128i zero = _mm_setzero_si128();
+
+        const charT *p = b;
+        __m128i prev_input = zero;
+        __m128i prev_incomplete = zero;
+
+        while (e - p >= 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+            if (_mm_movemask_epi8(input) == 0)
+            {
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(prev_incomplete, zero)) != 0xffff)
+                {
+                    break;
+                }
+            }
+            else
+            {
+                __m128i errors = utf8_block_errors(input, prev_input);
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(errors, zero)) != 0xffff)
+                {
+                    break;
+                }
+
+                prev_incomplete = _mm_subs_epu8(input, incomplete_limit);
+            }
+
+            prev_input = input;
+            p += 16;
+        }
+
+        return validate_scalar<utf8_codec<charT>>(utf8_boundary_before(b, p), e);
+    }
+
+#endif
+
+    template <typename charT>
+    constexpr std::size_t utf8_validate(const charT *b, const charT *e)
+    {
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                return static_cast<std::size_t>(utf8_validate_avx2(b, e) - b);
+            case simd_level::ssse3:
+                return static_cast<std::size_t>(utf8_validate_ssse3(b, e) - b);
+            default:
+                break;
+            }
+        }
+#endif
+
+        return static_cast<std::size_t>(validate_scalar<utf8_codec<charT>>(b, e) - b);
+    }
+
+    constexpr std::size_t validate_u8(std::span<const char8_t> in)
+    {
+        return utf8_validate(in.data(), in.data() + in.size());
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t validate_b8(std::span<const byteT> in)
+    {
+        return utf8_validate(in.data(), in.data() + in.size());
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <std::endian order, typename unitT>
+    XTUAL_TARGET("sse2") const unitT *utf16_validate_sse2(const unitT *p, const unitT *e)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(unitT);
+
+        const __m128i mask = _mm_set1_epi16(static_cast<short>(0xfc00));
+        const __m128i high = _mm_set1_epi16(static_cast<short>(0xd800));
+        const __m128i low = _mm_set1_epi16(static_cast<short>(0xdc00));
+
+        unsigned carry = 0;
+
+        for (; e - p >= step; p += step)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+            if constexpr (order != std::endian::native)
+            {
+                x = byteswap_epi16_sse2(x);
+            }
+
+            __m128i kind = _mm_and_si128(x, mask);
+            auto h = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(kind, high)));
+            auto l = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(kind, low)));
+
+            if (l != (((h << 2) | carry) & 0xffff))
+            {
+                break;
+            }
+
+            carry = h >> 14;
+        }
+
+        return carry != 0 ? p - step / 8 : p;
+    }
+
+    template <std::endian order, typename unitT>
+    XTUAL_TARGET("avx2") const unitT *utf16_validate_avx2(const unitT *p, const unitT *e)
+    {
+        constexpr std::ptrdiff_t step = 32 / sizeof(unitT);
+
+        const __m256i mask = _mm256_set1_epi16(static_cast<short>(0xfc00));
+        const __m256i high = _mm256_set1_epi16(static_cast<short>(0xd800));
+        const __m256i low = _mm256_set1_epi16(static_cast<short>(0xdc00));
+
+        std::uint32_t carry = 0;
+
+        for (; e - p >= step; p += step)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+
+            if constexpr (order != std::endian::native)
+            {
+                x = byteswap_epi16_avx2(x);
+            }
+
+            __m256i kind = _mm256_and_si256(x, mask);
+            auto h = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(kind, high)));
+            auto l = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(kind, low)));
+
+            if (l != ((h << 2) | carry))
+            {
+                break;
+            }
+
+            carry = h >> 30;
+        }
+
+        return carry != 0 ? p - step / 16 : utf16_validate_sse2<order>(p, e);
+    }
+
+    template <std::endian order, typename unitT>
+    XTUAL_TARGET("sse2") const unitT *utf32_validate_sse2(const unitT *p, const unitT *e)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(unitT);
+
+        for (; e - p >= step; p += step)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+            if (!is_valid_utf32_block(order != std::endian::native ? byteswap_epi32_sse2(x) : x))
+            {
+                break;
+            }
+        }
+
+        return p;
+    }
+
+    template <std::endian order, typename unitT>
+    XTUAL_TARGET("avx2") const unitT *utf32_validate_avx2(const unitT *p, const unitT *e)
+    {
+        constexpr std::ptrdiff_t step = 32 / sizeof(unitT);
+
+        for (; e - p >= step; p += step)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+
+            if (!is_valid_utf32_block(order != std::endian::native ? byteswap_epi32_avx2(x) : x))
+            {
+                break;
+            }
+        }
+
+        return utf32_validate_sse2<order>(p, e);
+    }
+
+#endif
+
+    template <typename Codec, std::endian order>
+    constexpr std::size_t utf16_validate(const typename Codec::unit_type *b, const typename Codec::unit_type *e)
+    {
+        const auto *p = b;
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                p = utf16_validate_avx2<order>(b, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                p = utf16_validate_sse2<order>(b, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        return static_cast<std::size_t>(validate_scalar<Codec>(p, e) - b);
+    }
+
+    template <typename Codec, std::endian order>
+    constexpr std::size_t utf32_validate(const typename Codec::unit_type *b, const typename Codec::unit_type *e)
+    {
+        const auto *p = b;
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                p = utf32_validate_avx2<order>(b, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                p = utf32_validate_sse2<order>(b, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        return static_cast<std::size_t>(validate_scalar<Codec>(p, e) - b);
+    }
+
+    constexpr std::size_t validate_u16(std::span<const char16_t> in)
+    {
+        return utf16_validate<u16_codec, std::endian::native>(in.data(), in.data() + in.size());
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t validate_b16be(std::span<const byteT> in)
+    {
+        return utf16_validate<b16be_codec<byteT>, std::endian::big>(in.data(), in.data() + in.size());
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t validate_b16le(std::span<const byteT> in)
+    {
+        return utf16_validate<b16le_codec<byteT>, std::endian::little>(in.data(), in.data() + in.size());
+    }
+
+    constexpr std::size_t validate_u32(std::span<const char32_t> in)
+    {
+        return utf32_validate<u32_codec, std::endian::native>(in.data(), in.data() + in.size());
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t validate_b32be(std::span<const byteT> in)
+    {
+        return utf32_validate<b32be_codec<byteT>, std::endian::big>(in.data(), in.data() + in.size());
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t validate_b32le(std::span<const byteT> in)
+    {
+        return utf32_validate<b32le_codec<byteT>, std::endian::little>(in.data(), in.data() + in.size());
+    }
+
+    template <typename Codec>
+    struct validate_kernel
+    {
+        static constexpr std::size_t run(const typename Codec::unit_type *b, const typename Codec::unit_type *e)
+        {
+            return static_cast<std::size_t>(validate_scalar<Codec>(b, e) - b);
+        }
+    };
+
+    template <typename charT, typename Engine>
+    struct validate_kernel<utf8_codec<charT, Engine>>
+    {
+        static constexpr std::size_t run(const charT *b, const charT *e)
+        {
+            return utf8_validate(b, e);
+        }
+    };
+
+    template <>
+    struct validate_kernel<u16_codec>
+    {
+        static constexpr std::size_t run(const char16_t *b, const char16_t *e)
+        {
+            return utf16_validate<u16_codec, std::endian::native>(b, e);
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct validate_kernel<b16_codec<byteT, order>>
+    {
+        static constexpr std::size_t run(const byteT *b, const byteT *e)
+        {
+            return utf16_validate<b16_codec<byteT, order>, order>(b, e);
+        }
+    };
+
+    template <>
+    struct validate_kernel<u32_codec>
+    {
+        static constexpr std::size_t run(const char32_t *b, const char32_t *e)
+        {
+            return utf32_validate<u32_codec, std::endian::native>(b, e);
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct validate_kernel<b32_codec<byteT, order>>
+    {
+        static constexpr std::size_t run(const byteT *b, const byteT *e)
+        {
+            return utf32_validate<b32_codec<byteT, order>, order>(b, e);
+        }
+    };
+
+    template <typename Codec>
+    constexpr std::size_t validate_units(std::span<const typename Codec::unit_type> in)
+    {
+        return validate_kernel<Codec>::run(in.data(), in.data() + in.size());
+    }
+
+}
+
+namespace xtual
+{
+
+    inline constexpr std::size_t parallel_chunk_size = 1 << 16;
+
+    inline constexpr std::size_t parallel_threshold = 1 << 18;
+
+    class parallel_pool
+    {
+    public:
+        static parallel_pool &instance()
+        {
+            static parallel_pool pool;
+
+            return pool;
+        }
+
+        ~parallel_pool()
+        {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+
+            wake.notify_all();
+        }
+
+        template <std::invocable<std::size_t> F>
+        bool run(std::size_t n, std::size_t helpers, F &f)
+        {
+            std::unique_lock busy_lock(busy, std::try_to_lock);
+
+            if (!busy_lock)
+            {
+                return false;
+            }
+
+            while (workers.size() < helpers)
+            {
+                workers.emplace_back([this]() { serve(); });
+            }
+
+            std::atomic<std::size_t> next = 0;
+
+            std::function<void()> work = [&]() {
+                for (std::size_t k = next++; k < n; k = next++)
+                {
+                    f(k);
+                }
+            };
+
+            {
+                std::lock_guard lock(mutex);
+                task = &work;
+                seats = helpers;
+                ++generation;
+            }
+
+            wake.notify_all();
+            work();
+
+            std::unique_lock lock(mutex);
+            finished.wait(lock, [&]() { return active == 0; });
+            task = nullptr;
+            seats = 0;
+
+            return true;
+        }
+
+    private:
+        parallel_pool() = default;
+
+        void serve()
+        {
+            std::unique_lock lock(mutex);
+            std::size_t seen = 0;
+
+            while (true)
+            {
+                wake.wait(lock, [&]() { return stopping || (generation != seen && seats != 0); });
+
+                if (stopping)
+                {
+                    return;
+                }
+
+                seen = generation;
+                --seats;
+                ++active;
+
+                const std::function<void()> *t = task;
+
+                lock.unlock();
+                (*t)();
+                lock.lock();
+
+                if (--active == 0)
+                {
+                    finished.notify_all();
+                }
+            }
+        }
+
+        std::mutex busy;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+        const std::function<void()> *task = nullptr;
+        std::size_t seats = 0;
+        std::size_t active = 0;
+        std::size_t generation = 0;
+        bool stopping = false;
+        std::vector<std::jthread> workers;
+    };
+
+    template <std::invocable<std::size_t> F>
+    void parallel_for(std::size_t n, unsigned threads, F f)
+    {
+        if (threads > 1 && n > 1 && parallel_pool::instance().run(n, std::min<std::size_t>(threads, n) - 1, f))
+        {
+            return;
+        }
+
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            f(k);
+        }
+    }
+
+    template <typename From, typename To>
+    transcode_result transcode_measure(std::span<const typename From::unit_type> in, error_policy policy)
+    {
+        if constexpr (countable_conversion<From, To>)
+        {
+            if (validate_units<From>(in) == in.size())
+            {
+                return { in.size(), converted_length<From, To>(in), transcode_status::ok };
+            }
+        }
+
+        std::array<typename To::unit_type, 1024> scratch;
+
+        std::size_t read = 0;
+        std::size_t written = 0;
+
+        while (true)
+        {
+            transcode_result r = transcode<From, To>(in.subspan(read), scratch, policy);
+
+            read += r.read;
+            written += r.written;
+
+            if (r.status != transcode_status::insufficient)
+            {
+                return { read, written, r.status };
+            }
+        }
+    }
+
+    template <typename From, typename To>
+    transcode_result parallel_transcode(std::span<const typename From::unit_type> in, std::span<typename To::unit_type> out, error_policy policy = error_policy::strict, unsigned threads = std::thread::hardware_concurrency())
+    {
+        std::size_t n = std::min<std::size_t>(std::max(threads, 1u) * 4, in.size() / parallel_chunk_size);
+
+        if (threads <= 1 || n <= 1 || in.size() < parallel_threshold)
+        {
+            return transcode<From, To>(in, out, policy);
+        }
+
+        std::vector<std::size_t> bounds(n + 1);
+
+        bounds[0] = 0;
+        bounds[n] = in.size();
+
+        for (std::size_t k = 1; k < n; ++k)
+        {
+            const auto *p = From::resync(in.data() + bounds[k - 1], in.data() + in.size() / n * k, in.data() + in.size());
+
+            bounds[k] = static_cast<std::size_t>(p - in.data());
+        }
+
+        auto chunk = [&](std::size_t k) {
+            return in.subspan(bounds[k], bounds[k + 1] - bounds[k]);
+        };
+
+        std::vector<transcode_result> measured(n);
+
+        parallel_for(n, threads, [&](std::size_t k) {
+            measured[k] = transcode_measure<From, To>(chunk(k), policy);
+        });
+
+        std::vector<std::size_t> offsets(n + 1);
+        std::size_t last = 0;
+
+        for (offsets[0] = 0; last < n; ++last)
+        {
+            offsets[last + 1] = offsets[last] + measured[last].written;
+
+            if (measured[last].status != transcode_status::ok || offsets[last + 1] > out.size())
+            {
+                break;
+            }
+        }
+
+        parallel_for(last, threads, [&](std::size_t k) {
+            transcode<From, To>(chunk(k), out.subspan(offsets[k], measured[k].written), policy);
+        });
+
+        if (last == n)
+        {
+            return { in.size(), offsets[n], transcode_status::ok };
+        }
+
+        transcode_result r = transcode<From, To>(chunk(last), out.subspan(offsets[last]), policy);
+
+        if (r.status == transcode_status::incomplete && last + 1 != n)
+        {
+            r.status = transcode_status::invalid;
+        }
+
+        return { bounds[last] + r.read, offsets[last] + r.written, r.status };
+    }
+
+}
+
+namespace xtual
+{
+
+    enum class encoding
+    {
+        b8,
+        b16be,
+        b16le,
+        b32be,
+        b32le,
+    };
+
+    struct encoding_candidate
+    {
+        encoding form;
+        unsigned confidence;
+    };
+
+    struct encoding_detection
+    {
+        std::array<encoding_candidate, 5> candidates;
+        std::size_t bom_length;
+
+        constexpr encoding best() const
+        {
+            return candidates[0].form;
+        }
+    };
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <byte_like byteT>
+    XTUAL_TARGET("sse2") void count_zero_bytes_sse2(const byteT *&p, const byteT *e, std::array<std::size_t, 4> &zeros)
+    {
+        for (; e - p >= 16; p += 16)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128())));
+
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                zeros[k] += std::popcount(mask & (0x1111u << k));
+            }
+        }
+    }
+
+    template <byte_like byteT>
+    XTUAL_TARGET("avx2") void count_zero_bytes_avx2(const byteT *&p, const byteT *e, std::array<std::size_t, 4> &zeros)
+    {
+        for (; e - p >= 32; p += 32)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_setzero_si256())));
+
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                zeros[k] += std::popcount(mask & (0x11111111u << k));
+            }
+        }
+
+        count_zero_bytes_sse2(p, e, zeros);
+    }
+
+#endif
+
+    template <byte_like byteT>
+    constexpr std::array<std::size_t, 4> count_zero_bytes(const byteT *p, const byteT *e)
+    {
+        std::array<std::size_t, 4> zeros {};
+        const byteT *b = p;
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                count_zero_bytes_avx2(p, e, zeros);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                count_zero_bytes_sse2(p, e, zeros);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        for (; p != e; ++p)
+        {
+            if (static_cast<char8_t>(*p) == 0)
+            {
+                ++zeros[(p - b) % 4];
+            }
+        }
+
+        return zeros;
+    }
+
+    inline constexpr std::size_t detect_sample_size = 1 << 16;
+
+    template <typename From>
+    constexpr bool detect_is_valid(std::span<const typename From::unit_type> in)
+    {
+        std::size_t n = validate_units<From>(in);
+
+        if (n == in.size())
+        {
+            return true;
+        }
+
+        const auto *p = in.data() + n;
+        char32_t ch;
+
+        return From::decode(p, in.data() + in.size(), ch) == transcode_status::incomplete;
+    }
+
+    template <byte_like byteT>
+    std::size_t detect_bom(std::span<const byteT> in, encoding &form)
+    {
+        auto starts_with = [&](std::initializer_list<unsigned char> bom) {
+            return in.size() >= bom.size() && std::equal(bom.begin(), bom.end(), in.begin(), [](unsigned char x, byteT y) {
+                return x == static_cast<unsigned char>(y);
+            });
+        };
+
+        if (starts_with({ 0xef, 0xbb, 0xbf }))
+        {
+            form = encoding::b8;
+            return 3;
+        }
+
+        if (starts_with({ 0x00, 0x00, 0xfe, 0xff }))
+        {
+            form = encoding::b32be;
+            return 4;
+        }
+
+        if (starts_with({ 0xff, 0xfe, 0x00, 0x00 }))
+        {
+            form = encoding::b32le;
+            return 4;
+        }
+
+        if (starts_with({ 0xfe, 0xff }))
+        {
+            form = encoding::b16be;
+            return 2;
+        }
+
+        if (starts_with({ 0xff, 0xfe }))
+        {
+            form = encoding::b16le;
+            return 2;
+        }
+
+        return 0;
+    }
+
+    template <byte_like byteT>
+    encoding_detection detect_encoding(std::span<const byteT> in)
+    {
+        encoding_detection result {
+            { {
+                { encoding::b8, 0 },
+                { encoding::b16le, 0 },
+                { encoding::b16be, 0 },
+                { encoding::b32le, 0 },
+                { encoding::b32be, 0 },
+            } },
+            0,
+        };
+
+        encoding form;
+
+        result.bom_length = detect_bom(in, form);
+        in = in.first(std::min(in.size(), detect_sample_size));
+
+        auto quads = in.size() / 4;
+        auto pairs = in.size() / 2;
+        auto zeros = count_zero_bytes(in.data(), in.data() + quads * 4);
+        auto total = zeros[0] + zeros[1] + zeros[2] + zeros[3];
+
+        auto utf16_score = [&](std::size_t high, std::size_t low) -> unsigned {
+            return high > low ? 20 + static_cast<unsigned>(75 * (high - low) / pairs) : 20;
+        };
+
+        for (auto &c : result.candidates)
+        {
+            switch (c.form)
+            {
+            case encoding::b8:
+                if (detect_is_valid<b8_codec<byteT>>(in))
+                {
+                    c.confidence = total == 0 ? 90 : 30;
+                }
+                break;
+            case encoding::b16le:
+                if (pairs != 0 && detect_is_valid<b16le_codec<byteT>>(in))
+                {
+                    c.confidence = utf16_score(zeros[1] + zeros[3], zeros[0] + zeros[2]);
+                }
+                break;
+            case encoding::b16be:
+                if (pairs != 0 && detect_is_valid<b16be_codec<byteT>>(in))
+                {
+                    c.confidence = utf16_score(zeros[0] + zeros[2], zeros[1] + zeros[3]);
+                }
+                break;
+            case encoding::b32le:
+                if (quads != 0 && zeros[3] == quads && detect_is_valid<b32le_codec<byteT>>(in))
+                {
+                    c.confidence = 95;
+                }
+                break;
+            case encoding::b32be:
+                if (quads != 0 && zeros[0] == quads && detect_is_valid<b32be_codec<byteT>>(in))
+                {
+                    c.confidence = 95;
+                }
+                break;
+            }
+        }
+
+        if (result.bom_length != 0)
+        {
+            for (auto &c : result.candidates)
+            {
+                if (c.form == form)
+                {
+                    c.confidence = 100;
+                }
+            }
+        }
+
+        std::stable_sort(result.candidates.begin(), result.candidates.end(), [](const encoding_candidate &x, const encoding_candidate &y) {
+            return x.confidence > y.confidence;
+        });
+
+        return result;
+    }
+
+    template <byte_like byteT, typename F>
+    decltype(auto) visit_encoding(encoding form, F &&f)
+    {
+        switch (form)
+        {
+        case encoding::b16be:
+            return std::forward<F>(f)(std::type_identity<b16be_codec<byteT>>());
+        case encoding::b16le:
+            return std::forward<F>(f)(std::type_identity<b16le_codec<byteT>>());
+        case encoding::b32be:
+            return std::forward<F>(f)(std::type_identity<b32be_codec<byteT>>());
+        case encoding::b32le:
+            return std::forward<F>(f)(std::type_identity<b32le_codec<byteT>>());
+        default:
+            return std::forward<F>(f)(std::type_identity<b8_codec<byteT>>());
+        }
+    }
+
+}
+
+namespace xtual
+{
+
+    // A class template rather than a specialised variable template, whose
+    // partial specialisations GCC 12 leaves out of a module interface.
+    template <typename Codec>
+    struct utf8_codec_match
+    {
+        static constexpr bool value = false;
+    };
+
+    template <typename charT, typename Engine>
+    struct utf8_codec_match<utf8_codec<charT, Engine>>
+    {
+        static constexpr bool value = true;
+    };
+
+    template <typename Codec>
+    inline constexpr bool is_utf8_codec = utf8_codec_match<Codec>::value;
+
+    template <typename Codec>
+    requires is_utf8_codec<Codec> || std::same_as<Codec, u16_codec>
+    class offset_index
+    {
+    public:
+        using unit_type = typename Codec::unit_type;
+
+        static constexpr std::size_t block_length = 64;
+
+        constexpr explicit offset_index(std::size_t stride = 256)
+            : stride(stride == 0 ? 1 : stride)
+        {
+        }
+
+        constexpr explicit offset_index(std::span<const unit_type> text, std::size_t stride = 256)
+            : offset_index(stride)
+        {
+            extend(text);
+        }
+
+        constexpr void extend(std::span<const unit_type> text)
+        {
+            const unit_type *b = text.data();
+            const unit_type *p = b + indexed;
+            const unit_type *e = b + text.size();
+
+            std::size_t target = marks.size() * stride;
+
+            while (p != e)
+            {
+                if (e - p >= static_cast<std::ptrdiff_t>(block_length))
+                {
+                    std::size_t n = count_starts(p, p + block_length);
+
+                    if (count + n <= target)
+                    {
+                        count += n;
+                        p += block_length;
+
+                        continue;
+                    }
+                }
+
+                const unit_type *q = e - p >= static_cast<std::ptrdiff_t>(block_length) ? p + block_length : e;
+
+                for (; p != q; ++p)
+                {
+                    if (is_start(p))
+                    {
+                        if (count == target)
+                        {
+                            marks.push_back(static_cast<std::size_t>(p - b));
+                            target += stride;
+                        }
+
+                        ++count;
+                    }
+                }
+            }
+
+            underlying = text;
+            indexed = text.size();
+        }
+
+        constexpr std::size_t size() const
+        {
+            return count;
+        }
+
+        constexpr std::size_t length() const
+        {
+            return indexed;
+        }
+
+        constexpr std::size_t offset(std::size_t n) const
+        {
+            if (n >= count)
+            {
+                return indexed;
+            }
+
+            const unit_type *b = underlying.data();
+            const unit_type *p = b + marks[n / stride];
+
+            for (std::size_t k = n % stride; k != 0; --k)
+            {
+                for (++p; !is_start(p); ++p)
+                {
+                }
+            }
+
+            return static_cast<std::size_t>(p - b);
+        }
+
+        constexpr std::optional<char32_t> at(std::size_t n) const
+        {
+            if (n >= count)
+            {
+                return std::nullopt;
+            }
+
+            const unit_type *p = underlying.data() + offset(n);
+            char32_t ch;
+
+            if (Codec::decode(p, underlying.data() + indexed, ch) != transcode_status::ok)
+            {
+                return std::nullopt;
+            }
+
+            return ch;
+        }
+
+        constexpr std::span<const unit_type> substr(std::size_t first, std::size_t last) const
+        {
+            last = std::min(last, count);
+            first = std::min(first, last);
+
+            std::size_t b = offset(first);
+
+            return underlying.subspan(b, offset(last) - b);
+        }
+
+    private:
+        static constexpr bool is_start(const unit_type *p)
+        {
+            if constexpr (is_utf8_codec<Codec>)
+            {
+                return !is_utf8_tail(Codec::load(p));
+            }
+            else
+            {
+                return !is_low_surrogate(*p);
+            }
+        }
+
+        static constexpr std::size_t count_starts(const unit_type *p, const unit_type *e)
+        {
+            if constexpr (is_utf8_codec<Codec>)
+            {
+                return utf8_count(p, e, false);
+            }
+            else
+            {
+                return count_code_points_u16({ p, e });
+            }
+        }
+
+        std::size_t stride;
+        std::vector<std::size_t> marks;
+        std::span<const unit_type> underlying;
+        std::size_t indexed = 0;
+        std::size_t count = 0;
+    };
+
+    using u8_offset_index = offset_index<u8_codec>;
+
+    template <byte_like byteT>
+    using b8_offset_index = offset_index<b8_codec<byteT>>;
+
+    using u16_offset_index = offset_index<u16_codec>;
+
+}
+
+namespace xtual
+{
+
+    template <typename T>
+    concept unicode_string_like =
+        std::convertible_to<const T &, std::u8string_view>
+        || std::convertible_to<const T &, std::u16string_view>
+        || std::convertible_to<const T &, std::u32string_view>;
+
+    template <typename From, typename To, typename Container>
+    std::optional<Container> convert_units(std::span<const typename From::unit_type> in, error_policy policy, Container out)
+    {
+        out.resize(converted_length<From, To>(in));
+
+        transcode_result r = transcode<From, To>(in, std::span(out.data(), out.size()), policy);
+
+        if (r.status == transcode_status::ok)
+        {
+            out.resize(r.written);
+
+            return out;
+        }
+
+        if (r.status != transcode_status::insufficient)
+        {
+            return std::nullopt;
+        }
+
+        transcode_result rest = transcode_measure<From, To>(in.subspan(r.read), policy);
+
+        if (rest.status != transcode_status::ok)
+        {
+            return std::nullopt;
+        }
+
+        out.resize(r.written + rest.written);
+        transcode<From, To>(in.subspan(r.read), std::span(out.data() + r.written, rest.written), policy);
+
+        return out;
+    }
+
+    template <typename To, typename Container, unicode_string_like Source>
+    std::optional<Container> convert_string(const Source &in, error_policy policy, Container out)
+    {
+        if constexpr (std::convertible_to<const Source &, std::u8string_view>)
+        {
+            std::u8string_view s = in;
+
+            return convert_units<u8_codec, To>(std::span(s.data(), s.size()), policy, std::move(out));
+        }
+        else if constexpr (std::convertible_to<const Source &, std::u16string_view>)
+        {
+            std::u16string_view s = in;
+
+            return convert_units<u16_codec, To>(std::span(s.data(), s.size()), policy, std::move(out));
+        }
+        else
+        {
+            std::u32string_view s = in;
+
+            return convert_units<u32_codec, To>(std::span(s.data(), s.size()), policy, std::move(out));
+        }
+    }
+
+    // Source is always deduced; its default only keeps GCC 12 from dropping
+    // the defaults before it when this is exported from a module.
+    template <typename Alloc = std::allocator<char8_t>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::basic_string<char8_t, std::char_traits<char8_t>, Alloc>> to_u8string(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<u8_codec>(in, policy, std::basic_string<char8_t, std::char_traits<char8_t>, Alloc>(alloc));
+    }
+
+    template <typename Alloc = std::allocator<char16_t>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::basic_string<char16_t, std::char_traits<char16_t>, Alloc>> to_u16string(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<u16_codec>(in, policy, std::basic_string<char16_t, std::char_traits<char16_t>, Alloc>(alloc));
+    }
+
+    template <typename Alloc = std::allocator<char32_t>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::basic_string<char32_t, std::char_traits<char32_t>, Alloc>> to_u32string(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<u32_codec>(in, policy, std::basic_string<char32_t, std::char_traits<char32_t>, Alloc>(alloc));
+    }
+
+    template <byte_like byteT = std::byte, typename Alloc = std::allocator<byteT>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::vector<byteT, Alloc>> to_b8_bytes(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<b8_codec<byteT>>(in, policy, std::vector<byteT, Alloc>(alloc));
+    }
+
+    template <byte_like byteT = std::byte, typename Alloc = std::allocator<byteT>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::vector<byteT, Alloc>> to_b16be_bytes(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<b16be_codec<byteT>>(in, policy, std::vector<byteT, Alloc>(alloc));
+    }
+
+    template <byte_like byteT = std::byte, typename Alloc = std::allocator<byteT>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::vector<byteT, Alloc>> to_b16le_bytes(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<b16le_codec<byteT>>(in, policy, std::vector<byteT, Alloc>(alloc));
+    }
+
+    template <byte_like byteT = std::byte, typename Alloc = std::allocator<byteT>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::vector<byteT, Alloc>> to_b32be_bytes(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<b32be_codec<byteT>>(in, policy, std::vector<byteT, Alloc>(alloc));
+    }
+
+    template <byte_like byteT = std::byte, typename Alloc = std::allocator<byteT>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::vector<byteT, Alloc>> to_b32le_bytes(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<b32le_codec<byteT>>(in, policy, std::vector<byteT, Alloc>(alloc));
+    }
+
+}
+
+namespace xtual
+{
+
+    struct column_result
+    {
+        std::size_t rows;
+        std::size_t written;
+        std::size_t errors;
+        transcode_status status;
+    };
+
+    constexpr bool column_error(std::span<const std::uint64_t> bitmap, std::size_t row)
+    {
+        return (bitmap[row / 64] >> (row % 64) & 1) != 0;
+    }
+
+    inline void set_column_error(std::span<std::uint64_t> bitmap, std::size_t row)
+    {
+        bitmap[row / 64] |= std::uint64_t(1) << (row % 64);
+    }
+
+    template <typename Codec, std::integral offsetT>
+    std::size_t validate_column(std::span<const typename Codec::unit_type> data, std::span<const offsetT> offsets, std::span<std::uint64_t> errors)
+    {
+        std::size_t rows = offsets.empty() ? 0 : offsets.size() - 1;
+
+        std::fill(errors.begin(), errors.begin() + (rows + 63) / 64, 0);
+
+        if (rows == 0)
+        {
+            return 0;
+        }
+
+        const auto *base = data.data();
+        auto end = static_cast<std::size_t>(offsets[rows]);
+        auto pos = static_cast<std::size_t>(offsets[0]);
+
+        while (pos < end)
+        {
+            std::size_t bad = pos + validate_kernel<Codec>::run(base + pos, base + end);
+
+            if (bad == end)
+            {
+                break;
+            }
+
+            auto row = static_cast<std::size_t>(std::upper_bound(offsets.begin(), offsets.end(), static_cast<offsetT>(bad)) - offsets.begin()) - 1;
+
+            set_column_error(errors, row);
+            pos = static_cast<std::size_t>(offsets[row + 1]);
+        }
+
+        std::size_t checked = 0;
+
+        for (std::size_t k = 1; k < rows; ++k)
+        {
+            auto p = base + static_cast<std::size_t>(offsets[k]);
+
+            if (p == base + end || Codec::resync(base, p, base + end) == p)
+            {
+                continue;
+            }
+
+            for (std::size_t j : { k - 1, k })
+            {
+                if (j < checked || column_error(errors, j))
+                {
+                    continue;
+                }
+
+                const auto *b = base + static_cast<std::size_t>(offsets[j]);
+                const auto *e = base + static_cast<std::size_t>(offsets[j + 1]);
+
+                if (validate_kernel<Codec>::run(b, e) != static_cast<std::size_t>(e - b))
+                {
+                    set_column_error(errors, j);
+                }
+
+                checked = j + 1;
+            }
+        }
+
+        std::size_t count = 0;
+
+        for (std::size_t k = 0; k < (rows + 63) / 64; ++k)
+        {
+            count += static_cast<std::size_t>(std::popcount(errors[k]));
+        }
+
+        return count;
+    }
+
+    template <std::size_t from, std::size_t to>
+    struct column_counter;
+
+    template <>
+    struct column_counter<8, 16>
+    {
+        static constexpr std::size_t base = 0;
+
+        static constexpr std::size_t weight(char32_t u)
+        {
+            return (is_utf8_tail(static_cast<char8_t>(u)) ? 0 : 1) + (u >= U'\xf0' ? 1 : 0);
+        }
+
+#if defined(XTUAL_X86_SIMD)
+        XTUAL_TARGET("avx2") static std::array<std::uint32_t, 3> masks(const void *p)
+        {
+            __m256i input = _mm256_loadu_si256(static_cast<const __m256i *>(p));
+            __m256i astral = _mm256_cmpeq_epi8(_mm256_max_epu8(input, _mm256_set1_epi8(char(0xf0))), input);
+
+            return { static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(input, _mm256_set1_epi8(-65)))), static_cast<std::uint32_t>(_mm256_movemask_epi8(astral)), 0 };
+        }
+#endif
+    };
+
+    template <>
+    struct column_counter<8, 32>
+    {
+        static constexpr std::size_t base = 0;
+
+        static constexpr std::size_t weight(char32_t u)
+        {
+            return is_utf8_tail(static_cast<char8_t>(u)) ? 0 : 1;
+        }
+
+#if defined(XTUAL_X86_SIMD)
+        XTUAL_TARGET("avx2") static std::array<std::uint32_t, 3> masks(const void *p)
+        {
+            __m256i input = _mm256_loadu_si256(static_cast<const __m256i *>(p));
+
+            return { static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(input, _mm256_set1_epi8(-65)))), 0, 0 };
+        }
+#endif
+    };
+
+    template <>
+    struct column_counter<16, 8>
+    {
+        static constexpr std::size_t base = 1;
+
+        static constexpr std::size_t weight(char32_t u)
+        {
+            return is_surrogate(u) ? 2 : utf8_width(u);
+        }
+
+#if defined(XTUAL_X86_SIMD)
+        XTUAL_TARGET("avx2") static std::array<std::uint32_t, 3> masks(const void *p)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i above_2 = _mm256_set1_epi16(static_cast<short>(0xf800));
+
+            __m256i input = _mm256_loadu_si256(static_cast<const __m256i *>(p));
+            __m256i narrow_1 = _mm256_cmpeq_epi16(_mm256_and_si256(input, _mm256_set1_epi16(static_cast<short>(0xff80))), zero);
+            __m256i narrow_2 = _mm256_cmpeq_epi16(_mm256_and_si256(input, above_2), zero);
+            __m256i surrogates = _mm256_cmpeq_epi16(_mm256_and_si256(input, above_2), _mm256_set1_epi16(static_cast<short>(0xd800)));
+
+            return { ~static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_1)), ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(narrow_2, surrogates))), 0 };
+        }
+#endif
+    };
+
+    template <>
+    struct column_counter<16, 32>
+    {
+        static constexpr std::size_t base = 0;
+
+        static constexpr std::size_t weight(char32_t u)
+        {
+            return is_low_surrogate(u) ? 0 : 1;
+        }
+
+#if defined(XTUAL_X86_SIMD)
+        XTUAL_TARGET("avx2") static std::array<std::uint32_t, 3> masks(const void *p)
+        {
+            __m256i input = _mm256_loadu_si256(static_cast<const __m256i *>(p));
+            __m256i low = _mm256_cmpeq_epi16(_mm256_and_si256(input, _mm256_set1_epi16(static_cast<short>(0xfc00))), _mm256_set1_epi16(static_cast<short>(0xdc00)));
+
+            return { ~static_cast<std::uint32_t>(_mm256_movemask_epi8(low)), 0, 0 };
+        }
+#endif
+    };
+
+    template <>
+    struct column_counter<32, 8>
+    {
+        static constexpr std::size_t base = 1;
+
+        static constexpr std::size_t weight(char32_t u)
+        {
+            return utf8_width(u);
+        }
+
+#if defined(XTUAL_X86_SIMD)
+        XTUAL_TARGET("avx2") static std::array<std::uint32_t, 3> masks(const void *p)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+
+            __m256i input = _mm256_loadu_si256(static_cast<const __m256i *>(p));
+            __m256i narrow_1 = _mm256_cmpeq_epi32(_mm256_and_si256(input, _mm256_set1_epi32(static_cast<int>(0xffffff80))), zero);
+            __m256i narrow_2 = _mm256_cmpeq_epi32(_mm256_and_si256(input, _mm256_set1_epi32(static_cast<int>(0xfffff800))), zero);
+            __m256i narrow_3 = _mm256_cmpeq_epi32(_mm256_and_si256(input, _mm256_set1_epi32(static_cast<int>(0xffff0000))), zero);
+
+            return { ~static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_1)), ~static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_2)), ~static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_3)) };
+        }
+#endif
+    };
+
+    template <>
+    struct column_counter<32, 16>
+    {
+        static constexpr std::size_t base = 1;
+
+        static constexpr std::size_t weight(char32_t u)
+        {
+            return u > U'\xffff' ? 2 : 1;
+        }
+
+#if defined(XTUAL_X86_SIMD)
+        XTUAL_TARGET("avx2") static std::array<std::uint32_t, 3> masks(const void *p)
+        {
+            __m256i input = _mm256_loadu_si256(static_cast<const __m256i *>(p));
+            __m256i bmp = _mm256_cmpeq_epi32(_mm256_and_si256(input, _mm256_set1_epi32(static_cast<int>(0xffff0000))), _mm256_setzero_si256());
+
+            return { ~static_cast<std::uint32_t>(_mm256_movemask_epi8(bmp)), 0, 0 };
+        }
+#endif
+    };
+
+#if defined(XTUAL_X86_SIMD)
+
+    // Walks the rows [row, last) in 32-byte blocks, keeping a running count;
+    // a row ending inside a block takes its offset from the masked prefix.
+    template <typename Counter, typename unitT, std::integral offsetT, std::integral outOffsetT>
+    XTUAL_TARGET("avx2") void column_lengths_avx2(const unitT *base, std::span<const offsetT> offsets, std::size_t &row, std::size_t last, const unitT *&p, std::size_t &n, outOffsetT *out, std::size_t written, std::size_t units)
+    {
+        constexpr std::size_t step = 32 / sizeof(unitT);
+
+        const unitT *e = base + static_cast<std::size_t>(offsets[last]);
+
+        auto prefix = [](const std::array<std::uint32_t, 3> &masks, std::uint32_t below, std::size_t bytes) {
+            std::size_t bits = static_cast<std::size_t>(std::popcount(masks[0] & below) + std::popcount(masks[1] & below) + std::popcount(masks[2] & below));
+
+            return (Counter::base * bytes + bits) / sizeof(unitT);
+        };
+
+        for (; static_cast<std::size_t>(e - p) >= step; p += step)
+        {
+            auto masks = Counter::masks(p);
+
+            for (; row < last && base + static_cast<std::size_t>(offsets[row + 1]) < p + step; ++row)
+            {
+                auto bytes = static_cast<std::size_t>(base + static_cast<std::size_t>(offsets[row + 1]) - p) * sizeof(unitT);
+
+                out[row + 1] = static_cast<outOffsetT>(written + (n + prefix(masks, (std::uint32_t(1) << bytes) - 1, bytes)) * units);
+            }
+
+            n += prefix(masks, ~std::uint32_t(0), 32);
+        }
+    }
+
+#endif
+
+    // Sets out[k + 1] to written plus the converted length of rows [first, k]
+    // for every k in [first, last), in one counting pass over the rows.
+    template <typename From, typename To, std::integral offsetT, std::integral outOffsetT>
+        requires countable_conversion<From, To>
+    void column_lengths(const typename From::unit_type *base, std::span<const offsetT> offsets, std::size_t first, std::size_t last, outOffsetT *out, std::size_t written)
+    {
+        constexpr std::size_t units = encoding_form<To>::units;
+
+        if constexpr (encoding_form<From>::bits == encoding_form<To>::bits)
+        {
+            for (std::size_t row = first; row < last; ++row)
+            {
+                out[row + 1] = static_cast<outOffsetT>(written + static_cast<std::size_t>(offsets[row + 1] - offsets[first]) / encoding_form<From>::units * units);
+            }
+        }
+        else
+        {
+            using counter = column_counter<encoding_form<From>::bits, encoding_form<To>::bits>;
+
+            const auto *p = base + static_cast<std::size_t>(offsets[first]);
+            std::size_t n = 0;
+            std::size_t row = first;
+
+#if defined(XTUAL_X86_SIMD)
+            if (active_simd_level() == simd_level::avx2)
+            {
+                column_lengths_avx2<counter>(base, offsets, row, last, p, n, out, written, units);
+            }
+#endif
+
+            for (; row < last; ++row)
+            {
+                for (const auto *e = base + static_cast<std::size_t>(offsets[row + 1]); p != e; ++p)
+                {
+                    n += counter::weight(unit_value(p));
+                }
+
+                out[row + 1] = static_cast<outOffsetT>(written + n * units);
+            }
+        }
+    }
+
+    template <typename From, typename To, std::integral offsetT, std::integral outOffsetT>
+    column_result transcode_column(std::span<const typename From::unit_type> data, std::span<const offsetT> offsets, std::span<typename To::unit_type> out, std::span<outOffsetT> out_offsets, std::span<std::uint64_t> errors, error_policy policy = error_policy::strict)
+    {
+        std::size_t rows = offsets.empty() ? 0 : offsets.size() - 1;
+        std::size_t count = validate_column<From>(data, offsets, errors);
+
+        auto row_span = [&](std::size_t first, std::size_t last) {
+            auto b = static_cast<std::size_t>(offsets[first]);
+
+            return data.subspan(b, static_cast<std::size_t>(offsets[last]) - b);
+        };
+
+        std::size_t written = 0;
+        std::size_t row = 0;
+
+        out_offsets[0] = 0;
+
+        while (row < rows)
+        {
+            if (column_error(errors, row))
+            {
+                if (policy == error_policy::replace)
+                {
+                    auto in = row_span(row, row + 1);
+                    transcode_result m = transcode_measure<From, To>(in, policy);
+
+                    if (m.status != transcode_status::ok || m.written > out.size() - written)
+                    {
+                        return { row, written, count, transcode_status::insufficient };
+                    }
+
+                    written += transcode<From, To>(in, out.subspan(written), policy).written;
+                }
+
+                out_offsets[++row] = static_cast<outOffsetT>(written);
+
+                continue;
+            }
+
+            std::size_t first = row;
+            std::size_t last = row;
+
+            while (last < rows && !column_error(errors, last))
+            {
+                ++last;
+            }
+
+            column_lengths<From, To>(data.data(), offsets, first, last, out_offsets.data(), written);
+
+            auto limit = static_cast<outOffsetT>(out.size());
+
+            row = static_cast<std::size_t>(std::upper_bound(out_offsets.begin() + first + 1, out_offsets.begin() + last + 1, limit) - out_offsets.begin()) - 1;
+
+            std::size_t length = static_cast<std::size_t>(out_offsets[row]) - written;
+
+            transcode<From, To>(row_span(first, row), out.subspan(written, length));
+            written += length;
+
+            if (row < rows && !column_error(errors, row))
+            {
+                return { row, written, count, transcode_status::insufficient };
+            }
+        }
+
+        return { rows, written, count, transcode_status::ok };
+    }
+
+}
+
+namespace xtual
+{
+
+    template <typename From>
+    class stream_decoder
+    {
+    public:
+        using unit_type = typename From::unit_type;
+
+        constexpr explicit stream_decoder(error_policy policy = error_policy::strict)
+            : policy(policy)
+        {
+        }
+
+        constexpr bool has_pending() const
+        {
+            return size != 0;
+        }
+
+        constexpr void reset()
+        {
+            size = 0;
+        }
+
+        template <typename To = u32_codec>
+        constexpr transcode_result feed(std::span<const unit_type> in, std::span<typename To::unit_type> out)
+        {
+            std::size_t read = 0;
+            std::size_t written = 0;
+
+            transcode_status status = complete_pending<To>(in, out, read, written);
+
+            if (status != transcode_status::ok)
+            {
+                return { read, written, status };
+            }
+
+            while (true)
+            {
+                transcode_result r = transcode_units<From, To>(in.subspan(read), out.subspan(written), true);
+
+                read += r.read;
+                written += r.written;
+
+                if (r.status == transcode_status::ok || r.status == transcode_status::insufficient)
+                {
+                    return { read, written, r.status };
+                }
+
+                if (r.status == transcode_status::incomplete)
+                {
+                    for (; read != in.size(); ++read)
+                    {
+                        buf[size++] = in[read];
+                    }
+
+                    return { read, written, transcode_status::ok };
+                }
+
+                if (policy == error_policy::strict)
+                {
+                    return { read, written, transcode_status::invalid };
+                }
+
+                if (!replace<To>(out, written))
+                {
+                    return { read, written, transcode_status::insufficient };
+                }
+
+                read += skip_length<From>(in.data() + read, in.data() + in.size());
+            }
+        }
+
+        template <typename To = u32_codec>
+        constexpr transcode_result finish(std::span<typename To::unit_type> out)
+        {
+            transcode_result r = transcode<From, To>(std::span<const unit_type>(buf.data(), size), out, policy);
+
+            if (r.status != transcode_status::insufficient)
+            {
+                size = 0;
+            }
+
+            return { 0, r.status == transcode_status::insufficient ? 0 : r.written, r.status };
+        }
+
+    private:
+        template <typename To>
+        constexpr bool replace(std::span<typename To::unit_type> out, std::size_t &written)
+        {
+            auto *o = out.data() + written;
+
+            if (!To::encode(o, out.data() + out.size(), replacement_character<To>()))
+            {
+                return false;
+            }
+
+            written = static_cast<std::size_t>(o - out.data());
+
+            return true;
+        }
+
+        template <typename To>
+        constexpr transcode_status complete_pending(std::span<const unit_type> in, std::span<typename To::unit_type> out, std::size_t &read, std::size_t &written)
+        {
+            std::size_t carried = size;
+
+            while (size != 0)
+            {
+                const unit_type *p = buf.data();
+                char32_t ch;
+
+                transcode_status status = From::decode(p, buf.data() + size, ch);
+
+                if (status == transcode_status::incomplete)
+                {
+                    if (read == in.size())
+                    {
+                        return transcode_status::ok;
+                    }
+
+                    buf[size++] = in[read++];
+                }
+                else if (status == transcode_status::ok)
+                {
+                    auto *o = out.data() + written;
+
+                    if (!can_encode<To>(ch))
+                    {
+                        decode_error(transcode_status::invalid);
+
+                        if (policy == error_policy::strict)
+                        {
+                            read -= size - carried;
+                            size = 0;
+
+                            return transcode_status::invalid;
+                        }
+
+                        ch = replacement_character<To>();
+                    }
+
+                    if (!To::encode(o, out.data() + out.size(), ch))
+                    {
+                        read -= size - carried;
+                        size = carried;
+
+                        return transcode_status::insufficient;
+                    }
+
+                    written = static_cast<std::size_t>(o - out.data());
+                    size = 0;
+                }
+                else
+                {
+                    std::size_t skip = From::ill_formed_length(buf.data(), buf.data() + size);
+                    std::size_t keep = skip > carried ? skip : carried;
+
+                    read -= size - keep;
+                    size = keep;
+
+                    decode_error(transcode_status::invalid);
+
+                    if (policy == error_policy::strict)
+                    {
+                        read -= size - carried;
+                        size = 0;
+
+                        return transcode_status::invalid;
+                    }
+
+                    if (!replace<To>(out, written))
+                    {
+                        read -= size - carried;
+                        size = carried;
+
+                        return transcode_status::insufficient;
+                    }
+
+                    for (std::size_t k = skip; k < size; ++k)
+                    {
+                        buf[k - skip] = buf[k];
+                    }
+
+                    size -= skip;
+                    carried = size;
+                }
+            }
+
+            return transcode_status::ok;
+        }
+
+        std::array<unit_type, From::max_length> buf {};
+        std::size_t size = 0;
+        error_policy policy;
+    };
+
+    using u8_stream_decoder = stream_decoder<u8_codec>;
+
+    template <byte_like byteT>
+    using b8_stream_decoder = stream_decoder<b8_codec<byteT>>;
+
+    using u16_stream_decoder = stream_decoder<u16_codec>;
+
+    template <byte_like byteT>
+    using b16be_stream_decoder = stream_decoder<b16be_codec<byteT>>;
+
+    template <byte_like byteT>
+    using b16le_stream_decoder = stream_decoder<b16le_codec<byteT>>;
+
+    using u32_stream_decoder = stream_decoder<u32_codec>;
+
+    template <byte_like byteT>
+    using b32be_stream_decoder = stream_decoder<b32be_codec<byteT>>;
+
+    template <byte_like byteT>
+    using b32le_stream_decoder = stream_decoder<b32le_codec<byteT>>;
+
+}
+
+namespace xtual
+{
+
+    struct u8_decoding
+    {
+        using codec = u8_codec;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_u8(i, s);
+        }
+    };
+
+    template <byte_like byteT>
+    struct b8_decoding
+    {
+        using codec = b8_codec<byteT>;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_b8<byteT>(i, s);
+        }
+    };
+
+    struct u16_decoding
+    {
+        using codec = u16_codec;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_u16(i, s);
+        }
+    };
+
+    template <byte_like byteT>
+    struct b16be_decoding
+    {
+        using codec = b16be_codec<byteT>;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_b16be<byteT>(i, s);
+        }
+    };
+
+    template <byte_like byteT>
+    struct b16le_decoding
+    {
+        using codec = b16le_codec<byteT>;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_b16le<byteT>(i, s);
+        }
+    };
+
+    struct u32_decoding
+    {
+        using codec = u32_codec;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_u32(i, s);
+        }
+    };
+
+    template <byte_like byteT>
+    struct b32be_decoding
+    {
+        using codec = b32be_codec<byteT>;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_b32be<byteT>(i, s);
+        }
+    };
+
+    template <byte_like byteT>
+    struct b32le_decoding
+    {
+        using codec = b32le_codec<byteT>;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_b32le<byteT>(i, s);
+        }
+    };
+
+    template <std::ranges::view V, typename Decoding>
+    requires std::ranges::forward_range<V>
+    class decode_view : public std::ranges::view_interface<decode_view<V, Decoding>>
+    {
+    public:
+        template <bool Const>
+        class iterator
+        {
+        public:
+            using Base = std::conditional_t<Const, const V, V>;
+            using unit_type = typename Decoding::codec::unit_type;
+
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = char32_t;
+            using difference_type = std::ptrdiff_t;
+
+            static constexpr bool contiguous =
+                std::ranges::contiguous_range<Base>
+                && std::sized_sentinel_for<std::ranges::sentinel_t<Base>, std::ranges::iterator_t<Base>>
+                && std::same_as<std::ranges::range_value_t<Base>, unit_type>;
+
+            iterator() = default;
+
+            constexpr iterator(std::ranges::iterator_t<Base> pos, std::ranges::sentinel_t<Base> end)
+                : pos(std::move(pos)), next(this->pos), end(std::move(end))
+            {
+                decode();
+            }
+
+            constexpr char32_t operator*() const
+            {
+                return value;
+            }
+
+            constexpr iterator &operator++()
+            {
+                pos = next;
+                decode();
+
+                return *this;
+            }
+
+            constexpr iterator operator++(int)
+            {
+                iterator tmp = *this;
+                ++*this;
+
+                return tmp;
+            }
+
+            constexpr std::ranges::iterator_t<Base> base() const
+            {
+                return pos;
+            }
+
+            friend constexpr bool operator==(const iterator &x, const iterator &y)
+            {
+                return x.pos == y.pos;
+            }
+
+            friend constexpr bool operator==(const iterator &x, std::default_sentinel_t)
+            {
+                return x.pos == x.end;
+            }
+
+        private:
+            constexpr void decode()
+            {
+                if (pos == end)
+                {
+                    return;
+                }
+
+                if constexpr (contiguous)
+                {
+                    const unit_type *p = std::to_address(pos);
+                    const unit_type *e = p + (end - pos);
+                    const unit_type *q = p;
+
+                    if (Decoding::codec::decode(q, e, value) != transcode_status::ok)
+                    {
+                        value = U'\xfffd';
+                        q = p + Decoding::codec::ill_formed_length(p, e);
+                    }
+
+                    next = pos + (q - p);
+                }
+                else
+                {
+                    next = pos;
+                    value = Decoding::decode(next, end).value();
+                }
+            }
+
+            std::ranges::iterator_t<Base> pos {};
+            std::ranges::iterator_t<Base> next {};
+            std::ranges::sentinel_t<Base> end {};
+            char32_t value = U'\0';
+        };
+
+        decode_view() requires std::default_initializable<V> = default;
+
+        constexpr explicit decode_view(V base)
+            : underlying(std::move(base))
+        {
+        }
+
+        constexpr V base() const & requires std::copy_constructible<V>
+        {
+            return underlying;
+        }
+
+        constexpr V base() &&
+        {
+            return std::move(underlying);
+        }
+
+        constexpr iterator<false> begin()
+        {
+            return { std::ranges::begin(underlying), std::ranges::end(underlying) };
+        }
+
+        constexpr iterator<true> begin() const requires std::ranges::forward_range<const V>
+        {
+            return { std::ranges::begin(underlying), std::ranges::end(underlying) };
+        }
+
+        constexpr std::default_sentinel_t end() const
+        {
+            return std::default_sentinel;
+        }
+
+    private:
+        V underlying = V();
+    };
+
+    template <std::ranges::view V, typename To>
+    requires std::ranges::forward_range<V> && std::convertible_to<std::ranges::range_value_t<V>, char32_t>
+    class encode_view : public std::ranges::view_interface<encode_view<V, To>>
+    {
+    public:
+        template <bool Const>
+        class iterator
+        {
+        public:
+            using Base = std::conditional_t<Const, const V, V>;
+            using unit_type = typename To::unit_type;
+
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = unit_type;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            constexpr iterator(std::ranges::iterator_t<Base> pos, std::ranges::sentinel_t<Base> end)
+                : pos(std::move(pos)), end(std::move(end))
+            {
+                encode();
+            }
+
+            constexpr unit_type operator*() const
+            {
+                return units[index];
+            }
+
+            constexpr iterator &operator++()
+            {
+                if (++index == size)
+                {
+                    ++pos;
+                    encode();
+                }
+
+                return *this;
+            }
+
+            constexpr iterator operator++(int)
+            {
+                iterator tmp = *this;
+                ++*this;
+
+                return tmp;
+            }
+
+            constexpr std::ranges::iterator_t<Base> base() const
+            {
+                return pos;
+            }
+
+            friend constexpr bool operator==(const iterator &x, const iterator &y)
+            {
+                return x.pos == y.pos && x.index == y.index;
+            }
+
+            friend constexpr bool operator==(const iterator &x, std::default_sentinel_t)
+            {
+                return x.pos == x.end;
+            }
+
+        private:
+            constexpr void encode()
+            {
+                index = 0;
+                size = 0;
+
+                if (pos == end)
+                {
+                    return;
+                }
+
+                char32_t ch = static_cast<char32_t>(*pos);
+                unit_type *p = units.data();
+
+                if (!is_code_point(ch))
+                {
+                    ch = U'\xfffd';
+                }
+
+                if (!can_encode<To>(ch))
+                {
+                    ch = replacement_character<To>();
+                }
+
+                To::encode(p, units.data() + units.size(), ch);
+                size = static_cast<std::size_t>(p - units.data());
+            }
+
+            std::ranges::iterator_t<Base> pos {};
+            std::ranges::sentinel_t<Base> end {};
+            std::array<unit_type, To::max_length> units {};
+            std::size_t index = 0;
+            std::size_t size = 0;
+        };
+
+        encode_view() requires std::default_initializable<V> = default;
+
+        constexpr explicit encode_view(V base)
+            : underlying(std::move(base))
+        {
+        }
+
+        constexpr V base() const & requires std::copy_constructible<V>
+        {
+            return underlying;
+        }
+
+        constexpr V base() &&
+        {
+            return std::move(underlying);
+        }
+
+        constexpr iterator<false> begin()
+        {
+            return { std::ranges::begin(underlying), std::ranges::end(underlying) };
+        }
+
+        constexpr iterator<true> begin() const requires std::ranges::forward_range<const V>
+        {
+            return { std::ranges::begin(underlying), std::ranges::end(underlying) };
+        }
+
+        constexpr std::default_sentinel_t end() const
+        {
+            return std::default_sentinel;
+        }
+
+    private:
+        V underlying = V();
+    };
+
+    template <typename Decoding>
+    struct decode_adaptor
+    {
+        template <std::ranges::viewable_range R>
+        constexpr auto operator()(R &&r) const
+        {
+            return decode_view<std::views::all_t<R>, Decoding>(std::views::all(std::forward<R>(r)));
+        }
+
+        template <std::ranges::viewable_range R>
+        friend constexpr auto operator|(R &&r, const decode_adaptor &adaptor)
+        {
+            return adaptor(std::forward<R>(r));
+        }
+    };
+
+    template <typename To>
+    struct encode_adaptor
+    {
+        template <std::ranges::viewable_range R>
+        constexpr auto operator()(R &&r) const
+        {
+            return encode_view<std::views::all_t<R>, To>(std::views::all(std::forward<R>(r)));
+        }
+
+        template <std::ranges::viewable_range R>
+        friend constexpr auto operator|(R &&r, const encode_adaptor &adaptor)
+        {
+            return adaptor(std::forward<R>(r));
+        }
+    };
+
+    namespace views
+    {
+
+        inline constexpr decode_adaptor<u8_decoding> decode_u8 {};
+
+        template <byte_like byteT>
+        inline constexpr decode_adaptor<b8_decoding<byteT>> decode_b8 {};
+
+        inline constexpr decode_adaptor<u16_decoding> decode_u16 {};
+
+        template <byte_like byteT>
+        inline constexpr decode_adaptor<b16be_decoding<byteT>> decode_b16be {};
+
+        template <byte_like byteT>
+        inline constexpr decode_adaptor<b16le_decoding<byteT>> decode_b16le {};
+
+        inline constexpr decode_adaptor<u32_decoding> decode_u32 {};
+
+        template <byte_like byteT>
+        inline constexpr decode_adaptor<b32be_decoding<byteT>> decode_b32be {};
+
+        template <byte_like byteT>
+        inline constexpr decode_adaptor<b32le_decoding<byteT>> decode_b32le {};
+
+        inline constexpr encode_adaptor<u8_codec> encode_u8 {};
+
+        template <byte_like byteT>
+        inline constexpr encode_adaptor<b8_codec<byteT>> encode_b8 {};
+
+        inline constexpr encode_adaptor<u16_codec> encode_u16 {};
+
+        template <byte_like byteT>
+        inline constexpr encode_adaptor<b16be_codec<byteT>> encode_b16be {};
+
+        template <byte_like byteT>
+        inline constexpr encode_adaptor<b16le_codec<byteT>> encode_b16le {};
+
+        inline constexpr encode_adaptor<u32_codec> encode_u32 {};
+
+        template <byte_like byteT>
+        inline constexpr encode_adaptor<b32be_codec<byteT>> encode_b32be {};
+
+        template <byte_like byteT>
+        inline constexpr encode_adaptor<b32le_codec<byteT>> encode_b32le {};
+
+    }
+
+}
+
+
+
+}
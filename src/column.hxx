@@ -0,0 +1,373 @@
+namespace xtual
+{
+
+    struct column_result
+    {
+        std::size_t rows;
+        std::size_t written;
+        std::size_t errors;
+        transcode_status status;
+    };
+
+    constexpr bool column_error(std::span<const std::uint64_t> bitmap, std::size_t row)
+    {
+        return (bitmap[row / 64] >> (row % 64) & 1) != 0;
+    }
+
+    inline void set_column_error(std::span<std::uint64_t> bitmap, std::size_t row)
+    {
+        bitmap[row / 64] |= std::uint64_t(1) << (row % 64);
+    }
+
+    template <typename Codec, std::integral offsetT>
+    std::size_t validate_column(std::span<const typename Codec::unit_type> data, std::span<const offsetT> offsets, std::span<std::uint64_t> errors)
+    {
+        std::size_t rows = offsets.empty() ? 0 : offsets.size() - 1;
+
+        std::fill(errors.begin(), errors.begin() + (rows + 63) / 64, 0);
+
+        if (rows == 0)
+        {
+            return 0;
+        }
+
+        const auto *base = data.data();
+        auto end = static_cast<std::size_t>(offsets[rows]);
+        auto pos = static_cast<std::size_t>(offsets[0]);
+
+        while (pos < end)
+        {
+            std::size_t bad = pos + validate_kernel<Codec>::run(base + pos, base + end);
+
+            if (bad == end)
+            {
+                break;
+            }
+
+            auto row = static_cast<std::size_t>(std::upper_bound(offsets.begin(), offsets.end(), static_cast<offsetT>(bad)) - offsets.begin()) - 1;
+
+            set_column_error(errors, row);
+            pos = static_cast<std::size_t>(offsets[row + 1]);
+        }
+
+        std::size_t checked = 0;
+
+        for (std::size_t k = 1; k < rows; ++k)
+        {
+            auto p = base + static_cast<std::size_t>(offsets[k]);
+
+            if (p == base + end || Codec::resync(base, p, base + end) == p)
+            {
+                continue;
+            }
+
+            for (std::size_t j : { k - 1, k })
+            {
+                if (j < checked || column_error(errors, j))
+                {
+                    continue;
+                }
+
+                const auto *b = base + static_cast<std::size_t>(offsets[j]);
+                const auto *e = base + static_cast<std::size_t>(offsets[j + 1]);
+
+                if (validate_kernel<Codec>::run(b, e) != static_cast<std::size_t>(e - b))
+                {
+                    set_column_error(errors, j);
+                }
+
+                checked = j + 1;
+            }
+        }
+
+        std::size_t count = 0;
+
+        for (std::size_t k = 0; k < (rows + 63) / 64; ++k)
+        {
+            count += static_cast<std::size_t>(std::popcount(errors[k]));
+        }
+
+        return count;
+    }
+
+    template <std::size_t from, std::size_t to>
+    struct column_counter;
+
+    template <>
+    struct column_counter<8, 16>
+    {
+        static constexpr std::size_t base = 0;
+
+        static constexpr std::size_t weight(char32_t u)
+        {
+            return (is_utf8_tail(static_cast<char8_t>(u)) ? 0 : 1) + (u >= U'\xf0' ? 1 : 0);
+        }
+
+#if defined(XTUAL_X86_SIMD)
+        XTUAL_TARGET("avx2") static std::array<std::uint32_t, 3> masks(const void *p)
+        {
+            __m256i input = _mm256_loadu_si256(static_cast<const __m256i *>(p));
+            __m256i astral = _mm256_cmpeq_epi8(_mm256_max_epu8(input, _mm256_set1_epi8(char(0xf0))), input);
+
+            return { static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(input, _mm256_set1_epi8(-65)))), static_cast<std::uint32_t>(_mm256_movemask_epi8(astral)), 0 };
+        }
+#endif
+    };
+
+    template <>
+    struct column_counter<8, 32>
+    {
+        static constexpr std::size_t base = 0;
+
+        static constexpr std::size_t weight(char32_t u)
+        {
+            return is_utf8_tail(static_cast<char8_t>(u)) ? 0 : 1;
+        }
+
+#if defined(XTUAL_X86_SIMD)
+        XTUAL_TARGET("avx2") static std::array<std::uint32_t, 3> masks(const void *p)
+        {
+            __m256i input = _mm256_loadu_si256(static_cast<const __m256i *>(p));
+
+            return { static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(input, _mm256_set1_epi8(-65)))), 0, 0 };
+        }
+#endif
+    };
+
+    template <>
+    struct column_counter<16, 8>
+    {
+        static constexpr std::size_t base = 1;
+
+        static constexpr std::size_t weight(char32_t u)
+        {
+            return is_surrogate(u) ? 2 : utf8_width(u);
+        }
+
+#if defined(XTUAL_X86_SIMD)
+        XTUAL_TARGET("avx2") static std::array<std::uint32_t, 3> masks(const void *p)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i above_2 = _mm256_set1_epi16(static_cast<short>(0xf800));
+
+            __m256i input = _mm256_loadu_si256(static_cast<const __m256i *>(p));
+            __m256i narrow_1 = _mm256_cmpeq_epi16(_mm256_and_si256(input, _mm256_set1_epi16(static_cast<short>(0xff80))), zero);
+            __m256i narrow_2 = _mm256_cmpeq_epi16(_mm256_and_si256(input, above_2), zero);
+            __m256i surrogates = _mm256_cmpeq_epi16(_mm256_and_si256(input, above_2), _mm256_set1_epi16(static_cast<short>(0xd800)));
+
+            return { ~static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_1)), ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(narrow_2, surrogates))), 0 };
+        }
+#endif
+    };
+
+    template <>
+    struct column_counter<16, 32>
+    {
+        static constexpr std::size_t base = 0;
+
+        static constexpr std::size_t weight(char32_t u)
+        {
+            return is_low_surrogate(u) ? 0 : 1;
+        }
+
+#if defined(XTUAL_X86_SIMD)
+        XTUAL_TARGET("avx2") static std::array<std::uint32_t, 3> masks(const void *p)
+        {
+            __m256i input = _mm256_loadu_si256(static_cast<const __m256i *>(p));
+            __m256i low = _mm256_cmpeq_epi16(_mm256_and_si256(input, _mm256_set1_epi16(static_cast<short>(0xfc00))), _mm256_set1_epi16(static_cast<short>(0xdc00)));
+
+            return { ~static_cast<std::uint32_t>(_mm256_movemask_epi8(low)), 0, 0 };
+        }
+#endif
+    };
+
+    template <>
+    struct column_counter<32, 8>
+    {
+        static constexpr std::size_t base = 1;
+
+        static constexpr std::size_t weight(char32_t u)
+        {
+            return utf8_width(u);
+        }
+
+#if defined(XTUAL_X86_SIMD)
+        XTUAL_TARGET("avx2") static std::array<std::uint32_t, 3> masks(const void *p)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+
+            __m256i input = _mm256_loadu_si256(static_cast<const __m256i *>(p));
+            __m256i narrow_1 = _mm256_cmpeq_epi32(_mm256_and_si256(input, _mm256_set1_epi32(static_cast<int>(0xffffff80))), zero);
+            __m256i narrow_2 = _mm256_cmpeq_epi32(_mm256_and_si256(input, _mm256_set1_epi32(static_cast<int>(0xfffff800))), zero);
+            __m256i narrow_3 = _mm256_cmpeq_epi32(_mm256_and_si256(input, _mm256_set1_epi32(static_cast<int>(0xffff0000))), zero);
+
+            return { ~static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_1)), ~static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_2)), ~static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_3)) };
+        }
+#endif
+    };
+
+    template <>
+    struct column_counter<32, 16>
+    {
+        static constexpr std::size_t base = 1;
+
+        static constexpr std::size_t weight(char32_t u)
+        {
+            return u > U'\xffff' ? 2 : 1;
+        }
+
+#if defined(XTUAL_X86_SIMD)
+        XTUAL_TARGET("avx2") static std::array<std::uint32_t, 3> masks(const void *p)
+        {
+            __m256i input = _mm256_loadu_si256(static_cast<const __m256i *>(p));
+            __m256i bmp = _mm256_cmpeq_epi32(_mm256_and_si256(input, _mm256_set1_epi32(static_cast<int>(0xffff0000))), _mm256_setzero_si256());
+
+            return { ~static_cast<std::uint32_t>(_mm256_movemask_epi8(bmp)), 0, 0 };
+        }
+#endif
+    };
+
+#if defined(XTUAL_X86_SIMD)
+
+    // Walks the rows [row, last) in 32-byte blocks, keeping a running count;
+    // a row ending inside a block takes its offset from the masked prefix.
+    template <typename Counter, typename unitT, std::integral offsetT, std::integral outOffsetT>
+    XTUAL_TARGET("avx2") void column_lengths_avx2(const unitT *base, std::span<const offsetT> offsets, std::size_t &row, std::size_t last, const unitT *&p, std::size_t &n, outOffsetT *out, std::size_t written, std::size_t units)
+    {
+        constexpr std::size_t step = 32 / sizeof(unitT);
+
+        const unitT *e = base + static_cast<std::size_t>(offsets[last]);
+
+        auto prefix = [](const std::array<std::uint32_t, 3> &masks, std::uint32_t below, std::size_t bytes) {
+            std::size_t bits = static_cast<std::size_t>(std::popcount(masks[0] & below) + std::popcount(masks[1] & below) + std::popcount(masks[2] & below));
+
+            return (Counter::base * bytes + bits) / sizeof(unitT);
+        };
+
+        for (; static_cast<std::size_t>(e - p) >= step; p += step)
+        {
+            auto masks = Counter::masks(p);
+
+            for (; row < last && base + static_cast<std::size_t>(offsets[row + 1]) < p + step; ++row)
+            {
+                auto bytes = static_cast<std::size_t>(base + static_cast<std::size_t>(offsets[row + 1]) - p) * sizeof(unitT);
+
+                out[row + 1] = static_cast<outOffsetT>(written + (n + prefix(masks, (std::uint32_t(1) << bytes) - 1, bytes)) * units);
+            }
+
+            n += prefix(masks, ~std::uint32_t(0), 32);
+        }
+    }
+
+#endif
+
+    // Sets out[k + 1] to written plus the converted length of rows [first, k]
+    // for every k in [first, last), in one counting pass over the rows.
+    template <typename From, typename To, std::integral offsetT, std::integral outOffsetT>
+        requires countable_conversion<From, To>
+    void column_lengths(const typename From::unit_type *base, std::span<const offsetT> offsets, std::size_t first, std::size_t last, outOffsetT *out, std::size_t written)
+    {
+        constexpr std::size_t units = encoding_form<To>::units;
+
+        if constexpr (encoding_form<From>::bits == encoding_form<To>::bits)
+        {
+            for (std::size_t row = first; row < last; ++row)
+            {
+                out[row + 1] = static_cast<outOffsetT>(written + static_cast<std::size_t>(offsets[row + 1] - offsets[first]) / encoding_form<From>::units * units);
+            }
+        }
+        else
+        {
+            using counter = column_counter<encoding_form<From>::bits, encoding_form<To>::bits>;
+
+            const auto *p = base + static_cast<std::size_t>(offsets[first]);
+            std::size_t n = 0;
+            std::size_t row = first;
+
+#if defined(XTUAL_X86_SIMD)
+            if (active_simd_level() == simd_level::avx2)
+            {
+                column_lengths_avx2<counter>(base, offsets, row, last, p, n, out, written, units);
+            }
+#endif
+
+            for (; row < last; ++row)
+            {
+                for (const auto *e = base + static_cast<std::size_t>(offsets[row + 1]); p != e; ++p)
+                {
+                    n += counter::weight(unit_value(p));
+                }
+
+                out[row + 1] = static_cast<outOffsetT>(written + n * units);
+            }
+        }
+    }
+
+    template <typename From, typename To, std::integral offsetT, std::integral outOffsetT>
+    column_result transcode_column(std::span<const typename From::unit_type> data, std::span<const offsetT> offsets, std::span<typename To::unit_type> out, std::span<outOffsetT> out_offsets, std::span<std::uint64_t> errors, error_policy policy = error_policy::strict)
+    {
+        std::size_t rows = offsets.empty() ? 0 : offsets.size() - 1;
+        std::size_t count = validate_column<From>(data, offsets, errors);
+
+        auto row_span = [&](std::size_t first, std::size_t last) {
+            auto b = static_cast<std::size_t>(offsets[first]);
+
+            return data.subspan(b, static_cast<std::size_t>(offsets[last]) - b);
+        };
+
+        std::size_t written = 0;
+        std::size_t row = 0;
+
+        out_offsets[0] = 0;
+
+        while (row < rows)
+        {
+            if (column_error(errors, row))
+            {
+                if (policy == error_policy::replace)
+                {
+                    auto in = row_span(row, row + 1);
+                    transcode_result m = transcode_measure<From, To>(in, policy);
+
+                    if (m.status != transcode_status::ok || m.written > out.size() - written)
+                    {
+                        return { row, written, count, transcode_status::insufficient };
+                    }
+
+                    written += transcode<From, To>(in, out.subspan(written), policy).written;
+                }
+
+                out_offsets[++row] = static_cast<outOffsetT>(written);
+
+                continue;
+            }
+
+            std::size_t first = row;
+            std::size_t last = row;
+
+            while (last < rows && !column_error(errors, last))
+            {
+                ++last;
+            }
+
+            column_lengths<From, To>(data.data(), offsets, first, last, out_offsets.data(), written);
+
+            auto limit = static_cast<outOffsetT>(out.size());
+
+            row = static_cast<std::size_t>(std::upper_bound(out_offsets.begin() + first + 1, out_offsets.begin() + last + 1, limit) - out_offsets.begin()) - 1;
+
+            std::size_t length = static_cast<std::size_t>(out_offsets[row]) - written;
+
+            transcode<From, To>(row_span(first, row), out.subspan(written, length));
+            written += length;
+
+            if (row < rows && !column_error(errors, row))
+            {
+                return { row, written, count, transcode_status::insufficient };
+            }
+        }
+
+        return { rows, written, count, transcode_status::ok };
+    }
+
+}
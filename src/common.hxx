@@ -46,4 +46,188 @@ namespace xtual
         return !is_surrogate(ch) && ch <= U'\x10ffff';
     }
 
+    enum class transcode_status
+    {
+        ok,
+        invalid,
+        incomplete,
+        insufficient
+    };
+
+    enum class error_policy
+    {
+        strict,
+        replace
+    };
+
+#if defined(XTUAL_ENABLE_STATS)
+    inline void stats_count_error(transcode_status status);
+#endif
+
+    // Counts a decoding failure of the given kind when statistics are
+    // enabled, and returns std::nullopt for the failing decoder to return.
+    constexpr std::nullopt_t decode_error(transcode_status status)
+    {
+#if defined(XTUAL_ENABLE_STATS)
+        if (!std::is_constant_evaluated())
+        {
+            stats_count_error(status);
+        }
+#else
+        static_cast<void>(status);
+#endif
+
+        return std::nullopt;
+    }
+
+    struct transcode_result
+    {
+        std::size_t read;
+        std::size_t written;
+        transcode_status status;
+    };
+
+    template <typename From, typename To>
+    struct transcode_kernel
+    {
+        static void run(const typename From::unit_type *&, const typename From::unit_type *, typename To::unit_type *&, typename To::unit_type *)
+        {
+        }
+    };
+
+    template <typename Codec>
+    constexpr bool can_encode(char32_t ch)
+    {
+        if constexpr (requires { Codec::can_encode(ch); })
+        {
+            return Codec::can_encode(ch);
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    template <typename Codec>
+    constexpr char32_t replacement_character()
+    {
+        if constexpr (requires { Codec::replacement; })
+        {
+            return Codec::replacement;
+        }
+        else
+        {
+            return U'\xfffd';
+        }
+    }
+
+    template <typename Codec>
+    constexpr std::size_t skip_length(const typename Codec::unit_type *p, const typename Codec::unit_type *e)
+    {
+        const auto *q = p;
+        char32_t ch;
+
+        if (Codec::decode(q, e, ch) == transcode_status::ok)
+        {
+            return static_cast<std::size_t>(q - p);
+        }
+
+        return Codec::ill_formed_length(p, e);
+    }
+
+    constexpr std::uint16_t byteswap(std::uint16_t u)
+    {
+        return static_cast<std::uint16_t>((u << 8) | (u >> 8));
+    }
+
+    constexpr std::uint32_t byteswap(std::uint32_t u)
+    {
+        return (u << 24) | ((u & 0xff00) << 8) | ((u >> 8) & 0xff00) | (u >> 24);
+    }
+
+    template <typename Iter, typename Sent, typename unitT>
+    concept contiguous_units =
+        std::contiguous_iterator<Iter>
+        && std::sized_sentinel_for<Sent, Iter>
+        && std::same_as<std::iter_value_t<Iter>, unitT>;
+
+    template <typename Codec, std::contiguous_iterator Iter, std::sized_sentinel_for<Iter> Sent>
+    constexpr std::optional<char32_t> decode_contiguous(Iter &i, Sent s)
+    {
+        if (i == s)
+        {
+            return std::nullopt;
+        }
+
+        const typename Codec::unit_type *p = std::to_address(i);
+        const typename Codec::unit_type *q = p;
+        char32_t ch;
+
+        if (Codec::decode(q, p + (s - i), ch) != transcode_status::ok)
+        {
+            return std::nullopt;
+        }
+
+        i += q - p;
+
+        return ch;
+    }
+
+    template <typename Codec, std::contiguous_iterator Iter, std::sized_sentinel_for<Iter> Sent>
+    constexpr bool encode_contiguous(Iter &i, Sent s, char32_t ch)
+    {
+        if (i == s || !is_code_point(ch))
+        {
+            return false;
+        }
+
+        typename Codec::unit_type *p = std::to_address(i);
+        typename Codec::unit_type *q = p;
+
+        if (!Codec::encode(q, p + (s - i), ch))
+        {
+            return false;
+        }
+
+        i += q - p;
+
+        return true;
+    }
+
+    template <std::bidirectional_iterator Iter, std::sentinel_for<Iter> Sent, typename Tail, typename Decode>
+    constexpr std::optional<char32_t> decode_backward(Iter &i, Sent s, std::size_t width, std::size_t max_length, Tail is_tail, Decode decode)
+    {
+        Iter j = i;
+
+        for (std::size_t n = 0; n < max_length; ++n)
+        {
+            for (std::size_t k = 0; k < width; ++k)
+            {
+                if (j == s)
+                {
+                    return std::nullopt;
+                }
+
+                --j;
+            }
+
+            if (j == s || !is_tail(j))
+            {
+                break;
+            }
+        }
+
+        Iter k = j;
+        auto ch = decode(k, i);
+
+        if (!ch.has_value() || k != i)
+        {
+            return std::nullopt;
+        }
+
+        i = j;
+
+        return ch;
+    }
+
 }
@@ -0,0 +1,21 @@
+m4_include(`common.hxx')
+m4_include(`cpu.hxx')
+m4_include(`utf32.hxx')
+m4_include(`utf16.hxx')
+m4_include(`utf8.hxx')
+m4_include(`endian.hxx')
+m4_include(`latin1.hxx')
+m4_include(`u16u8.hxx')
+m4_include(`count.hxx')
+m4_include(`stats.hxx')
+m4_include(`transcode.hxx')
+m4_include(`cstring.hxx')
+m4_include(`literal.hxx')
+m4_include(`validate.hxx')
+m4_include(`parallel.hxx')
+m4_include(`detect.hxx')
+m4_include(`index.hxx')
+m4_include(`convert.hxx')
+m4_include(`column.hxx')
+m4_include(`stream.hxx')
+m4_include(`views.hxx')
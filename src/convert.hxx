@@ -0,0 +1,115 @@
+namespace xtual
+{
+
+    template <typename T>
+    concept unicode_string_like =
+        std::convertible_to<const T &, std::u8string_view>
+        || std::convertible_to<const T &, std::u16string_view>
+        || std::convertible_to<const T &, std::u32string_view>;
+
+    template <typename From, typename To, typename Container>
+    std::optional<Container> convert_units(std::span<const typename From::unit_type> in, error_policy policy, Container out)
+    {
+        out.resize(converted_length<From, To>(in));
+
+        transcode_result r = transcode<From, To>(in, std::span(out.data(), out.size()), policy);
+
+        if (r.status == transcode_status::ok)
+        {
+            out.resize(r.written);
+
+            return out;
+        }
+
+        if (r.status != transcode_status::insufficient)
+        {
+            return std::nullopt;
+        }
+
+        transcode_result rest = transcode_measure<From, To>(in.subspan(r.read), policy);
+
+        if (rest.status != transcode_status::ok)
+        {
+            return std::nullopt;
+        }
+
+        out.resize(r.written + rest.written);
+        transcode<From, To>(in.subspan(r.read), std::span(out.data() + r.written, rest.written), policy);
+
+        return out;
+    }
+
+    template <typename To, typename Container, unicode_string_like Source>
+    std::optional<Container> convert_string(const Source &in, error_policy policy, Container out)
+    {
+        if constexpr (std::convertible_to<const Source &, std::u8string_view>)
+        {
+            std::u8string_view s = in;
+
+            return convert_units<u8_codec, To>(std::span(s.data(), s.size()), policy, std::move(out));
+        }
+        else if constexpr (std::convertible_to<const Source &, std::u16string_view>)
+        {
+            std::u16string_view s = in;
+
+            return convert_units<u16_codec, To>(std::span(s.data(), s.size()), policy, std::move(out));
+        }
+        else
+        {
+            std::u32string_view s = in;
+
+            return convert_units<u32_codec, To>(std::span(s.data(), s.size()), policy, std::move(out));
+        }
+    }
+
+    // Source is always deduced; its default only keeps GCC 12 from dropping
+    // the defaults before it when this is exported from a module.
+    template <typename Alloc = std::allocator<char8_t>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::basic_string<char8_t, std::char_traits<char8_t>, Alloc>> to_u8string(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<u8_codec>(in, policy, std::basic_string<char8_t, std::char_traits<char8_t>, Alloc>(alloc));
+    }
+
+    template <typename Alloc = std::allocator<char16_t>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::basic_string<char16_t, std::char_traits<char16_t>, Alloc>> to_u16string(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<u16_codec>(in, policy, std::basic_string<char16_t, std::char_traits<char16_t>, Alloc>(alloc));
+    }
+
+    template <typename Alloc = std::allocator<char32_t>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::basic_string<char32_t, std::char_traits<char32_t>, Alloc>> to_u32string(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<u32_codec>(in, policy, std::basic_string<char32_t, std::char_traits<char32_t>, Alloc>(alloc));
+    }
+
+    template <byte_like byteT = std::byte, typename Alloc = std::allocator<byteT>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::vector<byteT, Alloc>> to_b8_bytes(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<b8_codec<byteT>>(in, policy, std::vector<byteT, Alloc>(alloc));
+    }
+
+    template <byte_like byteT = std::byte, typename Alloc = std::allocator<byteT>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::vector<byteT, Alloc>> to_b16be_bytes(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<b16be_codec<byteT>>(in, policy, std::vector<byteT, Alloc>(alloc));
+    }
+
+    template <byte_like byteT = std::byte, typename Alloc = std::allocator<byteT>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::vector<byteT, Alloc>> to_b16le_bytes(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<b16le_codec<byteT>>(in, policy, std::vector<byteT, Alloc>(alloc));
+    }
+
+    template <byte_like byteT = std::byte, typename Alloc = std::allocator<byteT>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::vector<byteT, Alloc>> to_b32be_bytes(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<b32be_codec<byteT>>(in, policy, std::vector<byteT, Alloc>(alloc));
+    }
+
+    template <byte_like byteT = std::byte, typename Alloc = std::allocator<byteT>, unicode_string_like Source = std::u8string_view>
+    std::optional<std::vector<byteT, Alloc>> to_b32le_bytes(const Source &in, error_policy policy = error_policy::strict, const Alloc &alloc = Alloc())
+    {
+        return convert_string<b32le_codec<byteT>>(in, policy, std::vector<byteT, Alloc>(alloc));
+    }
+
+}
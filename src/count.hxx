@@ -0,0 +1,666 @@
+namespace xtual
+{
+
+    template <typename charT>
+    constexpr std::size_t utf8_count_scalar(const charT *p, const charT *e, bool astral_twice)
+    {
+        std::size_t n = 0;
+
+        for (; p != e; ++p)
+        {
+            char8_t ch = utf8_codec<charT>::load(p);
+
+            n += is_utf8_tail(ch) ? 0 : 1;
+            n += astral_twice && ch >= static_cast<char8_t>(0xf0) ? 1 : 0;
+        }
+
+        return n;
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <typename charT>
+    XTUAL_TARGET("sse2") std::size_t utf8_count_sse2(const charT *p, const charT *e, bool astral_twice)
+    {
+        const __m128i tail_limit = _mm_set1_epi8(-65);
+        const __m128i astral_lead = _mm_set1_epi8(char(0xf0));
+
+        std::size_t n = 0;
+
+        for (; e - p >= 16; p += 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+            n += std::popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(input, tail_limit))));
+
+            if (astral_twice)
+            {
+                __m128i astral = _mm_cmpeq_epi8(_mm_max_epu8(input, astral_lead), input);
+
+                n += std::popcount(static_cast<unsigned>(_mm_movemask_epi8(astral)));
+            }
+        }
+
+        return n + utf8_count_scalar(p, e, astral_twice);
+    }
+
+    template <typename charT>
+    XTUAL_TARGET("avx2") std::size_t utf8_count_avx2(const charT *p, const charT *e, bool astral_twice)
+    {
+        const __m256i tail_limit = _mm256_set1_epi8(-65);
+        const __m256i astral_lead = _mm256_set1_epi8(char(0xf0));
+
+        std::size_t n = 0;
+
+        for (; e - p >= 32; p += 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+
+            n += std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(input, tail_limit))));
+
+            if (astral_twice)
+            {
+                __m256i astral = _mm256_cmpeq_epi8(_mm256_max_epu8(input, astral_lead), input);
+
+                n += std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(astral)));
+            }
+        }
+
+        return n + utf8_count_sse2(p, e, astral_twice);
+    }
+
+#endif
+
+    template <typename charT>
+    constexpr std::size_t utf8_count(const charT *p, const charT *e, bool astral_twice)
+    {
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                return utf8_count_avx2(p, e, astral_twice);
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                return utf8_count_sse2(p, e, astral_twice);
+            default:
+                break;
+            }
+        }
+#endif
+
+        return utf8_count_scalar(p, e, astral_twice);
+    }
+
+    constexpr std::size_t count_code_points_u8(std::span<const char8_t> in)
+    {
+        return utf8_count(in.data(), in.data() + in.size(), false);
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t count_code_points_b8(std::span<const byteT> in)
+    {
+        return utf8_count(in.data(), in.data() + in.size(), false);
+    }
+
+    constexpr std::size_t utf16_length_from_u8(std::span<const char8_t> in)
+    {
+        return utf8_count(in.data(), in.data() + in.size(), true);
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t utf16_length_from_b8(std::span<const byteT> in)
+    {
+        return utf8_count(in.data(), in.data() + in.size(), true);
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    XTUAL_TARGET("sse2") inline std::size_t count_code_points_u16_sse2(const char16_t *&p, const char16_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m128i mask = _mm_set1_epi16(static_cast<short>(0xfc00));
+        const __m128i low = _mm_set1_epi16(static_cast<short>(0xdc00));
+
+        for (; e - p >= 8; p += 8)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i tails = _mm_cmpeq_epi16(_mm_and_si128(input, mask), low);
+
+            n += 8 - std::popcount(static_cast<unsigned>(_mm_movemask_epi8(tails))) / 2;
+        }
+
+        return n;
+    }
+
+    XTUAL_TARGET("avx2") inline std::size_t count_code_points_u16_avx2(const char16_t *&p, const char16_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m256i mask = _mm256_set1_epi16(static_cast<short>(0xfc00));
+        const __m256i low = _mm256_set1_epi16(static_cast<short>(0xdc00));
+
+        for (; e - p >= 16; p += 16)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i tails = _mm256_cmpeq_epi16(_mm256_and_si256(input, mask), low);
+
+            n += 16 - std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(tails))) / 2;
+        }
+
+        return n + count_code_points_u16_sse2(p, e);
+    }
+
+#endif
+
+    constexpr std::size_t count_code_points_u16(std::span<const char16_t> in)
+    {
+        std::size_t n = 0;
+        const char16_t *p = in.data();
+        const char16_t *e = p + in.size();
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                n += count_code_points_u16_avx2(p, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                n += count_code_points_u16_sse2(p, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        for (; p != e; ++p)
+        {
+            n += is_low_surrogate(*p) ? 0 : 1;
+        }
+
+        return n;
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    XTUAL_TARGET("sse2") inline std::size_t utf8_length_from_u16_sse2(const char16_t *&p, const char16_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i above_1 = _mm_set1_epi16(static_cast<short>(0xff80));
+        const __m128i above_2 = _mm_set1_epi16(static_cast<short>(0xf800));
+        const __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xd800));
+
+        for (; e - p >= 8; p += 8)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i narrow_1 = _mm_cmpeq_epi16(_mm_and_si128(input, above_1), zero);
+            __m128i narrow_2 = _mm_cmpeq_epi16(_mm_and_si128(input, above_2), zero);
+            __m128i surrogates = _mm_cmpeq_epi16(_mm_and_si128(input, above_2), surrogate);
+
+            std::size_t ones = std::popcount(static_cast<unsigned>(_mm_movemask_epi8(narrow_1))) / 2;
+            std::size_t twos = std::popcount(static_cast<unsigned>(_mm_movemask_epi8(narrow_2))) / 2;
+            std::size_t halves = std::popcount(static_cast<unsigned>(_mm_movemask_epi8(surrogates))) / 2;
+
+            n += 24 - ones - twos - halves;
+        }
+
+        return n;
+    }
+
+    XTUAL_TARGET("avx2") inline std::size_t utf8_length_from_u16_avx2(const char16_t *&p, const char16_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i above_1 = _mm256_set1_epi16(static_cast<short>(0xff80));
+        const __m256i above_2 = _mm256_set1_epi16(static_cast<short>(0xf800));
+        const __m256i surrogate = _mm256_set1_epi16(static_cast<short>(0xd800));
+
+        for (; e - p >= 16; p += 16)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i narrow_1 = _mm256_cmpeq_epi16(_mm256_and_si256(input, above_1), zero);
+            __m256i narrow_2 = _mm256_cmpeq_epi16(_mm256_and_si256(input, above_2), zero);
+            __m256i surrogates = _mm256_cmpeq_epi16(_mm256_and_si256(input, above_2), surrogate);
+
+            std::size_t ones = std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_1))) / 2;
+            std::size_t twos = std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_2))) / 2;
+            std::size_t halves = std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(surrogates))) / 2;
+
+            n += 48 - ones - twos - halves;
+        }
+
+        return n + utf8_length_from_u16_sse2(p, e);
+    }
+
+#endif
+
+    constexpr std::size_t utf8_length_from_u16(std::span<const char16_t> in)
+    {
+        std::size_t n = 0;
+        const char16_t *p = in.data();
+        const char16_t *e = p + in.size();
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                n += utf8_length_from_u16_avx2(p, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                n += utf8_length_from_u16_sse2(p, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        for (; p != e; ++p)
+        {
+            n += is_surrogate(*p) ? 2 : utf8_width(*p);
+        }
+
+        return n;
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    XTUAL_TARGET("sse2") inline std::size_t utf8_length_from_u32_sse2(const char32_t *&p, const char32_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i above_1 = _mm_set1_epi32(static_cast<int>(0xffffff80));
+        const __m128i above_2 = _mm_set1_epi32(static_cast<int>(0xfffff800));
+        const __m128i above_3 = _mm_set1_epi32(static_cast<int>(0xffff0000));
+
+        for (; e - p >= 4; p += 4)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i narrow_1 = _mm_cmpeq_epi32(_mm_and_si128(input, above_1), zero);
+            __m128i narrow_2 = _mm_cmpeq_epi32(_mm_and_si128(input, above_2), zero);
+            __m128i narrow_3 = _mm_cmpeq_epi32(_mm_and_si128(input, above_3), zero);
+
+            std::size_t narrow = std::popcount(static_cast<unsigned>(_mm_movemask_epi8(narrow_1)))
+                + std::popcount(static_cast<unsigned>(_mm_movemask_epi8(narrow_2)))
+                + std::popcount(static_cast<unsigned>(_mm_movemask_epi8(narrow_3)));
+
+            n += 16 - narrow / 4;
+        }
+
+        return n;
+    }
+
+    XTUAL_TARGET("avx2") inline std::size_t utf8_length_from_u32_avx2(const char32_t *&p, const char32_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i above_1 = _mm256_set1_epi32(static_cast<int>(0xffffff80));
+        const __m256i above_2 = _mm256_set1_epi32(static_cast<int>(0xfffff800));
+        const __m256i above_3 = _mm256_set1_epi32(static_cast<int>(0xffff0000));
+
+        for (; e - p >= 8; p += 8)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i narrow_1 = _mm256_cmpeq_epi32(_mm256_and_si256(input, above_1), zero);
+            __m256i narrow_2 = _mm256_cmpeq_epi32(_mm256_and_si256(input, above_2), zero);
+            __m256i narrow_3 = _mm256_cmpeq_epi32(_mm256_and_si256(input, above_3), zero);
+
+            std::size_t narrow = std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_1)))
+                + std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_2)))
+                + std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(narrow_3)));
+
+            n += 32 - narrow / 4;
+        }
+
+        return n + utf8_length_from_u32_sse2(p, e);
+    }
+
+#endif
+
+    constexpr std::size_t utf8_length_from_u32(std::span<const char32_t> in)
+    {
+        std::size_t n = 0;
+        const char32_t *p = in.data();
+        const char32_t *e = p + in.size();
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                n += utf8_length_from_u32_avx2(p, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                n += utf8_length_from_u32_sse2(p, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        for (; p != e; ++p)
+        {
+            n += utf8_width(*p);
+        }
+
+        return n;
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    XTUAL_TARGET("sse2") inline std::size_t utf16_length_from_u32_sse2(const char32_t *&p, const char32_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i above_bmp = _mm_set1_epi32(static_cast<int>(0xffff0000));
+
+        for (; e - p >= 4; p += 4)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i bmp = _mm_cmpeq_epi32(_mm_and_si128(input, above_bmp), zero);
+
+            n += 8 - std::popcount(static_cast<unsigned>(_mm_movemask_epi8(bmp))) / 4;
+        }
+
+        return n;
+    }
+
+    XTUAL_TARGET("avx2") inline std::size_t utf16_length_from_u32_avx2(const char32_t *&p, const char32_t *e)
+    {
+        std::size_t n = 0;
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i above_bmp = _mm256_set1_epi32(static_cast<int>(0xffff0000));
+
+        for (; e - p >= 8; p += 8)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i bmp = _mm256_cmpeq_epi32(_mm256_and_si256(input, above_bmp), zero);
+
+            n += 16 - std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(bmp))) / 4;
+        }
+
+        return n + utf16_length_from_u32_sse2(p, e);
+    }
+
+#endif
+
+    constexpr std::size_t utf16_length_from_u32(std::span<const char32_t> in)
+    {
+        std::size_t n = 0;
+        const char32_t *p = in.data();
+        const char32_t *e = p + in.size();
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                n += utf16_length_from_u32_avx2(p, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                n += utf16_length_from_u32_sse2(p, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        for (; p != e; ++p)
+        {
+            n += (*p & ~U'\xffff') == 0 ? 1 : 2;
+        }
+
+        return n;
+    }
+
+    struct unit_match
+    {
+        std::uint32_t mask;
+        std::uint32_t value;
+    };
+
+    // Rewrites a match on unit values as a match on width-byte units read
+    // from memory in native order, so byte-order codecs need no swap.
+    template <std::size_t width, std::endian order>
+    constexpr unit_match stored_match(unit_match m)
+    {
+        if constexpr (width == 2 && order != std::endian::native)
+        {
+            return { byteswap(static_cast<std::uint16_t>(m.mask)), byteswap(static_cast<std::uint16_t>(m.value)) };
+        }
+        else if constexpr (width == 4 && order != std::endian::native)
+        {
+            return { byteswap(m.mask), byteswap(m.value) };
+        }
+        else
+        {
+            return m;
+        }
+    }
+
+    template <std::size_t width>
+    std::uint32_t load_stored_unit(const std::byte *p)
+    {
+        if constexpr (width == 1)
+        {
+            return static_cast<std::uint32_t>(*p);
+        }
+        else if constexpr (width == 2)
+        {
+            std::uint16_t u;
+            std::memcpy(&u, p, 2);
+
+            return u;
+        }
+        else
+        {
+            std::uint32_t u;
+            std::memcpy(&u, p, 4);
+
+            return u;
+        }
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <std::size_t width>
+    XTUAL_TARGET("sse2") inline std::size_t match_bits_sse2(__m128i x, unit_match m)
+    {
+        __m128i masked = _mm_and_si128(x, _mm_set1_epi32(static_cast<int>(m.mask * (width == 1 ? 0x01010101 : width == 2 ? 0x10001 : 1))));
+        __m128i value = _mm_set1_epi32(static_cast<int>(m.value * (width == 1 ? 0x01010101 : width == 2 ? 0x10001 : 1)));
+        __m128i matched = width == 1 ? _mm_cmpeq_epi8(masked, value) : width == 2 ? _mm_cmpeq_epi16(masked, value) : _mm_cmpeq_epi32(masked, value);
+
+        return static_cast<std::size_t>(std::popcount(static_cast<unsigned>(_mm_movemask_epi8(matched))));
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("avx2") inline std::size_t match_bits_avx2(__m256i x, unit_match m)
+    {
+        __m256i masked = _mm256_and_si256(x, _mm256_set1_epi32(static_cast<int>(m.mask * (width == 1 ? 0x01010101 : width == 2 ? 0x10001 : 1))));
+        __m256i value = _mm256_set1_epi32(static_cast<int>(m.value * (width == 1 ? 0x01010101 : width == 2 ? 0x10001 : 1)));
+        __m256i matched = width == 1 ? _mm256_cmpeq_epi8(masked, value) : width == 2 ? _mm256_cmpeq_epi16(masked, value) : _mm256_cmpeq_epi32(masked, value);
+
+        return static_cast<std::size_t>(std::popcount(static_cast<std::uint32_t>(_mm256_movemask_epi8(matched))));
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("sse2") std::array<std::size_t, 2> count_matching_units_sse2(const std::byte *&p, const std::byte *e, unit_match first, unit_match second)
+    {
+        std::array<std::size_t, 2> n {};
+
+        for (; e - p >= 16; p += 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+            n[0] += match_bits_sse2<width>(input, first);
+            n[1] += match_bits_sse2<width>(input, second);
+        }
+
+        return { n[0] / width, n[1] / width };
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("avx2") std::array<std::size_t, 2> count_matching_units_avx2(const std::byte *&p, const std::byte *e, unit_match first, unit_match second)
+    {
+        std::array<std::size_t, 2> n {};
+
+        for (; e - p >= 32; p += 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+
+            n[0] += match_bits_avx2<width>(input, first);
+            n[1] += match_bits_avx2<width>(input, second);
+        }
+
+        return { n[0] / width, n[1] / width };
+    }
+
+#endif
+
+    // Counts, in one pass, the width-byte units in [b, e) matching each of
+    // two masks; order is the byte order the units are stored in.
+    template <std::size_t width, std::endian order, typename unitT>
+    std::array<std::size_t, 2> count_matching_units(const unitT *b, const unitT *e, unit_match first, unit_match second)
+    {
+        const auto *p = reinterpret_cast<const std::byte *>(b);
+        const auto *pe = reinterpret_cast<const std::byte *>(e);
+
+        first = stored_match<width, order>(first);
+        second = stored_match<width, order>(second);
+
+        std::array<std::size_t, 2> n {};
+
+#if defined(XTUAL_X86_SIMD)
+        switch (active_simd_level())
+        {
+        case simd_level::avx2:
+            n = count_matching_units_avx2<width>(p, pe, first, second);
+            break;
+        case simd_level::ssse3:
+        case simd_level::sse2:
+            n = count_matching_units_sse2<width>(p, pe, first, second);
+            break;
+        default:
+            break;
+        }
+#endif
+
+        for (; static_cast<std::size_t>(pe - p) >= width; p += width)
+        {
+            std::uint32_t u = load_stored_unit<width>(p);
+
+            n[0] += (u & first.mask) == first.value;
+            n[1] += (u & second.mask) == second.value;
+        }
+
+        return n;
+    }
+
+    template <typename Codec>
+    struct encoding_form;
+
+    template <typename charT, typename Engine>
+    struct encoding_form<utf8_codec<charT, Engine>>
+    {
+        static constexpr std::size_t bits = 8;
+        static constexpr std::size_t units = 1;
+    };
+
+    template <>
+    struct encoding_form<u16_codec>
+    {
+        static constexpr std::size_t bits = 16;
+        static constexpr std::size_t units = 1;
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct encoding_form<b16_codec<byteT, order>>
+    {
+        static constexpr std::size_t bits = 16;
+        static constexpr std::size_t units = 2;
+    };
+
+    template <>
+    struct encoding_form<u32_codec>
+    {
+        static constexpr std::size_t bits = 32;
+        static constexpr std::size_t units = 1;
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct encoding_form<b32_codec<byteT, order>>
+    {
+        static constexpr std::size_t bits = 32;
+        static constexpr std::size_t units = 4;
+    };
+
+    template <typename From, typename To>
+    concept countable_conversion = requires {
+        encoding_form<From>::bits;
+        encoding_form<To>::bits;
+    } && (encoding_form<From>::units == 1 || encoding_form<From>::bits == encoding_form<To>::bits);
+
+    template <typename From, typename To>
+        requires countable_conversion<From, To>
+    constexpr std::size_t converted_length(std::span<const typename From::unit_type> in)
+    {
+        constexpr std::size_t from = encoding_form<From>::bits;
+        constexpr std::size_t to = encoding_form<To>::bits;
+
+        std::size_t n = in.size();
+
+        if constexpr (from == to)
+        {
+            n = in.size() / encoding_form<From>::units;
+        }
+        else if constexpr (from == 8 && to == 16)
+        {
+            n = utf8_count(in.data(), in.data() + in.size(), true);
+        }
+        else if constexpr (from == 8 && to == 32)
+        {
+            n = utf8_count(in.data(), in.data() + in.size(), false);
+        }
+        else if constexpr (from == 16 && to == 8)
+        {
+            n = utf8_length_from_u16(in);
+        }
+        else if constexpr (from == 16 && to == 32)
+        {
+            n = count_code_points_u16(in);
+        }
+        else if constexpr (from == 32 && to == 8)
+        {
+            n = utf8_length_from_u32(in);
+        }
+        else if constexpr (from == 32 && to == 16)
+        {
+            n = utf16_length_from_u32(in);
+        }
+
+        return n * encoding_form<To>::units;
+    }
+
+}
@@ -0,0 +1,114 @@
+namespace xtual
+{
+
+    enum class simd_level
+    {
+        scalar,
+        sse2,
+        ssse3,
+        avx2,
+    };
+
+    constexpr std::string_view simd_level_name(simd_level level)
+    {
+        switch (level)
+        {
+        case simd_level::sse2:
+            return "sse2";
+        case simd_level::ssse3:
+            return "ssse3";
+        case simd_level::avx2:
+            return "avx2";
+        default:
+            return "scalar";
+        }
+    }
+
+    constexpr std::optional<simd_level> parse_simd_level(std::string_view name)
+    {
+        for (simd_level level : { simd_level::scalar, simd_level::sse2, simd_level::ssse3, simd_level::avx2 })
+        {
+            // std::ranges::equal rather than ==, which GCC 12 cannot
+            // instantiate in a module importer that includes <string_view>.
+            if (std::ranges::equal(simd_level_name(level), name))
+            {
+                return level;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    // Reads the CPUID feature bits directly; AVX2 also needs the OS to save
+    // the YMM registers, which XGETBV reports.
+    inline simd_level detect_simd_level()
+    {
+#if defined(XTUAL_X86_SIMD)
+        unsigned int a, b, c, d;
+
+        if (__get_cpuid(1, &a, &b, &c, &d) == 0)
+        {
+            return simd_level::scalar;
+        }
+
+        bool sse2 = (d >> 26 & 1) != 0;
+        bool ssse3 = (c >> 9 & 1) != 0;
+        bool avx = (c >> 27 & 1) != 0 && (c >> 28 & 1) != 0;
+
+        if (avx)
+        {
+            unsigned int low, high;
+
+            __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+            avx = (low & 6) == 6;
+        }
+
+        if (avx && __get_cpuid_count(7, 0, &a, &b, &c, &d) != 0 && (b >> 5 & 1) != 0)
+        {
+            return simd_level::avx2;
+        }
+
+        if (ssse3)
+        {
+            return simd_level::ssse3;
+        }
+
+        if (sse2)
+        {
+            return simd_level::sse2;
+        }
+#endif
+
+        return simd_level::scalar;
+    }
+
+    XTUAL_HEADER_INLINE std::atomic<int> simd_level_state = -1;
+
+    XTUAL_HEADER_INLINE simd_level set_simd_level(simd_level level)
+    {
+        level = std::min(level, detect_simd_level());
+        simd_level_state.store(static_cast<int>(level), std::memory_order_relaxed);
+
+        return level;
+    }
+
+    XTUAL_HEADER_INLINE simd_level active_simd_level()
+    {
+        int state = simd_level_state.load(std::memory_order_relaxed);
+
+        if (state >= 0)
+        {
+            return static_cast<simd_level>(state);
+        }
+
+        simd_level level = simd_level::avx2;
+
+        if (const char *name = std::getenv("XTUAL_SIMD_LEVEL"))
+        {
+            level = parse_simd_level(name).value_or(level);
+        }
+
+        return set_simd_level(level);
+    }
+
+}
@@ -0,0 +1,427 @@
+namespace xtual
+{
+
+    struct null_sentinel
+    {
+        template <std::input_iterator Iter>
+            requires std::equality_comparable<std::iter_value_t<Iter>>
+        friend constexpr bool operator==(const Iter &i, null_sentinel)
+        {
+            return *i == std::iter_value_t<Iter>();
+        }
+    };
+
+    struct null_scan
+    {
+        std::size_t length;
+        std::size_t ascii;
+        bool terminated;
+    };
+
+    template <typename unitT>
+    constexpr null_scan scan_null_terminated_scalar(const unitT *p, std::size_t limit)
+    {
+        null_scan scan { 0, limit, false };
+
+        for (std::size_t k = 0; k < limit; ++k)
+        {
+            auto u = unit_value(p + k);
+
+            if (u == 0)
+            {
+                scan.terminated = true;
+                scan.ascii = std::min(scan.ascii, k);
+                scan.length = k;
+
+                return scan;
+            }
+
+            if (u >= 0x80 && scan.ascii == limit)
+            {
+                scan.ascii = k;
+            }
+        }
+
+        scan.length = limit;
+
+        return scan;
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <typename unitT>
+    XTUAL_TARGET("sse2") inline __m128i cmpeq_units_sse2(__m128i x, __m128i y)
+    {
+        if constexpr (sizeof(unitT) == 1)
+        {
+            return _mm_cmpeq_epi8(x, y);
+        }
+        else if constexpr (sizeof(unitT) == 2)
+        {
+            return _mm_cmpeq_epi16(x, y);
+        }
+        else
+        {
+            return _mm_cmpeq_epi32(x, y);
+        }
+    }
+
+    template <typename unitT>
+    XTUAL_TARGET("avx2") inline __m256i cmpeq_units_avx2(__m256i x, __m256i y)
+    {
+        if constexpr (sizeof(unitT) == 1)
+        {
+            return _mm256_cmpeq_epi8(x, y);
+        }
+        else if constexpr (sizeof(unitT) == 2)
+        {
+            return _mm256_cmpeq_epi16(x, y);
+        }
+        else
+        {
+            return _mm256_cmpeq_epi32(x, y);
+        }
+    }
+
+    constexpr null_scan finish_null_scan(std::size_t zero, std::size_t ascii, std::size_t limit)
+    {
+        if (zero < limit)
+        {
+            return { zero, std::min(ascii, zero), true };
+        }
+
+        return { limit, std::min(ascii, limit), false };
+    }
+
+    template <typename unitT>
+    XTUAL_TARGET("sse2") [[gnu::no_sanitize_address]] null_scan scan_null_terminated_sse2(const unitT *p, std::size_t limit)
+    {
+        auto address = reinterpret_cast<std::uintptr_t>(p);
+        const auto *block = reinterpret_cast<const char *>(address & ~static_cast<std::uintptr_t>(15));
+        auto skip = static_cast<std::size_t>(address & 15);
+        std::size_t bytes = limit < SIZE_MAX / sizeof(unitT) - 64 ? limit * sizeof(unitT) + skip : SIZE_MAX;
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i high = sizeof(unitT) == 2 ? _mm_set1_epi16(static_cast<short>(0xff80)) : _mm_set1_epi32(~0x7f);
+
+        std::uint32_t keep = ~0u << skip;
+        std::size_t ascii = limit;
+
+        for (std::size_t offset = 0; offset < bytes; offset += 16)
+        {
+            __m128i x = _mm_load_si128(reinterpret_cast<const __m128i *>(block + offset));
+
+            auto zeros = static_cast<std::uint32_t>(_mm_movemask_epi8(cmpeq_units_sse2<unitT>(x, zero))) & keep;
+            std::uint32_t wide;
+
+            if constexpr (sizeof(unitT) == 1)
+            {
+                wide = static_cast<std::uint32_t>(_mm_movemask_epi8(x)) & keep;
+            }
+            else
+            {
+                wide = ~static_cast<std::uint32_t>(_mm_movemask_epi8(cmpeq_units_sse2<unitT>(_mm_and_si128(x, high), zero))) & 0xffff & keep;
+            }
+
+            keep = ~0u;
+
+            if (wide != 0 && ascii == limit)
+            {
+                ascii = (offset + std::countr_zero(wide) - skip) / sizeof(unitT);
+            }
+
+            if (zeros != 0)
+            {
+                return finish_null_scan((offset + std::countr_zero(zeros) - skip) / sizeof(unitT), ascii, limit);
+            }
+        }
+
+        return finish_null_scan(limit, ascii, limit);
+    }
+
+    template <typename unitT>
+    XTUAL_TARGET("avx2") [[gnu::no_sanitize_address]] null_scan scan_null_terminated_avx2(const unitT *p, std::size_t limit)
+    {
+        auto address = reinterpret_cast<std::uintptr_t>(p);
+        const auto *block = reinterpret_cast<const char *>(address & ~static_cast<std::uintptr_t>(31));
+        auto skip = static_cast<std::size_t>(address & 31);
+        std::size_t bytes = limit < SIZE_MAX / sizeof(unitT) - 64 ? limit * sizeof(unitT) + skip : SIZE_MAX;
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i high = sizeof(unitT) == 2 ? _mm256_set1_epi16(static_cast<short>(0xff80)) : _mm256_set1_epi32(~0x7f);
+
+        std::uint32_t keep = ~0u << skip;
+        std::size_t ascii = limit;
+
+        for (std::size_t offset = 0; offset < bytes; offset += 32)
+        {
+            __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i *>(block + offset));
+
+            auto zeros = static_cast<std::uint32_t>(_mm256_movemask_epi8(cmpeq_units_avx2<unitT>(x, zero))) & keep;
+            std::uint32_t wide;
+
+            if constexpr (sizeof(unitT) == 1)
+            {
+                wide = static_cast<std::uint32_t>(_mm256_movemask_epi8(x)) & keep;
+            }
+            else
+            {
+                wide = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(cmpeq_units_avx2<unitT>(_mm256_and_si256(x, high), zero))) & keep;
+            }
+
+            keep = ~0u;
+
+            if (wide != 0 && ascii == limit)
+            {
+                ascii = (offset + std::countr_zero(wide) - skip) / sizeof(unitT);
+            }
+
+            if (zeros != 0)
+            {
+                return finish_null_scan((offset + std::countr_zero(zeros) - skip) / sizeof(unitT), ascii, limit);
+            }
+        }
+
+        return finish_null_scan(limit, ascii, limit);
+    }
+
+#endif
+
+    template <typename unitT>
+    constexpr null_scan scan_null_terminated(const unitT *p, std::size_t limit = SIZE_MAX / sizeof(unitT))
+    {
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                return scan_null_terminated_avx2(p, limit);
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                return scan_null_terminated_sse2(p, limit);
+            default:
+                break;
+            }
+        }
+#endif
+
+        return scan_null_terminated_scalar(p, limit);
+    }
+
+    template <typename unitT>
+    constexpr std::size_t null_terminated_length(const unitT *p)
+    {
+        return scan_null_terminated(p).length;
+    }
+
+    template <typename Codec>
+    struct null_terminator
+    {
+        static constexpr std::size_t width = 1;
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct null_terminator<b16_codec<byteT, order>>
+    {
+        static constexpr std::size_t width = 2;
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct null_terminator<b32_codec<byteT, order>>
+    {
+        static constexpr std::size_t width = 4;
+    };
+
+    template <std::size_t width, byte_like byteT>
+    constexpr null_scan scan_null_terminated_bytes_scalar(const byteT *p, std::size_t limit)
+    {
+        for (std::size_t k = 0; k + width <= limit; k += width)
+        {
+            std::size_t z = 0;
+
+            while (z < width && static_cast<std::byte>(p[k + z]) == std::byte(0))
+            {
+                ++z;
+            }
+
+            if (z == width)
+            {
+                return { k, 0, true };
+            }
+        }
+
+        return { limit, 0, false };
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <std::size_t width>
+    constexpr std::uint64_t zero_unit_starts(std::uint64_t zeros, std::size_t skip)
+    {
+        std::uint64_t run = zeros & zeros >> 1;
+
+        if constexpr (width == 4)
+        {
+            run &= run >> 2;
+        }
+
+        std::uint64_t phase = width == 2 ? 0x5555555555555555 : 0x1111111111111111;
+
+        return run & phase << (skip % width);
+    }
+
+    template <std::size_t width, byte_like byteT>
+    XTUAL_TARGET("sse2") [[gnu::no_sanitize_address]] null_scan scan_null_terminated_bytes_sse2(const byteT *p, std::size_t limit)
+    {
+        auto address = reinterpret_cast<std::uintptr_t>(p);
+        const auto *block = reinterpret_cast<const char *>(address & ~static_cast<std::uintptr_t>(15));
+        auto skip = static_cast<std::size_t>(address & 15);
+        std::size_t bytes = limit < SIZE_MAX - 64 ? limit + skip : SIZE_MAX;
+
+        std::uint64_t keep = ~std::uint64_t(0) << skip;
+        std::uint64_t prev = 0;
+
+        for (std::size_t offset = 0; offset < bytes; offset += 16)
+        {
+            __m128i x = _mm_load_si128(reinterpret_cast<const __m128i *>(block + offset));
+            auto zeros = static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128()))) & keep;
+
+            keep = ~std::uint64_t(0);
+
+            std::uint64_t starts = zero_unit_starts<width>(prev | zeros << 16, skip) & (0xffffull << (17 - width));
+
+            if (starts != 0)
+            {
+                std::size_t k = offset - 16 + std::countr_zero(starts) - skip;
+
+                return k < limit ? null_scan { k, 0, true } : null_scan { limit, 0, false };
+            }
+
+            prev = zeros;
+        }
+
+        return { limit, 0, false };
+    }
+
+    template <std::size_t width, byte_like byteT>
+    XTUAL_TARGET("avx2") [[gnu::no_sanitize_address]] null_scan scan_null_terminated_bytes_avx2(const byteT *p, std::size_t limit)
+    {
+        auto address = reinterpret_cast<std::uintptr_t>(p);
+        const auto *block = reinterpret_cast<const char *>(address & ~static_cast<std::uintptr_t>(31));
+        auto skip = static_cast<std::size_t>(address & 31);
+        std::size_t bytes = limit < SIZE_MAX - 64 ? limit + skip : SIZE_MAX;
+
+        std::uint64_t keep = ~std::uint64_t(0) << skip;
+        std::uint64_t prev = 0;
+
+        for (std::size_t offset = 0; offset < bytes; offset += 32)
+        {
+            __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i *>(block + offset));
+            auto zeros = static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_setzero_si256())))) & keep;
+
+            keep = ~std::uint64_t(0);
+
+            std::uint64_t starts = zero_unit_starts<width>(prev | zeros << 32, skip) & (0xffffffffull << (33 - width));
+
+            if (starts != 0)
+            {
+                std::size_t k = offset - 32 + std::countr_zero(starts) - skip;
+
+                return k < limit ? null_scan { k, 0, true } : null_scan { limit, 0, false };
+            }
+
+            prev = zeros;
+        }
+
+        return { limit, 0, false };
+    }
+
+#endif
+
+    template <std::size_t width, byte_like byteT>
+    constexpr null_scan scan_null_terminated_bytes(const byteT *p, std::size_t limit)
+    {
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                return scan_null_terminated_bytes_avx2<width>(p, limit);
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                return scan_null_terminated_bytes_sse2<width>(p, limit);
+            default:
+                break;
+            }
+        }
+#endif
+
+        return scan_null_terminated_bytes_scalar<width>(p, limit);
+    }
+
+    template <typename From, typename To>
+    constexpr transcode_result transcode_null_terminated(const typename From::unit_type *in, std::span<typename To::unit_type> out, error_policy policy = error_policy::strict)
+    {
+        using unit_type = typename From::unit_type;
+
+        constexpr std::size_t width = null_terminator<From>::width;
+        constexpr std::size_t chunk = 4096;
+
+        std::size_t read = 0;
+        std::size_t written = 0;
+
+        for (;;)
+        {
+            const unit_type *p = in + read;
+            null_scan scan;
+
+            if constexpr (width == 1)
+            {
+                scan = scan_null_terminated(p, chunk);
+            }
+            else
+            {
+                scan = scan_null_terminated_bytes<width>(p, chunk);
+            }
+
+            std::size_t length = scan.length;
+            transcode_result r;
+
+            if constexpr (sizeof(unit_type) == 1 && width == 1)
+            {
+                if (scan.ascii == length && !std::is_constant_evaluated())
+                {
+                    std::span<const unsigned char> part(reinterpret_cast<const unsigned char *>(p), length);
+
+                    r = transcode<ascii_codec<unsigned char>, To>(part, out.subspan(written), policy);
+                    read += r.read;
+                    written += r.written;
+
+                    if (r.status != transcode_status::ok || scan.terminated)
+                    {
+                        return { read, written, r.status };
+                    }
+
+                    continue;
+                }
+            }
+
+            if (!scan.terminated)
+            {
+                length = static_cast<std::size_t>(From::resync(p, p + length - 1, p + length) - p);
+            }
+
+            r = transcode<From, To>(std::span<const unit_type>(p, length), out.subspan(written), policy);
+            read += r.read;
+            written += r.written;
+
+            if (r.status != transcode_status::ok || scan.terminated)
+            {
+                return { read, written, r.status };
+            }
+        }
+    }
+
+}
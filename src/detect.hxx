@@ -0,0 +1,262 @@
+namespace xtual
+{
+
+    enum class encoding
+    {
+        b8,
+        b16be,
+        b16le,
+        b32be,
+        b32le,
+    };
+
+    struct encoding_candidate
+    {
+        encoding form;
+        unsigned confidence;
+    };
+
+    struct encoding_detection
+    {
+        std::array<encoding_candidate, 5> candidates;
+        std::size_t bom_length;
+
+        constexpr encoding best() const
+        {
+            return candidates[0].form;
+        }
+    };
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <byte_like byteT>
+    XTUAL_TARGET("sse2") void count_zero_bytes_sse2(const byteT *&p, const byteT *e, std::array<std::size_t, 4> &zeros)
+    {
+        for (; e - p >= 16; p += 16)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128())));
+
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                zeros[k] += std::popcount(mask & (0x1111u << k));
+            }
+        }
+    }
+
+    template <byte_like byteT>
+    XTUAL_TARGET("avx2") void count_zero_bytes_avx2(const byteT *&p, const byteT *e, std::array<std::size_t, 4> &zeros)
+    {
+        for (; e - p >= 32; p += 32)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_setzero_si256())));
+
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                zeros[k] += std::popcount(mask & (0x11111111u << k));
+            }
+        }
+
+        count_zero_bytes_sse2(p, e, zeros);
+    }
+
+#endif
+
+    template <byte_like byteT>
+    constexpr std::array<std::size_t, 4> count_zero_bytes(const byteT *p, const byteT *e)
+    {
+        std::array<std::size_t, 4> zeros {};
+        const byteT *b = p;
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                count_zero_bytes_avx2(p, e, zeros);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                count_zero_bytes_sse2(p, e, zeros);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        for (; p != e; ++p)
+        {
+            if (static_cast<char8_t>(*p) == 0)
+            {
+                ++zeros[(p - b) % 4];
+            }
+        }
+
+        return zeros;
+    }
+
+    inline constexpr std::size_t detect_sample_size = 1 << 16;
+
+    template <typename From>
+    constexpr bool detect_is_valid(std::span<const typename From::unit_type> in)
+    {
+        std::size_t n = validate_units<From>(in);
+
+        if (n == in.size())
+        {
+            return true;
+        }
+
+        const auto *p = in.data() + n;
+        char32_t ch;
+
+        return From::decode(p, in.data() + in.size(), ch) == transcode_status::incomplete;
+    }
+
+    template <byte_like byteT>
+    std::size_t detect_bom(std::span<const byteT> in, encoding &form)
+    {
+        auto starts_with = [&](std::initializer_list<unsigned char> bom) {
+            return in.size() >= bom.size() && std::equal(bom.begin(), bom.end(), in.begin(), [](unsigned char x, byteT y) {
+                return x == static_cast<unsigned char>(y);
+            });
+        };
+
+        if (starts_with({ 0xef, 0xbb, 0xbf }))
+        {
+            form = encoding::b8;
+            return 3;
+        }
+
+        if (starts_with({ 0x00, 0x00, 0xfe, 0xff }))
+        {
+            form = encoding::b32be;
+            return 4;
+        }
+
+        if (starts_with({ 0xff, 0xfe, 0x00, 0x00 }))
+        {
+            form = encoding::b32le;
+            return 4;
+        }
+
+        if (starts_with({ 0xfe, 0xff }))
+        {
+            form = encoding::b16be;
+            return 2;
+        }
+
+        if (starts_with({ 0xff, 0xfe }))
+        {
+            form = encoding::b16le;
+            return 2;
+        }
+
+        return 0;
+    }
+
+    template <byte_like byteT>
+    encoding_detection detect_encoding(std::span<const byteT> in)
+    {
+        encoding_detection result {
+            { {
+                { encoding::b8, 0 },
+                { encoding::b16le, 0 },
+                { encoding::b16be, 0 },
+                { encoding::b32le, 0 },
+                { encoding::b32be, 0 },
+            } },
+            0,
+        };
+
+        encoding form;
+
+        result.bom_length = detect_bom(in, form);
+        in = in.first(std::min(in.size(), detect_sample_size));
+
+        auto quads = in.size() / 4;
+        auto pairs = in.size() / 2;
+        auto zeros = count_zero_bytes(in.data(), in.data() + quads * 4);
+        auto total = zeros[0] + zeros[1] + zeros[2] + zeros[3];
+
+        auto utf16_score = [&](std::size_t high, std::size_t low) -> unsigned {
+            return high > low ? 20 + static_cast<unsigned>(75 * (high - low) / pairs) : 20;
+        };
+
+        for (auto &c : result.candidates)
+        {
+            switch (c.form)
+            {
+            case encoding::b8:
+                if (detect_is_valid<b8_codec<byteT>>(in))
+                {
+                    c.confidence = total == 0 ? 90 : 30;
+                }
+                break;
+            case encoding::b16le:
+                if (pairs != 0 && detect_is_valid<b16le_codec<byteT>>(in))
+                {
+                    c.confidence = utf16_score(zeros[1] + zeros[3], zeros[0] + zeros[2]);
+                }
+                break;
+            case encoding::b16be:
+                if (pairs != 0 && detect_is_valid<b16be_codec<byteT>>(in))
+                {
+                    c.confidence = utf16_score(zeros[0] + zeros[2], zeros[1] + zeros[3]);
+                }
+                break;
+            case encoding::b32le:
+                if (quads != 0 && zeros[3] == quads && detect_is_valid<b32le_codec<byteT>>(in))
+                {
+                    c.confidence = 95;
+                }
+                break;
+            case encoding::b32be:
+                if (quads != 0 && zeros[0] == quads && detect_is_valid<b32be_codec<byteT>>(in))
+                {
+                    c.confidence = 95;
+                }
+                break;
+            }
+        }
+
+        if (result.bom_length != 0)
+        {
+            for (auto &c : result.candidates)
+            {
+                if (c.form == form)
+                {
+                    c.confidence = 100;
+                }
+            }
+        }
+
+        std::stable_sort(result.candidates.begin(), result.candidates.end(), [](const encoding_candidate &x, const encoding_candidate &y) {
+            return x.confidence > y.confidence;
+        });
+
+        return result;
+    }
+
+    template <byte_like byteT, typename F>
+    decltype(auto) visit_encoding(encoding form, F &&f)
+    {
+        switch (form)
+        {
+        case encoding::b16be:
+            return std::forward<F>(f)(std::type_identity<b16be_codec<byteT>>());
+        case encoding::b16le:
+            return std::forward<F>(f)(std::type_identity<b16le_codec<byteT>>());
+        case encoding::b32be:
+            return std::forward<F>(f)(std::type_identity<b32be_codec<byteT>>());
+        case encoding::b32le:
+            return std::forward<F>(f)(std::type_identity<b32le_codec<byteT>>());
+        default:
+            return std::forward<F>(f)(std::type_identity<b8_codec<byteT>>());
+        }
+    }
+
+}
@@ -0,0 +1,297 @@
+namespace xtual
+{
+
+#if defined(XTUAL_X86_SIMD)
+
+    XTUAL_TARGET("sse2") inline __m128i byteswap_epi16_sse2(__m128i x)
+    {
+        return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+    }
+
+    XTUAL_TARGET("sse2") inline __m128i byteswap_epi32_sse2(__m128i x)
+    {
+        return _mm_shufflehi_epi16(_mm_shufflelo_epi16(byteswap_epi16_sse2(x), 0xb1), 0xb1);
+    }
+
+    XTUAL_TARGET("ssse3") inline __m128i byteswap_epi16_ssse3(__m128i x)
+    {
+        return _mm_shuffle_epi8(x, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+    }
+
+    XTUAL_TARGET("ssse3") inline __m128i byteswap_epi32_ssse3(__m128i x)
+    {
+        return _mm_shuffle_epi8(x, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+    }
+
+    XTUAL_TARGET("avx2") inline __m256i byteswap_epi16_avx2(__m256i x)
+    {
+        return _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+            1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+            1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+    }
+
+    XTUAL_TARGET("avx2") inline __m256i byteswap_epi32_avx2(__m256i x)
+    {
+        return _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+    }
+
+    XTUAL_TARGET("sse2") inline bool is_valid_utf16_block(__m128i x)
+    {
+        __m128i masked = _mm_and_si128(x, _mm_set1_epi16(static_cast<short>(0xf800)));
+        __m128i surrogates = _mm_cmpeq_epi16(masked, _mm_set1_epi16(static_cast<short>(0xd800)));
+
+        return _mm_movemask_epi8(surrogates) == 0;
+    }
+
+    XTUAL_TARGET("sse2") inline bool is_valid_utf32_block(__m128i x)
+    {
+        const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000));
+
+        __m128i masked = _mm_and_si128(x, _mm_set1_epi32(static_cast<int>(0xfffff800)));
+        __m128i surrogates = _mm_cmpeq_epi32(masked, _mm_set1_epi32(0xd800));
+        __m128i above = _mm_cmpgt_epi32(_mm_xor_si128(x, bias), _mm_xor_si128(_mm_set1_epi32(0x10ffff), bias));
+
+        return _mm_movemask_epi8(_mm_or_si128(surrogates, above)) == 0;
+    }
+
+    XTUAL_TARGET("avx2") inline bool is_valid_utf16_block(__m256i x)
+    {
+        __m256i masked = _mm256_and_si256(x, _mm256_set1_epi16(static_cast<short>(0xf800)));
+        __m256i surrogates = _mm256_cmpeq_epi16(masked, _mm256_set1_epi16(static_cast<short>(0xd800)));
+
+        return _mm256_testz_si256(surrogates, surrogates);
+    }
+
+    XTUAL_TARGET("avx2") inline bool is_valid_utf32_block(__m256i x)
+    {
+        __m256i masked = _mm256_and_si256(x, _mm256_set1_epi32(static_cast<int>(0xfffff800)));
+        __m256i surrogates = _mm256_cmpeq_epi32(masked, _mm256_set1_epi32(0xd800));
+        __m256i above = _mm256_cmpeq_epi32(_mm256_max_epu32(x, _mm256_set1_epi32(0x110000)), x);
+        __m256i errors = _mm256_or_si256(surrogates, above);
+
+        return _mm256_testz_si256(errors, errors);
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("sse2") inline __m128i byteswap_sse2(__m128i x)
+    {
+        return width == 2 ? byteswap_epi16_sse2(x) : byteswap_epi32_sse2(x);
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("ssse3") inline __m128i byteswap_ssse3(__m128i x)
+    {
+        return width == 2 ? byteswap_epi16_ssse3(x) : byteswap_epi32_ssse3(x);
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("avx2") inline __m256i byteswap_avx2(__m256i x)
+    {
+        return width == 2 ? byteswap_epi16_avx2(x) : byteswap_epi32_avx2(x);
+    }
+
+    constexpr std::size_t utf16_pass_lanes(std::uint32_t high, std::uint32_t low, std::size_t lanes)
+    {
+        std::uint32_t last = std::uint32_t(3) << (2 * lanes - 2);
+        std::size_t n = (high & last) != 0 ? lanes - 1 : lanes;
+
+        high &= ~last;
+
+        return low == high << 2 ? n : 0;
+    }
+
+    XTUAL_TARGET("sse2") inline std::size_t utf16_pass_lanes(__m128i x)
+    {
+        __m128i masked = _mm_and_si128(x, _mm_set1_epi16(static_cast<short>(0xfc00)));
+        auto high = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(masked, _mm_set1_epi16(static_cast<short>(0xd800)))));
+        auto low = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(masked, _mm_set1_epi16(static_cast<short>(0xdc00)))));
+
+        return utf16_pass_lanes(high, low, 8);
+    }
+
+    XTUAL_TARGET("avx2") inline std::size_t utf16_pass_lanes(__m256i x)
+    {
+        __m256i masked = _mm256_and_si256(x, _mm256_set1_epi16(static_cast<short>(0xfc00)));
+        auto high = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(masked, _mm256_set1_epi16(static_cast<short>(0xd800)))));
+        auto low = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(masked, _mm256_set1_epi16(static_cast<short>(0xdc00)))));
+
+        return utf16_pass_lanes(high, low, 16);
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("sse2") inline std::size_t pass_lanes(__m128i x)
+    {
+        if constexpr (width == 2)
+        {
+            return utf16_pass_lanes(x);
+        }
+        else
+        {
+            return is_valid_utf32_block(x) ? 4 : 0;
+        }
+    }
+
+    template <std::size_t width>
+    XTUAL_TARGET("avx2") inline std::size_t pass_lanes(__m256i x)
+    {
+        if constexpr (width == 2)
+        {
+            return utf16_pass_lanes(x);
+        }
+        else
+        {
+            return is_valid_utf32_block(x) ? 8 : 0;
+        }
+    }
+
+    template <std::size_t width, std::endian from, std::endian to, typename inT, typename outT>
+    XTUAL_TARGET("sse2") void byteorder_kernel_sse2(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+        constexpr std::ptrdiff_t in_step = 16 / sizeof(inT);
+        constexpr std::ptrdiff_t out_step = 16 / sizeof(outT);
+
+        while (ie - i >= in_step && oe - o >= out_step)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i));
+
+            std::size_t lanes = pass_lanes<width>(from != std::endian::native ? byteswap_sse2<width>(x) : x);
+
+            if (lanes == 0)
+            {
+                break;
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(o), from != to ? byteswap_sse2<width>(x) : x);
+            i += lanes * width / sizeof(inT);
+            o += lanes * width / sizeof(outT);
+        }
+    }
+
+    template <std::size_t width, std::endian from, std::endian to, typename inT, typename outT>
+    XTUAL_TARGET("ssse3") void byteorder_kernel_ssse3(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+        constexpr std::ptrdiff_t in_step = 16 / sizeof(inT);
+        constexpr std::ptrdiff_t out_step = 16 / sizeof(outT);
+
+        while (ie - i >= in_step && oe - o >= out_step)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i));
+
+            std::size_t lanes = pass_lanes<width>(from != std::endian::native ? byteswap_ssse3<width>(x) : x);
+
+            if (lanes == 0)
+            {
+                break;
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(o), from != to ? byteswap_ssse3<width>(x) : x);
+            i += lanes * width / sizeof(inT);
+            o += lanes * width / sizeof(outT);
+        }
+    }
+
+    template <std::size_t width, std::endian from, std::endian to, typename inT, typename outT>
+    XTUAL_TARGET("avx2") void byteorder_kernel_avx2(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+        constexpr std::ptrdiff_t in_step = 32 / sizeof(inT);
+        constexpr std::ptrdiff_t out_step = 32 / sizeof(outT);
+
+        while (ie - i >= in_step && oe - o >= out_step)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(i));
+
+            std::size_t lanes = pass_lanes<width>(from != std::endian::native ? byteswap_avx2<width>(x) : x);
+
+            if (lanes == 0)
+            {
+                break;
+            }
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(o), from != to ? byteswap_avx2<width>(x) : x);
+            i += lanes * width / sizeof(inT);
+            o += lanes * width / sizeof(outT);
+        }
+
+        byteorder_kernel_ssse3<width, from, to>(i, ie, o, oe);
+    }
+
+#endif
+
+    template <std::size_t width, std::endian from, std::endian to, typename inT, typename outT>
+    void byteorder_kernel(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+#if defined(XTUAL_X86_SIMD)
+        switch (active_simd_level())
+        {
+        case simd_level::avx2:
+            byteorder_kernel_avx2<width, from, to>(i, ie, o, oe);
+            break;
+        case simd_level::ssse3:
+            byteorder_kernel_ssse3<width, from, to>(i, ie, o, oe);
+            break;
+        case simd_level::sse2:
+            byteorder_kernel_sse2<width, from, to>(i, ie, o, oe);
+            break;
+        default:
+            break;
+        }
+#endif
+    }
+
+    template <byte_like byteT, std::endian order>
+    struct transcode_kernel<b16_codec<byteT, order>, u16_codec>
+    {
+        static void run(const byteT *&i, const byteT *ie, char16_t *&o, char16_t *oe)
+        {
+            byteorder_kernel<2, order, std::endian::native>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct transcode_kernel<u16_codec, b16_codec<byteT, order>>
+    {
+        static void run(const char16_t *&i, const char16_t *ie, byteT *&o, byteT *oe)
+        {
+            byteorder_kernel<2, std::endian::native, order>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct transcode_kernel<b32_codec<byteT, order>, u32_codec>
+    {
+        static void run(const byteT *&i, const byteT *ie, char32_t *&o, char32_t *oe)
+        {
+            byteorder_kernel<4, order, std::endian::native>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct transcode_kernel<u32_codec, b32_codec<byteT, order>>
+    {
+        static void run(const char32_t *&i, const char32_t *ie, byteT *&o, byteT *oe)
+        {
+            byteorder_kernel<4, std::endian::native, order>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like inT, std::endian from, byte_like outT, std::endian to>
+    struct transcode_kernel<b16_codec<inT, from>, b16_codec<outT, to>>
+    {
+        static void run(const inT *&i, const inT *ie, outT *&o, outT *oe)
+        {
+            byteorder_kernel<2, from, to>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like inT, std::endian from, byte_like outT, std::endian to>
+    struct transcode_kernel<b32_codec<inT, from>, b32_codec<outT, to>>
+    {
+        static void run(const inT *&i, const inT *ie, outT *&o, outT *oe)
+        {
+            byteorder_kernel<4, from, to>(i, ie, o, oe);
+        }
+    };
+
+}
@@ -0,0 +1,182 @@
+namespace xtual
+{
+
+    // A class template rather than a specialised variable template, whose
+    // partial specialisations GCC 12 leaves out of a module interface.
+    template <typename Codec>
+    struct utf8_codec_match
+    {
+        static constexpr bool value = false;
+    };
+
+    template <typename charT, typename Engine>
+    struct utf8_codec_match<utf8_codec<charT, Engine>>
+    {
+        static constexpr bool value = true;
+    };
+
+    template <typename Codec>
+    inline constexpr bool is_utf8_codec = utf8_codec_match<Codec>::value;
+
+    template <typename Codec>
+    requires is_utf8_codec<Codec> || std::same_as<Codec, u16_codec>
+    class offset_index
+    {
+    public:
+        using unit_type = typename Codec::unit_type;
+
+        static constexpr std::size_t block_length = 64;
+
+        constexpr explicit offset_index(std::size_t stride = 256)
+            : stride(stride == 0 ? 1 : stride)
+        {
+        }
+
+        constexpr explicit offset_index(std::span<const unit_type> text, std::size_t stride = 256)
+            : offset_index(stride)
+        {
+            extend(text);
+        }
+
+        constexpr void extend(std::span<const unit_type> text)
+        {
+            const unit_type *b = text.data();
+            const unit_type *p = b + indexed;
+            const unit_type *e = b + text.size();
+
+            std::size_t target = marks.size() * stride;
+
+            while (p != e)
+            {
+                if (e - p >= static_cast<std::ptrdiff_t>(block_length))
+                {
+                    std::size_t n = count_starts(p, p + block_length);
+
+                    if (count + n <= target)
+                    {
+                        count += n;
+                        p += block_length;
+
+                        continue;
+                    }
+                }
+
+                const unit_type *q = e - p >= static_cast<std::ptrdiff_t>(block_length) ? p + block_length : e;
+
+                for (; p != q; ++p)
+                {
+                    if (is_start(p))
+                    {
+                        if (count == target)
+                        {
+                            marks.push_back(static_cast<std::size_t>(p - b));
+                            target += stride;
+                        }
+
+                        ++count;
+                    }
+                }
+            }
+
+            underlying = text;
+            indexed = text.size();
+        }
+
+        constexpr std::size_t size() const
+        {
+            return count;
+        }
+
+        constexpr std::size_t length() const
+        {
+            return indexed;
+        }
+
+        constexpr std::size_t offset(std::size_t n) const
+        {
+            if (n >= count)
+            {
+                return indexed;
+            }
+
+            const unit_type *b = underlying.data();
+            const unit_type *p = b + marks[n / stride];
+
+            for (std::size_t k = n % stride; k != 0; --k)
+            {
+                for (++p; !is_start(p); ++p)
+                {
+                }
+            }
+
+            return static_cast<std::size_t>(p - b);
+        }
+
+        constexpr std::optional<char32_t> at(std::size_t n) const
+        {
+            if (n >= count)
+            {
+                return std::nullopt;
+            }
+
+            const unit_type *p = underlying.data() + offset(n);
+            char32_t ch;
+
+            if (Codec::decode(p, underlying.data() + indexed, ch) != transcode_status::ok)
+            {
+                return std::nullopt;
+            }
+
+            return ch;
+        }
+
+        constexpr std::span<const unit_type> substr(std::size_t first, std::size_t last) const
+        {
+            last = std::min(last, count);
+            first = std::min(first, last);
+
+            std::size_t b = offset(first);
+
+            return underlying.subspan(b, offset(last) - b);
+        }
+
+    private:
+        static constexpr bool is_start(const unit_type *p)
+        {
+            if constexpr (is_utf8_codec<Codec>)
+            {
+                return !is_utf8_tail(Codec::load(p));
+            }
+            else
+            {
+                return !is_low_surrogate(*p);
+            }
+        }
+
+        static constexpr std::size_t count_starts(const unit_type *p, const unit_type *e)
+        {
+            if constexpr (is_utf8_codec<Codec>)
+            {
+                return utf8_count(p, e, false);
+            }
+            else
+            {
+                return count_code_points_u16({ p, e });
+            }
+        }
+
+        std::size_t stride;
+        std::vector<std::size_t> marks;
+        std::span<const unit_type> underlying;
+        std::size_t indexed = 0;
+        std::size_t count = 0;
+    };
+
+    using u8_offset_index = offset_index<u8_codec>;
+
+    template <byte_like byteT>
+    using b8_offset_index = offset_index<b8_codec<byteT>>;
+
+    using u16_offset_index = offset_index<u16_codec>;
+
+}
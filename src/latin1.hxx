@@ -0,0 +1,569 @@
+namespace xtual
+{
+
+    template <byte_like byteT, char32_t max>
+    struct single_byte_codec
+    {
+        using unit_type = byteT;
+
+        static constexpr std::size_t max_length = 1;
+
+        static constexpr char32_t replacement = U'?';
+
+        static constexpr bool can_encode(char32_t ch)
+        {
+            return ch <= max;
+        }
+
+        static constexpr const byteT *resync(const byteT *, const byteT *p, const byteT *)
+        {
+            return p;
+        }
+
+        static constexpr std::size_t ill_formed_length(const byteT *, const byteT *)
+        {
+            return 1;
+        }
+
+        static constexpr transcode_status decode(const byteT *&p, const byteT *, char32_t &ch)
+        {
+            char32_t u = static_cast<char32_t>(static_cast<std::byte>(*p));
+
+            if (u > max)
+            {
+                return transcode_status::invalid;
+            }
+
+            ch = u;
+            ++p;
+
+            return transcode_status::ok;
+        }
+
+        static constexpr bool encode(byteT *&p, byteT *e, char32_t ch)
+        {
+            if (p == e || ch > max)
+            {
+                return false;
+            }
+
+            *p++ = static_cast<byteT>(static_cast<std::byte>(ch));
+
+            return true;
+        }
+    };
+
+    template <byte_like byteT>
+    using latin1_codec = single_byte_codec<byteT, U'\xff'>;
+
+    template <byte_like byteT>
+    using ascii_codec = single_byte_codec<byteT, U'\x7f'>;
+
+    template <byte_like byteT, char32_t max, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool single_byte_encode(Iter &i, Sent s, char32_t ch)
+    {
+        if (i == s || ch > max)
+        {
+            return false;
+        }
+
+        *i++ = static_cast<byteT>(static_cast<std::byte>(ch));
+
+        return true;
+    }
+
+    template <byte_like byteT, char32_t max, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    constexpr std::optional<char32_t> single_byte_decode(Iter &i, Sent s)
+    {
+        if (i == s)
+        {
+            return std::nullopt;
+        }
+
+        char32_t ch = static_cast<char32_t>(static_cast<std::byte>(static_cast<byteT>(*i)));
+
+        if (ch > max)
+        {
+            return decode_error(transcode_status::invalid);
+        }
+
+        ++i;
+
+        return ch;
+    }
+
+    template <byte_like byteT, char32_t max, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    constexpr std::optional<char32_t> single_byte_decode_lossy(Iter &i, Sent s)
+    {
+        if (i == s)
+        {
+            return std::nullopt;
+        }
+
+        char32_t ch = static_cast<char32_t>(static_cast<std::byte>(static_cast<byteT>(*i++)));
+
+        if (ch > max)
+        {
+            decode_error(transcode_status::invalid);
+
+            return U'\xfffd';
+        }
+
+        return ch;
+    }
+
+    template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool encode_as_latin1(Iter &i, Sent s, char32_t ch)
+    {
+        return single_byte_encode<byteT, U'\xff'>(i, s, ch);
+    }
+
+    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_from_latin1(Iter &i, Sent s)
+    {
+        return single_byte_decode<byteT, U'\xff'>(i, s);
+    }
+
+    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_latin1(Iter &i, Sent s)
+    {
+        return single_byte_decode_lossy<byteT, U'\xff'>(i, s);
+    }
+
+    template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
+    constexpr bool encode_as_ascii(Iter &i, Sent s, char32_t ch)
+    {
+        return single_byte_encode<byteT, U'\x7f'>(i, s, ch);
+    }
+
+    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_from_ascii(Iter &i, Sent s)
+    {
+        return single_byte_decode<byteT, U'\x7f'>(i, s);
+    }
+
+    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_ascii(Iter &i, Sent s)
+    {
+        return single_byte_decode_lossy<byteT, U'\x7f'>(i, s);
+    }
+
+    template <typename unitT>
+    constexpr char32_t unit_value(const unitT *p)
+    {
+        if constexpr (sizeof(unitT) == 1)
+        {
+            return static_cast<char32_t>(static_cast<std::byte>(*p));
+        }
+        else
+        {
+            return static_cast<char32_t>(*p);
+        }
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <typename unitT>
+    XTUAL_TARGET("sse2") inline bool is_below_sse2(__m128i x, char32_t limit)
+    {
+        __m128i high;
+
+        if constexpr (sizeof(unitT) == 1)
+        {
+            high = _mm_set1_epi8(static_cast<char>(~limit & 0xff));
+        }
+        else if constexpr (sizeof(unitT) == 2)
+        {
+            high = _mm_set1_epi16(static_cast<short>(~limit & 0xffff));
+        }
+        else
+        {
+            high = _mm_set1_epi32(static_cast<int>(~limit));
+        }
+
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(x, high), _mm_setzero_si128())) == 0xffff;
+    }
+
+    template <typename unitT>
+    XTUAL_TARGET("sse2") const unitT *ascii_prefix_sse2(const unitT *p, const unitT *e)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(unitT);
+
+        for (; e - p >= step; p += step)
+        {
+            if (!is_below_sse2<unitT>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), U'\x7f'))
+            {
+                break;
+            }
+        }
+
+        return p;
+    }
+
+    template <typename unitT>
+    XTUAL_TARGET("avx2") const unitT *ascii_prefix_avx2(const unitT *p, const unitT *e)
+    {
+        constexpr std::ptrdiff_t step = 32 / sizeof(unitT);
+
+        __m256i high;
+
+        if constexpr (sizeof(unitT) == 1)
+        {
+            high = _mm256_set1_epi8(static_cast<char>(0x80));
+        }
+        else if constexpr (sizeof(unitT) == 2)
+        {
+            high = _mm256_set1_epi16(static_cast<short>(0xff80));
+        }
+        else
+        {
+            high = _mm256_set1_epi32(static_cast<int>(0xffffff80));
+        }
+
+        for (; e - p >= 2 * step; p += 2 * step)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + step));
+
+            if (!_mm256_testz_si256(_mm256_or_si256(x, y), high))
+            {
+                break;
+            }
+        }
+
+        for (; e - p >= step; p += step)
+        {
+            if (!_mm256_testz_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), high))
+            {
+                break;
+            }
+        }
+
+        return ascii_prefix_sse2(p, e);
+    }
+
+    template <char32_t limit, typename inT, typename outT>
+    XTUAL_TARGET("sse2") void single_byte_kernel_sse2(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+        constexpr std::size_t in_size = sizeof(inT);
+        constexpr std::size_t out_size = sizeof(outT);
+        constexpr bool check = in_size != 1 || limit < U'\xff';
+
+        const __m128i zero = _mm_setzero_si128();
+
+        while (ie - i >= 16 && oe - o >= 16)
+        {
+            __m128i v[in_size];
+            __m128i any = zero;
+
+            for (std::size_t k = 0; k < in_size; ++k)
+            {
+                v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i) + k);
+                any = _mm_or_si128(any, v[k]);
+            }
+
+            if (check && !is_below_sse2<inT>(any, limit))
+            {
+                break;
+            }
+
+            __m128i bytes;
+
+            if constexpr (in_size == 1)
+            {
+                bytes = v[0];
+            }
+            else if constexpr (in_size == 2)
+            {
+                bytes = _mm_packus_epi16(v[0], v[1]);
+            }
+            else
+            {
+                bytes = _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3]));
+            }
+
+            auto *q = reinterpret_cast<__m128i *>(o);
+
+            if constexpr (out_size == 1)
+            {
+                _mm_storeu_si128(q, bytes);
+            }
+            else if constexpr (out_size == 2)
+            {
+                _mm_storeu_si128(q, _mm_unpacklo_epi8(bytes, zero));
+                _mm_storeu_si128(q + 1, _mm_unpackhi_epi8(bytes, zero));
+            }
+            else
+            {
+                __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+                __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+
+                _mm_storeu_si128(q, _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128(q + 1, _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128(q + 2, _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128(q + 3, _mm_unpackhi_epi16(hi, zero));
+            }
+
+            i += 16;
+            o += 16;
+        }
+    }
+
+    template <char32_t limit, typename inT, typename outT>
+    XTUAL_TARGET("avx2") void single_byte_kernel_avx2(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+        if constexpr (sizeof(inT) == 1 && sizeof(outT) == 1)
+        {
+            const __m256i high = _mm256_set1_epi8(static_cast<char>(~limit & 0xff));
+
+            while (ie - i >= 32 && oe - o >= 32)
+            {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(i));
+
+                if (limit < U'\xff' && !_mm256_testz_si256(x, high))
+                {
+                    break;
+                }
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(o), x);
+                i += 32;
+                o += 32;
+            }
+        }
+
+        single_byte_kernel_sse2<limit>(i, ie, o, oe);
+    }
+
+    constexpr std::array<std::array<std::int8_t, 16>, 256> make_latin1_expand_table()
+    {
+        std::array<std::array<std::int8_t, 16>, 256> table {};
+
+        for (std::size_t mask = 0; mask < 256; ++mask)
+        {
+            std::size_t n = 0;
+
+            for (std::size_t k = 0; k < 8; ++k)
+            {
+                table[mask][n++] = static_cast<std::int8_t>(2 * k);
+
+                if ((mask >> k & 1) != 0)
+                {
+                    table[mask][n++] = static_cast<std::int8_t>(2 * k + 1);
+                }
+            }
+
+            for (; n < 16; ++n)
+            {
+                table[mask][n] = -1;
+            }
+        }
+
+        return table;
+    }
+
+    inline constexpr auto latin1_expand_table = make_latin1_expand_table();
+
+    template <typename outT>
+    XTUAL_TARGET("ssse3") inline void latin1_expand_ssse3(__m128i x, unsigned mask, outT *&o)
+    {
+        __m128i wide = _mm_unpacklo_epi8(x, _mm_setzero_si128());
+        __m128i lead = _mm_or_si128(_mm_srli_epi16(wide, 6), _mm_set1_epi16(0xc0));
+        __m128i tail = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(wide, _mm_set1_epi16(0x3f)), 8), _mm_set1_epi16(static_cast<short>(0x8000)));
+        __m128i ascii = _mm_cmplt_epi16(wide, _mm_set1_epi16(0x80));
+        __m128i words = _mm_or_si128(_mm_and_si128(ascii, wide), _mm_andnot_si128(ascii, _mm_or_si128(lead, tail)));
+        __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(latin1_expand_table[mask].data()));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm_shuffle_epi8(words, shuffle));
+        o += 8 + std::popcount(mask);
+    }
+
+    template <typename inT, typename outT>
+    XTUAL_TARGET("ssse3") void latin1_to_utf8_kernel_ssse3(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+        while (ie - i >= 16 && oe - o >= 32)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i));
+            auto mask = static_cast<unsigned>(_mm_movemask_epi8(x));
+
+            if (mask == 0)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(o), x);
+                o += 16;
+            }
+            else
+            {
+                latin1_expand_ssse3(x, mask & 0xff, o);
+                latin1_expand_ssse3(_mm_srli_si128(x, 8), mask >> 8, o);
+            }
+
+            i += 16;
+        }
+    }
+
+#endif
+
+    template <typename inT, typename outT>
+    void latin1_to_utf8_kernel(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+#if defined(XTUAL_X86_SIMD)
+        switch (active_simd_level())
+        {
+        case simd_level::avx2:
+            single_byte_kernel_avx2<U'\x7f'>(i, ie, o, oe);
+            latin1_to_utf8_kernel_ssse3(i, ie, o, oe);
+            break;
+        case simd_level::ssse3:
+            latin1_to_utf8_kernel_ssse3(i, ie, o, oe);
+            break;
+        case simd_level::sse2:
+            single_byte_kernel_sse2<U'\x7f'>(i, ie, o, oe);
+            break;
+        default:
+            break;
+        }
+#endif
+    }
+
+    template <typename unitT>
+    constexpr const unitT *ascii_prefix(const unitT *p, const unitT *e)
+    {
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                p = ascii_prefix_avx2(p, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                p = ascii_prefix_sse2(p, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        for (; p != e && unit_value(p) <= U'\x7f'; ++p)
+        {
+        }
+
+        return p;
+    }
+
+    constexpr bool is_ascii(std::span<const char8_t> in)
+    {
+        return ascii_prefix(in.data(), in.data() + in.size()) == in.data() + in.size();
+    }
+
+    constexpr bool is_ascii(std::span<const char16_t> in)
+    {
+        return ascii_prefix(in.data(), in.data() + in.size()) == in.data() + in.size();
+    }
+
+    constexpr bool is_ascii(std::span<const char32_t> in)
+    {
+        return ascii_prefix(in.data(), in.data() + in.size()) == in.data() + in.size();
+    }
+
+    template <byte_like byteT>
+    constexpr bool is_ascii(std::span<const byteT> in)
+    {
+        return ascii_prefix(in.data(), in.data() + in.size()) == in.data() + in.size();
+    }
+
+    template <char32_t limit, typename inT, typename outT>
+    void single_byte_kernel(const inT *&i, const inT *ie, outT *&o, outT *oe)
+    {
+#if defined(XTUAL_X86_SIMD)
+        switch (active_simd_level())
+        {
+        case simd_level::avx2:
+            single_byte_kernel_avx2<limit>(i, ie, o, oe);
+            break;
+        case simd_level::ssse3:
+        case simd_level::sse2:
+            single_byte_kernel_sse2<limit>(i, ie, o, oe);
+            break;
+        default:
+            break;
+        }
+#endif
+    }
+
+    template <byte_like byteT, char32_t max, typename charT, typename Engine>
+    struct transcode_kernel<single_byte_codec<byteT, max>, utf8_codec<charT, Engine>>
+    {
+        static void run(const byteT *&i, const byteT *ie, charT *&o, charT *oe)
+        {
+            if constexpr (max == U'\xff')
+            {
+                latin1_to_utf8_kernel(i, ie, o, oe);
+            }
+            else
+            {
+                single_byte_kernel<U'\x7f'>(i, ie, o, oe);
+            }
+        }
+    };
+
+    template <typename charT, typename Engine, byte_like byteT, char32_t max>
+    struct transcode_kernel<utf8_codec<charT, Engine>, single_byte_codec<byteT, max>>
+    {
+        static void run(const charT *&i, const charT *ie, byteT *&o, byteT *oe)
+        {
+            single_byte_kernel<U'\x7f'>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like inT, char32_t in_max, byte_like outT, char32_t out_max>
+    struct transcode_kernel<single_byte_codec<inT, in_max>, single_byte_codec<outT, out_max>>
+    {
+        static void run(const inT *&i, const inT *ie, outT *&o, outT *oe)
+        {
+            single_byte_kernel<std::min(in_max, out_max)>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, char32_t max>
+    struct transcode_kernel<single_byte_codec<byteT, max>, u16_codec>
+    {
+        static void run(const byteT *&i, const byteT *ie, char16_t *&o, char16_t *oe)
+        {
+            single_byte_kernel<max>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, char32_t max>
+    struct transcode_kernel<u16_codec, single_byte_codec<byteT, max>>
+    {
+        static void run(const char16_t *&i, const char16_t *ie, byteT *&o, byteT *oe)
+        {
+            single_byte_kernel<max>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, char32_t max>
+    struct transcode_kernel<single_byte_codec<byteT, max>, u32_codec>
+    {
+        static void run(const byteT *&i, const byteT *ie, char32_t *&o, char32_t *oe)
+        {
+            single_byte_kernel<max>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, char32_t max>
+    struct transcode_kernel<u32_codec, single_byte_codec<byteT, max>>
+    {
+        static void run(const char32_t *&i, const char32_t *ie, byteT *&o, byteT *oe)
+        {
+            single_byte_kernel<max>(i, ie, o, oe);
+        }
+    };
+
+}
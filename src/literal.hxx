@@ -0,0 +1,86 @@
+namespace xtual
+{
+
+    template <std::size_t N>
+    struct u8_literal
+    {
+        consteval u8_literal(const char8_t (&s)[N])
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                data[k] = s[k];
+            }
+        }
+
+        constexpr std::span<const char8_t> units() const
+        {
+            return { data.data(), N - 1 };
+        }
+
+        std::array<char8_t, N> data {};
+    };
+
+    template <typename To, std::size_t N>
+    struct encoded_literal
+    {
+        std::array<typename To::unit_type, N> data {};
+        std::size_t size = 0;
+        transcode_status status = transcode_status::ok;
+    };
+
+    template <typename To, u8_literal s>
+    consteval auto encode_literal()
+    {
+        constexpr std::size_t n = s.units().size();
+
+        encoded_literal<To, n * To::max_length> result;
+        transcode_result r = transcode<u8_codec, To>(s.units(), result.data);
+
+        result.size = r.written;
+        result.status = r.status;
+
+        return result;
+    }
+
+    template <typename To, u8_literal s>
+    consteval auto literal_array()
+    {
+        constexpr auto encoded = encode_literal<To, s>();
+
+        static_assert(encoded.status == transcode_status::ok, "literal is not valid UTF-8");
+
+        std::array<typename To::unit_type, encoded.size> result {};
+
+        for (std::size_t k = 0; k < encoded.size; ++k)
+        {
+            result[k] = encoded.data[k];
+        }
+
+        return result;
+    }
+
+    template <u8_literal s>
+    inline constexpr auto u8_to_u8_array = literal_array<u8_codec, s>();
+
+    template <u8_literal s, byte_like byteT = std::byte>
+    inline constexpr auto u8_to_b8_array = literal_array<b8_codec<byteT>, s>();
+
+    template <u8_literal s>
+    inline constexpr auto u8_to_u16_array = literal_array<u16_codec, s>();
+
+    template <u8_literal s, byte_like byteT = std::byte>
+    inline constexpr auto u8_to_b16be_array = literal_array<b16be_codec<byteT>, s>();
+
+    template <u8_literal s, byte_like byteT = std::byte>
+    inline constexpr auto u8_to_b16le_array = literal_array<b16le_codec<byteT>, s>();
+
+    template <u8_literal s>
+    inline constexpr auto u8_to_u32_array = literal_array<u32_codec, s>();
+
+    template <u8_literal s, byte_like byteT = std::byte>
+    inline constexpr auto u8_to_b32be_array = literal_array<b32be_codec<byteT>, s>();
+
+    template <u8_literal s, byte_like byteT = std::byte>
+    inline constexpr auto u8_to_b32le_array = literal_array<b32le_codec<byteT>, s>();
+
+}
@@ -0,0 +1,224 @@
+namespace xtual
+{
+
+    inline constexpr std::size_t parallel_chunk_size = 1 << 16;
+
+    inline constexpr std::size_t parallel_threshold = 1 << 18;
+
+    class parallel_pool
+    {
+    public:
+        static parallel_pool &instance()
+        {
+            static parallel_pool pool;
+
+            return pool;
+        }
+
+        ~parallel_pool()
+        {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+
+            wake.notify_all();
+        }
+
+        template <std::invocable<std::size_t> F>
+        bool run(std::size_t n, std::size_t helpers, F &f)
+        {
+            std::unique_lock busy_lock(busy, std::try_to_lock);
+
+            if (!busy_lock)
+            {
+                return false;
+            }
+
+            while (workers.size() < helpers)
+            {
+                workers.emplace_back([this]() { serve(); });
+            }
+
+            std::atomic<std::size_t> next = 0;
+
+            std::function<void()> work = [&]() {
+                for (std::size_t k = next++; k < n; k = next++)
+                {
+                    f(k);
+                }
+            };
+
+            {
+                std::lock_guard lock(mutex);
+                task = &work;
+                seats = helpers;
+                ++generation;
+            }
+
+            wake.notify_all();
+            work();
+
+            std::unique_lock lock(mutex);
+            finished.wait(lock, [&]() { return active == 0; });
+            task = nullptr;
+            seats = 0;
+
+            return true;
+        }
+
+    private:
+        parallel_pool() = default;
+
+        void serve()
+        {
+            std::unique_lock lock(mutex);
+            std::size_t seen = 0;
+
+            while (true)
+            {
+                wake.wait(lock, [&]() { return stopping || (generation != seen && seats != 0); });
+
+                if (stopping)
+                {
+                    return;
+                }
+
+                seen = generation;
+                --seats;
+                ++active;
+
+                const std::function<void()> *t = task;
+
+                lock.unlock();
+                (*t)();
+                lock.lock();
+
+                if (--active == 0)
+                {
+                    finished.notify_all();
+                }
+            }
+        }
+
+        std::mutex busy;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+        const std::function<void()> *task = nullptr;
+        std::size_t seats = 0;
+        std::size_t active = 0;
+        std::size_t generation = 0;
+        bool stopping = false;
+        std::vector<std::jthread> workers;
+    };
+
+    template <std::invocable<std::size_t> F>
+    void parallel_for(std::size_t n, unsigned threads, F f)
+    {
+        if (threads > 1 && n > 1 && parallel_pool::instance().run(n, std::min<std::size_t>(threads, n) - 1, f))
+        {
+            return;
+        }
+
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            f(k);
+        }
+    }
+
+    template <typename From, typename To>
+    transcode_result transcode_measure(std::span<const typename From::unit_type> in, error_policy policy)
+    {
+        if constexpr (countable_conversion<From, To>)
+        {
+            if (validate_units<From>(in) == in.size())
+            {
+                return { in.size(), converted_length<From, To>(in), transcode_status::ok };
+            }
+        }
+
+        std::array<typename To::unit_type, 1024> scratch;
+
+        std::size_t read = 0;
+        std::size_t written = 0;
+
+        while (true)
+        {
+            transcode_result r = transcode<From, To>(in.subspan(read), scratch, policy);
+
+            read += r.read;
+            written += r.written;
+
+            if (r.status != transcode_status::insufficient)
+            {
+                return { read, written, r.status };
+            }
+        }
+    }
+
+    template <typename From, typename To>
+    transcode_result parallel_transcode(std::span<const typename From::unit_type> in, std::span<typename To::unit_type> out, error_policy policy = error_policy::strict, unsigned threads = std::thread::hardware_concurrency())
+    {
+        std::size_t n = std::min<std::size_t>(std::max(threads, 1u) * 4, in.size() / parallel_chunk_size);
+
+        if (threads <= 1 || n <= 1 || in.size() < parallel_threshold)
+        {
+            return transcode<From, To>(in, out, policy);
+        }
+
+        std::vector<std::size_t> bounds(n + 1);
+
+        bounds[0] = 0;
+        bounds[n] = in.size();
+
+        for (std::size_t k = 1; k < n; ++k)
+        {
+            const auto *p = From::resync(in.data() + bounds[k - 1], in.data() + in.size() / n * k, in.data() + in.size());
+
+            bounds[k] = static_cast<std::size_t>(p - in.data());
+        }
+
+        auto chunk = [&](std::size_t k) {
+            return in.subspan(bounds[k], bounds[k + 1] - bounds[k]);
+        };
+
+        std::vector<transcode_result> measured(n);
+
+        parallel_for(n, threads, [&](std::size_t k) {
+            measured[k] = transcode_measure<From, To>(chunk(k), policy);
+        });
+
+        std::vector<std::size_t> offsets(n + 1);
+        std::size_t last = 0;
+
+        for (offsets[0] = 0; last < n; ++last)
+        {
+            offsets[last + 1] = offsets[last] + measured[last].written;
+
+            if (measured[last].status != transcode_status::ok || offsets[last + 1] > out.size())
+            {
+                break;
+            }
+        }
+
+        parallel_for(last, threads, [&](std::size_t k) {
+            transcode<From, To>(chunk(k), out.subspan(offsets[k], measured[k].written), policy);
+        });
+
+        if (last == n)
+        {
+            return { in.size(), offsets[n], transcode_status::ok };
+        }
+
+        transcode_result r = transcode<From, To>(chunk(last), out.subspan(offsets[last]), policy);
+
+        if (r.status == transcode_status::incomplete && last + 1 != n)
+        {
+            r.status = transcode_status::invalid;
+        }
+
+        return { bounds[last] + r.read, offsets[last] + r.written, r.status };
+    }
+
+}
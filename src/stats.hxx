@@ -0,0 +1,331 @@
+namespace xtual
+{
+
+    enum class stats_form
+    {
+        utf8,
+        utf16,
+        utf32,
+        single_byte,
+    };
+
+    template <typename Codec>
+    struct stats_form_of;
+
+    template <typename charT, typename Engine>
+    struct stats_form_of<utf8_codec<charT, Engine>>
+    {
+        static constexpr stats_form value = stats_form::utf8;
+        static constexpr std::size_t width = 1;
+        static constexpr std::endian byte_order = std::endian::native;
+    };
+
+    template <>
+    struct stats_form_of<u16_codec>
+    {
+        static constexpr stats_form value = stats_form::utf16;
+        static constexpr std::size_t width = 2;
+        static constexpr std::endian byte_order = std::endian::native;
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct stats_form_of<b16_codec<byteT, order>>
+    {
+        static constexpr stats_form value = stats_form::utf16;
+        static constexpr std::size_t width = 2;
+        static constexpr std::endian byte_order = order;
+    };
+
+    template <>
+    struct stats_form_of<u32_codec>
+    {
+        static constexpr stats_form value = stats_form::utf32;
+        static constexpr std::size_t width = 4;
+        static constexpr std::endian byte_order = std::endian::native;
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct stats_form_of<b32_codec<byteT, order>>
+    {
+        static constexpr stats_form value = stats_form::utf32;
+        static constexpr std::size_t width = 4;
+        static constexpr std::endian byte_order = order;
+    };
+
+    template <byte_like byteT, char32_t max>
+    struct stats_form_of<single_byte_codec<byteT, max>>
+    {
+        static constexpr stats_form value = stats_form::single_byte;
+        static constexpr std::size_t width = 1;
+        static constexpr std::endian byte_order = std::endian::native;
+    };
+
+    struct transcode_stats
+    {
+        std::array<std::uint64_t, 4> bytes_read {};
+        std::array<std::uint64_t, 4> bytes_written {};
+        std::uint64_t code_points = 0;
+        std::uint64_t ascii_code_points = 0;
+        std::array<std::uint64_t, 4> errors {};
+        std::array<std::uint64_t, 4> path_bytes {};
+
+        std::uint64_t read(stats_form form) const
+        {
+            return bytes_read[static_cast<std::size_t>(form)];
+        }
+
+        std::uint64_t written(stats_form form) const
+        {
+            return bytes_written[static_cast<std::size_t>(form)];
+        }
+
+        std::uint64_t error_count(transcode_status status) const
+        {
+            return errors[static_cast<std::size_t>(status)];
+        }
+
+        std::uint64_t path(simd_level level) const
+        {
+            return path_bytes[static_cast<std::size_t>(level)];
+        }
+
+        double ascii_fraction() const
+        {
+            return code_points == 0 ? 0.0 : static_cast<double>(ascii_code_points) / static_cast<double>(code_points);
+        }
+
+        transcode_stats &operator+=(const transcode_stats &other)
+        {
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                bytes_read[k] += other.bytes_read[k];
+                bytes_written[k] += other.bytes_written[k];
+                errors[k] += other.errors[k];
+                path_bytes[k] += other.path_bytes[k];
+            }
+
+            code_points += other.code_points;
+            ascii_code_points += other.ascii_code_points;
+
+            return *this;
+        }
+
+        transcode_stats &operator-=(const transcode_stats &other)
+        {
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                bytes_read[k] -= other.bytes_read[k];
+                bytes_written[k] -= other.bytes_written[k];
+                errors[k] -= other.errors[k];
+                path_bytes[k] -= other.path_bytes[k];
+            }
+
+            code_points -= other.code_points;
+            ascii_code_points -= other.ascii_code_points;
+
+            return *this;
+        }
+    };
+
+#if defined(XTUAL_ENABLE_STATS)
+
+    inline constexpr bool stats_enabled = true;
+
+    struct stats_counters
+    {
+        std::array<std::atomic<std::uint64_t>, 4> bytes_read {};
+        std::array<std::atomic<std::uint64_t>, 4> bytes_written {};
+        std::atomic<std::uint64_t> code_points = 0;
+        std::atomic<std::uint64_t> ascii_code_points = 0;
+        std::array<std::atomic<std::uint64_t>, 4> errors {};
+        std::array<std::atomic<std::uint64_t>, 4> path_bytes {};
+
+        // Only the owning thread adds, so a relaxed load and store is enough;
+        // other threads read the counters but never write them.
+        static void add(std::atomic<std::uint64_t> &counter, std::uint64_t n)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        static void set(std::array<std::uint64_t, 4> &out, const std::array<std::atomic<std::uint64_t>, 4> &in)
+        {
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                out[k] = in[k].load(std::memory_order_relaxed);
+            }
+        }
+
+        transcode_stats load() const
+        {
+            transcode_stats s;
+
+            set(s.bytes_read, bytes_read);
+            set(s.bytes_written, bytes_written);
+            set(s.errors, errors);
+            set(s.path_bytes, path_bytes);
+            s.code_points = code_points.load(std::memory_order_relaxed);
+            s.ascii_code_points = ascii_code_points.load(std::memory_order_relaxed);
+
+            return s;
+        }
+
+        // The counters at the last stats_reset, guarded by the registry mutex.
+        transcode_stats baseline;
+    };
+
+    struct stats_registry
+    {
+        std::mutex mutex;
+        std::vector<stats_counters *> live;
+        transcode_stats retired;
+
+        static stats_registry &instance()
+        {
+            static stats_registry registry;
+
+            return registry;
+        }
+    };
+
+    struct stats_thread_slot
+    {
+        stats_counters counters;
+
+        stats_thread_slot()
+        {
+            stats_registry &registry = stats_registry::instance();
+            std::lock_guard lock(registry.mutex);
+
+            registry.live.push_back(&counters);
+        }
+
+        ~stats_thread_slot()
+        {
+            stats_registry &registry = stats_registry::instance();
+            std::lock_guard lock(registry.mutex);
+
+            registry.retired += counters.load();
+            registry.retired -= counters.baseline;
+            std::erase(registry.live, &counters);
+        }
+    };
+
+    inline stats_counters &thread_stats()
+    {
+        thread_local stats_thread_slot slot;
+
+        return slot.counters;
+    }
+
+    inline transcode_stats stats_snapshot()
+    {
+        stats_registry &registry = stats_registry::instance();
+        std::lock_guard lock(registry.mutex);
+
+        transcode_stats s = registry.retired;
+
+        for (const stats_counters *counters : registry.live)
+        {
+            s += counters->load();
+            s -= counters->baseline;
+        }
+
+        return s;
+    }
+
+    inline void stats_reset()
+    {
+        stats_registry &registry = stats_registry::instance();
+        std::lock_guard lock(registry.mutex);
+
+        registry.retired = transcode_stats();
+
+        for (stats_counters *counters : registry.live)
+        {
+            counters->baseline = counters->load();
+        }
+    }
+
+    inline void stats_count_error(transcode_status status)
+    {
+        stats_counters &counters = thread_stats();
+
+        stats_counters::add(counters.errors[static_cast<std::size_t>(status)], 1);
+    }
+
+#else
+
+    inline constexpr bool stats_enabled = false;
+
+    inline transcode_stats stats_snapshot()
+    {
+        return transcode_stats();
+    }
+
+    inline void stats_reset()
+    {
+    }
+
+#endif
+
+    template <typename From, typename To>
+    struct transcode_probe
+    {
+        bool chunk = false;
+        std::uint64_t code_points = 0;
+        std::uint64_t ascii_code_points = 0;
+        std::uint64_t kernel_units = 0;
+
+        constexpr void decoded(char32_t ch)
+        {
+            ++code_points;
+            ascii_code_points += ch < U'\x80';
+        }
+
+        // Counts the units a bulk kernel converted with the count kernels;
+        // the converted span is well formed, so every unit that is not a
+        // UTF-8 tail or a low surrogate starts a code point.
+        void kernel(const typename From::unit_type *b, const typename From::unit_type *e)
+        {
+            using form = stats_form_of<From>;
+
+            constexpr std::uint32_t ascii_mask = static_cast<std::uint32_t>((std::uint64_t(1) << (8 * form::width)) - 1) & ~std::uint32_t(0x7f);
+            constexpr unit_match tails = form::value == stats_form::utf8 ? unit_match { 0xc0, 0x80 } : form::value == stats_form::utf16 ? unit_match { 0xfc00, 0xdc00 } : unit_match { 0, 1 };
+
+            auto n = count_matching_units<form::width, form::byte_order>(b, e, { ascii_mask, 0 }, tails);
+            auto units = static_cast<std::uint64_t>(e - b) * sizeof(typename From::unit_type) / form::width;
+
+            kernel_units += static_cast<std::uint64_t>(e - b);
+            code_points += units - n[1];
+            ascii_code_points += n[0];
+        }
+
+        constexpr transcode_result finish(transcode_result r) const
+        {
+#if defined(XTUAL_ENABLE_STATS)
+            if (!std::is_constant_evaluated())
+            {
+                constexpr std::uint64_t from_size = sizeof(typename From::unit_type);
+                constexpr std::uint64_t to_size = sizeof(typename To::unit_type);
+
+                stats_counters &counters = thread_stats();
+
+                stats_counters::add(counters.bytes_read[static_cast<std::size_t>(stats_form_of<From>::value)], r.read * from_size);
+                stats_counters::add(counters.bytes_written[static_cast<std::size_t>(stats_form_of<To>::value)], r.written * to_size);
+                stats_counters::add(counters.code_points, code_points);
+                stats_counters::add(counters.ascii_code_points, ascii_code_points);
+                stats_counters::add(counters.path_bytes[static_cast<std::size_t>(active_simd_level())], kernel_units * from_size);
+                stats_counters::add(counters.path_bytes[static_cast<std::size_t>(simd_level::scalar)], (r.read - kernel_units) * from_size);
+
+                if (r.status != transcode_status::ok && !(chunk && r.status == transcode_status::incomplete))
+                {
+                    stats_counters::add(counters.errors[static_cast<std::size_t>(r.status)], 1);
+                }
+            }
+#endif
+
+            return r;
+        }
+    };
+
+}
@@ -0,0 +1,219 @@
+namespace xtual
+{
+
+    template <typename From>
+    class stream_decoder
+    {
+    public:
+        using unit_type = typename From::unit_type;
+
+        constexpr explicit stream_decoder(error_policy policy = error_policy::strict)
+            : policy(policy)
+        {
+        }
+
+        constexpr bool has_pending() const
+        {
+            return size != 0;
+        }
+
+        constexpr void reset()
+        {
+            size = 0;
+        }
+
+        template <typename To = u32_codec>
+        constexpr transcode_result feed(std::span<const unit_type> in, std::span<typename To::unit_type> out)
+        {
+            std::size_t read = 0;
+            std::size_t written = 0;
+
+            transcode_status status = complete_pending<To>(in, out, read, written);
+
+            if (status != transcode_status::ok)
+            {
+                return { read, written, status };
+            }
+
+            while (true)
+            {
+                transcode_result r = transcode_units<From, To>(in.subspan(read), out.subspan(written), true);
+
+                read += r.read;
+                written += r.written;
+
+                if (r.status == transcode_status::ok || r.status == transcode_status::insufficient)
+                {
+                    return { read, written, r.status };
+                }
+
+                if (r.status == transcode_status::incomplete)
+                {
+                    for (; read != in.size(); ++read)
+                    {
+                        buf[size++] = in[read];
+                    }
+
+                    return { read, written, transcode_status::ok };
+                }
+
+                if (policy == error_policy::strict)
+                {
+                    return { read, written, transcode_status::invalid };
+                }
+
+                if (!replace<To>(out, written))
+                {
+                    return { read, written, transcode_status::insufficient };
+                }
+
+                read += skip_length<From>(in.data() + read, in.data() + in.size());
+            }
+        }
+
+        template <typename To = u32_codec>
+        constexpr transcode_result finish(std::span<typename To::unit_type> out)
+        {
+            transcode_result r = transcode<From, To>(std::span<const unit_type>(buf.data(), size), out, policy);
+
+            if (r.status != transcode_status::insufficient)
+            {
+                size = 0;
+            }
+
+            return { 0, r.status == transcode_status::insufficient ? 0 : r.written, r.status };
+        }
+
+    private:
+        template <typename To>
+        constexpr bool replace(std::span<typename To::unit_type> out, std::size_t &written)
+        {
+            auto *o = out.data() + written;
+
+            if (!To::encode(o, out.data() + out.size(), replacement_character<To>()))
+            {
+                return false;
+            }
+
+            written = static_cast<std::size_t>(o - out.data());
+
+            return true;
+        }
+
+        template <typename To>
+        constexpr transcode_status complete_pending(std::span<const unit_type> in, std::span<typename To::unit_type> out, std::size_t &read, std::size_t &written)
+        {
+            std::size_t carried = size;
+
+            while (size != 0)
+            {
+                const unit_type *p = buf.data();
+                char32_t ch;
+
+                transcode_status status = From::decode(p, buf.data() + size, ch);
+
+                if (status == transcode_status::incomplete)
+                {
+                    if (read == in.size())
+                    {
+                        return transcode_status::ok;
+                    }
+
+                    buf[size++] = in[read++];
+                }
+                else if (status == transcode_status::ok)
+                {
+                    auto *o = out.data() + written;
+
+                    if (!can_encode<To>(ch))
+                    {
+                        decode_error(transcode_status::invalid);
+
+                        if (policy == error_policy::strict)
+                        {
+                            read -= size - carried;
+                            size = 0;
+
+                            return transcode_status::invalid;
+                        }
+
+                        ch = replacement_character<To>();
+                    }
+
+                    if (!To::encode(o, out.data() + out.size(), ch))
+                    {
+                        read -= size - carried;
+                        size = carried;
+
+                        return transcode_status::insufficient;
+                    }
+
+                    written = static_cast<std::size_t>(o - out.data());
+                    size = 0;
+                }
+                else
+                {
+                    std::size_t skip = From::ill_formed_length(buf.data(), buf.data() + size);
+                    std::size_t keep = skip > carried ? skip : carried;
+
+                    read -= size - keep;
+                    size = keep;
+
+                    decode_error(transcode_status::invalid);
+
+                    if (policy == error_policy::strict)
+                    {
+                        read -= size - carried;
+                        size = 0;
+
+                        return transcode_status::invalid;
+                    }
+
+                    if (!replace<To>(out, written))
+                    {
+                        read -= size - carried;
+                        size = carried;
+
+                        return transcode_status::insufficient;
+                    }
+
+                    for (std::size_t k = skip; k < size; ++k)
+                    {
+                        buf[k - skip] = buf[k];
+                    }
+
+                    size -= skip;
+                    carried = size;
+                }
+            }
+
+            return transcode_status::ok;
+        }
+
+        std::array<unit_type, From::max_length> buf {};
+        std::size_t size = 0;
+        error_policy policy;
+    };
+
+    using u8_stream_decoder = stream_decoder<u8_codec>;
+
+    template <byte_like byteT>
+    using b8_stream_decoder = stream_decoder<b8_codec<byteT>>;
+
+    using u16_stream_decoder = stream_decoder<u16_codec>;
+
+    template <byte_like byteT>
+    using b16be_stream_decoder = stream_decoder<b16be_codec<byteT>>;
+
+    template <byte_like byteT>
+    using b16le_stream_decoder = stream_decoder<b16le_codec<byteT>>;
+
+    using u32_stream_decoder = stream_decoder<u32_codec>;
+
+    template <byte_like byteT>
+    using b32be_stream_decoder = stream_decoder<b32be_codec<byteT>>;
+
+    template <byte_like byteT>
+    using b32le_stream_decoder = stream_decoder<b32le_codec<byteT>>;
+
+}
@@ -0,0 +1,527 @@
+namespace xtual
+{
+
+    // Transcodes until the first failure. A chunk is a piece of a longer
+    // input, so a sequence cut off by its end is not counted as an error.
+    template <typename From, typename To>
+    constexpr transcode_result transcode_units(std::span<const typename From::unit_type> in, std::span<typename To::unit_type> out, bool chunk)
+    {
+        const auto *i = in.data();
+        const auto *ie = i + in.size();
+        auto *o = out.data();
+        auto *oe = o + out.size();
+
+        [[maybe_unused]] transcode_probe<From, To> probe { chunk };
+
+        while (i != ie)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                [[maybe_unused]] const auto *k = i;
+
+                transcode_kernel<From, To>::run(i, ie, o, oe);
+
+                if constexpr (stats_enabled)
+                {
+                    probe.kernel(k, i);
+                }
+
+                if (i == ie)
+                {
+                    break;
+                }
+            }
+
+            const auto *j = i;
+            char32_t ch;
+
+            transcode_status status = From::decode(j, ie, ch);
+
+            if (status != transcode_status::ok)
+            {
+                return probe.finish({ static_cast<std::size_t>(i - in.data()), static_cast<std::size_t>(o - out.data()), status });
+            }
+
+            if (!To::encode(o, oe, ch))
+            {
+                transcode_status failure = can_encode<To>(ch) ? transcode_status::insufficient : transcode_status::invalid;
+
+                return probe.finish({ static_cast<std::size_t>(i - in.data()), static_cast<std::size_t>(o - out.data()), failure });
+            }
+
+            if constexpr (stats_enabled)
+            {
+                probe.decoded(ch);
+            }
+
+            i = j;
+        }
+
+        return probe.finish({ in.size(), static_cast<std::size_t>(o - out.data()), transcode_status::ok });
+    }
+
+    template <typename From, typename To>
+    constexpr transcode_result transcode_strict(std::span<const typename From::unit_type> in, std::span<typename To::unit_type> out)
+    {
+        return transcode_units<From, To>(in, out, false);
+    }
+
+    template <typename From, typename To>
+    constexpr transcode_result transcode(std::span<const typename From::unit_type> in, std::span<typename To::unit_type> out, error_policy policy = error_policy::strict)
+    {
+        transcode_result r = transcode_strict<From, To>(in, out);
+
+        if (policy == error_policy::strict)
+        {
+            return r;
+        }
+
+        std::size_t read = r.read;
+        std::size_t written = r.written;
+
+        while (r.status == transcode_status::invalid || r.status == transcode_status::incomplete)
+        {
+            auto *o = out.data() + written;
+
+            if (!To::encode(o, out.data() + out.size(), replacement_character<To>()))
+            {
+                return { read, written, transcode_status::insufficient };
+            }
+
+            written = static_cast<std::size_t>(o - out.data());
+            read += skip_length<From>(in.data() + read, in.data() + in.size());
+
+            r = transcode_strict<From, To>(in.subspan(read), out.subspan(written));
+            read += r.read;
+            written += r.written;
+        }
+
+        return { read, written, r.status };
+    }
+
+    template <typename Codec>
+    constexpr std::size_t find_code_point_boundary(std::span<const typename Codec::unit_type> in, std::size_t n)
+    {
+        if (n >= in.size())
+        {
+            return in.size();
+        }
+
+        return static_cast<std::size_t>(Codec::resync(in.data(), in.data() + n, in.data() + in.size()) - in.data());
+    }
+
+    template <typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_u8(std::span<const char8_t> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_b8(std::span<const char8_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, b8_codec<byteT>>(in, out, policy);
+    }
+
+    template <typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_u16(std::span<const char8_t> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_b16be(std::span<const char8_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, b16be_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_b16le(std::span<const char8_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, b16le_codec<byteT>>(in, out, policy);
+    }
+
+    template <typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_u32(std::span<const char8_t> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_b32be(std::span<const char8_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, b32be_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_u8_to_b32le(std::span<const char8_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<utf8_codec<char8_t, Engine>, b32le_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_u8(std::span<const byteT> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<byteT, Engine>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_b8(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<inT, Engine>, b8_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_u16(std::span<const byteT> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<byteT, Engine>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_b16be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<inT, Engine>, b16be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_b16le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<inT, Engine>, b16le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_u32(std::span<const byteT> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<byteT, Engine>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_b32be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<inT, Engine>, b32be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT, typename Engine = utf8_branchy>
+    constexpr transcode_result transcode_b8_to_b32le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b8_codec<inT, Engine>, b32le_codec<outT>>(in, out, policy);
+    }
+
+    constexpr transcode_result transcode_u16_to_u8(std::span<const char16_t> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u16_to_b8(std::span<const char16_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, b8_codec<byteT>>(in, out, policy);
+    }
+
+    constexpr transcode_result transcode_u16_to_u16(std::span<const char16_t> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u16_to_b16be(std::span<const char16_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, b16be_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u16_to_b16le(std::span<const char16_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, b16le_codec<byteT>>(in, out, policy);
+    }
+
+    constexpr transcode_result transcode_u16_to_u32(std::span<const char16_t> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u16_to_b32be(std::span<const char16_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, b32be_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u16_to_b32le(std::span<const char16_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, b32le_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b16be_to_u8(std::span<const byteT> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<byteT>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16be_to_b8(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<inT>, b8_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b16be_to_u16(std::span<const byteT> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<byteT>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16be_to_b16be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<inT>, b16be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16be_to_b16le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<inT>, b16le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b16be_to_u32(std::span<const byteT> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<byteT>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16be_to_b32be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<inT>, b32be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16be_to_b32le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16be_codec<inT>, b32le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b16le_to_u8(std::span<const byteT> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<byteT>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16le_to_b8(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<inT>, b8_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b16le_to_u16(std::span<const byteT> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<byteT>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16le_to_b16be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<inT>, b16be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16le_to_b16le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<inT>, b16le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b16le_to_u32(std::span<const byteT> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<byteT>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16le_to_b32be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<inT>, b32be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b16le_to_b32le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b16le_codec<inT>, b32le_codec<outT>>(in, out, policy);
+    }
+
+    constexpr transcode_result transcode_u32_to_u8(std::span<const char32_t> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u32_to_b8(std::span<const char32_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, b8_codec<byteT>>(in, out, policy);
+    }
+
+    constexpr transcode_result transcode_u32_to_u16(std::span<const char32_t> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u32_to_b16be(std::span<const char32_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, b16be_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u32_to_b16le(std::span<const char32_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, b16le_codec<byteT>>(in, out, policy);
+    }
+
+    constexpr transcode_result transcode_u32_to_u32(std::span<const char32_t> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u32_to_b32be(std::span<const char32_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, b32be_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u32_to_b32le(std::span<const char32_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, b32le_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b32be_to_u8(std::span<const byteT> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<byteT>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32be_to_b8(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<inT>, b8_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b32be_to_u16(std::span<const byteT> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<byteT>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32be_to_b16be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<inT>, b16be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32be_to_b16le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<inT>, b16le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b32be_to_u32(std::span<const byteT> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<byteT>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32be_to_b32be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<inT>, b32be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32be_to_b32le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32be_codec<inT>, b32le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b32le_to_u8(std::span<const byteT> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<byteT>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32le_to_b8(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<inT>, b8_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b32le_to_u16(std::span<const byteT> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<byteT>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32le_to_b16be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<inT>, b16be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32le_to_b16le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<inT>, b16le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_b32le_to_u32(std::span<const byteT> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<byteT>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32le_to_b32be(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<inT>, b32be_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like inT, byte_like outT = inT>
+    constexpr transcode_result transcode_b32le_to_b32le(std::span<const inT> in, std::span<std::type_identity_t<outT>> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<b32le_codec<inT>, b32le_codec<outT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_latin1_to_u8(std::span<const byteT> in, std::span<char8_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<latin1_codec<byteT>, u8_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_latin1_to_u16(std::span<const byteT> in, std::span<char16_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<latin1_codec<byteT>, u16_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_latin1_to_u32(std::span<const byteT> in, std::span<char32_t> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<latin1_codec<byteT>, u32_codec>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u8_to_latin1(std::span<const char8_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u8_codec, latin1_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u16_to_latin1(std::span<const char16_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u16_codec, latin1_codec<byteT>>(in, out, policy);
+    }
+
+    template <byte_like byteT>
+    constexpr transcode_result transcode_u32_to_latin1(std::span<const char32_t> in, std::span<byteT> out, error_policy policy = error_policy::strict)
+    {
+        return transcode<u32_codec, latin1_codec<byteT>>(in, out, policy);
+    }
+
+}
@@ -0,0 +1,761 @@
+namespace xtual
+{
+
+#if defined(XTUAL_X86_SIMD)
+
+    struct utf8_compress_entry
+    {
+        std::array<std::uint8_t, 16> shuffle;
+        std::uint8_t length;
+    };
+
+    constexpr std::array<utf8_compress_entry, 256> make_utf8_pair_table()
+    {
+        std::array<utf8_compress_entry, 256> table {};
+
+        for (std::size_t key = 0; key < 256; ++key)
+        {
+            utf8_compress_entry &entry = table[key];
+            std::uint8_t n = 0;
+
+            for (std::uint8_t k = 0; k < 8; ++k)
+            {
+                entry.shuffle[n++] = static_cast<std::uint8_t>(2 * k);
+
+                if ((key >> k & 1) == 0)
+                {
+                    entry.shuffle[n++] = static_cast<std::uint8_t>(2 * k + 1);
+                }
+            }
+
+            entry.length = n;
+
+            while (n < 16)
+            {
+                entry.shuffle[n++] = 0x80;
+            }
+        }
+
+        return table;
+    }
+
+    constexpr std::array<utf8_compress_entry, 256> make_utf8_triple_table()
+    {
+        std::array<utf8_compress_entry, 256> table {};
+
+        for (std::size_t key = 0; key < 256; ++key)
+        {
+            utf8_compress_entry &entry = table[key];
+            std::uint8_t n = 0;
+
+            for (std::uint8_t k = 0; k < 4; ++k)
+            {
+                std::size_t length = 1 + (key >> k & 1) + (key >> (k + 4) & 1);
+
+                for (std::uint8_t j = 0; j < length; ++j)
+                {
+                    entry.shuffle[n++] = static_cast<std::uint8_t>(4 * k + j);
+                }
+            }
+
+            entry.length = n;
+
+            while (n < 16)
+            {
+                entry.shuffle[n++] = 0x80;
+            }
+        }
+
+        return table;
+    }
+
+    inline constexpr std::array<utf8_compress_entry, 256> utf8_pair_table = make_utf8_pair_table();
+
+    inline constexpr std::array<utf8_compress_entry, 256> utf8_triple_table = make_utf8_triple_table();
+
+    struct utf8_expand_shape
+    {
+        std::array<std::uint8_t, 16> shuffle;
+        std::array<std::uint8_t, 16> mask;
+        std::array<std::uint8_t, 16> expect;
+        std::array<std::uint8_t, 16> minimum;
+    };
+
+    struct utf8_expand_entry
+    {
+        std::uint8_t consumed;
+        std::uint8_t units;
+        std::uint16_t shape;
+    };
+
+    inline constexpr std::size_t utf8_pair_shapes = 64;
+
+    constexpr void set_utf8_lane(std::array<std::uint8_t, 16> &lanes, std::size_t offset, std::size_t width, std::uint32_t value)
+    {
+        for (std::size_t k = 0; k < width; ++k)
+        {
+            lanes[offset + k] = static_cast<std::uint8_t>(value >> (8 * k));
+        }
+    }
+
+    constexpr utf8_expand_shape make_utf8_expand_shape(const std::size_t lengths[], std::size_t count, std::size_t width)
+    {
+        constexpr std::uint32_t masks[] = { 0, 0xffffff80, 0xffffe0c0, 0xfff0c0c0 };
+        constexpr std::uint32_t expects[] = { 0, 0, 0xc080, 0xe08080 };
+        constexpr std::uint32_t minimums[] = { 0, 0, 0x80, 0x800 };
+
+        utf8_expand_shape shape {};
+        std::size_t position = 0;
+
+        shape.shuffle.fill(0x80);
+
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            std::size_t length = lengths[k];
+
+            for (std::size_t j = 0; j < length; ++j)
+            {
+                shape.shuffle[width * k + j] = static_cast<std::uint8_t>(position + length - 1 - j);
+            }
+
+            set_utf8_lane(shape.mask, width * k, width, masks[length]);
+            set_utf8_lane(shape.expect, width * k, width, expects[length]);
+            set_utf8_lane(shape.minimum, width * k, width, minimums[length]);
+            position += length;
+        }
+
+        return shape;
+    }
+
+    constexpr std::array<utf8_expand_shape, utf8_pair_shapes + 256> make_utf8_expand_shapes()
+    {
+        std::array<utf8_expand_shape, utf8_pair_shapes + 256> shapes {};
+
+        for (std::size_t key = 0; key < utf8_pair_shapes; ++key)
+        {
+            std::size_t lengths[6] {};
+
+            for (std::size_t k = 0; k < 6; ++k)
+            {
+                lengths[k] = 1 + (key >> k & 1);
+            }
+
+            shapes[key] = make_utf8_expand_shape(lengths, 6, 2);
+        }
+
+        for (std::size_t key = 0; key < 256; ++key)
+        {
+            std::size_t lengths[4] {};
+            std::size_t count = 0;
+
+            for (; count < 4 && (key >> (2 * count) & 3) != 0; ++count)
+            {
+                lengths[count] = key >> (2 * count) & 3;
+            }
+
+            shapes[utf8_pair_shapes + key] = make_utf8_expand_shape(lengths, count, 4);
+        }
+
+        return shapes;
+    }
+
+    constexpr std::array<utf8_expand_entry, 4096> make_utf8_expand_table()
+    {
+        std::array<utf8_expand_entry, 4096> table {};
+
+        for (std::size_t ends = 0; ends < 4096; ++ends)
+        {
+            std::size_t lengths[12] {};
+            std::size_t count = 0;
+            std::size_t position = 0;
+
+            for (std::size_t k = 0; k < 12; ++k)
+            {
+                if ((ends >> k & 1) != 0)
+                {
+                    lengths[count++] = k + 1 - position;
+                    position = k + 1;
+                }
+            }
+
+            std::size_t pairs = 0;
+            std::size_t triples = 0;
+
+            for (; pairs < std::min<std::size_t>(count, 6) && lengths[pairs] <= 2; ++pairs)
+            {
+            }
+
+            for (; triples < std::min<std::size_t>(count, 4) && lengths[triples] <= 3; ++triples)
+            {
+            }
+
+            utf8_expand_entry &entry = table[ends];
+            std::size_t key = 0;
+
+            if (pairs == 6)
+            {
+                for (std::size_t k = 0; k < 6; ++k)
+                {
+                    key |= (lengths[k] - 1) << k;
+                }
+
+                entry.units = 6;
+                entry.shape = static_cast<std::uint16_t>(key);
+            }
+            else
+            {
+                for (std::size_t k = 0; k < triples; ++k)
+                {
+                    key |= lengths[k] << (2 * k);
+                }
+
+                entry.units = static_cast<std::uint8_t>(triples);
+                entry.shape = static_cast<std::uint16_t>(utf8_pair_shapes + key);
+            }
+
+            for (std::size_t k = 0; k < entry.units; ++k)
+            {
+                entry.consumed = static_cast<std::uint8_t>(entry.consumed + lengths[k]);
+            }
+        }
+
+        return table;
+    }
+
+    inline constexpr std::array<utf8_expand_shape, utf8_pair_shapes + 256> utf8_expand_shapes = make_utf8_expand_shapes();
+
+    inline constexpr std::array<utf8_expand_entry, 4096> utf8_expand_table = make_utf8_expand_table();
+
+    XTUAL_TARGET("sse2") inline __m128i load_table_sse2(const std::array<std::uint8_t, 16> &table)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(table.data()));
+    }
+
+    template <std::endian order, typename unitT>
+    XTUAL_TARGET("sse2") inline __m128i load_utf16_sse2(const unitT *p)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+        return order == std::endian::native ? x : byteswap_epi16_sse2(x);
+    }
+
+    template <std::endian order, typename unitT>
+    XTUAL_TARGET("sse2") inline void store_utf16_sse2(unitT *p, __m128i x)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), order == std::endian::native ? x : byteswap_epi16_sse2(x));
+    }
+
+    template <typename From, typename To>
+    bool transcode_block_scalar(const typename From::unit_type *&i, const typename From::unit_type *e, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        while (i < e)
+        {
+            const auto *j = i;
+            char32_t ch;
+
+            if (From::decode(j, ie, ch) != transcode_status::ok || !To::encode(o, oe, ch))
+            {
+                return false;
+            }
+
+            i = j;
+        }
+
+        return true;
+    }
+
+    template <typename inT, typename outT>
+    XTUAL_TARGET("sse2") inline void utf16_to_utf8_ascii_sse2(const inT *&i, outT *&o, __m128i x, __m128i y)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm_packus_epi16(x, y));
+        i += 32 / sizeof(inT);
+        o += 16;
+    }
+
+    // Eight units holding surrogate pairs: each half of a pair carries two
+    // bytes of the four-byte sequence, so every lane is one to three bytes
+    // and the triple table compresses them. A high surrogate in the last
+    // lane is left for the next block.
+    template <typename inT, typename outT>
+    XTUAL_TARGET("ssse3") inline bool utf16_to_utf8_pairs_ssse3(const inT *&i, outT *&o, __m128i x)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i prefix = _mm_set1_epi16(static_cast<short>(0xfc00));
+
+        __m128i highs = _mm_cmpeq_epi16(_mm_and_si128(x, prefix), _mm_set1_epi16(static_cast<short>(0xd800)));
+        __m128i lows = _mm_cmpeq_epi16(_mm_and_si128(x, prefix), _mm_set1_epi16(static_cast<short>(0xdc00)));
+
+        auto high_bits = static_cast<std::uint32_t>(_mm_movemask_epi8(highs));
+        auto low_bits = static_cast<std::uint32_t>(_mm_movemask_epi8(lows));
+        std::size_t held = high_bits >> 15;
+
+        if (low_bits != (high_bits << 2 & 0xffff))
+        {
+            return false;
+        }
+
+        __m128i previous = _mm_slli_si128(x, 2);
+
+        for (std::size_t half = 0; half < 2; ++half)
+        {
+            const __m128i low6 = _mm_set1_epi32(0x3f);
+
+            __m128i w = half == 0 ? _mm_unpacklo_epi16(x, zero) : _mm_unpackhi_epi16(x, zero);
+            __m128i v = half == 0 ? _mm_unpacklo_epi16(previous, zero) : _mm_unpackhi_epi16(previous, zero);
+            __m128i h = half == 0 ? _mm_unpacklo_epi16(highs, highs) : _mm_unpackhi_epi16(highs, highs);
+            __m128i l = half == 0 ? _mm_unpacklo_epi16(lows, lows) : _mm_unpackhi_epi16(lows, lows);
+
+            __m128i two = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(w, 6), _mm_slli_epi32(_mm_and_si128(w, low6), 8)), _mm_set1_epi32(0x80c0));
+            __m128i three = _mm_or_si128(_mm_srli_epi32(w, 12), _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(w, 6), low6), 8));
+
+            three = _mm_or_si128(_mm_or_si128(three, _mm_slli_epi32(_mm_and_si128(w, low6), 16)), _mm_set1_epi32(0x8080e0));
+
+            // The plane plus one is bits 6-10 of the high surrogate; its low
+            // two bits are unchanged by the carry and reappear in the low lane.
+            __m128i plane = _mm_add_epi32(_mm_and_si128(w, _mm_set1_epi32(0x3ff)), _mm_set1_epi32(0x40));
+            __m128i lead = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(plane, 8), _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(plane, 2), low6), 8)), _mm_set1_epi32(0x80f0));
+            __m128i trail = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(3)), 4), _mm_and_si128(_mm_srli_epi32(w, 6), _mm_set1_epi32(0xf)));
+
+            trail = _mm_or_si128(_mm_or_si128(trail, _mm_slli_epi32(_mm_and_si128(w, low6), 8)), _mm_set1_epi32(0x8080));
+
+            __m128i pairs = _mm_or_si128(h, l);
+            __m128i ge80 = _mm_or_si128(_mm_cmpgt_epi32(w, _mm_set1_epi32(0x7f)), pairs);
+            __m128i ge800 = _mm_andnot_si128(pairs, _mm_cmpgt_epi32(w, _mm_set1_epi32(0x7ff)));
+            __m128i lanes = _mm_or_si128(_mm_and_si128(ge80, two), _mm_andnot_si128(ge80, w));
+
+            lanes = _mm_or_si128(_mm_and_si128(ge800, three), _mm_andnot_si128(ge800, lanes));
+            lanes = _mm_or_si128(_mm_and_si128(h, lead), _mm_andnot_si128(h, lanes));
+            lanes = _mm_or_si128(_mm_and_si128(l, trail), _mm_andnot_si128(l, lanes));
+
+            auto key = static_cast<std::size_t>(_mm_movemask_ps(_mm_castsi128_ps(ge80)) | _mm_movemask_ps(_mm_castsi128_ps(ge800)) << 4);
+            const utf8_compress_entry &entry = utf8_triple_table[key];
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm_shuffle_epi8(lanes, load_table_sse2(entry.shuffle)));
+            o += entry.length;
+        }
+
+        o -= 2 * held;
+        i += (8 - held) * 2 / sizeof(inT);
+
+        return true;
+    }
+
+    template <typename inT, typename outT>
+    XTUAL_TARGET("ssse3") inline bool utf16_to_utf8_block_ssse3(const inT *&i, outT *&o, __m128i x)
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        if (is_below_sse2<char16_t>(x, U'\x7ff'))
+        {
+            __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(x, _mm_set1_epi16(static_cast<short>(0xff80))), zero);
+            __m128i lead = _mm_or_si128(_mm_srli_epi16(x, 6), _mm_set1_epi16(0xc0));
+            __m128i tail = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(x, _mm_set1_epi16(0x3f)), 8), _mm_set1_epi16(static_cast<short>(0x8000)));
+            __m128i lanes = _mm_or_si128(_mm_and_si128(ascii, x), _mm_andnot_si128(ascii, _mm_or_si128(lead, tail)));
+
+            const utf8_compress_entry &entry = utf8_pair_table[static_cast<std::size_t>(_mm_movemask_epi8(_mm_packs_epi16(ascii, zero)))];
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm_shuffle_epi8(lanes, load_table_sse2(entry.shuffle)));
+            o += entry.length;
+        }
+        else if (is_valid_utf16_block(x))
+        {
+            for (__m128i w : { _mm_unpacklo_epi16(x, zero), _mm_unpackhi_epi16(x, zero) })
+            {
+                const __m128i low6 = _mm_set1_epi32(0x3f);
+
+                __m128i two = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(w, 6), _mm_slli_epi32(_mm_and_si128(w, low6), 8)), _mm_set1_epi32(0x80c0));
+                __m128i three = _mm_or_si128(_mm_srli_epi32(w, 12), _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(w, 6), low6), 8));
+
+                three = _mm_or_si128(_mm_or_si128(three, _mm_slli_epi32(_mm_and_si128(w, low6), 16)), _mm_set1_epi32(0x8080e0));
+
+                __m128i ge80 = _mm_cmpgt_epi32(w, _mm_set1_epi32(0x7f));
+                __m128i ge800 = _mm_cmpgt_epi32(w, _mm_set1_epi32(0x7ff));
+                __m128i lanes = _mm_or_si128(_mm_and_si128(ge80, two), _mm_andnot_si128(ge80, w));
+
+                lanes = _mm_or_si128(_mm_and_si128(ge800, three), _mm_andnot_si128(ge800, lanes));
+
+                auto key = static_cast<std::size_t>(_mm_movemask_ps(_mm_castsi128_ps(ge80)) | _mm_movemask_ps(_mm_castsi128_ps(ge800)) << 4);
+                const utf8_compress_entry &entry = utf8_triple_table[key];
+
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm_shuffle_epi8(lanes, load_table_sse2(entry.shuffle)));
+                o += entry.length;
+            }
+        }
+        else
+        {
+            return utf16_to_utf8_pairs_ssse3(i, o, x);
+        }
+
+        i += 16 / sizeof(inT);
+
+        return true;
+    }
+
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("sse2") void utf16_to_utf8_kernel_sse2(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(typename From::unit_type);
+
+        while (ie - i >= 2 * step && oe - o >= 16)
+        {
+            __m128i x = load_utf16_sse2<order>(i);
+            __m128i y = load_utf16_sse2<order>(i + step);
+
+            if (is_below_sse2<char16_t>(_mm_or_si128(x, y), U'\x7f'))
+            {
+                utf16_to_utf8_ascii_sse2(i, o, x, y);
+            }
+            else if (!transcode_block_scalar<From, To>(i, i + 2 * step, ie, o, oe))
+            {
+                return;
+            }
+        }
+    }
+
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("ssse3") void utf16_to_utf8_kernel_ssse3(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(typename From::unit_type);
+
+        while (ie - i >= 2 * step && oe - o >= 32)
+        {
+            __m128i x = load_utf16_sse2<order>(i);
+            __m128i y = load_utf16_sse2<order>(i + step);
+
+            if (is_below_sse2<char16_t>(_mm_or_si128(x, y), U'\x7f'))
+            {
+                utf16_to_utf8_ascii_sse2(i, o, x, y);
+            }
+            else if (!utf16_to_utf8_block_ssse3(i, o, x) && !transcode_block_scalar<From, To>(i, i + 2 * step, ie, o, oe))
+            {
+                return;
+            }
+        }
+
+        utf16_to_utf8_kernel_sse2<order, From, To>(i, ie, o, oe);
+    }
+
+    // Converts 32 ASCII units with one pack; otherwise runs the SSSE3 block
+    // over all four 8-unit quarters. Only quarters with an unpaired
+    // surrogate take the scalar codec, which stops at the error.
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("avx2") void utf16_to_utf8_kernel_avx2(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        constexpr std::ptrdiff_t step = 32 / sizeof(typename From::unit_type);
+
+        const __m256i high = _mm256_set1_epi16(static_cast<short>(0xff80));
+
+        while (ie - i >= 2 * step && oe - o >= 32)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(i + step));
+
+            if constexpr (order != std::endian::native)
+            {
+                x = byteswap_epi16_avx2(x);
+                y = byteswap_epi16_avx2(y);
+            }
+
+            if (_mm256_testz_si256(_mm256_or_si256(x, y), high))
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(o), _mm256_permute4x64_epi64(_mm256_packus_epi16(x, y), 0xd8));
+                i += 2 * step;
+                o += 32;
+            }
+            else
+            {
+                constexpr std::ptrdiff_t half = step / 2;
+
+                for (const auto *e = i + 2 * step; e - i >= half && oe - o >= 32;)
+                {
+                    if (!utf16_to_utf8_block_ssse3(i, o, load_utf16_sse2<order>(i)) && !transcode_block_scalar<From, To>(i, i + half, ie, o, oe))
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+
+        utf16_to_utf8_kernel_ssse3<order, From, To>(i, ie, o, oe);
+    }
+
+    template <std::endian order, typename outT>
+    XTUAL_TARGET("ssse3") inline const utf8_expand_entry *utf8_to_utf16_block_ssse3(__m128i x, std::uint64_t starts, outT *o)
+    {
+        const utf8_expand_entry &entry = utf8_expand_table[starts >> 1 & 0xfff];
+
+        if ((starts & 1) == 0 || entry.units == 0)
+        {
+            return nullptr;
+        }
+
+        const utf8_expand_shape &shape = utf8_expand_shapes[entry.shape];
+
+        __m128i lanes = _mm_shuffle_epi8(x, load_table_sse2(shape.shuffle));
+        __m128i matched = _mm_cmpeq_epi8(_mm_and_si128(lanes, load_table_sse2(shape.mask)), load_table_sse2(shape.expect));
+
+        if (_mm_movemask_epi8(matched) != 0xffff)
+        {
+            return nullptr;
+        }
+
+        __m128i units;
+
+        if (entry.shape < utf8_pair_shapes)
+        {
+            units = _mm_or_si128(_mm_and_si128(lanes, _mm_set1_epi16(0x7f)), _mm_and_si128(_mm_srli_epi16(lanes, 2), _mm_set1_epi16(0x7c0)));
+
+            if (_mm_movemask_epi8(_mm_cmplt_epi16(units, load_table_sse2(shape.minimum))) != 0)
+            {
+                return nullptr;
+            }
+        }
+        else
+        {
+            units = _mm_or_si128(_mm_and_si128(lanes, _mm_set1_epi32(0x7f)), _mm_and_si128(_mm_srli_epi32(lanes, 2), _mm_set1_epi32(0xfc0)));
+            units = _mm_or_si128(units, _mm_and_si128(_mm_srli_epi32(lanes, 4), _mm_set1_epi32(0xf000)));
+
+            __m128i surrogates = _mm_cmpeq_epi32(_mm_and_si128(units, _mm_set1_epi32(0xf800)), _mm_set1_epi32(0xd800));
+
+            if (_mm_movemask_epi8(_mm_or_si128(_mm_cmplt_epi32(units, load_table_sse2(shape.minimum)), surrogates)) != 0)
+            {
+                return nullptr;
+            }
+
+            units = _mm_shuffle_epi8(units, _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1));
+        }
+
+        store_utf16_sse2<order>(o, units);
+
+        return &entry;
+    }
+
+    template <std::endian order, typename inT, typename outT>
+    XTUAL_TARGET("sse2") inline void utf8_to_utf16_ascii_sse2(const inT *&i, outT *&o, __m128i x)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(outT);
+
+        const __m128i zero = _mm_setzero_si128();
+
+        store_utf16_sse2<order>(o, _mm_unpacklo_epi8(x, zero));
+        store_utf16_sse2<order>(o + step, _mm_unpackhi_epi8(x, zero));
+        i += 16;
+        o += 2 * step;
+    }
+
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("ssse3") inline bool utf8_to_utf16_window_ssse3(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe, std::uint64_t high, std::uint64_t starts)
+    {
+        const auto *e = i + 48;
+
+        while (i <= e)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i));
+
+            if ((high & 0xffff) == 0)
+            {
+                utf8_to_utf16_ascii_sse2<order>(i, o, x);
+                high >>= 16;
+                starts >>= 16;
+
+                continue;
+            }
+
+            const auto *p = i;
+            const utf8_expand_entry *entry = utf8_to_utf16_block_ssse3<order>(x, starts, o);
+
+            if (entry != nullptr)
+            {
+                i += entry->consumed;
+                o += entry->units * (2 / sizeof(typename To::unit_type));
+            }
+            else if (!transcode_block_scalar<From, To>(i, i + 1, ie, o, oe))
+            {
+                return false;
+            }
+
+            high >>= i - p;
+            starts >>= i - p;
+        }
+
+        return true;
+    }
+
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("sse2") void utf8_to_utf16_kernel_sse2(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(typename To::unit_type);
+
+        while (ie - i >= 16 && oe - o >= 2 * step)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i));
+
+            if (_mm_movemask_epi8(x) == 0)
+            {
+                utf8_to_utf16_ascii_sse2<order>(i, o, x);
+            }
+            else if (!transcode_block_scalar<From, To>(i, i + 16, ie, o, oe))
+            {
+                return;
+            }
+        }
+    }
+
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("ssse3") void utf8_to_utf16_kernel_ssse3(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(typename To::unit_type);
+
+        const __m128i tails = _mm_set1_epi8(static_cast<char>(0xbf));
+
+        while (ie - i >= 64 && oe - o >= 8 * step)
+        {
+            std::uint64_t high = 0;
+            std::uint64_t starts = 0;
+
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(i) + k);
+
+                high |= static_cast<std::uint64_t>(_mm_movemask_epi8(x)) << (16 * k);
+                starts |= static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(x, tails))) << (16 * k);
+            }
+
+            if (!utf8_to_utf16_window_ssse3<order, From, To>(i, ie, o, oe, high, starts))
+            {
+                return;
+            }
+        }
+
+        utf8_to_utf16_kernel_sse2<order, From, To>(i, ie, o, oe);
+    }
+
+    template <std::endian order, typename From, typename To>
+    XTUAL_TARGET("avx2") void utf8_to_utf16_kernel_avx2(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+        constexpr std::ptrdiff_t step = 32 / sizeof(typename To::unit_type);
+
+        const __m256i tails = _mm256_set1_epi8(static_cast<char>(0xbf));
+
+        while (ie - i >= 64 && oe - o >= 4 * step)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(i + 32));
+
+            auto high = static_cast<std::uint32_t>(_mm256_movemask_epi8(x)) | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(y))) << 32;
+
+            if (high == 0)
+            {
+                for (__m256i z : { x, y })
+                {
+                    __m256i lo = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(z));
+                    __m256i hi = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(z, 1));
+
+                    if constexpr (order != std::endian::native)
+                    {
+                        lo = byteswap_epi16_avx2(lo);
+                        hi = byteswap_epi16_avx2(hi);
+                    }
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(o), lo);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(o + step), hi);
+                    o += 2 * step;
+                }
+
+                i += 64;
+
+                continue;
+            }
+
+            auto starts = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(x, tails))) | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(y, tails)))) << 32;
+
+            if (!utf8_to_utf16_window_ssse3<order, From, To>(i, ie, o, oe, high, starts))
+            {
+                return;
+            }
+        }
+
+        utf8_to_utf16_kernel_ssse3<order, From, To>(i, ie, o, oe);
+    }
+
+#endif
+
+    template <std::endian order, typename From, typename To>
+    void utf16_to_utf8_kernel(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+#if defined(XTUAL_X86_SIMD)
+        switch (active_simd_level())
+        {
+        case simd_level::avx2:
+            utf16_to_utf8_kernel_avx2<order, From, To>(i, ie, o, oe);
+            break;
+        case simd_level::ssse3:
+            utf16_to_utf8_kernel_ssse3<order, From, To>(i, ie, o, oe);
+            break;
+        case simd_level::sse2:
+            utf16_to_utf8_kernel_sse2<order, From, To>(i, ie, o, oe);
+            break;
+        default:
+            break;
+        }
+#endif
+    }
+
+    template <std::endian order, typename From, typename To>
+    void utf8_to_utf16_kernel(const typename From::unit_type *&i, const typename From::unit_type *ie, typename To::unit_type *&o, typename To::unit_type *oe)
+    {
+#if defined(XTUAL_X86_SIMD)
+        switch (active_simd_level())
+        {
+        case simd_level::avx2:
+            utf8_to_utf16_kernel_avx2<order, From, To>(i, ie, o, oe);
+            break;
+        case simd_level::ssse3:
+            utf8_to_utf16_kernel_ssse3<order, From, To>(i, ie, o, oe);
+            break;
+        case simd_level::sse2:
+            utf8_to_utf16_kernel_sse2<order, From, To>(i, ie, o, oe);
+            break;
+        default:
+            break;
+        }
+#endif
+    }
+
+    template <typename charT, typename Engine>
+    struct transcode_kernel<u16_codec, utf8_codec<charT, Engine>>
+    {
+        static void run(const char16_t *&i, const char16_t *ie, charT *&o, charT *oe)
+        {
+            utf16_to_utf8_kernel<std::endian::native, u16_codec, utf8_codec<charT, Engine>>(i, ie, o, oe);
+        }
+    };
+
+    template <byte_like byteT, std::endian order, typename charT, typename Engine>
+    struct transcode_kernel<b16_codec<byteT, order>, utf8_codec<charT, Engine>>
+    {
+        static void run(const byteT *&i, const byteT *ie, charT *&o, charT *oe)
+        {
+            utf16_to_utf8_kernel<order, b16_codec<byteT, order>, utf8_codec<charT, Engine>>(i, ie, o, oe);
+        }
+    };
+
+    template <typename charT, typename Engine>
+    struct transcode_kernel<utf8_codec<charT, Engine>, u16_codec>
+    {
+        static void run(const charT *&i, const charT *ie, char16_t *&o, char16_t *oe)
+        {
+            utf8_to_utf16_kernel<std::endian::native, utf8_codec<charT, Engine>, u16_codec>(i, ie, o, oe);
+        }
+    };
+
+    template <typename charT, typename Engine, byte_like byteT, std::endian order>
+    struct transcode_kernel<utf8_codec<charT, Engine>, b16_codec<byteT, order>>
+    {
+        static void run(const charT *&i, const charT *ie, byteT *&o, byteT *oe)
+        {
+            utf8_to_utf16_kernel<order, utf8_codec<charT, Engine>, b16_codec<byteT, order>>(i, ie, o, oe);
+        }
+    };
+
+}
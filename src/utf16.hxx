@@ -2,8 +2,13 @@
 namespace xtual
 {
 
+    struct u16_codec;
+
+    template <byte_like byteT, std::endian order>
+    struct b16_codec;
+
     template <typename charT, std::output_iterator<charT> Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent, char16_t> Writ>
-    bool utf16_encode(Iter &i, Sent s, char32_t ch, Writ write)
+    constexpr bool utf16_encode(Iter &i, Sent s, char32_t ch, Writ write)
     {
         if (!is_code_point(ch))
         {
@@ -29,8 +34,16 @@ namespace xtual
     }
 
     template <std::output_iterator<char16_t> Iter, std::sentinel_for<Iter> Sent>
-    bool encode_as_u16(Iter &i, Sent s, char32_t ch)
+    constexpr bool encode_as_u16(Iter &i, Sent s, char32_t ch)
     {
+        if constexpr (contiguous_units<Iter, Sent, char16_t>)
+        {
+            if (encode_contiguous<u16_codec>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
         return utf16_encode<char16_t>(i, s, ch, [](Iter &i, Sent s, char16_t ch) {
             if (i == s)
             {
@@ -44,8 +57,16 @@ namespace xtual
     }
 
     template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
-    bool encode_as_b16be(Iter &i, Sent s, char32_t ch)
+    constexpr bool encode_as_b16be(Iter &i, Sent s, char32_t ch)
     {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (encode_contiguous<b16_codec<byteT, std::endian::big>>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
         return utf16_encode<byteT>(i, s, ch, [](Iter &i, Sent s, char16_t ch) {
             if (i == s)
             {
@@ -66,8 +87,16 @@ namespace xtual
     }
 
     template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
-    bool encode_as_b16le(Iter &i, Sent s, char32_t ch)
+    constexpr bool encode_as_b16le(Iter &i, Sent s, char32_t ch)
     {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (encode_contiguous<b16_codec<byteT, std::endian::little>>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
         return utf16_encode<byteT>(i, s, ch, [](Iter &i, Sent s, char16_t ch) {
             if (i == s)
             {
@@ -87,15 +116,24 @@ namespace xtual
         });
     }
 
+    constexpr char32_t decode_utf16_2(char16_t w1, char16_t w2)
+    {
+        char32_t u = ((static_cast<char32_t>(w1) & U'\x3ff') << 10)
+            | (static_cast<char32_t>(w2) & U'\x3ff');
+
+        return u + U'\x10000';
+    }
+
     template <typename charT, std::input_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
     requires std::convertible_to<std::iter_value_t<Iter>, charT>
-    std::optional<char32_t> utf16_decode(Iter &i, Sent s, Rdr read)
+    constexpr std::optional<char32_t> utf16_decode(Iter &i, Sent s, Rdr read)
     {
+        bool empty = i == s;
         auto opt1 = read(i, s);
 
         if (!opt1.has_value())
         {
-            return std::nullopt;
+            return empty ? std::nullopt : decode_error(transcode_status::incomplete);
         }
 
         char16_t w1 = opt1.value();
@@ -107,33 +145,38 @@ namespace xtual
         
         if (!is_high_surrogate(w1))
         {
-            return std::nullopt;
+            return decode_error(transcode_status::invalid);
         }
 
         auto opt2 = read(i, s);
 
         if (!opt2.has_value())
         {
-            return std::nullopt;
+            return decode_error(transcode_status::incomplete);
         }
 
         char16_t w2 = opt2.value();
 
         if (!is_low_surrogate(w2))
         {
-            return std::nullopt;
+            return decode_error(transcode_status::invalid);
         }
 
-        char32_t u = ((static_cast<char32_t>(w1) & U'\x3ff') << 10)
-            | (static_cast<char32_t>(w2) & U'\x3ff');
-
-        return u + U'\x10000';
+        return decode_utf16_2(w1, w2);
     }
 
     template <std::input_iterator Iter, std::sentinel_for<Iter> Sent>
     requires std::convertible_to<std::iter_value_t<Iter>, char16_t>
-    std::optional<char32_t> decode_from_u16(Iter &i, Sent s)
+    constexpr std::optional<char32_t> decode_from_u16(Iter &i, Sent s)
     {
+        if constexpr (contiguous_units<Iter, Sent, char16_t>)
+        {
+            if (auto ch = decode_contiguous<u16_codec>(i, s))
+            {
+                return ch;
+            }
+        }
+
         return utf16_decode<char16_t>(i, s, [](Iter &i, Sent s) -> std::optional<char16_t> {
             if (i == s)
             {
@@ -146,8 +189,16 @@ namespace xtual
 
     template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
     requires std::convertible_to<std::iter_value_t<Iter>, byteT>
-    std::optional<char32_t> decode_from_b16be(Iter &i, Sent s)
+    constexpr std::optional<char32_t> decode_from_b16be(Iter &i, Sent s)
     {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b16_codec<byteT, std::endian::big>>(i, s))
+            {
+                return ch;
+            }
+        }
+
         return utf16_decode<byteT>(i, s, [](Iter &i, Sent s) -> std::optional<char16_t> {
             if (i == s)
             {
@@ -171,8 +222,16 @@ namespace xtual
 
     template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
     requires std::convertible_to<std::iter_value_t<Iter>, byteT>
-    std::optional<char32_t> decode_from_b16le(Iter &i, Sent s)
+    constexpr std::optional<char32_t> decode_from_b16le(Iter &i, Sent s)
     {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b16_codec<byteT, std::endian::little>>(i, s))
+            {
+                return ch;
+            }
+        }
+
         return utf16_decode<byteT>(i, s, [](Iter &i, Sent s) -> std::optional<char16_t> {
             if (i == s)
             {
@@ -194,4 +253,386 @@ namespace xtual
         });
     }
     
+    template <std::bidirectional_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, char16_t>
+    constexpr std::optional<char32_t> decode_backward_from_u16(Iter &i, Sent s)
+    {
+        return decode_backward(i, s, 1, 2, [](const Iter &j) {
+            return is_low_surrogate(static_cast<char16_t>(*j));
+        }, [](Iter &k, const Iter &e) {
+            return decode_from_u16(k, e);
+        });
+    }
+
+    template <byte_like byteT, std::bidirectional_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_backward_from_b16be(Iter &i, Sent s)
+    {
+        return decode_backward(i, s, 2, 2, [](const Iter &j) {
+            char16_t c1 = static_cast<char16_t>(static_cast<std::byte>(static_cast<byteT>(*j)));
+            char16_t c2 = static_cast<char16_t>(static_cast<std::byte>(static_cast<byteT>(*std::next(j))));
+
+            return is_low_surrogate(static_cast<char16_t>((c1 << 8) | c2));
+        }, [](Iter &k, const Iter &e) {
+            return decode_from_b16be<byteT>(k, e);
+        });
+    }
+
+    template <byte_like byteT, std::bidirectional_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_backward_from_b16le(Iter &i, Sent s)
+    {
+        return decode_backward(i, s, 2, 2, [](const Iter &j) {
+            char16_t c1 = static_cast<char16_t>(static_cast<std::byte>(static_cast<byteT>(*j)));
+            char16_t c2 = static_cast<char16_t>(static_cast<std::byte>(static_cast<byteT>(*std::next(j))));
+
+            return is_low_surrogate(static_cast<char16_t>(c1 | (c2 << 8)));
+        }, [](Iter &k, const Iter &e) {
+            return decode_from_b16le<byteT>(k, e);
+        });
+    }
+
+    template <typename charT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
+    requires std::convertible_to<std::iter_value_t<Iter>, charT>
+    constexpr std::optional<char32_t> utf16_decode_lossy(Iter &i, Sent s, Rdr read)
+    {
+        if (i == s)
+        {
+            return std::nullopt;
+        }
+
+        Iter j = i;
+        auto opt = utf16_decode<charT>(j, s, read);
+
+        if (opt.has_value())
+        {
+            i = j;
+
+            return opt;
+        }
+
+        read(i, s);
+
+        return U'\xfffd';
+    }
+
+    template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, char16_t>
+    constexpr std::optional<char32_t> decode_lossy_from_u16(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, char16_t>)
+        {
+            if (auto ch = decode_contiguous<u16_codec>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf16_decode_lossy<char16_t>(i, s, [](Iter &i, Sent s) -> std::optional<char16_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            return *i++;
+        });
+    }
+    template <byte_like byteT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_b16be(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b16_codec<byteT, std::endian::big>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf16_decode_lossy<byteT>(i, s, [](Iter &i, Sent s) -> std::optional<char16_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b1 = *i++;
+            char16_t c1 = static_cast<char16_t>(static_cast<std::byte>(b1));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b2 = *i++;
+            char16_t c2 = static_cast<char16_t>(static_cast<std::byte>(b2));
+
+            return (c1 << 8) | c2;
+        });
+    }
+    template <byte_like byteT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_b16le(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b16_codec<byteT, std::endian::little>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf16_decode_lossy<byteT>(i, s, [](Iter &i, Sent s) -> std::optional<char16_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b1 = *i++;
+            char16_t c1 = static_cast<char16_t>(static_cast<std::byte>(b1));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b2 = *i++;
+            char16_t c2 = static_cast<char16_t>(static_cast<std::byte>(b2));
+
+            return c1 | (c2 << 8);
+        });
+    }
+
+    struct u16_codec
+    {
+        using unit_type = char16_t;
+
+        static constexpr std::size_t max_length = 2;
+
+        static constexpr const char16_t *resync(const char16_t *b, const char16_t *p, const char16_t *)
+        {
+            return p != b && is_low_surrogate(p[0]) && is_high_surrogate(p[-1]) ? p - 1 : p;
+        }
+
+        static constexpr std::size_t ill_formed_length(const char16_t *, const char16_t *)
+        {
+            return 1;
+        }
+
+        static constexpr transcode_status decode(const char16_t *&p, const char16_t *e, char32_t &ch)
+        {
+            char16_t w1 = p[0];
+
+            if (!is_surrogate(w1))
+            {
+                ch = static_cast<char32_t>(w1);
+                p += 1;
+
+                return transcode_status::ok;
+            }
+
+            if (!is_high_surrogate(w1))
+            {
+                return transcode_status::invalid;
+            }
+
+            if (e - p < 2)
+            {
+                return transcode_status::incomplete;
+            }
+
+            char16_t w2 = p[1];
+
+            if (!is_low_surrogate(w2))
+            {
+                return transcode_status::invalid;
+            }
+
+            ch = decode_utf16_2(w1, w2);
+            p += 2;
+
+            return transcode_status::ok;
+        }
+
+        static constexpr bool encode(char16_t *&p, char16_t *e, char32_t ch)
+        {
+            if ((ch & ~U'\xffff') == 0)
+            {
+                if (p == e)
+                {
+                    return false;
+                }
+
+                *p++ = static_cast<char16_t>(ch);
+
+                return true;
+            }
+
+            if (e - p < 2)
+            {
+                return false;
+            }
+
+            char32_t u = ch - U'\x10000';
+
+            *p++ = static_cast<char16_t>(0xd800 | ((u >> 10) & 0x3ff));
+            *p++ = static_cast<char16_t>(0xdc00 | (u & 0x3ff));
+
+            return true;
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct b16_codec
+    {
+        using unit_type = byteT;
+
+        static constexpr std::size_t max_length = 4;
+
+        static constexpr char16_t load(const byteT *p)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                std::uint16_t u;
+                std::memcpy(&u, p, 2);
+
+                return static_cast<char16_t>(order == std::endian::native ? u : byteswap(u));
+            }
+
+            char16_t c1 = static_cast<char16_t>(static_cast<std::byte>(p[0]));
+            char16_t c2 = static_cast<char16_t>(static_cast<std::byte>(p[1]));
+
+            if constexpr (order == std::endian::big)
+            {
+                return (c1 << 8) | c2;
+            }
+            else
+            {
+                return c1 | (c2 << 8);
+            }
+        }
+
+        static constexpr void store(byteT *p, char16_t ch)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                std::uint16_t u = static_cast<std::uint16_t>(ch);
+
+                if constexpr (order != std::endian::native)
+                {
+                    u = byteswap(u);
+                }
+
+                std::memcpy(p, &u, 2);
+
+                return;
+            }
+
+            std::byte hi = static_cast<std::byte>((ch >> 8) & 0xff);
+            std::byte lo = static_cast<std::byte>(ch & 0xff);
+
+            if constexpr (order == std::endian::big)
+            {
+                p[0] = static_cast<byteT>(hi);
+                p[1] = static_cast<byteT>(lo);
+            }
+            else
+            {
+                p[0] = static_cast<byteT>(lo);
+                p[1] = static_cast<byteT>(hi);
+            }
+        }
+
+        static constexpr const byteT *resync(const byteT *b, const byteT *p, const byteT *e)
+        {
+            p = b + ((p - b) & ~std::ptrdiff_t(1));
+
+            if (e - p < 2)
+            {
+                return p;
+            }
+
+            return p != b && is_low_surrogate(load(p)) && is_high_surrogate(load(p - 2)) ? p - 2 : p;
+        }
+
+        static constexpr std::size_t ill_formed_length(const byteT *p, const byteT *e)
+        {
+            return e - p < 2 ? static_cast<std::size_t>(e - p) : 2;
+        }
+
+        static constexpr transcode_status decode(const byteT *&p, const byteT *e, char32_t &ch)
+        {
+            if (e - p < 2)
+            {
+                return transcode_status::incomplete;
+            }
+
+            char16_t w1 = load(p);
+
+            if (!is_surrogate(w1))
+            {
+                ch = static_cast<char32_t>(w1);
+                p += 2;
+
+                return transcode_status::ok;
+            }
+
+            if (!is_high_surrogate(w1))
+            {
+                return transcode_status::invalid;
+            }
+
+            if (e - p < 4)
+            {
+                return transcode_status::incomplete;
+            }
+
+            char16_t w2 = load(p + 2);
+
+            if (!is_low_surrogate(w2))
+            {
+                return transcode_status::invalid;
+            }
+
+            ch = decode_utf16_2(w1, w2);
+            p += 4;
+
+            return transcode_status::ok;
+        }
+
+        static constexpr bool encode(byteT *&p, byteT *e, char32_t ch)
+        {
+            if ((ch & ~U'\xffff') == 0)
+            {
+                if (e - p < 2)
+                {
+                    return false;
+                }
+
+                store(p, static_cast<char16_t>(ch));
+                p += 2;
+
+                return true;
+            }
+
+            if (e - p < 4)
+            {
+                return false;
+            }
+
+            char32_t u = ch - U'\x10000';
+
+            store(p, static_cast<char16_t>(0xd800 | ((u >> 10) & 0x3ff)));
+            store(p + 2, static_cast<char16_t>(0xdc00 | (u & 0x3ff)));
+            p += 4;
+
+            return true;
+        }
+    };
+
+    template <byte_like byteT>
+    using b16be_codec = b16_codec<byteT, std::endian::big>;
+
+    template <byte_like byteT>
+    using b16le_codec = b16_codec<byteT, std::endian::little>;
+    
 }
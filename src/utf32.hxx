@@ -2,8 +2,13 @@
 namespace xtual
 {
 
+    struct u32_codec;
+
+    template <byte_like byteT, std::endian order>
+    struct b32_codec;
+
     template <typename charT, std::output_iterator<charT> Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent, char32_t> Writ>
-    bool utf32_encode(Iter &i, Sent s, char32_t ch, Writ write)
+    constexpr bool utf32_encode(Iter &i, Sent s, char32_t ch, Writ write)
     {
         if (!is_code_point(ch))
         {
@@ -14,8 +19,16 @@ namespace xtual
     }
 
     template <std::output_iterator<char32_t> Iter, std::sentinel_for<Iter> Sent>
-    bool encode_as_u32(Iter &i, Sent s, char32_t ch)
+    constexpr bool encode_as_u32(Iter &i, Sent s, char32_t ch)
     {
+        if constexpr (contiguous_units<Iter, Sent, char32_t>)
+        {
+            if (encode_contiguous<u32_codec>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
         return utf32_encode<char32_t>(i, s, ch, [](Iter &i, Sent s, char32_t ch) {
             if (i == s)
             {
@@ -29,8 +42,16 @@ namespace xtual
     }
 
     template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
-    bool encode_as_b32be(Iter &i, Sent s, char32_t ch)
+    constexpr bool encode_as_b32be(Iter &i, Sent s, char32_t ch)
     {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (encode_contiguous<b32_codec<byteT, std::endian::big>>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
         return utf32_encode<byteT>(i, s, ch, [](Iter &i, Sent s, char32_t ch) {
             if (i == s)
             {
@@ -65,8 +86,16 @@ namespace xtual
     }
 
     template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
-    bool encode_as_b32le(Iter &i, Sent s, char32_t ch)
+    constexpr bool encode_as_b32le(Iter &i, Sent s, char32_t ch)
     {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (encode_contiguous<b32_codec<byteT, std::endian::little>>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
         return utf32_encode<byteT>(i, s, ch, [](Iter &i, Sent s, char32_t ch) {
             if (i == s)
             {
@@ -101,20 +130,21 @@ namespace xtual
     }
 
     template <std::input_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
-    std::optional<char32_t> utf32_decode(Iter &i, Sent s, Rdr read)
+    constexpr std::optional<char32_t> utf32_decode(Iter &i, Sent s, Rdr read)
     {
+        bool empty = i == s;
         auto opt = read(i, s);
 
         if (!opt.has_value())
         {
-            return std::nullopt;
+            return empty ? std::nullopt : decode_error(transcode_status::incomplete);
         }
 
         char32_t ch = opt.value();
 
         if (!is_code_point(ch))
         {
-            return std::nullopt;
+            return decode_error(transcode_status::invalid);
         }
         else
         {
@@ -124,8 +154,16 @@ namespace xtual
 
     template <std::input_iterator Iter, std::sentinel_for<Iter> Sent>
     requires std::convertible_to<std::iter_value_t<Iter>, char32_t>
-    std::optional<char32_t> decode_from_u32(Iter &i, Sent s)
+    constexpr std::optional<char32_t> decode_from_u32(Iter &i, Sent s)
     {
+        if constexpr (contiguous_units<Iter, Sent, char32_t>)
+        {
+            if (auto ch = decode_contiguous<u32_codec>(i, s))
+            {
+                return ch;
+            }
+        }
+
         return utf32_decode(i, s, [](Iter &i, Sent s) -> std::optional<char32_t> {
             if (i == s)
             {
@@ -138,8 +176,16 @@ namespace xtual
 
     template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
     requires std::convertible_to<std::iter_value_t<Iter>, byteT>
-    std::optional<char32_t> decode_from_b32be(Iter &i, Sent s)
+    constexpr std::optional<char32_t> decode_from_b32be(Iter &i, Sent s)
     {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b32_codec<byteT, std::endian::big>>(i, s))
+            {
+                return ch;
+            }
+        }
+
         return utf32_decode(i, s, [](Iter &i, Sent s) -> std::optional<char32_t> {
             if (i == s)
             {
@@ -179,8 +225,16 @@ namespace xtual
 
     template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
     requires std::convertible_to<std::iter_value_t<Iter>, byteT>
-    std::optional<char32_t> decode_from_b32le(Iter &i, Sent s)
+    constexpr std::optional<char32_t> decode_from_b32le(Iter &i, Sent s)
     {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b32_codec<byteT, std::endian::little>>(i, s))
+            {
+                return ch;
+            }
+        }
+
         return utf32_decode(i, s, [](Iter &i, Sent s) -> std::optional<char32_t> {
             if (i == s)
             {
@@ -217,5 +271,293 @@ namespace xtual
             return c1 | (c2 << 8) | (c3 << 16) | (c4 << 24);
         });
     }
+
+    template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
+    constexpr std::optional<char32_t> utf32_decode_lossy(Iter &i, Sent s, Rdr read)
+    {
+        if (i == s)
+        {
+            return std::nullopt;
+        }
+
+        Iter j = i;
+        auto opt = utf32_decode(j, s, read);
+
+        if (opt.has_value())
+        {
+            i = j;
+
+            return opt;
+        }
+
+        read(i, s);
+
+        return U'\xfffd';
+    }
+
+    template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, char32_t>
+    constexpr std::optional<char32_t> decode_lossy_from_u32(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, char32_t>)
+        {
+            if (auto ch = decode_contiguous<u32_codec>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf32_decode_lossy(i, s, [](Iter &i, Sent s) -> std::optional<char32_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            return *i++;
+        });
+    }
+    template <byte_like byteT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_b32be(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b32_codec<byteT, std::endian::big>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf32_decode_lossy(i, s, [](Iter &i, Sent s) -> std::optional<char32_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b1 = *i++;
+            char32_t c1 = static_cast<char32_t>(static_cast<std::byte>(b1));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b2 = *i++;
+            char32_t c2 = static_cast<char32_t>(static_cast<std::byte>(b2));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b3 = *i++;
+            char32_t c3 = static_cast<char32_t>(static_cast<std::byte>(b3));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b4 = *i++;
+            char32_t c4 = static_cast<char32_t>(static_cast<std::byte>(b4));
+
+            return (c1 << 24) | (c2 << 16) | (c3 << 8) | c4;
+        });
+    }
+    template <byte_like byteT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_lossy_from_b32le(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<b32_codec<byteT, std::endian::little>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf32_decode_lossy(i, s, [](Iter &i, Sent s) -> std::optional<char32_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b1 = *i++;
+            char32_t c1 = static_cast<char32_t>(static_cast<std::byte>(b1));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b2 = *i++;
+            char32_t c2 = static_cast<char32_t>(static_cast<std::byte>(b2));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b3 = *i++;
+            char32_t c3 = static_cast<char32_t>(static_cast<std::byte>(b3));
+
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            byteT b4 = *i++;
+            char32_t c4 = static_cast<char32_t>(static_cast<std::byte>(b4));
+
+            return c1 | (c2 << 8) | (c3 << 16) | (c4 << 24);
+        });
+    }
+
+    struct u32_codec
+    {
+        using unit_type = char32_t;
+
+        static constexpr std::size_t max_length = 1;
+
+        static constexpr const char32_t *resync(const char32_t *, const char32_t *p, const char32_t *)
+        {
+            return p;
+        }
+
+        static constexpr std::size_t ill_formed_length(const char32_t *, const char32_t *)
+        {
+            return 1;
+        }
+
+        static constexpr transcode_status decode(const char32_t *&p, const char32_t *, char32_t &ch)
+        {
+            if (!is_code_point(*p))
+            {
+                return transcode_status::invalid;
+            }
+
+            ch = *p++;
+
+            return transcode_status::ok;
+        }
+
+        static constexpr bool encode(char32_t *&p, char32_t *e, char32_t ch)
+        {
+            if (p == e)
+            {
+                return false;
+            }
+
+            *p++ = ch;
+
+            return true;
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct b32_codec
+    {
+        using unit_type = byteT;
+
+        static constexpr std::size_t max_length = 4;
+
+        static constexpr char32_t load(const byteT *p)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                std::uint32_t u;
+                std::memcpy(&u, p, 4);
+
+                return static_cast<char32_t>(order == std::endian::native ? u : byteswap(u));
+            }
+
+            char32_t c1 = static_cast<char32_t>(static_cast<std::byte>(p[0]));
+            char32_t c2 = static_cast<char32_t>(static_cast<std::byte>(p[1]));
+            char32_t c3 = static_cast<char32_t>(static_cast<std::byte>(p[2]));
+            char32_t c4 = static_cast<char32_t>(static_cast<std::byte>(p[3]));
+
+            if constexpr (order == std::endian::big)
+            {
+                return (c1 << 24) | (c2 << 16) | (c3 << 8) | c4;
+            }
+            else
+            {
+                return c1 | (c2 << 8) | (c3 << 16) | (c4 << 24);
+            }
+        }
+
+        static constexpr void store(byteT *p, char32_t ch)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                std::uint32_t u = static_cast<std::uint32_t>(ch);
+
+                if constexpr (order != std::endian::native)
+                {
+                    u = byteswap(u);
+                }
+
+                std::memcpy(p, &u, 4);
+
+                return;
+            }
+
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                std::size_t shift = order == std::endian::big ? 24 - 8 * k : 8 * k;
+
+                p[k] = static_cast<byteT>(static_cast<std::byte>((ch >> shift) & 0xff));
+            }
+        }
+
+        static constexpr const byteT *resync(const byteT *b, const byteT *p, const byteT *)
+        {
+            return b + ((p - b) & ~std::ptrdiff_t(3));
+        }
+
+        static constexpr std::size_t ill_formed_length(const byteT *p, const byteT *e)
+        {
+            return e - p < 4 ? static_cast<std::size_t>(e - p) : 4;
+        }
+
+        static constexpr transcode_status decode(const byteT *&p, const byteT *e, char32_t &ch)
+        {
+            if (e - p < 4)
+            {
+                return transcode_status::incomplete;
+            }
+
+            char32_t u = load(p);
+
+            if (!is_code_point(u))
+            {
+                return transcode_status::invalid;
+            }
+
+            ch = u;
+            p += 4;
+
+            return transcode_status::ok;
+        }
+
+        static constexpr bool encode(byteT *&p, byteT *e, char32_t ch)
+        {
+            if (e - p < 4)
+            {
+                return false;
+            }
+
+            store(p, ch);
+            p += 4;
+
+            return true;
+        }
+    };
+
+    template <byte_like byteT>
+    using b32be_codec = b32_codec<byteT, std::endian::big>;
+
+    template <byte_like byteT>
+    using b32le_codec = b32_codec<byteT, std::endian::little>;
     
 }
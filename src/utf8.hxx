@@ -2,8 +2,55 @@
 namespace xtual
 {
 
+    struct utf8_branchy
+    {
+    };
+
+    // Namespace-scope tables rather than static members, which GCC 12 does
+    // not emit for importers of the module.
+    inline constexpr std::uint8_t utf8_dfa_classes[256] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+        7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+        8, 8, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        10, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 4, 3, 3, 11, 6, 6, 6, 5, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8
+    };
+
+    inline constexpr std::uint8_t utf8_dfa_transitions[108] = {
+        0, 12, 24, 36, 60, 96, 72, 12, 12, 12, 48, 84,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 0, 12, 12, 12, 12, 12, 0, 12, 0, 12, 12,
+        12, 24, 12, 12, 12, 12, 12, 24, 12, 24, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 24, 12, 12, 12, 12,
+        12, 24, 12, 12, 12, 12, 12, 12, 12, 24, 12, 12,
+        12, 36, 12, 12, 12, 12, 12, 36, 12, 36, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 36, 12, 36, 12, 12,
+        12, 36, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12
+    };
+
+    struct utf8_dfa
+    {
+        static constexpr std::uint8_t accept = 0;
+        static constexpr std::uint8_t reject = 12;
+
+        static constexpr std::uint8_t step(std::uint8_t state, char32_t &ch, char8_t w)
+        {
+            std::uint8_t type = utf8_dfa_classes[w];
+
+            ch = state == accept ? (0xffu >> type) & w : (w & 0x3fu) | (ch << 6);
+
+            return utf8_dfa_transitions[state + type];
+        }
+    };
+
+    template <typename charT, typename Engine = utf8_branchy>
+    struct utf8_codec;
+
     template <typename charT, std::output_iterator<charT> Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent, char8_t> Writ>
-    bool utf8_encode(Iter &i, Sent s, char32_t ch, Writ write)
+    constexpr bool utf8_encode(Iter &i, Sent s, char32_t ch, Writ write)
     {
         if (!is_code_point(ch))
         {
@@ -58,8 +105,16 @@ namespace xtual
     }
     
     template <std::output_iterator<char8_t> Iter, std::sentinel_for<Iter> Sent>
-    bool encode_as_u8(Iter &i, Sent s, char32_t ch)
+    constexpr bool encode_as_u8(Iter &i, Sent s, char32_t ch)
     {
+        if constexpr (contiguous_units<Iter, Sent, char8_t>)
+        {
+            if (encode_contiguous<utf8_codec<char8_t>>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
         return utf8_encode<char8_t>(i, s, ch, [](Iter &i, Sent s, char8_t ch) {
             if (i == s)
             {
@@ -73,8 +128,16 @@ namespace xtual
     }
 
     template <byte_like byteT, std::output_iterator<byteT> Iter, std::sentinel_for<Iter> Sent>
-    bool encode_as_b8(Iter &i, Sent s, char32_t ch)
+    constexpr bool encode_as_b8(Iter &i, Sent s, char32_t ch)
     {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (encode_contiguous<utf8_codec<byteT>>(i, s, ch))
+            {
+                return true;
+            }
+        }
+
         return utf8_encode<byteT>(i, s, ch, [](Iter &i, Sent s, char8_t ch) {
             if (i == s)
             {
@@ -148,8 +211,76 @@ namespace xtual
         return (ch & ~U'\xffff') != U'\0' && is_code_point(ch);
     }
     
+    constexpr std::size_t utf8_sequence_length(char8_t w1)
+    {
+        if (is_ascii(w1))
+        {
+            return 1;
+        }
+        else if (is_utf8_2_prefix(w1))
+        {
+            return w1 < static_cast<char8_t>(0xc2) ? 0 : 2;
+        }
+        else if (is_utf8_3_prefix(w1))
+        {
+            return 3;
+        }
+        else if (is_utf8_4_prefix(w1))
+        {
+            return w1 > static_cast<char8_t>(0xf4) ? 0 : 4;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    constexpr bool is_utf8_second(char8_t w1, char8_t w2)
+    {
+        if (w1 == static_cast<char8_t>(0xe0))
+        {
+            return w2 >= static_cast<char8_t>(0xa0) && w2 <= static_cast<char8_t>(0xbf);
+        }
+        else if (w1 == static_cast<char8_t>(0xed))
+        {
+            return w2 >= static_cast<char8_t>(0x80) && w2 <= static_cast<char8_t>(0x9f);
+        }
+        else if (w1 == static_cast<char8_t>(0xf0))
+        {
+            return w2 >= static_cast<char8_t>(0x90) && w2 <= static_cast<char8_t>(0xbf);
+        }
+        else if (w1 == static_cast<char8_t>(0xf4))
+        {
+            return w2 >= static_cast<char8_t>(0x80) && w2 <= static_cast<char8_t>(0x8f);
+        }
+        else
+        {
+            return is_utf8_tail(w2);
+        }
+    }
+
+    constexpr std::size_t utf8_width(char32_t ch)
+    {
+        if ((ch & ~U'\x7f') == 0)
+        {
+            return 1;
+        }
+        else if ((ch & ~U'\x7ff') == 0)
+        {
+            return 2;
+        }
+        else if ((ch & ~U'\xffff') == 0)
+        {
+            return 3;
+        }
+        else
+        {
+            return 4;
+        }
+    }
+    
     template <std::input_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
-    bool read_utf8_tail(Iter &i, Sent s, char8_t buf[], std::size_t n, Rdr read)
+    constexpr transcode_status read_utf8_tail(Iter &i, Sent s, char8_t buf[], std::size_t n, Rdr read)
     {
         for (std::size_t k = 0; k < n; ++k)
         {
@@ -157,25 +288,25 @@ namespace xtual
 
             if (!opt.has_value())
             {
-                return false;
+                return transcode_status::incomplete;
             }
 
             char8_t ch = opt.value();
 
             if (!is_utf8_tail(ch))
             {
-                return false;
+                return transcode_status::invalid;
             }
 
             buf[k] = ch;
         }
 
-        return true;
+        return transcode_status::ok;
     }
     
     template <typename charT, std::input_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
     requires std::convertible_to<std::iter_value_t<Iter>, charT>
-    std::optional<char32_t> utf8_decode(Iter &i, Sent s, Rdr read)
+    constexpr std::optional<char32_t> utf8_decode(Iter &i, Sent s, Rdr read)
     {
         auto opt1 = read(i, s);
 
@@ -194,16 +325,16 @@ namespace xtual
         {
             char8_t ws[1];
 
-            if (!read_utf8_tail(i, s, ws, 1, read))
+            if (transcode_status status = read_utf8_tail(i, s, ws, 1, read); status != transcode_status::ok)
             {
-                return std::nullopt;
+                return decode_error(status);
             }
 
             char32_t ch = decode_utf8_2(w1, ws[0]);
 
             if (!is_valid_utf8_2_value(ch))
             {
-                return std::nullopt;
+                return decode_error(transcode_status::invalid);
             }
 
             return ch;
@@ -212,16 +343,16 @@ namespace xtual
         {
             char8_t ws[2];
 
-            if (!read_utf8_tail(i, s, ws, 2, read))
+            if (transcode_status status = read_utf8_tail(i, s, ws, 2, read); status != transcode_status::ok)
             {
-                return std::nullopt;
+                return decode_error(status);
             }
 
             char32_t ch = decode_utf8_3(w1, ws[0], ws[1]);
 
             if (!is_valid_utf8_3_value(ch))
             {
-                return std::nullopt;
+                return decode_error(transcode_status::invalid);
             }
 
             return ch;
@@ -230,31 +361,196 @@ namespace xtual
         {
             char8_t ws[3];
 
-            if (!read_utf8_tail(i, s, ws, 3, read))
+            if (transcode_status status = read_utf8_tail(i, s, ws, 3, read); status != transcode_status::ok)
             {
-                return std::nullopt;
+                return decode_error(status);
             }
             
             char32_t ch = decode_utf8_4(w1, ws[0], ws[1], ws[2]);
 
             if (!is_valid_utf8_4_value(ch))
             {
-                return std::nullopt;
+                return decode_error(transcode_status::invalid);
             }
 
             return ch;
         }
         else
+        {
+            return decode_error(transcode_status::invalid);
+        }
+    }
+
+    template <std::input_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
+    constexpr std::optional<char32_t> utf8_decode_dfa(Iter &i, Sent s, Rdr read)
+    {
+        std::uint8_t state = utf8_dfa::accept;
+        char32_t ch = 0;
+
+        do
+        {
+            auto opt = read(i, s);
+
+            if (!opt.has_value())
+            {
+                return state == utf8_dfa::accept ? std::nullopt : decode_error(transcode_status::incomplete);
+            }
+
+            state = utf8_dfa::step(state, ch, opt.value());
+        }
+        while (state > utf8_dfa::reject);
+
+        if (state == utf8_dfa::reject)
+        {
+            return decode_error(transcode_status::invalid);
+        }
+
+        return ch;
+    }
+
+    // The deduced parameters carry defaults only because GCC 12 drops the
+    // Engine default from a module interface when parameters without one
+    // follow it.
+    template <typename Engine = utf8_branchy, std::input_iterator Iter = const char8_t *, std::sentinel_for<Iter> Sent = Iter>
+    requires std::convertible_to<std::iter_value_t<Iter>, char8_t>
+    constexpr std::optional<char32_t> decode_from_u8(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, char8_t>)
+        {
+            if (auto ch = decode_contiguous<utf8_codec<char8_t, Engine>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        auto read = [](Iter &i, Sent s) -> std::optional<char8_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            return *i++;
+        };
+
+        if constexpr (std::same_as<Engine, utf8_dfa>)
+        {
+            return utf8_decode_dfa(i, s, read);
+        }
+        else
+        {
+            return utf8_decode<char8_t>(i, s, read);
+        }
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy, std::input_iterator Iter = const byteT *, std::sentinel_for<Iter> Sent = Iter>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_from_b8(Iter &i, Sent s)
+    {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<utf8_codec<byteT, Engine>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        auto read = [](Iter &i, Sent s) -> std::optional<char8_t> {
+            if (i == s)
+            {
+                return std::nullopt;
+            }
+
+            return static_cast<char8_t>(static_cast<std::byte>(*i++));
+        };
+
+        if constexpr (std::same_as<Engine, utf8_dfa>)
+        {
+            return utf8_decode_dfa(i, s, read);
+        }
+        else
+        {
+            return utf8_decode<byteT>(i, s, read);
+        }
+    }
+    
+    template <typename Engine = utf8_branchy, std::bidirectional_iterator Iter = const char8_t *, std::sentinel_for<Iter> Sent = Iter>
+    requires std::convertible_to<std::iter_value_t<Iter>, char8_t>
+    constexpr std::optional<char32_t> decode_backward_from_u8(Iter &i, Sent s)
+    {
+        return decode_backward(i, s, 1, 4, [](const Iter &j) {
+            return is_utf8_tail(static_cast<char8_t>(*j));
+        }, [](Iter &k, const Iter &e) {
+            return decode_from_u8<Engine>(k, e);
+        });
+    }
+
+    template <byte_like byteT, typename Engine = utf8_branchy, std::bidirectional_iterator Iter = const byteT *, std::sentinel_for<Iter> Sent = Iter>
+    requires std::convertible_to<std::iter_value_t<Iter>, byteT>
+    constexpr std::optional<char32_t> decode_backward_from_b8(Iter &i, Sent s)
+    {
+        return decode_backward(i, s, 1, 4, [](const Iter &j) {
+            return is_utf8_tail(static_cast<char8_t>(static_cast<std::byte>(static_cast<byteT>(*j))));
+        }, [](Iter &k, const Iter &e) {
+            return decode_from_b8<byteT, Engine>(k, e);
+        });
+    }
+
+    template <typename charT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent, std::invocable<Iter &, Sent> Rdr>
+    requires std::convertible_to<std::iter_value_t<Iter>, charT>
+    constexpr std::optional<char32_t> utf8_decode_lossy(Iter &i, Sent s, Rdr read)
+    {
+        if (i == s)
         {
             return std::nullopt;
         }
+
+        Iter j = i;
+        auto opt = utf8_decode<charT>(j, s, read);
+
+        if (opt.has_value())
+        {
+            i = j;
+
+            return opt;
+        }
+
+        char8_t w1 = read(i, s).value();
+        std::size_t n = utf8_sequence_length(w1);
+
+        for (std::size_t k = 1; k < n; ++k)
+        {
+            Iter t = i;
+            auto next = read(t, s);
+
+            if (!next.has_value())
+            {
+                break;
+            }
+
+            if (k == 1 ? !is_utf8_second(w1, next.value()) : !is_utf8_tail(next.value()))
+            {
+                break;
+            }
+
+            i = t;
+        }
+
+        return U'\xfffd';
     }
 
-    template <std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
     requires std::convertible_to<std::iter_value_t<Iter>, char8_t>
-    std::optional<char32_t> decode_from_u8(Iter &i, Sent s)
+    constexpr std::optional<char32_t> decode_lossy_from_u8(Iter &i, Sent s)
     {
-        return utf8_decode<char8_t>(i, s, [](Iter &i, Sent s) -> std::optional<char8_t> {
+        if constexpr (contiguous_units<Iter, Sent, char8_t>)
+        {
+            if (auto ch = decode_contiguous<utf8_codec<char8_t>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf8_decode_lossy<char8_t>(i, s, [](Iter &i, Sent s) -> std::optional<char8_t> {
             if (i == s)
             {
                 return std::nullopt;
@@ -264,11 +560,19 @@ namespace xtual
         });
     }
 
-    template <byte_like byteT, std::input_iterator Iter, std::sentinel_for<Iter> Sent>
+    template <byte_like byteT, std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
     requires std::convertible_to<std::iter_value_t<Iter>, byteT>
-    std::optional<char32_t> decode_from_b8(Iter &i, Sent s)
+    constexpr std::optional<char32_t> decode_lossy_from_b8(Iter &i, Sent s)
     {
-        return utf8_decode<byteT>(i, s, [](Iter &i, Sent s) -> std::optional<char8_t> {
+        if constexpr (contiguous_units<Iter, Sent, byteT>)
+        {
+            if (auto ch = decode_contiguous<utf8_codec<byteT>>(i, s))
+            {
+                return ch;
+            }
+        }
+
+        return utf8_decode_lossy<byteT>(i, s, [](Iter &i, Sent s) -> std::optional<char8_t> {
             if (i == s)
             {
                 return std::nullopt;
@@ -277,5 +581,190 @@ namespace xtual
             return static_cast<char8_t>(static_cast<std::byte>(*i++));
         });
     }
+
+    template <typename charT, typename Engine>
+    struct utf8_codec
+    {
+        using unit_type = charT;
+
+        static constexpr std::size_t max_length = 4;
+
+        static constexpr char8_t load(const charT *p)
+        {
+            return static_cast<char8_t>(static_cast<std::byte>(*p));
+        }
+
+        static constexpr void store(charT *p, char32_t ch)
+        {
+            *p = static_cast<charT>(static_cast<std::byte>(ch & 0xff));
+        }
+
+        static constexpr const charT *resync(const charT *b, const charT *p, const charT *)
+        {
+            const charT *q = p;
+
+            for (std::size_t k = 0; k < 3 && q != b && is_utf8_tail(load(q)); ++k)
+            {
+                --q;
+            }
+
+            return q + utf8_sequence_length(load(q)) > p ? q : p;
+        }
+
+        static constexpr std::size_t prefix_length(const charT *p, const charT *e)
+        {
+            char8_t w1 = load(p);
+            std::size_t n = utf8_sequence_length(w1);
+
+            if (n == 0)
+            {
+                return 0;
+            }
+
+            std::size_t k = 1;
+
+            if (k < n && p + k != e && is_utf8_second(w1, load(p + k)))
+            {
+                ++k;
+
+                while (k < n && p + k != e && is_utf8_tail(load(p + k)))
+                {
+                    ++k;
+                }
+            }
+
+            return k;
+        }
+
+        static constexpr std::size_t ill_formed_length(const charT *p, const charT *e)
+        {
+            std::size_t m = prefix_length(p, e);
+
+            return m == 0 ? 1 : m;
+        }
+
+        static constexpr transcode_status decode(const charT *&p, const charT *e, char32_t &ch)
+        {
+            if constexpr (std::same_as<Engine, utf8_dfa>)
+            {
+                const charT *q = p;
+                char32_t u = 0;
+                std::uint8_t state = utf8_dfa::step(utf8_dfa::accept, u, load(q++));
+
+                if (e - p >= 4)
+                {
+                    while (state > utf8_dfa::reject)
+                    {
+                        state = utf8_dfa::step(state, u, load(q++));
+                    }
+                }
+                else
+                {
+                    while (state > utf8_dfa::reject)
+                    {
+                        if (q == e)
+                        {
+                            return transcode_status::incomplete;
+                        }
+
+                        state = utf8_dfa::step(state, u, load(q++));
+                    }
+                }
+
+                if (state == utf8_dfa::reject)
+                {
+                    return transcode_status::invalid;
+                }
+
+                ch = u;
+                p = q;
+
+                return transcode_status::ok;
+            }
+
+            char8_t w1 = load(p);
+
+            if (is_ascii(w1))
+            {
+                ch = static_cast<char32_t>(w1);
+                p += 1;
+
+                return transcode_status::ok;
+            }
+
+            std::size_t n = utf8_sequence_length(w1);
+
+            if (n == 0)
+            {
+                return transcode_status::invalid;
+            }
+
+            std::size_t m = prefix_length(p, e);
+
+            if (m < n)
+            {
+                return p + m == e ? transcode_status::incomplete : transcode_status::invalid;
+            }
+
+            if (n == 2)
+            {
+                ch = decode_utf8_2(w1, load(p + 1));
+            }
+            else if (n == 3)
+            {
+                ch = decode_utf8_3(w1, load(p + 1), load(p + 2));
+            }
+            else
+            {
+                ch = decode_utf8_4(w1, load(p + 1), load(p + 2), load(p + 3));
+            }
+
+            p += n;
+
+            return transcode_status::ok;
+        }
+
+        static constexpr bool encode(charT *&p, charT *e, char32_t ch)
+        {
+            std::size_t n = utf8_width(ch);
+
+            if (static_cast<std::size_t>(e - p) < n)
+            {
+                return false;
+            }
+
+            if (n == 1)
+            {
+                store(p, ch);
+            }
+            else if (n == 2)
+            {
+                store(p, 0xc0 | (ch >> 6));
+                store(p + 1, 0x80 | (ch & 0x3f));
+            }
+            else if (n == 3)
+            {
+                store(p, 0xe0 | (ch >> 12));
+                store(p + 1, 0x80 | ((ch >> 6) & 0x3f));
+                store(p + 2, 0x80 | (ch & 0x3f));
+            }
+            else
+            {
+                store(p, 0xf0 | (ch >> 18));
+                store(p + 1, 0x80 | ((ch >> 12) & 0x3f));
+                store(p + 2, 0x80 | ((ch >> 6) & 0x3f));
+                store(p + 3, 0x80 | (ch & 0x3f));
+            }
+
+            p += n;
+
+            return true;
+        }
+    };
+
+    using u8_codec = utf8_codec<char8_t>;
+
+    template <byte_like byteT, typename Engine = utf8_branchy>
+    using b8_codec = utf8_codec<byteT, Engine>;
     
 }
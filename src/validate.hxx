@@ -0,0 +1,478 @@
+namespace xtual
+{
+
+    template <typename Codec>
+    constexpr const typename Codec::unit_type *validate_scalar(const typename Codec::unit_type *p, const typename Codec::unit_type *e)
+    {
+        while (p != e)
+        {
+            char32_t ch;
+
+            if (Codec::decode(p, e, ch) != transcode_status::ok)
+            {
+                break;
+            }
+        }
+
+        return p;
+    }
+
+    template <typename charT>
+    constexpr const charT *utf8_boundary_before(const charT *b, const charT *p)
+    {
+        for (std::size_t k = 0; k < 3 && p != b && is_utf8_tail(utf8_codec<charT>::load(p - 1)); ++k)
+        {
+            --p;
+        }
+
+        if (p != b && utf8_codec<charT>::load(p - 1) >= static_cast<char8_t>(0xc0))
+        {
+            --p;
+        }
+
+        return p;
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    XTUAL_TARGET("avx2") inline __m256i utf8_block_errors(__m256i input, __m256i prev_input)
+    {
+        const __m256i byte_1_high_table = _mm256_setr_epi8(
+            0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+            char(0x80), char(0x80), char(0x80), char(0x80), 0x21, 0x01, 0x15, 0x49,
+            0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+            char(0x80), char(0x80), char(0x80), char(0x80), 0x21, 0x01, 0x15, 0x49);
+        const __m256i byte_1_low_table = _mm256_setr_epi8(
+            char(0xe7), char(0xa3), char(0x83), char(0x83), char(0x8b), char(0xcb), char(0xcb), char(0xcb),
+            char(0xcb), char(0xcb), char(0xcb), char(0xcb), char(0xcb), char(0xdb), char(0xcb), char(0xcb),
+            char(0xe7), char(0xa3), char(0x83), char(0x83), char(0x8b), char(0xcb), char(0xcb), char(0xcb),
+            char(0xcb), char(0xcb), char(0xcb), char(0xcb), char(0xcb), char(0xdb), char(0xcb), char(0xcb));
+        const __m256i byte_2_high_table = _mm256_setr_epi8(
+            0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+            char(0xe6), char(0xae), char(0xba), char(0xba), 0x01, 0x01, 0x01, 0x01,
+            0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+            char(0xe6), char(0xae), char(0xba), char(0xba), 0x01, 0x01, 0x01, 0x01);
+        const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+
+        __m256i carried = _mm256_permute2x128_si256(prev_input, input, 0x21);
+        __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+        __m256i prev2 = _mm256_alignr_epi8(input, carried, 14);
+        __m256i prev3 = _mm256_alignr_epi8(input, carried, 13);
+
+        __m256i byte_1_high = _mm256_shuffle_epi8(byte_1_high_table, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble));
+        __m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_table, _mm256_and_si256(prev1, low_nibble));
+        __m256i byte_2_high = _mm256_shuffle_epi8(byte_2_high_table, _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+        __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+        __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xe0 - 0x80));
+        __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xf0 - 0x80));
+        __m256i must_be_tail = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+
+        return _mm256_xor_si256(must_be_tail, special);
+    }
+
+    template <typename charT>
+    XTUAL_TARGET("avx2") const charT *utf8_validate_avx2(const charT *b, const charT *e)
+    {
+        const __m256i incomplete_limit = _mm256_setr_epi8(
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff),
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff),
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff),
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xef), char(0xdf), char(0xbf));
+
+        const charT *p = b;
+        __m256i prev_input = _mm256_setzero_si256();
+        __m256i prev_incomplete = _mm256_setzero_si256();
+
+        while (e - p >= 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+
+            if (_mm256_movemask_epi8(input) == 0)
+            {
+                if (!_mm256_testz_si256(prev_incomplete, prev_incomplete))
+                {
+                    break;
+                }
+            }
+            else
+            {
+                __m256i errors = utf8_block_errors(input, prev_input);
+
+                if (!_mm256_testz_si256(errors, errors))
+                {
+                    break;
+                }
+
+                prev_incomplete = _mm256_subs_epu8(input, incomplete_limit);
+            }
+
+            prev_input = input;
+            p += 32;
+        }
+
+        return validate_scalar<utf8_codec<charT>>(utf8_boundary_before(b, p), e);
+    }
+
+    XTUAL_TARGET("ssse3") inline __m128i utf8_block_errors(__m128i input, __m128i prev_input)
+    {
+        const __m128i byte_1_high_table = _mm_setr_epi8(
+            0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+            char(0x80), char(0x80), char(0x80), char(0x80), 0x21, 0x01, 0x15, 0x49);
+        const __m128i byte_1_low_table = _mm_setr_epi8(
+            char(0xe7), char(0xa3), char(0x83), char(0x83), char(0x8b), char(0xcb), char(0xcb), char(0xcb),
+            char(0xcb), char(0xcb), char(0xcb), char(0xcb), char(0xcb), char(0xdb), char(0xcb), char(0xcb));
+        const __m128i byte_2_high_table = _mm_setr_epi8(
+            0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+            char(0xe6), char(0xae), char(0xba), char(0xba), 0x01, 0x01, 0x01, 0x01);
+        const __m128i low_nibble = _mm_set1_epi8(0x0f);
+
+        __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+        __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+        __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+
+        __m128i byte_1_high = _mm_shuffle_epi8(byte_1_high_table, _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble));
+        __m128i byte_1_low = _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, low_nibble));
+        __m128i byte_2_high = _mm_shuffle_epi8(byte_2_high_table, _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+        __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+        __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(0xe0 - 0x80));
+        __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(0xf0 - 0x80));
+        __m128i must_be_tail = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(char(0x80)));
+
+        return _mm_xor_si128(must_be_tail, special);
+    }
+
+    template <typename charT>
+    XTUAL_TARGET("ssse3") const charT *utf8_validate_ssse3(const charT *b, const charT *e)
+    {
+        const __m128i incomplete_limit = _mm_setr_epi8(
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xff),
+            char(0xff), char(0xff), char(0xff), char(0xff), char(0xff), char(0xef), char(0xdf), char(0xbf));
+        const __m128i zero = _mm_setzero_si128();
+
+        const charT *p = b;
+        __m128i prev_input = zero;
+        __m128i prev_incomplete = zero;
+
+        while (e - p >= 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+            if (_mm_movemask_epi8(input) == 0)
+            {
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(prev_incomplete, zero)) != 0xffff)
+                {
+                    break;
+                }
+            }
+            else
+            {
+                __m128i errors = utf8_block_errors(input, prev_input);
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(errors, zero)) != 0xffff)
+                {
+                    break;
+                }
+
+                prev_incomplete = _mm_subs_epu8(input, incomplete_limit);
+            }
+
+            prev_input = input;
+            p += 16;
+        }
+
+        return validate_scalar<utf8_codec<charT>>(utf8_boundary_before(b, p), e);
+    }
+
+#endif
+
+    template <typename charT>
+    constexpr std::size_t utf8_validate(const charT *b, const charT *e)
+    {
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                return static_cast<std::size_t>(utf8_validate_avx2(b, e) - b);
+            case simd_level::ssse3:
+                return static_cast<std::size_t>(utf8_validate_ssse3(b, e) - b);
+            default:
+                break;
+            }
+        }
+#endif
+
+        return static_cast<std::size_t>(validate_scalar<utf8_codec<charT>>(b, e) - b);
+    }
+
+    constexpr std::size_t validate_u8(std::span<const char8_t> in)
+    {
+        return utf8_validate(in.data(), in.data() + in.size());
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t validate_b8(std::span<const byteT> in)
+    {
+        return utf8_validate(in.data(), in.data() + in.size());
+    }
+
+#if defined(XTUAL_X86_SIMD)
+
+    template <std::endian order, typename unitT>
+    XTUAL_TARGET("sse2") const unitT *utf16_validate_sse2(const unitT *p, const unitT *e)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(unitT);
+
+        const __m128i mask = _mm_set1_epi16(static_cast<short>(0xfc00));
+        const __m128i high = _mm_set1_epi16(static_cast<short>(0xd800));
+        const __m128i low = _mm_set1_epi16(static_cast<short>(0xdc00));
+
+        unsigned carry = 0;
+
+        for (; e - p >= step; p += step)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+            if constexpr (order != std::endian::native)
+            {
+                x = byteswap_epi16_sse2(x);
+            }
+
+            __m128i kind = _mm_and_si128(x, mask);
+            auto h = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(kind, high)));
+            auto l = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(kind, low)));
+
+            if (l != (((h << 2) | carry) & 0xffff))
+            {
+                break;
+            }
+
+            carry = h >> 14;
+        }
+
+        return carry != 0 ? p - step / 8 : p;
+    }
+
+    template <std::endian order, typename unitT>
+    XTUAL_TARGET("avx2") const unitT *utf16_validate_avx2(const unitT *p, const unitT *e)
+    {
+        constexpr std::ptrdiff_t step = 32 / sizeof(unitT);
+
+        const __m256i mask = _mm256_set1_epi16(static_cast<short>(0xfc00));
+        const __m256i high = _mm256_set1_epi16(static_cast<short>(0xd800));
+        const __m256i low = _mm256_set1_epi16(static_cast<short>(0xdc00));
+
+        std::uint32_t carry = 0;
+
+        for (; e - p >= step; p += step)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+
+            if constexpr (order != std::endian::native)
+            {
+                x = byteswap_epi16_avx2(x);
+            }
+
+            __m256i kind = _mm256_and_si256(x, mask);
+            auto h = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(kind, high)));
+            auto l = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(kind, low)));
+
+            if (l != ((h << 2) | carry))
+            {
+                break;
+            }
+
+            carry = h >> 30;
+        }
+
+        return carry != 0 ? p - step / 16 : utf16_validate_sse2<order>(p, e);
+    }
+
+    template <std::endian order, typename unitT>
+    XTUAL_TARGET("sse2") const unitT *utf32_validate_sse2(const unitT *p, const unitT *e)
+    {
+        constexpr std::ptrdiff_t step = 16 / sizeof(unitT);
+
+        for (; e - p >= step; p += step)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+            if (!is_valid_utf32_block(order != std::endian::native ? byteswap_epi32_sse2(x) : x))
+            {
+                break;
+            }
+        }
+
+        return p;
+    }
+
+    template <std::endian order, typename unitT>
+    XTUAL_TARGET("avx2") const unitT *utf32_validate_avx2(const unitT *p, const unitT *e)
+    {
+        constexpr std::ptrdiff_t step = 32 / sizeof(unitT);
+
+        for (; e - p >= step; p += step)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+
+            if (!is_valid_utf32_block(order != std::endian::native ? byteswap_epi32_avx2(x) : x))
+            {
+                break;
+            }
+        }
+
+        return utf32_validate_sse2<order>(p, e);
+    }
+
+#endif
+
+    template <typename Codec, std::endian order>
+    constexpr std::size_t utf16_validate(const typename Codec::unit_type *b, const typename Codec::unit_type *e)
+    {
+        const auto *p = b;
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                p = utf16_validate_avx2<order>(b, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                p = utf16_validate_sse2<order>(b, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        return static_cast<std::size_t>(validate_scalar<Codec>(p, e) - b);
+    }
+
+    template <typename Codec, std::endian order>
+    constexpr std::size_t utf32_validate(const typename Codec::unit_type *b, const typename Codec::unit_type *e)
+    {
+        const auto *p = b;
+
+#if defined(XTUAL_X86_SIMD)
+        if (!std::is_constant_evaluated())
+        {
+            switch (active_simd_level())
+            {
+            case simd_level::avx2:
+                p = utf32_validate_avx2<order>(b, e);
+                break;
+            case simd_level::ssse3:
+            case simd_level::sse2:
+                p = utf32_validate_sse2<order>(b, e);
+                break;
+            default:
+                break;
+            }
+        }
+#endif
+
+        return static_cast<std::size_t>(validate_scalar<Codec>(p, e) - b);
+    }
+
+    constexpr std::size_t validate_u16(std::span<const char16_t> in)
+    {
+        return utf16_validate<u16_codec, std::endian::native>(in.data(), in.data() + in.size());
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t validate_b16be(std::span<const byteT> in)
+    {
+        return utf16_validate<b16be_codec<byteT>, std::endian::big>(in.data(), in.data() + in.size());
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t validate_b16le(std::span<const byteT> in)
+    {
+        return utf16_validate<b16le_codec<byteT>, std::endian::little>(in.data(), in.data() + in.size());
+    }
+
+    constexpr std::size_t validate_u32(std::span<const char32_t> in)
+    {
+        return utf32_validate<u32_codec, std::endian::native>(in.data(), in.data() + in.size());
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t validate_b32be(std::span<const byteT> in)
+    {
+        return utf32_validate<b32be_codec<byteT>, std::endian::big>(in.data(), in.data() + in.size());
+    }
+
+    template <byte_like byteT>
+    constexpr std::size_t validate_b32le(std::span<const byteT> in)
+    {
+        return utf32_validate<b32le_codec<byteT>, std::endian::little>(in.data(), in.data() + in.size());
+    }
+
+    template <typename Codec>
+    struct validate_kernel
+    {
+        static constexpr std::size_t run(const typename Codec::unit_type *b, const typename Codec::unit_type *e)
+        {
+            return static_cast<std::size_t>(validate_scalar<Codec>(b, e) - b);
+        }
+    };
+
+    template <typename charT, typename Engine>
+    struct validate_kernel<utf8_codec<charT, Engine>>
+    {
+        static constexpr std::size_t run(const charT *b, const charT *e)
+        {
+            return utf8_validate(b, e);
+        }
+    };
+
+    template <>
+    struct validate_kernel<u16_codec>
+    {
+        static constexpr std::size_t run(const char16_t *b, const char16_t *e)
+        {
+            return utf16_validate<u16_codec, std::endian::native>(b, e);
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct validate_kernel<b16_codec<byteT, order>>
+    {
+        static constexpr std::size_t run(const byteT *b, const byteT *e)
+        {
+            return utf16_validate<b16_codec<byteT, order>, order>(b, e);
+        }
+    };
+
+    template <>
+    struct validate_kernel<u32_codec>
+    {
+        static constexpr std::size_t run(const char32_t *b, const char32_t *e)
+        {
+            return utf32_validate<u32_codec, std::endian::native>(b, e);
+        }
+    };
+
+    template <byte_like byteT, std::endian order>
+    struct validate_kernel<b32_codec<byteT, order>>
+    {
+        static constexpr std::size_t run(const byteT *b, const byteT *e)
+        {
+            return utf32_validate<b32_codec<byteT, order>, order>(b, e);
+        }
+    };
+
+    template <typename Codec>
+    constexpr std::size_t validate_units(std::span<const typename Codec::unit_type> in)
+    {
+        return validate_kernel<Codec>::run(in.data(), in.data() + in.size());
+    }
+
+}
@@ -0,0 +1,448 @@
+namespace xtual
+{
+
+    struct u8_decoding
+    {
+        using codec = u8_codec;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_u8(i, s);
+        }
+    };
+
+    template <byte_like byteT>
+    struct b8_decoding
+    {
+        using codec = b8_codec<byteT>;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_b8<byteT>(i, s);
+        }
+    };
+
+    struct u16_decoding
+    {
+        using codec = u16_codec;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_u16(i, s);
+        }
+    };
+
+    template <byte_like byteT>
+    struct b16be_decoding
+    {
+        using codec = b16be_codec<byteT>;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_b16be<byteT>(i, s);
+        }
+    };
+
+    template <byte_like byteT>
+    struct b16le_decoding
+    {
+        using codec = b16le_codec<byteT>;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_b16le<byteT>(i, s);
+        }
+    };
+
+    struct u32_decoding
+    {
+        using codec = u32_codec;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_u32(i, s);
+        }
+    };
+
+    template <byte_like byteT>
+    struct b32be_decoding
+    {
+        using codec = b32be_codec<byteT>;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_b32be<byteT>(i, s);
+        }
+    };
+
+    template <byte_like byteT>
+    struct b32le_decoding
+    {
+        using codec = b32le_codec<byteT>;
+
+        template <std::forward_iterator Iter, std::sentinel_for<Iter> Sent>
+        static constexpr std::optional<char32_t> decode(Iter &i, Sent s)
+        {
+            return decode_lossy_from_b32le<byteT>(i, s);
+        }
+    };
+
+    template <std::ranges::view V, typename Decoding>
+    requires std::ranges::forward_range<V>
+    class decode_view : public std::ranges::view_interface<decode_view<V, Decoding>>
+    {
+    public:
+        template <bool Const>
+        class iterator
+        {
+        public:
+            using Base = std::conditional_t<Const, const V, V>;
+            using unit_type = typename Decoding::codec::unit_type;
+
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = char32_t;
+            using difference_type = std::ptrdiff_t;
+
+            static constexpr bool contiguous =
+                std::ranges::contiguous_range<Base>
+                && std::sized_sentinel_for<std::ranges::sentinel_t<Base>, std::ranges::iterator_t<Base>>
+                && std::same_as<std::ranges::range_value_t<Base>, unit_type>;
+
+            iterator() = default;
+
+            constexpr iterator(std::ranges::iterator_t<Base> pos, std::ranges::sentinel_t<Base> end)
+                : pos(std::move(pos)), next(this->pos), end(std::move(end))
+            {
+                decode();
+            }
+
+            constexpr char32_t operator*() const
+            {
+                return value;
+            }
+
+            constexpr iterator &operator++()
+            {
+                pos = next;
+                decode();
+
+                return *this;
+            }
+
+            constexpr iterator operator++(int)
+            {
+                iterator tmp = *this;
+                ++*this;
+
+                return tmp;
+            }
+
+            constexpr std::ranges::iterator_t<Base> base() const
+            {
+                return pos;
+            }
+
+            friend constexpr bool operator==(const iterator &x, const iterator &y)
+            {
+                return x.pos == y.pos;
+            }
+
+            friend constexpr bool operator==(const iterator &x, std::default_sentinel_t)
+            {
+                return x.pos == x.end;
+            }
+
+        private:
+            constexpr void decode()
+            {
+                if (pos == end)
+                {
+                    return;
+                }
+
+                if constexpr (contiguous)
+                {
+                    const unit_type *p = std::to_address(pos);
+                    const unit_type *e = p + (end - pos);
+                    const unit_type *q = p;
+
+                    if (Decoding::codec::decode(q, e, value) != transcode_status::ok)
+                    {
+                        value = U'\xfffd';
+                        q = p + Decoding::codec::ill_formed_length(p, e);
+                    }
+
+                    next = pos + (q - p);
+                }
+                else
+                {
+                    next = pos;
+                    value = Decoding::decode(next, end).value();
+                }
+            }
+
+            std::ranges::iterator_t<Base> pos {};
+            std::ranges::iterator_t<Base> next {};
+            std::ranges::sentinel_t<Base> end {};
+            char32_t value = U'\0';
+        };
+
+        decode_view() requires std::default_initializable<V> = default;
+
+        constexpr explicit decode_view(V base)
+            : underlying(std::move(base))
+        {
+        }
+
+        constexpr V base() const & requires std::copy_constructible<V>
+        {
+            return underlying;
+        }
+
+        constexpr V base() &&
+        {
+            return std::move(underlying);
+        }
+
+        constexpr iterator<false> begin()
+        {
+            return { std::ranges::begin(underlying), std::ranges::end(underlying) };
+        }
+
+        constexpr iterator<true> begin() const requires std::ranges::forward_range<const V>
+        {
+            return { std::ranges::begin(underlying), std::ranges::end(underlying) };
+        }
+
+        constexpr std::default_sentinel_t end() const
+        {
+            return std::default_sentinel;
+        }
+
+    private:
+        V underlying = V();
+    };
+
+    template <std::ranges::view V, typename To>
+    requires std::ranges::forward_range<V> && std::convertible_to<std::ranges::range_value_t<V>, char32_t>
+    class encode_view : public std::ranges::view_interface<encode_view<V, To>>
+    {
+    public:
+        template <bool Const>
+        class iterator
+        {
+        public:
+            using Base = std::conditional_t<Const, const V, V>;
+            using unit_type = typename To::unit_type;
+
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = unit_type;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            constexpr iterator(std::ranges::iterator_t<Base> pos, std::ranges::sentinel_t<Base> end)
+                : pos(std::move(pos)), end(std::move(end))
+            {
+                encode();
+            }
+
+            constexpr unit_type operator*() const
+            {
+                return units[index];
+            }
+
+            constexpr iterator &operator++()
+            {
+                if (++index == size)
+                {
+                    ++pos;
+                    encode();
+                }
+
+                return *this;
+            }
+
+            constexpr iterator operator++(int)
+            {
+                iterator tmp = *this;
+                ++*this;
+
+                return tmp;
+            }
+
+            constexpr std::ranges::iterator_t<Base> base() const
+            {
+                return pos;
+            }
+
+            friend constexpr bool operator==(const iterator &x, const iterator &y)
+            {
+                return x.pos == y.pos && x.index == y.index;
+            }
+
+            friend constexpr bool operator==(const iterator &x, std::default_sentinel_t)
+            {
+                return x.pos == x.end;
+            }
+
+        private:
+            constexpr void encode()
+            {
+                index = 0;
+                size = 0;
+
+                if (pos == end)
+                {
+                    return;
+                }
+
+                char32_t ch = static_cast<char32_t>(*pos);
+                unit_type *p = units.data();
+
+                if (!is_code_point(ch))
+                {
+                    ch = U'\xfffd';
+                }
+
+                if (!can_encode<To>(ch))
+                {
+                    ch = replacement_character<To>();
+                }
+
+                To::encode(p, units.data() + units.size(), ch);
+                size = static_cast<std::size_t>(p - units.data());
+            }
+
+            std::ranges::iterator_t<Base> pos {};
+            std::ranges::sentinel_t<Base> end {};
+            std::array<unit_type, To::max_length> units {};
+            std::size_t index = 0;
+            std::size_t size = 0;
+        };
+
+        encode_view() requires std::default_initializable<V> = default;
+
+        constexpr explicit encode_view(V base)
+            : underlying(std::move(base))
+        {
+        }
+
+        constexpr V base() const & requires std::copy_constructible<V>
+        {
+            return underlying;
+        }
+
+        constexpr V base() &&
+        {
+            return std::move(underlying);
+        }
+
+        constexpr iterator<false> begin()
+        {
+            return { std::ranges::begin(underlying), std::ranges::end(underlying) };
+        }
+
+        constexpr iterator<true> begin() const requires std::ranges::forward_range<const V>
+        {
+            return { std::ranges::begin(underlying), std::ranges::end(underlying) };
+        }
+
+        constexpr std::default_sentinel_t end() const
+        {
+            return std::default_sentinel;
+        }
+
+    private:
+        V underlying = V();
+    };
+
+    template <typename Decoding>
+    struct decode_adaptor
+    {
+        template <std::ranges::viewable_range R>
+        constexpr auto operator()(R &&r) const
+        {
+            return decode_view<std::views::all_t<R>, Decoding>(std::views::all(std::forward<R>(r)));
+        }
+
+        template <std::ranges::viewable_range R>
+        friend constexpr auto operator|(R &&r, const decode_adaptor &adaptor)
+        {
+            return adaptor(std::forward<R>(r));
+        }
+    };
+
+    template <typename To>
+    struct encode_adaptor
+    {
+        template <std::ranges::viewable_range R>
+        constexpr auto operator()(R &&r) const
+        {
+            return encode_view<std::views::all_t<R>, To>(std::views::all(std::forward<R>(r)));
+        }
+
+        template <std::ranges::viewable_range R>
+        friend constexpr auto operator|(R &&r, const encode_adaptor &adaptor)
+        {
+            return adaptor(std::forward<R>(r));
+        }
+    };
+
+    namespace views
+    {
+
+        inline constexpr decode_adaptor<u8_decoding> decode_u8 {};
+
+        template <byte_like byteT>
+        inline constexpr decode_adaptor<b8_decoding<byteT>> decode_b8 {};
+
+        inline constexpr decode_adaptor<u16_decoding> decode_u16 {};
+
+        template <byte_like byteT>
+        inline constexpr decode_adaptor<b16be_decoding<byteT>> decode_b16be {};
+
+        template <byte_like byteT>
+        inline constexpr decode_adaptor<b16le_decoding<byteT>> decode_b16le {};
+
+        inline constexpr decode_adaptor<u32_decoding> decode_u32 {};
+
+        template <byte_like byteT>
+        inline constexpr decode_adaptor<b32be_decoding<byteT>> decode_b32be {};
+
+        template <byte_like byteT>
+        inline constexpr decode_adaptor<b32le_decoding<byteT>> decode_b32le {};
+
+        inline constexpr encode_adaptor<u8_codec> encode_u8 {};
+
+        template <byte_like byteT>
+        inline constexpr encode_adaptor<b8_codec<byteT>> encode_b8 {};
+
+        inline constexpr encode_adaptor<u16_codec> encode_u16 {};
+
+        template <byte_like byteT>
+        inline constexpr encode_adaptor<b16be_codec<byteT>> encode_b16be {};
+
+        template <byte_like byteT>
+        inline constexpr encode_adaptor<b16le_codec<byteT>> encode_b16le {};
+
+        inline constexpr encode_adaptor<u32_codec> encode_u32 {};
+
+        template <byte_like byteT>
+        inline constexpr encode_adaptor<b32be_codec<byteT>> encode_b32be {};
+
+        template <byte_like byteT>
+        inline constexpr encode_adaptor<b32le_codec<byteT>> encode_b32le {};
+
+    }
+
+}
@@ -0,0 +1,9 @@
+#ifndef XTUAL_INCLUDE_XTUAL_HXX_AFE2A99E_7F15_43E2_BF45_640942838743
+#define XTUAL_INCLUDE_XTUAL_HXX_AFE2A99E_7F15_43E2_BF45_640942838743
+
+#define XTUAL_MODULE
+
+m4_include(`prelude.hxx')
+import xtual;
+
+#endif
@@ -0,0 +1,16 @@
+m4_include(`license.hxx')
+
+module;
+
+#define XTUAL_MODULE
+
+m4_include(`prelude.hxx')
+
+export module xtual;
+
+export
+{
+
+m4_include(`components.hxx')
+
+}
@@ -3,16 +3,6 @@
 
 m4_include(`license.hxx')
 
-#include <concepts>
-#include <cstddef>
-#include <cstdint>
-#include <iterator>
-#include <optional>
-#include <tuple>
-
-m4_include(`common.hxx')
-m4_include(`utf32.hxx')
-m4_include(`utf16.hxx')
-m4_include(`utf8.hxx')
-
+m4_include(`prelude.hxx')
+m4_include(`components.hxx')
 #endif
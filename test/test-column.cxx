@@ -0,0 +1,240 @@
+#include <xtual.hxx>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+const xtual::simd_level levels[] = { xtual::simd_level::scalar, xtual::simd_level::sse2, xtual::simd_level::ssse3, xtual::simd_level::avx2 };
+
+struct column
+{
+    std::vector<char8_t> data;
+    std::vector<std::int32_t> offsets { 0 };
+
+    void push(std::u8string_view row)
+    {
+        data.insert(data.end(), row.begin(), row.end());
+        offsets.push_back(static_cast<std::int32_t>(data.size()));
+    }
+
+    std::u8string_view row(std::size_t k) const
+    {
+        return { data.data() + offsets[k], static_cast<std::size_t>(offsets[k + 1] - offsets[k]) };
+    }
+};
+
+column make_column(std::uint32_t seed, std::size_t rows)
+{
+    const char8_t *samples[] = { u8"a", u8"Z", u8"é", u8"日", u8"😀", u8"\xff", u8"\xe3\x81", u8"\x82", u8"" };
+    column c;
+
+    for (std::size_t k = 0; k < rows; ++k)
+    {
+        std::u8string row;
+        seed = seed * 1103515245 + 12345;
+
+        std::size_t n = (seed >> 16) % 40;
+
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            seed = seed * 1103515245 + 12345;
+
+            std::size_t pick = (seed >> 16) % 100;
+            row += samples[pick < 60 ? pick % 2 : pick < 97 ? 2 + pick % 3 : 5 + pick % 4];
+        }
+
+        c.push(row);
+    }
+
+    return c;
+}
+
+template <typename To>
+void check_column(const column &c, xtual::error_policy policy)
+{
+    std::size_t rows = c.offsets.size() - 1;
+
+    std::vector<typename To::unit_type> out(c.data.size() * 4);
+    std::vector<std::int64_t> out_offsets(rows + 1);
+    std::vector<std::uint64_t> errors((rows + 63) / 64);
+
+    auto r = xtual::transcode_column<xtual::u8_codec, To>(std::span<const char8_t>(c.data), std::span<const std::int32_t>(c.offsets), std::span(out), std::span(out_offsets), std::span(errors), policy);
+
+    assert(r.status == xtual::transcode_status::ok && r.rows == rows);
+    assert(static_cast<std::size_t>(out_offsets[rows]) == r.written);
+
+    std::size_t count = 0;
+
+    for (std::size_t k = 0; k < rows; ++k)
+    {
+        auto row = c.row(k);
+        std::vector<typename To::unit_type> expected(row.size() * 4);
+
+        auto e = xtual::transcode<xtual::u8_codec, To>(std::span<const char8_t>(row.data(), row.size()), expected, policy);
+        bool strict_error = xtual::validate_u8(std::span<const char8_t>(row.data(), row.size())) != row.size();
+
+        assert(xtual::column_error(errors, k) == strict_error);
+        count += strict_error;
+
+        std::size_t length = static_cast<std::size_t>(out_offsets[k + 1] - out_offsets[k]);
+
+        if (strict_error && policy == xtual::error_policy::strict)
+        {
+            assert(length == 0);
+        }
+        else
+        {
+            assert(e.status == xtual::transcode_status::ok && length == e.written);
+            assert(std::equal(expected.begin(), expected.begin() + e.written, out.begin() + out_offsets[k]));
+        }
+    }
+
+    assert(r.errors == count);
+}
+
+void test_transcode_column()
+{
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::uint32_t seed = 0; seed < 20; ++seed)
+        {
+            auto c = make_column(seed, seed * 10);
+
+            for (auto policy : { xtual::error_policy::strict, xtual::error_policy::replace })
+            {
+                check_column<xtual::u8_codec>(c, policy);
+                check_column<xtual::u16_codec>(c, policy);
+                check_column<xtual::u32_codec>(c, policy);
+                check_column<xtual::b16le_codec<std::byte>>(c, policy);
+            }
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+template <typename From, typename To>
+void check_wide_column(const column &c)
+{
+    using unit = typename From::unit_type;
+
+    std::size_t rows = c.offsets.size() - 1;
+    std::vector<unit> data;
+    std::vector<std::int32_t> offsets { 0 };
+
+    for (std::size_t k = 0; k < rows; ++k)
+    {
+        auto row = c.row(k);
+        std::vector<unit> units(row.size());
+
+        auto r = xtual::transcode<xtual::u8_codec, From>(std::span<const char8_t>(row.data(), row.size()), units, xtual::error_policy::replace);
+        data.insert(data.end(), units.begin(), units.begin() + r.written);
+        offsets.push_back(static_cast<std::int32_t>(data.size()));
+    }
+
+    std::vector<typename To::unit_type> out(data.size() * 4);
+    std::vector<std::int64_t> out_offsets(rows + 1);
+    std::vector<std::uint64_t> errors((rows + 63) / 64);
+
+    auto r = xtual::transcode_column<From, To>(std::span<const unit>(data), std::span<const std::int32_t>(offsets), std::span(out), std::span(out_offsets), std::span(errors));
+    assert(r.status == xtual::transcode_status::ok && r.rows == rows && r.errors == 0);
+
+    for (std::size_t k = 0; k < rows; ++k)
+    {
+        std::span<const unit> row(data.data() + offsets[k], static_cast<std::size_t>(offsets[k + 1] - offsets[k]));
+        assert((static_cast<std::size_t>(out_offsets[k + 1] - out_offsets[k]) == xtual::converted_length<From, To>(row)));
+    }
+}
+
+void test_wide_column()
+{
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::uint32_t seed = 0; seed < 20; ++seed)
+        {
+            auto c = make_column(seed, seed * 10);
+
+            check_wide_column<xtual::u16_codec, xtual::u8_codec>(c);
+            check_wide_column<xtual::u16_codec, xtual::u32_codec>(c);
+            check_wide_column<xtual::u32_codec, xtual::u8_codec>(c);
+            check_wide_column<xtual::u32_codec, xtual::u16_codec>(c);
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+void test_split_sequence()
+{
+    column c;
+    c.push(u8"ab\xe3\x81");
+    c.push(u8"\x82" "cd");
+    c.push(u8"日本");
+    c.push(u8"");
+
+    std::vector<std::uint64_t> errors(1);
+
+    assert(xtual::validate_column<xtual::u8_codec>(std::span<const char8_t>(c.data), std::span<const std::int32_t>(c.offsets), std::span(errors)) == 2);
+    assert(errors[0] == 3);
+
+    std::vector<char16_t> out(16);
+    std::vector<std::uint32_t> out_offsets(5);
+
+    auto r = xtual::transcode_column<xtual::u8_codec, xtual::u16_codec>(std::span<const char8_t>(c.data), std::span<const std::int32_t>(c.offsets), std::span(out), std::span(out_offsets), std::span(errors));
+    assert(r.status == xtual::transcode_status::ok && r.rows == 4 && r.written == 2 && r.errors == 2);
+    assert((out_offsets == std::vector<std::uint32_t> { 0, 0, 0, 2, 2 }));
+    assert(out[0] == u'日' && out[1] == u'本');
+}
+
+void test_insufficient()
+{
+    column c;
+    c.push(u8"abc");
+    c.push(u8"\xff");
+    c.push(u8"defg");
+
+    std::vector<char8_t> out(5);
+    std::vector<std::size_t> out_offsets(4);
+    std::vector<std::uint64_t> errors(1);
+
+    auto r = xtual::transcode_column<xtual::u8_codec, xtual::u8_codec>(std::span<const char8_t>(c.data), std::span<const std::int32_t>(c.offsets), std::span(out), std::span(out_offsets), std::span(errors), xtual::error_policy::replace);
+    assert(r.status == xtual::transcode_status::insufficient && r.rows == 1 && r.written == 3);
+    assert(out_offsets[1] == 3);
+
+    out.resize(10);
+    r = xtual::transcode_column<xtual::u8_codec, xtual::u8_codec>(std::span<const char8_t>(c.data), std::span<const std::int32_t>(c.offsets), std::span(out), std::span(out_offsets), std::span(errors), xtual::error_policy::replace);
+    assert(r.status == xtual::transcode_status::ok && r.rows == 3 && r.written == 10);
+}
+
+void test_b16_column()
+{
+    std::vector<char> data = { 'a', 0, 0x3d, static_cast<char>(0xd8), 0x00, static_cast<char>(0xde), 'b', 0 };
+    std::vector<std::int64_t> offsets = { 0, 2, 4, 8 };
+    std::vector<std::uint64_t> errors(1);
+
+    assert(xtual::validate_column<xtual::b16le_codec<char>>(std::span<const char>(data), std::span<const std::int64_t>(offsets), std::span(errors)) == 2);
+    assert(errors[0] == 6);
+
+    offsets = { 0, 2, 6, 8 };
+    assert(xtual::validate_column<xtual::b16le_codec<char>>(std::span<const char>(data), std::span<const std::int64_t>(offsets), std::span(errors)) == 0);
+}
+
+int main()
+{
+    test_transcode_column();
+    test_wide_column();
+    test_split_sequence();
+    test_insufficient();
+    test_b16_column();
+
+    std::cout << "OK" << std::endl;
+}
@@ -0,0 +1,93 @@
+#include <xtual.hxx>
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+template <typename T>
+std::vector<std::byte> bytes(std::initializer_list<T> units)
+{
+    std::vector<std::byte> out;
+
+    for (T u : units)
+    {
+        out.push_back(static_cast<std::byte>(u));
+    }
+
+    return out;
+}
+
+void test_to_string()
+{
+    assert(xtual::to_u16string(u8"aé野😀") == u"aé野😀");
+    assert(xtual::to_u32string(u8"aé野😀") == U"aé野😀");
+    assert(xtual::to_u8string(u"aé野😀") == u8"aé野😀");
+    assert(xtual::to_u32string(u"aé野😀") == U"aé野😀");
+    assert(xtual::to_u8string(U"aé野😀") == u8"aé野😀");
+    assert(xtual::to_u16string(U"aé野😀") == u"aé野😀");
+    assert(xtual::to_u8string(std::u8string(u8"same")) == u8"same");
+    assert(xtual::to_u16string(std::u8string_view()) == u"");
+}
+
+void test_to_bytes()
+{
+    assert(xtual::to_b8_bytes(U"é") == bytes({ 0xc3, 0xa9 }));
+    assert(xtual::to_b16be_bytes(u8"a😀") == bytes({ 0x00, 0x61, 0xd8, 0x3d, 0xde, 0x00 }));
+    assert(xtual::to_b16le_bytes(u"a") == bytes({ 0x61, 0x00 }));
+    assert(xtual::to_b32be_bytes(u8"é") == bytes({ 0x00, 0x00, 0x00, 0xe9 }));
+    assert(xtual::to_b32le_bytes(u"😀") == bytes({ 0x00, 0xf6, 0x01, 0x00 }));
+
+    auto chars = xtual::to_b8_bytes<char>(u"ok");
+    assert(chars && std::string(chars->begin(), chars->end()) == "ok");
+}
+
+void test_strict_error()
+{
+    assert(!xtual::to_u16string(std::u8string_view(u8"ab\xff")).has_value());
+    assert(!xtual::to_u8string(std::u16string_view(u"a\xd800")).has_value());
+    assert(!xtual::to_u8string(std::u32string_view(U"a\x110000")).has_value());
+    assert(!xtual::to_b16le_bytes(std::u8string_view(u8"ab\xe3\x81")).has_value());
+}
+
+void test_replace()
+{
+    using xtual::error_policy;
+
+    assert(xtual::to_u16string(std::u8string_view(u8"ab\xff" "c"), error_policy::replace) == u"ab\xfffd" "c");
+    assert(xtual::to_u8string(std::u8string_view(u8"\xff\xff\xff"), error_policy::replace) == u8"���");
+    assert(xtual::to_u8string(std::u16string_view(u"\xd800\xd800x"), error_policy::replace) == u8"��x");
+    assert(xtual::to_u32string(std::u8string_view(u8"\xe3\x81"), error_policy::replace) == U"\xfffd");
+}
+
+void test_pmr()
+{
+    std::array<std::byte, 1024> arena;
+    std::pmr::monotonic_buffer_resource resource(arena.data(), arena.size(), std::pmr::null_memory_resource());
+
+    auto s = xtual::to_u16string<std::pmr::polymorphic_allocator<char16_t>>(u8"日本語のテキスト", xtual::error_policy::strict, &resource);
+    assert(s && *s == u"日本語のテキスト");
+    assert(s->get_allocator().resource() == &resource);
+
+    auto b = xtual::to_b32le_bytes<std::byte, std::pmr::polymorphic_allocator<std::byte>>(u"pmr", xtual::error_policy::strict, &resource);
+    assert(b && b->size() == 12);
+
+    auto r = xtual::to_u8string<std::pmr::polymorphic_allocator<char8_t>>(std::u16string_view(u"\xdc00!"), xtual::error_policy::replace, &resource);
+    assert(r && *r == u8"�!");
+}
+
+int main()
+{
+    test_to_string();
+    test_to_bytes();
+    test_strict_error();
+    test_replace();
+    test_pmr();
+
+    std::cout << "OK" << std::endl;
+}
@@ -0,0 +1,109 @@
+#include <xtual.hxx>
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#undef NDEBUG
+#include <cassert>
+
+const char32_t *sample = U"The quick brown fox. Съешь же ещё этих мягких французских булок. いろはにほへと𩸽😀\x10ffff\xffff";
+
+void test_count_code_points_u8()
+{
+    const char8_t *buf = u8"aыあ𩸽";
+
+    assert(xtual::count_code_points_u8({ buf, 10 }) == 4);
+    assert(xtual::count_code_points_b8<char>({ "aыあ𩸽", 10 }) == 4);
+    assert(xtual::count_code_points_u8({ buf, 0 }) == 0);
+}
+
+void test_count_code_points_u16()
+{
+    const char16_t *buf = u"aыあ𩸽";
+
+    assert(xtual::count_code_points_u16({ buf, 5 }) == 4);
+}
+
+void test_utf16_length_from_u8()
+{
+    const char8_t *buf = u8"aыあ𩸽";
+
+    assert(xtual::utf16_length_from_u8({ buf, 10 }) == 5);
+    assert(xtual::utf16_length_from_b8<char>({ "aыあ𩸽", 10 }) == 5);
+}
+
+void test_utf8_length_from_u16()
+{
+    const char16_t *buf = u"aыあ𩸽";
+
+    assert(xtual::utf8_length_from_u16({ buf, 5 }) == 10);
+}
+
+void test_utf8_length_from_u32()
+{
+    const char32_t *buf = U"aыあ𩸽";
+
+    assert(xtual::utf8_length_from_u32({ buf, 4 }) == 10);
+    assert(xtual::utf16_length_from_u32({ buf, 4 }) == 5);
+}
+
+void test_lengths_match_transcode()
+{
+    const xtual::simd_level levels[] = { xtual::simd_level::scalar, xtual::simd_level::sse2, xtual::simd_level::avx2 };
+
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        std::u32string text;
+
+        for (int k = 0; k < 7; ++k)
+        {
+            text += sample;
+
+            std::u8string u8(text.size() * 4, u8'\0');
+            std::u16string u16(text.size() * 2, u'\0');
+
+            auto r8 = xtual::transcode_u32_to_u8(text, u8);
+            auto r16 = xtual::transcode_u32_to_u16(text, u16);
+
+            assert(r8.status == xtual::transcode_status::ok);
+            assert(r16.status == xtual::transcode_status::ok);
+
+            u8.resize(r8.written);
+            u16.resize(r16.written);
+
+            assert(xtual::utf8_length_from_u32(text) == u8.size());
+            assert(xtual::utf16_length_from_u32(text) == u16.size());
+            assert(xtual::utf8_length_from_u16(u16) == u8.size());
+            assert(xtual::utf16_length_from_u8(u8) == u16.size());
+            assert(xtual::count_code_points_u8(u8) == text.size());
+            assert(xtual::count_code_points_u16(u16) == text.size());
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+void test_lengths_constexpr()
+{
+    static_assert(xtual::count_code_points_u8(std::span<const char8_t>(u8"aыあ𩸽", 10)) == 4);
+    static_assert(xtual::utf16_length_from_u8(std::span<const char8_t>(u8"aыあ𩸽", 10)) == 5);
+    static_assert(xtual::utf8_length_from_u16(std::span<const char16_t>(u"aыあ𩸽", 5)) == 10);
+}
+
+int main()
+{
+    test_count_code_points_u8();
+    test_count_code_points_u16();
+    test_utf16_length_from_u8();
+    test_utf8_length_from_u16();
+    test_utf8_length_from_u32();
+
+    test_lengths_match_transcode();
+
+    test_lengths_constexpr();
+
+    std::cout << "OK" << std::endl;
+}
@@ -0,0 +1,141 @@
+#include <xtual.hxx>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+const xtual::simd_level levels[] = { xtual::simd_level::scalar, xtual::simd_level::sse2, xtual::simd_level::ssse3, xtual::simd_level::avx2 };
+
+std::u32string make_code_points(std::uint32_t seed, std::size_t n)
+{
+    const char32_t samples[] = { U'a', U'Z', U'é', U'я', U'ا', U'あ', U'野', U'\xffff', U'𩸽', U'😀', U'\x10ffff' };
+    std::u32string text;
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        seed = seed * 1103515245 + 12345;
+        text.push_back(samples[(seed >> 16) % 11]);
+    }
+
+    return text;
+}
+
+template <typename To>
+std::vector<typename To::unit_type> encode(const std::u32string &text)
+{
+    std::vector<typename To::unit_type> buf(text.size() * To::max_length);
+    auto *p = buf.data();
+
+    for (char32_t ch : text)
+    {
+        To::encode(p, buf.data() + buf.size(), ch);
+    }
+
+    buf.resize(p - buf.data());
+
+    return buf;
+}
+
+struct results
+{
+    std::vector<std::size_t> sizes;
+    std::vector<char16_t> u16;
+    std::vector<std::byte> b32;
+
+    bool operator==(const results &) const = default;
+};
+
+results run_kernels(std::uint32_t seed)
+{
+    results r;
+
+    auto text = make_code_points(seed, 500);
+    auto u8 = encode<xtual::u8_codec>(text);
+    auto u16 = encode<xtual::u16_codec>(text);
+    auto u32 = encode<xtual::u32_codec>(text);
+    auto b16 = encode<xtual::b16be_codec<std::byte>>(text);
+
+    u8[seed % u8.size()] = static_cast<char8_t>(seed);
+    b16[seed % b16.size() & ~std::size_t(1)] = std::byte { 0xdc };
+
+    r.sizes.push_back(xtual::validate_u8(u8));
+    r.sizes.push_back(xtual::count_code_points_u8(u8));
+    r.sizes.push_back(xtual::utf16_length_from_u8(u8));
+    r.sizes.push_back(xtual::count_code_points_u16(u16));
+    r.sizes.push_back(xtual::utf8_length_from_u16(u16));
+    r.sizes.push_back(xtual::utf8_length_from_u32(u32));
+    r.sizes.push_back(xtual::utf16_length_from_u32(u32));
+
+    auto zeros = xtual::count_zero_bytes(b16.data(), b16.data() + b16.size());
+    r.sizes.insert(r.sizes.end(), zeros.begin(), zeros.end());
+
+    r.u16.resize(u16.size());
+    auto t = xtual::transcode<xtual::b16be_codec<std::byte>, xtual::u16_codec>(std::span<const std::byte>(b16), r.u16);
+    r.sizes.push_back(t.read);
+    r.sizes.push_back(t.written);
+
+    r.b32.resize(u32.size() * 4);
+    t = xtual::transcode<xtual::u32_codec, xtual::b32le_codec<std::byte>>(std::span<const char32_t>(u32), r.b32);
+    r.sizes.push_back(t.read);
+    r.sizes.push_back(t.written);
+
+    return r;
+}
+
+void test_simd_level_names()
+{
+    for (auto level : levels)
+    {
+        assert(xtual::parse_simd_level(xtual::simd_level_name(level)) == level);
+    }
+
+    assert(!xtual::parse_simd_level("avx512").has_value());
+
+    static_assert(xtual::simd_level_name(xtual::simd_level::avx2) == "avx2");
+}
+
+void test_set_simd_level()
+{
+    auto detected = xtual::detect_simd_level();
+
+    assert(xtual::active_simd_level() <= detected);
+
+    for (auto level : levels)
+    {
+        auto set = xtual::set_simd_level(level);
+
+        assert(set == std::min(level, detected));
+        assert(xtual::active_simd_level() == set);
+    }
+}
+
+void test_levels_agree()
+{
+    for (std::uint32_t seed = 1; seed < 64; ++seed)
+    {
+        xtual::set_simd_level(xtual::simd_level::scalar);
+
+        auto expected = run_kernels(seed);
+
+        for (auto level : levels)
+        {
+            xtual::set_simd_level(level);
+
+            assert(run_kernels(seed) == expected);
+        }
+    }
+}
+
+int main()
+{
+    test_simd_level_names();
+    test_set_simd_level();
+    test_levels_agree();
+
+    std::cout << "OK" << std::endl;
+}
@@ -0,0 +1,302 @@
+#include <xtual.hxx>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#undef NDEBUG
+#include <cassert>
+
+const xtual::simd_level levels[] = { xtual::simd_level::scalar, xtual::simd_level::sse2, xtual::simd_level::ssse3, xtual::simd_level::avx2 };
+
+void test_null_sentinel()
+{
+    static_assert(std::sentinel_for<xtual::null_sentinel, const char *>);
+    static_assert(std::sentinel_for<xtual::null_sentinel, const char8_t *>);
+    static_assert(std::sentinel_for<xtual::null_sentinel, const char16_t *>);
+
+    const char *s = "a\xc3\xa9";
+
+    assert(xtual::decode_from_b8<char>(s, xtual::null_sentinel()) == U'a');
+    assert(xtual::decode_from_b8<char>(s, xtual::null_sentinel()) == U'é');
+    assert(!xtual::decode_from_b8<char>(s, xtual::null_sentinel()).has_value());
+
+    const char *t = "\xe3\x81";
+    assert(!xtual::decode_from_b8<char>(t, xtual::null_sentinel()).has_value());
+
+    const char16_t *u = u"😀";
+    assert(xtual::decode_from_u16(u, xtual::null_sentinel()) == U'😀');
+
+    static_assert(xtual::null_terminated_length(u8"abc") == 3);
+}
+
+template <typename unitT>
+void check_scan(const unitT *p, std::size_t limit)
+{
+    auto expected = xtual::scan_null_terminated_scalar(p, limit);
+    auto actual = xtual::scan_null_terminated(p, limit);
+
+    assert(actual.length == expected.length);
+    assert(actual.ascii == expected.ascii);
+    assert(actual.terminated == expected.terminated);
+}
+
+template <typename unitT>
+void test_scan_at_page_end()
+{
+    std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto *map = static_cast<char *>(mmap(nullptr, page * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    assert(map != MAP_FAILED);
+    assert(mprotect(map + page, page, PROT_NONE) == 0);
+
+    auto *end = reinterpret_cast<unitT *>(map + page);
+
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::size_t n = 1; n < 80; ++n)
+        {
+            unitT *p = end - n;
+
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                p[k] = static_cast<unitT>('a');
+            }
+
+            p[n - 1] = 0;
+            check_scan(p, SIZE_MAX / sizeof(unitT));
+            check_scan(p, n / 2);
+
+            for (std::size_t k = 0; k + 1 < n; ++k)
+            {
+                p[k] = static_cast<unitT>(sizeof(unitT) == 1 ? 0xc3 : 0x100);
+                check_scan(p, SIZE_MAX / sizeof(unitT));
+                check_scan(p, k);
+
+                p[k] = static_cast<unitT>(0x80);
+                check_scan(p, SIZE_MAX / sizeof(unitT));
+
+                p[k] = 0;
+                check_scan(p, SIZE_MAX / sizeof(unitT));
+
+                p[k] = static_cast<unitT>('a');
+            }
+
+            assert(xtual::null_terminated_length(p) == n - 1);
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+
+    munmap(map, page * 2);
+}
+
+template <std::size_t width>
+void test_scan_bytes_at_page_end()
+{
+    std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto *map = static_cast<unsigned char *>(mmap(nullptr, page * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    assert(map != MAP_FAILED);
+    assert(mprotect(map + page, page, PROT_NONE) == 0);
+
+    auto check = [](const unsigned char *p, std::size_t limit) {
+        auto expected = xtual::scan_null_terminated_bytes_scalar<width>(p, limit);
+        auto actual = xtual::scan_null_terminated_bytes<width>(p, limit);
+
+        assert(actual.length == expected.length);
+        assert(actual.terminated == expected.terminated);
+    };
+
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::size_t n = width; n < 100 * width; n += width)
+        {
+            unsigned char *p = map + page - n - n % 7 % width;
+
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                p[k] = k % 3 == 0 ? 0 : 0x41;
+            }
+
+            std::fill(p + n, map + page, 0x41);
+
+            std::fill(p + n - width, p + n, 0);
+            check(p, SIZE_MAX);
+            check(p, n - width);
+
+            for (std::size_t k = 0; k + width < n; ++k)
+            {
+                unsigned char saved = p[k + 1];
+
+                p[k + 1] = 0;
+                check(p, SIZE_MAX);
+                check(p, (k / width + 1) * width);
+                p[k + 1] = saved;
+            }
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+
+    munmap(map, page * 2);
+}
+
+std::u32string make_text(std::uint32_t seed, std::size_t n)
+{
+    const char32_t samples[] = { U'a', U'b', U'c', U'd', U'é', U'野', U'😀' };
+    std::u32string text;
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        seed = seed * 1103515245 + 12345;
+        text.push_back(samples[(seed >> 16) % (seed % 3 == 0 ? 7 : 4)]);
+    }
+
+    return text;
+}
+
+template <typename From, typename To>
+void check_transcode(const std::vector<typename From::unit_type> &in, xtual::error_policy policy)
+{
+    std::vector<typename To::unit_type> expected(in.size() * 4);
+    std::vector<typename To::unit_type> actual(in.size() * 4);
+
+    std::size_t n = 0;
+
+    while (in[n] != 0)
+    {
+        ++n;
+    }
+
+    auto e = xtual::transcode<From, To>(std::span<const typename From::unit_type>(in.data(), n), expected, policy);
+    auto a = xtual::transcode_null_terminated<From, To>(in.data(), actual, policy);
+
+    assert(a.status == e.status && a.read == e.read && a.written == e.written);
+    assert(std::equal(actual.begin(), actual.begin() + a.written, expected.begin()));
+}
+
+void test_transcode_null_terminated()
+{
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::size_t n : { 0, 1, 100, 4095, 4096, 4097, 9000 })
+        {
+            for (std::uint32_t seed = 0; seed < 3; ++seed)
+            {
+                auto text = make_text(seed, n);
+
+                auto u8 = xtual::to_u8string(text).value();
+                std::vector<char8_t> u8z(u8.begin(), u8.end());
+                u8z.push_back(0);
+
+                check_transcode<xtual::u8_codec, xtual::u16_codec>(u8z, xtual::error_policy::strict);
+                check_transcode<xtual::u8_codec, xtual::u32_codec>(u8z, xtual::error_policy::strict);
+                check_transcode<xtual::u8_codec, xtual::b16le_codec<std::byte>>(u8z, xtual::error_policy::strict);
+
+                auto u16 = xtual::to_u16string(text).value();
+                std::vector<char16_t> u16z(u16.begin(), u16.end());
+                u16z.push_back(0);
+
+                check_transcode<xtual::u16_codec, xtual::u8_codec>(u16z, xtual::error_policy::strict);
+
+                std::vector<char> ascii(n, 'x');
+                ascii.push_back(0);
+
+                check_transcode<xtual::b8_codec<char>, xtual::u16_codec>(ascii, xtual::error_policy::strict);
+
+                if (n > 10)
+                {
+                    u8z[n / 2] = 0xff;
+                    check_transcode<xtual::u8_codec, xtual::u16_codec>(u8z, xtual::error_policy::strict);
+                    check_transcode<xtual::u8_codec, xtual::u16_codec>(u8z, xtual::error_policy::replace);
+
+                    u16z[n / 3] = 0xdc00;
+                    check_transcode<xtual::u16_codec, xtual::u8_codec>(u16z, xtual::error_policy::replace);
+                }
+            }
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+
+    std::vector<char16_t> small(2);
+    auto r = xtual::transcode_null_terminated<xtual::b8_codec<char>, xtual::u16_codec>("abc", small);
+    assert(r.status == xtual::transcode_status::insufficient && r.read == 2 && r.written == 2);
+}
+
+void test_transcode_null_terminated_stray_tails()
+{
+    const char8_t seq[] = { 0xf0, 0x90, 0x80, 0x80, 0x80, 0x80 };
+
+    for (std::size_t at = 4088; at < 4097; ++at)
+    {
+        std::vector<char8_t> u8z(at + 100, u8'a');
+        std::copy(std::begin(seq), std::end(seq), u8z.begin() + at);
+        u8z.push_back(0);
+
+        check_transcode<xtual::u8_codec, xtual::u16_codec>(u8z, xtual::error_policy::strict);
+        check_transcode<xtual::u8_codec, xtual::u16_codec>(u8z, xtual::error_policy::replace);
+    }
+}
+
+void test_transcode_null_terminated_byte_order()
+{
+    const unsigned char b16[] = { 0x00, 0x41, 0x00, 0x42, 0x00, 0x00 };
+    const unsigned char b32[] = { 0x41, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    const unsigned char ascii[] = { 0xc3, 0xa9, 0x00 };
+
+    char8_t out[8];
+
+    auto r = xtual::transcode_null_terminated<xtual::b16be_codec<unsigned char>, xtual::u8_codec>(b16, out);
+    assert(r.status == xtual::transcode_status::ok && r.read == 4 && r.written == 2);
+    assert(out[0] == u8'A' && out[1] == u8'B');
+
+    r = xtual::transcode_null_terminated<xtual::b32le_codec<unsigned char>, xtual::u8_codec>(b32, out);
+    assert(r.status == xtual::transcode_status::ok && r.read == 8 && r.written == 3);
+
+    std::vector<unsigned char> long_b16;
+
+    for (std::size_t k = 0; k < 5000; ++k)
+    {
+        long_b16.push_back(0x30);
+        long_b16.push_back(0x42);
+    }
+
+    long_b16.push_back(0);
+    long_b16.push_back(0);
+
+    std::vector<char16_t> u16(5000);
+    auto q = xtual::transcode_null_terminated<xtual::b16le_codec<unsigned char>, xtual::u16_codec>(long_b16.data(), u16);
+    assert(q.status == xtual::transcode_status::ok && q.read == 10000 && q.written == 5000);
+    assert(u16[4999] == u'\x4230');
+
+    r = xtual::transcode_null_terminated<xtual::b8_codec<unsigned char>, xtual::u8_codec>(ascii, out);
+    assert(r.status == xtual::transcode_status::ok && r.read == 2 && r.written == 2);
+}
+
+int main()
+{
+    test_null_sentinel();
+    test_scan_at_page_end<char>();
+    test_scan_at_page_end<char16_t>();
+    test_scan_at_page_end<char32_t>();
+    test_scan_bytes_at_page_end<2>();
+    test_scan_bytes_at_page_end<4>();
+    test_transcode_null_terminated();
+    test_transcode_null_terminated_stray_tails();
+    test_transcode_null_terminated_byte_order();
+
+    std::cout << "OK" << std::endl;
+}
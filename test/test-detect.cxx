@@ -0,0 +1,177 @@
+#include <xtual.hxx>
+
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+template <typename To>
+std::vector<std::byte> encode(std::u32string_view text)
+{
+    std::vector<std::byte> buf(text.size() * To::max_length);
+    std::byte *p = buf.data();
+
+    for (char32_t ch : text)
+    {
+        To::encode(p, buf.data() + buf.size(), ch);
+    }
+
+    buf.resize(p - buf.data());
+
+    return buf;
+}
+
+std::vector<std::byte> with_bom(std::initializer_list<unsigned char> bom, std::vector<std::byte> body)
+{
+    std::vector<std::byte> buf;
+
+    for (unsigned char b : bom)
+    {
+        buf.push_back(static_cast<std::byte>(b));
+    }
+
+    buf.insert(buf.end(), body.begin(), body.end());
+
+    return buf;
+}
+
+xtual::encoding_detection detect(const std::vector<std::byte> &buf)
+{
+    return xtual::detect_encoding(std::span<const std::byte>(buf));
+}
+
+void test_detect_bom()
+{
+    std::u32string_view text = U"abc";
+
+    auto r = detect(with_bom({ 0xef, 0xbb, 0xbf }, encode<xtual::b8_codec<std::byte>>(text)));
+    assert(r.best() == xtual::encoding::b8 && r.bom_length == 3 && r.candidates[0].confidence == 100);
+
+    r = detect(with_bom({ 0xfe, 0xff }, encode<xtual::b16be_codec<std::byte>>(text)));
+    assert(r.best() == xtual::encoding::b16be && r.bom_length == 2);
+
+    r = detect(with_bom({ 0xff, 0xfe }, encode<xtual::b16le_codec<std::byte>>(text)));
+    assert(r.best() == xtual::encoding::b16le && r.bom_length == 2);
+
+    r = detect(with_bom({ 0x00, 0x00, 0xfe, 0xff }, encode<xtual::b32be_codec<std::byte>>(text)));
+    assert(r.best() == xtual::encoding::b32be && r.bom_length == 4);
+
+    r = detect(with_bom({ 0xff, 0xfe, 0x00, 0x00 }, encode<xtual::b32le_codec<std::byte>>(text)));
+    assert(r.best() == xtual::encoding::b32le && r.bom_length == 4);
+}
+
+void test_detect_without_bom()
+{
+    const std::u32string_view texts[] = {
+        U"The quick brown fox jumps over the lazy dog.",
+        U"Größenwahn und Übermut, déjà vu.",
+        U"吾輩は猫である。名前はまだ無い。",
+        U"😀😃😄😁😆😅🤣😂🙂🙃",
+    };
+
+    for (auto text : texts)
+    {
+        auto r = detect(encode<xtual::b8_codec<std::byte>>(text));
+        assert(r.best() == xtual::encoding::b8 && r.bom_length == 0);
+
+        r = detect(encode<xtual::b32be_codec<std::byte>>(text));
+        assert(r.best() == xtual::encoding::b32be);
+
+        r = detect(encode<xtual::b32le_codec<std::byte>>(text));
+        assert(r.best() == xtual::encoding::b32le);
+    }
+
+    for (auto text : { texts[0], texts[1] })
+    {
+        auto r = detect(encode<xtual::b16be_codec<std::byte>>(text));
+        assert(r.best() == xtual::encoding::b16be);
+
+        r = detect(encode<xtual::b16le_codec<std::byte>>(text));
+        assert(r.best() == xtual::encoding::b16le);
+    }
+}
+
+void test_detect_ranking()
+{
+    auto r = detect(encode<xtual::b16le_codec<std::byte>>(U"plain ascii text"));
+
+    for (std::size_t k = 1; k < r.candidates.size(); ++k)
+    {
+        assert(r.candidates[k - 1].confidence >= r.candidates[k].confidence);
+    }
+
+    assert(r.candidates[1].form == xtual::encoding::b8);
+
+    r = detect(with_bom({}, { std::byte { 0xff }, std::byte { 0xff }, std::byte { 0xff } }));
+    assert(r.best() != xtual::encoding::b8);
+    assert(r.candidates[4].confidence == 0);
+}
+
+void test_detect_truncated()
+{
+    auto buf = encode<xtual::b8_codec<std::byte>>(U"日本語");
+    buf.pop_back();
+
+    auto r = detect(buf);
+    assert(r.best() == xtual::encoding::b8 && r.candidates[0].confidence == 90);
+}
+
+void test_detect_sample()
+{
+    std::u32string text;
+
+    while (text.size() * 3 <= xtual::detect_sample_size)
+    {
+        text += U"日本語";
+    }
+
+    auto buf = encode<xtual::b8_codec<std::byte>>(text);
+    buf.resize(xtual::detect_sample_size + 1);
+    buf.back() = std::byte { 0xff };
+
+    auto r = detect(buf);
+    assert(r.best() == xtual::encoding::b8 && r.candidates[0].confidence == 90);
+
+    std::u32string astral(xtual::detect_sample_size / 4 + 1, U'\x1f600');
+    astral.front() = U'a';
+
+    buf = encode<xtual::b16le_codec<std::byte>>(astral);
+    r = detect(buf);
+
+    for (auto c : r.candidates)
+    {
+        assert(c.form != xtual::encoding::b16le || c.confidence != 0);
+    }
+}
+
+void test_visit_encoding()
+{
+    auto buf = encode<xtual::b16be_codec<std::byte>>(U"visit 日本");
+    auto r = detect(buf);
+
+    std::size_t n = xtual::visit_encoding<std::byte>(r.best(), [&](auto from) {
+        using From = typename decltype(from)::type;
+
+        std::vector<char32_t> out(buf.size());
+
+        return xtual::transcode<From, xtual::u32_codec>(std::span<const std::byte>(buf), out).written;
+    });
+
+    assert(n == 8);
+}
+
+int main()
+{
+    test_detect_bom();
+    test_detect_without_bom();
+    test_detect_ranking();
+    test_detect_truncated();
+    test_detect_sample();
+    test_visit_encoding();
+
+    std::cout << "OK" << std::endl;
+}
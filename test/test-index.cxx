@@ -0,0 +1,145 @@
+#include <xtual.hxx>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+const char32_t samples[] = { U'a', U'Z', U'é', U'я', U'ا', U'あ', U'野', U'\xffff', U'𩸽', U'😀', U'\x10ffff' };
+
+std::u32string make_code_points(std::uint32_t seed, std::size_t n)
+{
+    std::u32string text;
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        seed = seed * 1103515245 + 12345;
+        text.push_back(samples[(seed >> 16) % 11]);
+    }
+
+    return text;
+}
+
+template <typename Codec>
+std::vector<typename Codec::unit_type> encode(const std::u32string &text, std::vector<std::size_t> &offsets)
+{
+    std::vector<typename Codec::unit_type> buf(text.size() * Codec::max_length);
+    auto *p = buf.data();
+
+    for (char32_t ch : text)
+    {
+        offsets.push_back(p - buf.data());
+        Codec::encode(p, buf.data() + buf.size(), ch);
+    }
+
+    buf.resize(p - buf.data());
+    offsets.push_back(buf.size());
+
+    return buf;
+}
+
+template <typename Codec>
+void check_index(std::size_t stride)
+{
+    for (std::uint32_t seed = 0; seed < 4; ++seed)
+    {
+        auto text = make_code_points(seed, 1000);
+        std::vector<std::size_t> offsets;
+        auto buf = encode<Codec>(text, offsets);
+
+        xtual::offset_index<Codec> index(buf, stride);
+
+        assert(index.size() == text.size());
+        assert(index.length() == buf.size());
+
+        for (std::size_t n = 0; n <= text.size(); ++n)
+        {
+            assert(index.offset(n) == offsets[n]);
+        }
+
+        for (std::size_t n = 0; n < text.size(); ++n)
+        {
+            assert(index.at(n) == text[n]);
+        }
+
+        assert(!index.at(text.size()).has_value());
+
+        auto sub = index.substr(100, 250);
+        assert(sub.data() == buf.data() + offsets[100]);
+        assert(sub.size() == offsets[250] - offsets[100]);
+
+        assert(index.substr(990, 5000).size() == buf.size() - offsets[990]);
+        assert(index.substr(300, 200).empty());
+    }
+}
+
+template <typename Codec>
+void check_extend(std::size_t stride)
+{
+    auto text = make_code_points(7, 2000);
+    std::vector<std::size_t> offsets;
+    auto buf = encode<Codec>(text, offsets);
+
+    xtual::offset_index<Codec> index(stride);
+
+    for (std::size_t end = 0; end < buf.size(); end += 37)
+    {
+        index.extend({ buf.data(), end });
+    }
+
+    index.extend(buf);
+
+    xtual::offset_index<Codec> full(buf, stride);
+
+    assert(index.size() == full.size());
+
+    for (std::size_t n = 0; n <= text.size(); ++n)
+    {
+        assert(index.offset(n) == full.offset(n));
+    }
+}
+
+void test_offset_index_u8()
+{
+    check_index<xtual::u8_codec>(1);
+    check_index<xtual::u8_codec>(7);
+    check_index<xtual::u8_codec>(256);
+    check_index<xtual::b8_codec<std::byte>>(64);
+}
+
+void test_offset_index_u16()
+{
+    check_index<xtual::u16_codec>(1);
+    check_index<xtual::u16_codec>(13);
+    check_index<xtual::u16_codec>(256);
+}
+
+void test_offset_index_extend()
+{
+    check_extend<xtual::u8_codec>(16);
+    check_extend<xtual::u16_codec>(16);
+}
+
+void test_offset_index_empty()
+{
+    xtual::u8_offset_index index;
+
+    assert(index.size() == 0);
+    assert(index.offset(0) == 0);
+    assert(!index.at(0).has_value());
+    assert(index.substr(0, 10).empty());
+}
+
+int main()
+{
+    test_offset_index_u8();
+    test_offset_index_u16();
+    test_offset_index_extend();
+    test_offset_index_empty();
+
+    std::cout << "OK" << std::endl;
+}
@@ -0,0 +1,261 @@
+#include <xtual.hxx>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+const xtual::simd_level levels[] = { xtual::simd_level::scalar, xtual::simd_level::sse2, xtual::simd_level::ssse3, xtual::simd_level::avx2 };
+
+std::vector<unsigned char> make_latin1(std::uint32_t seed, std::size_t n, bool ascii)
+{
+    std::vector<unsigned char> buf;
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        seed = seed * 1103515245 + 12345;
+
+        unsigned char ch = static_cast<unsigned char>(seed >> 16);
+
+        buf.push_back(ascii || (seed >> 28) != 0 ? ch & 0x7f : ch);
+    }
+
+    return buf;
+}
+
+template <typename To>
+std::vector<typename To::unit_type> reference(const std::vector<unsigned char> &in)
+{
+    std::vector<typename To::unit_type> out(in.size() * To::max_length);
+    auto *o = out.data();
+
+    for (unsigned char ch : in)
+    {
+        To::encode(o, out.data() + out.size(), ch);
+    }
+
+    out.resize(o - out.data());
+
+    return out;
+}
+
+void test_latin1_codec()
+{
+    std::array<unsigned char, 2> buf {};
+    auto *i = buf.begin();
+
+    assert(xtual::encode_as_latin1<unsigned char>(i, buf.end(), U'é'));
+    assert(!xtual::encode_as_latin1<unsigned char>(i, buf.end(), U'\x100'));
+    assert(i == buf.begin() + 1 && buf[0] == 0xe9);
+
+    const auto *j = buf.cbegin();
+    assert(xtual::decode_from_latin1<unsigned char>(j, buf.cend()) == U'é');
+
+    i = buf.begin();
+    assert(xtual::encode_as_ascii<unsigned char>(i, buf.end(), U'a'));
+    assert(!xtual::encode_as_ascii<unsigned char>(i, buf.end(), U'é'));
+
+    buf = { 0x41, 0x80 };
+    j = buf.cbegin();
+    assert(xtual::decode_from_ascii<unsigned char>(j, buf.cend()) == U'A');
+    assert(!xtual::decode_from_ascii<unsigned char>(j, buf.cend()).has_value());
+    assert(xtual::decode_lossy_from_ascii<unsigned char>(j, buf.cend()) == U'\xfffd');
+    assert(j == buf.cend());
+}
+
+template <typename To>
+void check_from_latin1(const std::vector<unsigned char> &in)
+{
+    auto expected = reference<To>(in);
+    std::vector<typename To::unit_type> out(expected.size());
+
+    auto r = xtual::transcode<xtual::latin1_codec<unsigned char>, To>(std::span<const unsigned char>(in), out);
+
+    assert(r.status == xtual::transcode_status::ok && r.read == in.size() && r.written == expected.size());
+    assert(out == expected);
+}
+
+template <typename From>
+void check_to_latin1(const std::vector<unsigned char> &expected)
+{
+    auto in = reference<From>(expected);
+    std::vector<unsigned char> out(expected.size());
+
+    auto r = xtual::transcode<From, xtual::latin1_codec<unsigned char>>(std::span<const typename From::unit_type>(in), out);
+
+    assert(r.status == xtual::transcode_status::ok && r.read == in.size() && r.written == expected.size());
+    assert(out == expected);
+}
+
+void test_latin1_bulk()
+{
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::uint32_t seed = 0; seed < 40; ++seed)
+        {
+            for (bool ascii : { false, true })
+            {
+                auto text = make_latin1(seed, seed * 7, ascii);
+
+                check_from_latin1<xtual::u8_codec>(text);
+                check_from_latin1<xtual::u16_codec>(text);
+                check_from_latin1<xtual::u32_codec>(text);
+                check_from_latin1<xtual::b16le_codec<std::byte>>(text);
+
+                check_to_latin1<xtual::u8_codec>(text);
+                check_to_latin1<xtual::u16_codec>(text);
+                check_to_latin1<xtual::u32_codec>(text);
+            }
+
+            std::vector<unsigned char> heavy(seed * 5);
+
+            for (std::size_t k = 0; k < heavy.size(); ++k)
+            {
+                heavy[k] = static_cast<unsigned char>(seed * 31 + k * 57);
+            }
+
+            check_from_latin1<xtual::u8_codec>(heavy);
+            check_to_latin1<xtual::u8_codec>(heavy);
+
+            auto expected = reference<xtual::u8_codec>(heavy);
+
+            for (std::size_t n = 0; n < expected.size(); n += 13)
+            {
+                std::vector<char8_t> part(n);
+                auto r = xtual::transcode<xtual::latin1_codec<unsigned char>, xtual::u8_codec>(std::span<const unsigned char>(heavy), part);
+
+                assert(r.status == xtual::transcode_status::insufficient && r.written <= n);
+                assert(std::equal(part.begin(), part.begin() + r.written, expected.begin()));
+            }
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+void test_unencodable()
+{
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::size_t k = 0; k < 70; ++k)
+        {
+            std::u16string in(70, u'x');
+            in[k] = u'\x3042';
+
+            std::vector<unsigned char> out(in.size());
+
+            auto r = xtual::transcode_u16_to_latin1<unsigned char>(in, out);
+            assert(r.status == xtual::transcode_status::invalid && r.read == k && r.written == k);
+
+            r = xtual::transcode_u16_to_latin1<unsigned char>(in, out, xtual::error_policy::replace);
+            assert(r.status == xtual::transcode_status::ok && r.written == in.size() && out[k] == '?');
+
+            std::u32string wide(70, U'y');
+            wide[k] = U'é';
+
+            auto a = xtual::transcode<xtual::u32_codec, xtual::ascii_codec<char>>(std::span<const char32_t>(wide), std::span<char>(reinterpret_cast<char *>(out.data()), out.size()));
+            assert(a.status == xtual::transcode_status::invalid && a.read == k);
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+
+    std::u8string in = u8"a日b";
+    std::vector<unsigned char> out(in.size());
+
+    auto r = xtual::transcode_u8_to_latin1<unsigned char>(in, out, xtual::error_policy::replace);
+    assert(r.status == xtual::transcode_status::ok && r.read == in.size() && r.written == 3);
+    assert(out[0] == 'a' && out[1] == '?' && out[2] == 'b');
+
+    auto s = xtual::to_u8string(std::u8string_view(u8"\xff"), xtual::error_policy::replace);
+    assert(s == u8"\xef\xbf\xbd");
+}
+
+void test_stream_and_views()
+{
+    std::u8string in = u8"é日";
+    std::array<unsigned char, 8> out {};
+
+    xtual::stream_decoder<xtual::u8_codec> strict;
+    auto r = strict.feed<xtual::latin1_codec<unsigned char>>(std::span<const char8_t>(in.data(), 3), out);
+    assert(r.status == xtual::transcode_status::ok && r.written == 1 && out[0] == 0xe9);
+    r = strict.feed<xtual::latin1_codec<unsigned char>>(std::span<const char8_t>(in.data() + 3, 2), out);
+    assert(r.status == xtual::transcode_status::invalid);
+
+    xtual::stream_decoder<xtual::u8_codec> lossy(xtual::error_policy::replace);
+    r = lossy.feed<xtual::latin1_codec<unsigned char>>(std::span<const char8_t>(in.data(), 3), out);
+    r = lossy.feed<xtual::latin1_codec<unsigned char>>(std::span<const char8_t>(in.data() + 3, 2), out);
+    assert(r.status == xtual::transcode_status::ok && r.written == 1 && out[0] == '?');
+
+    std::u32string text = U"aé日";
+    std::string encoded;
+
+    for (char ch : text | xtual::encode_adaptor<xtual::latin1_codec<char>>())
+    {
+        encoded.push_back(ch);
+    }
+
+    assert(encoded == "a\xe9?");
+}
+
+void test_is_ascii()
+{
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::size_t n = 0; n < 200; n += 13)
+        {
+            std::u8string u8(n, u8'a');
+            std::u16string u16(n, u'a');
+            std::u32string u32(n, U'a');
+            std::vector<std::byte> bytes(n, std::byte { 'a' });
+
+            assert(xtual::is_ascii(u8) && xtual::is_ascii(u16) && xtual::is_ascii(u32));
+            assert(xtual::is_ascii(std::span<const std::byte>(bytes)));
+
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                u8[k] = 0x80;
+                u16[k] = 0x100;
+                u32[k] = 0x10000;
+                bytes[k] = std::byte { 0xff };
+
+                assert(!xtual::is_ascii(u8) && !xtual::is_ascii(u16) && !xtual::is_ascii(u32));
+                assert(!xtual::is_ascii(std::span<const std::byte>(bytes)));
+
+                u8[k] = u8'a';
+                u16[k] = u'\x80';
+                assert(!xtual::is_ascii(u16));
+                u16[k] = u'a';
+                u32[k] = U'a';
+                bytes[k] = std::byte { 'a' };
+            }
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+
+    static_assert(xtual::is_ascii(std::span<const char8_t>(u8"abc", 3)));
+    static_assert(!xtual::is_ascii(std::span<const char8_t>(u8"aé", 3)));
+}
+
+int main()
+{
+    test_latin1_codec();
+    test_latin1_bulk();
+    test_unencodable();
+    test_stream_and_views();
+    test_is_ascii();
+
+    std::cout << "OK" << std::endl;
+}
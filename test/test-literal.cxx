@@ -0,0 +1,93 @@
+#include <xtual.hxx>
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+
+#undef NDEBUG
+#include <cassert>
+
+constexpr std::size_t encode_u16(char32_t ch)
+{
+    char16_t buf[2] = {};
+    char16_t *i = buf;
+
+    return xtual::encode_as_u16(i, buf + 2, ch) ? i - buf : 0;
+}
+
+constexpr char32_t decode_b8(const char *s, std::size_t n)
+{
+    const char *i = s;
+
+    return xtual::decode_from_b8<char>(i, s + n).value_or(U'\0');
+}
+
+constexpr char32_t decode_lossy_b16le(const char *s, std::size_t n)
+{
+    const char *i = s;
+
+    return xtual::decode_lossy_from_b16le<char>(i, s + n).value_or(U'\0');
+}
+
+void test_constexpr_encode_decode()
+{
+    static_assert(encode_u16(U'あ') == 1);
+    static_assert(encode_u16(U'𩸽') == 2);
+    static_assert(encode_u16(U'\xd800') == 0);
+
+    static_assert(decode_b8("\xe3\x81\x82", 3) == U'あ');
+    static_assert(decode_b8("\xe3\x81", 2) == U'\0');
+
+    static_assert(decode_lossy_b16le("\x42\x30", 2) == U'あ');
+    static_assert(decode_lossy_b16le("\x00\xdc", 2) == U'\xfffd');
+}
+
+void test_literal_u16()
+{
+    constexpr auto a = xtual::u8_to_u16_array<u8"aあ𩸽">;
+
+    static_assert(a.size() == 4);
+    static_assert(a == std::array<char16_t, 4> { u'a', u'\x3042', u'\xd867', u'\xde3d' });
+
+    constexpr auto empty = xtual::u8_to_u16_array<u8"">;
+
+    static_assert(empty.size() == 0);
+}
+
+void test_literal_b16be()
+{
+    constexpr auto a = xtual::u8_to_b16be_array<u8"aあ", unsigned char>;
+
+    static_assert(a == std::array<unsigned char, 4> { 0x00, 0x61, 0x30, 0x42 });
+
+    constexpr auto b = xtual::u8_to_b16be_array<u8"あ">;
+
+    static_assert(b.size() == 2);
+    static_assert(b[0] == std::byte { 0x30 } && b[1] == std::byte { 0x42 });
+}
+
+void test_literal_u32()
+{
+    constexpr auto a = xtual::u8_to_u32_array<u8"ы𩸽">;
+
+    static_assert(a == std::array<char32_t, 2> { U'ы', U'𩸽' });
+}
+
+void test_literal_b32le()
+{
+    constexpr auto a = xtual::u8_to_b32le_array<u8"𩸽", char>;
+
+    static_assert(a == std::array<char, 4> { '\x3d', '\x9e', '\x02', '\x00' });
+}
+
+int main()
+{
+    test_constexpr_encode_decode();
+
+    test_literal_u16();
+    test_literal_b16be();
+    test_literal_u32();
+    test_literal_b32le();
+
+    std::cout << "OK" << std::endl;
+}
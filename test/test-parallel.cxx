@@ -0,0 +1,146 @@
+#include <xtual.hxx>
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+template <typename From, typename To>
+void check_parallel(std::span<const typename From::unit_type> in, std::size_t out_size, xtual::error_policy policy)
+{
+    std::vector<typename To::unit_type> expect(out_size);
+    std::vector<typename To::unit_type> actual(out_size);
+
+    auto r1 = xtual::transcode<From, To>(in, expect, policy);
+    auto r2 = xtual::parallel_transcode<From, To>(in, actual, policy, 4);
+
+    assert(r1.read == r2.read);
+    assert(r1.written == r2.written);
+    assert(r1.status == r2.status);
+    assert(std::equal(expect.begin(), expect.begin() + r1.written, actual.begin()));
+}
+
+std::vector<char32_t> make_text(std::size_t n)
+{
+    const char32_t alphabet[] = { U'a', U'é', U'ы', U'あ', U'𩸽', U'z', U'野', U'😀' };
+    std::vector<char32_t> text(n);
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        text[k] = alphabet[(k * 7 + k / 13) % 8];
+    }
+
+    return text;
+}
+
+template <typename Codec>
+std::vector<typename Codec::unit_type> encode_text(const std::vector<char32_t> &text)
+{
+    std::vector<typename Codec::unit_type> units(text.size() * Codec::max_length);
+    auto r = xtual::transcode<xtual::u32_codec, Codec>(text, units);
+
+    units.resize(r.written);
+
+    return units;
+}
+
+void test_parallel_valid()
+{
+    auto text = make_text(300000);
+
+    auto u8 = encode_text<xtual::u8_codec>(text);
+    auto u16 = encode_text<xtual::u16_codec>(text);
+    auto b16le = encode_text<xtual::b16le_codec<char>>(text);
+    auto b32be = encode_text<xtual::b32be_codec<char>>(text);
+
+    check_parallel<xtual::u8_codec, xtual::u16_codec>(u8, u8.size(), xtual::error_policy::strict);
+    check_parallel<xtual::u16_codec, xtual::u8_codec>(u16, u16.size() * 3, xtual::error_policy::strict);
+    check_parallel<xtual::b16le_codec<char>, xtual::u32_codec>(b16le, b16le.size(), xtual::error_policy::strict);
+    check_parallel<xtual::b32be_codec<char>, xtual::u8_codec>(b32be, b32be.size(), xtual::error_policy::strict);
+}
+
+void test_parallel_invalid()
+{
+    auto text = make_text(200000);
+    auto u8 = encode_text<xtual::u8_codec>(text);
+    auto u16 = encode_text<xtual::u16_codec>(text);
+
+    for (std::size_t k : { std::size_t(0), u8.size() / 3, u8.size() / 2 + 1, u8.size() - 1 })
+    {
+        for (std::size_t d = 0; d < 4; ++d)
+        {
+            std::size_t at = std::min(k + d, u8.size() - 1);
+
+            auto bad = u8;
+            bad[at] = 0xff;
+
+            check_parallel<xtual::u8_codec, xtual::u32_codec>(bad, bad.size(), xtual::error_policy::strict);
+            check_parallel<xtual::u8_codec, xtual::u32_codec>(bad, bad.size(), xtual::error_policy::replace);
+
+            auto cut = u8;
+            cut.erase(cut.begin() + at);
+
+            check_parallel<xtual::u8_codec, xtual::u16_codec>(cut, cut.size(), xtual::error_policy::strict);
+        }
+    }
+
+    for (std::size_t k = u16.size() / 4 - 4; k < u16.size() / 4 + 4; ++k)
+    {
+        auto bad = u16;
+        bad[k] = u'\xd800';
+
+        check_parallel<xtual::u16_codec, xtual::u8_codec>(bad, bad.size() * 3, xtual::error_policy::strict);
+        check_parallel<xtual::u16_codec, xtual::u8_codec>(bad, bad.size() * 3, xtual::error_policy::replace);
+    }
+}
+
+void test_parallel_insufficient()
+{
+    auto text = make_text(200000);
+    auto u8 = encode_text<xtual::u8_codec>(text);
+
+    for (std::size_t n : { std::size_t(0), std::size_t(1000), text.size() / 2, text.size() - 1 })
+    {
+        check_parallel<xtual::u8_codec, xtual::u32_codec>(u8, n, xtual::error_policy::strict);
+    }
+}
+
+void test_parallel_stray_tails()
+{
+    const char8_t seq[] = { 0xf0, 0x90, 0x80, 0x80, 0x80, 0x80 };
+
+    for (std::size_t d = 0; d < 6; ++d)
+    {
+        std::vector<char8_t> u8(262144, u8'a');
+        std::copy(std::begin(seq), std::end(seq), u8.begin() + u8.size() / 2 - d);
+
+        check_parallel<xtual::u8_codec, xtual::u16_codec>(u8, u8.size(), xtual::error_policy::strict);
+        check_parallel<xtual::u8_codec, xtual::u16_codec>(u8, u8.size(), xtual::error_policy::replace);
+    }
+}
+
+void test_parallel_small()
+{
+    const char8_t in[] = u8"aあ𩸽";
+    char16_t out[8];
+
+    auto r = xtual::parallel_transcode<xtual::u8_codec, xtual::u16_codec>(std::span(in, 8), out);
+
+    assert(r.status == xtual::transcode_status::ok);
+    assert(r.written == 4);
+}
+
+int main()
+{
+    test_parallel_valid();
+    test_parallel_invalid();
+    test_parallel_insufficient();
+    test_parallel_stray_tails();
+    test_parallel_small();
+
+    std::cout << "OK" << std::endl;
+}
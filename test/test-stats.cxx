@@ -0,0 +1,281 @@
+#define XTUAL_ENABLE_STATS
+#include <xtual.hxx>
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+void test_counters()
+{
+    static_assert(xtual::stats_enabled);
+
+    xtual::set_simd_level(xtual::simd_level::scalar);
+    xtual::stats_reset();
+
+    std::u8string in = u8"abcé日😀";
+    std::vector<char16_t> out(16);
+
+    auto r = xtual::transcode_u8_to_u16(in, out);
+    assert(r.status == xtual::transcode_status::ok);
+
+    auto s = xtual::stats_snapshot();
+    assert(s.read(xtual::stats_form::utf8) == in.size());
+    assert(s.written(xtual::stats_form::utf16) == r.written * 2);
+    assert(s.code_points == 6 && s.ascii_code_points == 3);
+    assert(s.ascii_fraction() == 0.5);
+    assert(s.path(xtual::simd_level::scalar) == in.size());
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+void test_errors()
+{
+    xtual::stats_reset();
+
+    std::u8string bad = u8"a\xff" "b\xe3\x81";
+    std::vector<char32_t> out(8);
+
+    xtual::transcode_u8_to_u32(bad, out);
+    xtual::transcode_u8_to_u32(std::u8string_view(u8"\xe3\x81"), out);
+    xtual::transcode_u8_to_u32(std::u8string_view(u8"abc"), std::span<char32_t>(out.data(), 1));
+
+    auto s = xtual::stats_snapshot();
+    assert(s.error_count(xtual::transcode_status::invalid) == 1);
+    assert(s.error_count(xtual::transcode_status::incomplete) == 1);
+    assert(s.error_count(xtual::transcode_status::insufficient) == 1);
+
+    xtual::stats_reset();
+    xtual::transcode_u8_to_u32(bad, out, xtual::error_policy::replace);
+
+    s = xtual::stats_snapshot();
+    assert(s.error_count(xtual::transcode_status::invalid) == 1);
+    assert(s.error_count(xtual::transcode_status::incomplete) == 1);
+    assert(s.code_points == 2 && s.read(xtual::stats_form::utf8) == 2);
+}
+
+void test_kernel_path()
+{
+    xtual::set_simd_level(xtual::simd_level::avx2);
+
+    if (xtual::active_simd_level() != xtual::simd_level::avx2)
+    {
+        return;
+    }
+
+    xtual::stats_reset();
+
+    std::string in(1000, 'x');
+    std::vector<char16_t> out(in.size());
+
+    xtual::transcode<xtual::latin1_codec<char>, xtual::u16_codec>(std::span<const char>(in), out);
+
+    auto s = xtual::stats_snapshot();
+    assert(s.read(xtual::stats_form::single_byte) == in.size());
+    assert(s.path(xtual::simd_level::avx2) + s.path(xtual::simd_level::scalar) == in.size());
+    assert(s.path(xtual::simd_level::avx2) >= 992);
+    assert(s.code_points == in.size() && s.ascii_code_points == in.size());
+}
+
+template <typename From, typename To>
+void check_kernel_counts(const std::u32string &text)
+{
+    std::vector<typename From::unit_type> in(text.size() * From::max_length);
+    auto *p = in.data();
+
+    for (char32_t ch : text)
+    {
+        From::encode(p, in.data() + in.size(), ch);
+    }
+
+    in.resize(static_cast<std::size_t>(p - in.data()));
+
+    std::vector<typename To::unit_type> out(text.size() * To::max_length);
+    std::size_t ascii = 0;
+
+    for (char32_t ch : text)
+    {
+        ascii += ch < U'\x80';
+    }
+
+    xtual::stats_reset();
+    xtual::transcode<From, To>(std::span<const typename From::unit_type>(in), out);
+
+    auto s = xtual::stats_snapshot();
+    assert(s.code_points == text.size() && s.ascii_code_points == ascii);
+}
+
+void test_kernel_counts()
+{
+    const xtual::simd_level levels[] = { xtual::simd_level::scalar, xtual::simd_level::sse2, xtual::simd_level::ssse3, xtual::simd_level::avx2 };
+    const char32_t samples[] = { U'a', U'~', U'é', U'\xff', U'Ж', U'日', U'😀', U'\x10ffff' };
+
+    std::u32string text;
+    std::u32string latin;
+
+    for (std::size_t k = 0; k < 500; ++k)
+    {
+        text.push_back(samples[k * 7 % (k % 3 == 0 ? 8 : 2)]);
+        latin.push_back(samples[k * 7 % (k % 3 == 0 ? 4 : 2)]);
+    }
+
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        check_kernel_counts<xtual::u8_codec, xtual::u16_codec>(text);
+        check_kernel_counts<xtual::u16_codec, xtual::u8_codec>(text);
+        check_kernel_counts<xtual::b16be_codec<char>, xtual::u8_codec>(text);
+        check_kernel_counts<xtual::b16le_codec<char>, xtual::u16_codec>(text);
+        check_kernel_counts<xtual::u32_codec, xtual::u8_codec>(text);
+        check_kernel_counts<xtual::b32be_codec<char>, xtual::u32_codec>(text);
+        check_kernel_counts<xtual::latin1_codec<char>, xtual::u8_codec>(latin);
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+void test_decode_errors()
+{
+    xtual::stats_reset();
+
+    std::u8string u8 = u8"a\xff" u8"\xe3\x81";
+    auto i = u8.begin();
+
+    assert(xtual::decode_from_u8(i, u8.end()) == U'a');
+    assert(!xtual::decode_from_u8(i, u8.end()));
+    assert(!xtual::decode_from_u8(i, u8.end()));
+    assert(!xtual::decode_from_u8(i, u8.end()));
+
+    auto s = xtual::stats_snapshot();
+    assert(s.error_count(xtual::transcode_status::invalid) == 1);
+    assert(s.error_count(xtual::transcode_status::incomplete) == 1);
+
+    xtual::stats_reset();
+
+    std::u16string u16 = u"a\xdc00" u"b\xd800";
+    auto j = u16.cbegin();
+
+    while (j != u16.cend())
+    {
+        xtual::decode_lossy_from_u16(j, u16.cend());
+    }
+
+    std::string b16 = "a";
+    auto k = b16.cbegin();
+
+    assert(!xtual::decode_from_b16le<char>(k, b16.cend()));
+
+    std::string ascii = "a\x80";
+    auto m = ascii.cbegin();
+
+    while (m != ascii.cend())
+    {
+        xtual::decode_lossy_from_ascii<char>(m, ascii.cend());
+    }
+
+    s = xtual::stats_snapshot();
+    assert(s.error_count(xtual::transcode_status::invalid) == 2);
+    assert(s.error_count(xtual::transcode_status::incomplete) == 2);
+}
+
+void test_stream_errors()
+{
+    xtual::stats_reset();
+
+    xtual::u8_stream_decoder decoder(xtual::error_policy::replace);
+    std::vector<char32_t> out(8);
+
+    decoder.feed(std::u8string_view(u8"a\xe3"), std::span(out));
+    decoder.feed(std::u8string_view(u8"\x81\x82\xe3"), std::span(out));
+
+    auto s = xtual::stats_snapshot();
+    assert(s.error_count(xtual::transcode_status::incomplete) == 0);
+    assert(s.error_count(xtual::transcode_status::invalid) == 0);
+
+    decoder.feed(std::u8string_view(u8"b\xff"), std::span(out));
+    decoder.finish(std::span(out));
+
+    s = xtual::stats_snapshot();
+    assert(s.error_count(xtual::transcode_status::invalid) == 2);
+}
+
+void test_reset_from_another_thread()
+{
+    std::atomic<int> phase = 0;
+
+    std::thread worker([&]
+    {
+        std::u32string in(100, U'a');
+        std::vector<char8_t> out(in.size());
+
+        xtual::transcode_u32_to_u8(in, out);
+        phase = 1;
+
+        while (phase != 2)
+        {
+            std::this_thread::yield();
+        }
+
+        xtual::transcode_u32_to_u8(in, out);
+    });
+
+    while (phase != 1)
+    {
+        std::this_thread::yield();
+    }
+
+    xtual::stats_reset();
+    phase = 2;
+    worker.join();
+
+    auto s = xtual::stats_snapshot();
+    assert(s.read(xtual::stats_form::utf32) == 400 && s.code_points == 100);
+}
+
+void test_threads()
+{
+    xtual::stats_reset();
+
+    std::vector<std::thread> threads;
+
+    for (int k = 0; k < 4; ++k)
+    {
+        threads.emplace_back([]
+        {
+            std::u32string in(100, U'あ');
+            std::vector<char8_t> out(in.size() * 3);
+
+            xtual::transcode_u32_to_u8(in, out);
+        });
+    }
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    auto s = xtual::stats_snapshot();
+    assert(s.read(xtual::stats_form::utf32) == 4 * 400);
+    assert(s.written(xtual::stats_form::utf8) == 4 * 300);
+    assert(s.code_points == 400 && s.ascii_code_points == 0);
+}
+
+int main()
+{
+    test_counters();
+    test_errors();
+    test_kernel_path();
+    test_kernel_counts();
+    test_decode_errors();
+    test_stream_errors();
+    test_reset_from_another_thread();
+    test_threads();
+
+    std::cout << "OK" << std::endl;
+}
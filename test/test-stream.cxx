@@ -0,0 +1,169 @@
+#include <xtual.hxx>
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+const char8_t *sample = u8"aыあ𩸽 The quick brown fox. いろはにほへと 😀😀 \U0010ffff";
+
+template <typename Decoder, typename unitT>
+std::u32string decode_in_chunks(Decoder &decoder, const std::vector<unitT> &in, std::size_t chunk, std::size_t room)
+{
+    std::u32string result;
+    std::vector<char32_t> out(room);
+
+    for (std::size_t k = 0; k < in.size(); k += chunk)
+    {
+        std::span<const unitT> piece(in.data() + k, std::min(chunk, in.size() - k));
+
+        while (true)
+        {
+            auto r = decoder.feed(piece, std::span<char32_t>(out));
+
+            result.append(out.data(), r.written);
+            piece = piece.subspan(r.read);
+
+            if (r.status == xtual::transcode_status::ok)
+            {
+                break;
+            }
+
+            assert(r.status == xtual::transcode_status::insufficient);
+        }
+    }
+
+    auto r = decoder.finish(std::span<char32_t>(out));
+    result.append(out.data(), r.written);
+
+    return result;
+}
+
+void test_stream_u8_chunks()
+{
+    std::vector<char8_t> in(sample, sample + std::char_traits<char8_t>::length(sample));
+    std::u32string expect(in.size(), U'\0');
+    expect.resize(xtual::transcode_u8_to_u32(in, expect).written);
+
+    for (std::size_t chunk = 1; chunk <= 7; ++chunk)
+    {
+        for (std::size_t room = 1; room <= 3; ++room)
+        {
+            xtual::u8_stream_decoder decoder;
+
+            assert(decode_in_chunks(decoder, in, chunk, room) == expect);
+            assert(!decoder.has_pending());
+        }
+    }
+}
+
+void test_stream_b16be_surrogate_across_chunks()
+{
+    const char *in = "\xD8\x42\xDF\xB7\x91\xCE";
+    xtual::b16be_stream_decoder<char> decoder;
+    char32_t out[4];
+
+    auto r1 = decoder.feed({ in, 1 }, std::span<char32_t>(out));
+    assert(r1.status == xtual::transcode_status::ok && r1.read == 1 && r1.written == 0);
+    assert(decoder.has_pending());
+
+    auto r2 = decoder.feed({ in + 1, 2 }, std::span<char32_t>(out));
+    assert(r2.status == xtual::transcode_status::ok && r2.read == 2 && r2.written == 0);
+
+    auto r3 = decoder.feed({ in + 3, 3 }, std::span<char32_t>(out));
+    assert(r3.status == xtual::transcode_status::ok && r3.read == 3 && r3.written == 2);
+    assert(out[0] == U'𠮷' && out[1] == U'野');
+    assert(!decoder.has_pending());
+}
+
+void test_stream_u8_to_u16()
+{
+    const char8_t *in = u8"a𩸽";
+    xtual::u8_stream_decoder decoder;
+    char16_t out[4];
+
+    auto r1 = decoder.feed<xtual::u16_codec>({ in, 3 }, out);
+    assert(r1.status == xtual::transcode_status::ok && r1.read == 3 && r1.written == 1);
+
+    auto r2 = decoder.feed<xtual::u16_codec>({ in + 3, 2 }, out);
+    assert(r2.status == xtual::transcode_status::ok && r2.read == 2 && r2.written == 2);
+    assert(out[0] == u'\xd867' && out[1] == u'\xde3d');
+}
+
+void test_stream_invalid()
+{
+    const char8_t *in = u8"a\xe3\x81" u8"b";
+    xtual::u8_stream_decoder decoder;
+    char32_t out[4];
+
+    auto r1 = decoder.feed({ in, 3 }, std::span<char32_t>(out));
+    assert(r1.status == xtual::transcode_status::ok && r1.read == 3 && r1.written == 1);
+
+    auto r2 = decoder.feed({ in + 3, 1 }, std::span<char32_t>(out));
+    assert(r2.status == xtual::transcode_status::invalid && r2.read == 0 && r2.written == 0);
+    assert(!decoder.has_pending());
+}
+
+void test_stream_incomplete_at_finish()
+{
+    const char8_t *in = u8"a\xe3\x81";
+    xtual::u8_stream_decoder decoder;
+    char32_t out[4];
+
+    decoder.feed({ in, 3 }, std::span<char32_t>(out));
+
+    auto r = decoder.finish(std::span<char32_t>(out));
+    assert(r.status == xtual::transcode_status::incomplete);
+    assert(!decoder.has_pending());
+}
+
+void test_stream_replace()
+{
+    const char8_t *buf = u8"\x61\xf1\x80\x80\xe1\x80\xc2\x62\x80\x63\x80\xbf\x64\xf0\x9f";
+    std::vector<char8_t> in(buf, buf + 15);
+
+    std::u32string expect(16, U'\0');
+    expect.resize(xtual::transcode_u8_to_u32(in, expect, xtual::error_policy::replace).written);
+
+    for (std::size_t chunk = 1; chunk <= 5; ++chunk)
+    {
+        for (std::size_t room = 1; room <= 2; ++room)
+        {
+            xtual::u8_stream_decoder decoder(xtual::error_policy::replace);
+
+            assert(decode_in_chunks(decoder, in, chunk, room) == expect);
+        }
+    }
+}
+
+void test_stream_b16le_replace()
+{
+    const char buf[] = { 'a', 0, 0, char(0xd8), 'b', 0, 0, char(0xdc), 'z' };
+    std::vector<char> in(buf, buf + 9);
+
+    for (std::size_t chunk = 1; chunk <= 4; ++chunk)
+    {
+        xtual::b16le_stream_decoder<char> decoder(xtual::error_policy::replace);
+
+        assert(decode_in_chunks(decoder, in, chunk, 1) == U"a\xfffd" U"b\xfffd\xfffd");
+    }
+}
+
+int main()
+{
+    test_stream_u8_chunks();
+    test_stream_b16be_surrogate_across_chunks();
+    test_stream_u8_to_u16();
+
+    test_stream_invalid();
+    test_stream_incomplete_at_finish();
+
+    test_stream_replace();
+    test_stream_b16le_replace();
+
+    std::cout << "OK" << std::endl;
+}
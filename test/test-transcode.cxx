@@ -0,0 +1,480 @@
+#include <xtual.hxx>
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+void test_transcode_u8_to_u16_normal()
+{
+    const char8_t *in = u8"aыあ𩸽";
+    char16_t out[16];
+
+    auto r = xtual::transcode_u8_to_u16({ in, 10 }, out);
+
+    assert(r.status == xtual::transcode_status::ok);
+    assert(r.read == 10);
+    assert(r.written == 5);
+
+    const char16_t *expect = u"aыあ𩸽";
+    assert(std::equal(out, out + r.written, expect, expect + 5));
+}
+
+void test_transcode_u16_to_u8_normal()
+{
+    const char16_t *in = u"aыあ𩸽";
+    char8_t out[16];
+
+    auto r = xtual::transcode_u16_to_u8({ in, 5 }, out);
+
+    assert(r.status == xtual::transcode_status::ok);
+    assert(r.read == 5);
+    assert(r.written == 10);
+
+    const char8_t *expect = u8"aыあ𩸽";
+    assert(std::equal(out, out + r.written, expect, expect + 10));
+}
+
+void test_transcode_u32_to_b16be_normal()
+{
+    const char32_t *in = U"𠮷野家";
+    std::byte out[16];
+
+    auto r = xtual::transcode_u32_to_b16be<std::byte>({ in, 3 }, out);
+
+    assert(r.status == xtual::transcode_status::ok);
+    assert(r.read == 3);
+    assert(r.written == 8);
+
+    auto expect = reinterpret_cast<const std::byte *>("\xD8\x42\xDF\xB7\x91\xCE\x5B\xB6");
+    assert(std::equal(out, out + r.written, expect, expect + 8));
+}
+
+void test_transcode_b16le_to_b32be_normal()
+{
+    const char *in = "\x42\xD8\xB7\xDF\x42\x00";
+    unsigned char out[16];
+
+    auto r = xtual::transcode_b16le_to_b32be<char, unsigned char>({ in, 6 }, out);
+
+    assert(r.status == xtual::transcode_status::ok);
+    assert(r.read == 6);
+    assert(r.written == 8);
+
+    const unsigned char expect[] = { 0x00, 0x02, 0x0B, 0xB7, 0x00, 0x00, 0x00, 0x42 };
+    assert(std::equal(out, out + r.written, expect, expect + 8));
+}
+
+void test_transcode_b8_to_b32le_normal()
+{
+    const char *in = "\xF0\xB0\xBB\x9E\xE9\xBA\xBA";
+    char out[16];
+
+    auto r = xtual::transcode_b8_to_b32le<char>({ in, 7 }, out);
+
+    assert(r.status == xtual::transcode_status::ok);
+    assert(r.read == 7);
+    assert(r.written == 8);
+
+    const char *expect = "\xDE\x0E\x03\x00\xBA\x9E\x00\x00";
+    assert(std::equal(out, out + r.written, expect, expect + 8));
+}
+
+void test_transcode_invalid()
+{
+    const char8_t *in1 = u8"ab\xc0\x80";
+    char32_t out[16];
+
+    auto r1 = xtual::transcode_u8_to_u32({ in1, 4 }, out);
+
+    assert(r1.status == xtual::transcode_status::invalid);
+    assert(r1.read == 2);
+    assert(r1.written == 2);
+
+    const char16_t in2[] = { u'a', u'\xdc00', u'b' };
+
+    auto r2 = xtual::transcode_u16_to_u32(in2, out);
+
+    assert(r2.status == xtual::transcode_status::invalid);
+    assert(r2.read == 1);
+    assert(r2.written == 1);
+
+    const char32_t in3[] = { U'a', U'\x110000' };
+    char8_t out3[16];
+
+    auto r3 = xtual::transcode_u32_to_u8(in3, out3);
+
+    assert(r3.status == xtual::transcode_status::invalid);
+    assert(r3.read == 1);
+    assert(r3.written == 1);
+}
+
+void test_transcode_incomplete()
+{
+    const char8_t *in1 = u8"a𩸽";
+    char16_t out[16];
+
+    auto r1 = xtual::transcode_u8_to_u16({ in1, 4 }, out);
+
+    assert(r1.status == xtual::transcode_status::incomplete);
+    assert(r1.read == 1);
+    assert(r1.written == 1);
+
+    const char16_t in2[] = { u'a', u'\xd800' };
+    char8_t out2[16];
+
+    auto r2 = xtual::transcode_u16_to_u8(in2, out2);
+
+    assert(r2.status == xtual::transcode_status::incomplete);
+    assert(r2.read == 1);
+    assert(r2.written == 1);
+
+    const char *in3 = "\x00\x00\x00\x61\x00\x00";
+
+    auto r3 = xtual::transcode_b32be_to_u16<char>({ in3, 6 }, out);
+
+    assert(r3.status == xtual::transcode_status::incomplete);
+    assert(r3.read == 4);
+    assert(r3.written == 1);
+}
+
+void test_transcode_insufficient()
+{
+    const char8_t *in = u8"aあ";
+    char16_t out1[1];
+
+    auto r1 = xtual::transcode_u8_to_u16({ in, 4 }, out1);
+
+    assert(r1.status == xtual::transcode_status::insufficient);
+    assert(r1.read == 1);
+    assert(r1.written == 1);
+
+    const char32_t *in2 = U"a𩸽";
+    char16_t out2[2];
+
+    auto r2 = xtual::transcode_u32_to_u16({ in2, 2 }, out2);
+
+    assert(r2.status == xtual::transcode_status::insufficient);
+    assert(r2.read == 1);
+    assert(r2.written == 1);
+}
+
+void test_transcode_matches_decode_from_u8()
+{
+    const char8_t tails[] = { 0x00, 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0, 0xbf, 0xc0, 0xff };
+
+    for (int w1 = 0; w1 < 256; ++w1)
+    {
+        for (int w2 = 0; w2 < 256; ++w2)
+        {
+            for (char8_t w3 : tails)
+            {
+                for (char8_t w4 : tails)
+                {
+                    const char8_t in[] = { static_cast<char8_t>(w1), static_cast<char8_t>(w2), w3, w4 };
+                    const char8_t *i = in;
+                    auto opt = xtual::decode_from_u8(i, in + 4);
+
+                    const char8_t *j = in;
+                    char32_t ch;
+                    auto status = xtual::u8_codec::decode(j, in + 4, ch);
+
+                    if (opt.has_value())
+                    {
+                        assert(status == xtual::transcode_status::ok);
+                        assert(ch == opt.value());
+                        assert(i == j);
+                    }
+                    else
+                    {
+                        assert(status != xtual::transcode_status::ok);
+                        assert(j == in);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void test_transcode_replace()
+{
+    const char8_t *in1 = u8"\x61\xf1\x80\x80\xe1\x80\xc2\x62\x80\x63\x80\xbf\x64\xe3\x81";
+    char16_t out1[16];
+
+    auto r1 = xtual::transcode_u8_to_u16({ in1, 15 }, out1, xtual::error_policy::replace);
+
+    assert(r1.status == xtual::transcode_status::ok);
+    assert(r1.read == 15);
+    assert(r1.written == 11);
+
+    const char16_t expect1[] = { u'a', u'\xfffd', u'\xfffd', u'\xfffd', u'b', u'\xfffd', u'c', u'\xfffd', u'\xfffd', u'd', u'\xfffd' };
+    assert(std::equal(out1, out1 + r1.written, expect1, expect1 + 11));
+
+    const char16_t in2[] = { u'a', u'\xdc00', u'b', u'\xd800' };
+    char8_t out2[16];
+
+    auto r2 = xtual::transcode_u16_to_u8(in2, out2, xtual::error_policy::replace);
+
+    assert(r2.status == xtual::transcode_status::ok);
+    assert(r2.read == 4);
+    assert(r2.written == 8);
+
+    const char8_t *expect2 = u8"a\ufffdb\ufffd";
+    assert(std::equal(out2, out2 + r2.written, expect2, expect2 + 8));
+}
+
+void test_transcode_replace_insufficient()
+{
+    const char8_t *in = u8"ab\xff";
+    char8_t out[4];
+
+    auto r = xtual::transcode_u8_to_u8({ in, 3 }, out, xtual::error_policy::replace);
+
+    assert(r.status == xtual::transcode_status::insufficient);
+    assert(r.read == 2);
+    assert(r.written == 2);
+}
+
+template <typename From, typename To>
+void check_transcode_via_u8(std::span<const typename From::unit_type> in)
+{
+    std::vector<typename To::unit_type> out(in.size() * 4);
+    auto r = xtual::transcode<From, To>(in, out);
+
+    std::vector<char8_t> u8(in.size() * 4);
+    auto r1 = xtual::transcode<From, xtual::u8_codec>(in, u8);
+
+    assert(r.read == r1.read);
+    assert(r.status == r1.status);
+
+    std::vector<typename To::unit_type> expect(in.size() * 4);
+    auto r2 = xtual::transcode<xtual::u8_codec, To>(std::span<const char8_t>(u8.data(), r1.written), expect);
+
+    assert(r2.status == xtual::transcode_status::ok);
+    assert(r.written == r2.written);
+    assert(std::equal(out.begin(), out.begin() + r.written, expect.begin()));
+
+    for (std::size_t n = 0; n < r.written; n += 7)
+    {
+        std::vector<typename To::unit_type> part(n);
+        auto rp = xtual::transcode<From, To>(in, part);
+
+        assert(rp.status == xtual::transcode_status::insufficient);
+        assert(rp.written <= n);
+        assert(std::equal(part.begin(), part.begin() + rp.written, out.begin()));
+    }
+}
+
+template <typename T>
+std::vector<std::byte> to_bytes(const std::vector<T> &units, std::endian order)
+{
+    std::vector<std::byte> bytes;
+
+    for (T unit : units)
+    {
+        for (std::size_t k = 0; k < sizeof(T); ++k)
+        {
+            std::size_t shift = order == std::endian::big ? 8 * (sizeof(T) - 1 - k) : 8 * k;
+
+            bytes.push_back(static_cast<std::byte>((unit >> shift) & 0xff));
+        }
+    }
+
+    return bytes;
+}
+
+void test_transcode_byte_order()
+{
+    std::vector<char32_t> text;
+
+    for (std::size_t k = 0; k < 200; ++k)
+    {
+        text.push_back(k % 37 == 36 ? U'\x29e3d' : U"aéあ"[k % 3]);
+    }
+
+    for (std::size_t k = 0; k <= 120; ++k)
+    {
+        std::vector<char32_t> u32 = text;
+
+        if (k < 120)
+        {
+            u32[k] = k % 2 == 0 ? U'\xd800' : U'\x110000';
+        }
+
+        std::vector<char16_t> u16(u32.size() * 2);
+        auto r = xtual::transcode_u32_to_u16(std::span<const char32_t>(text), u16);
+        u16.resize(r.written);
+
+        if (k < 120)
+        {
+            u16[k] = k % 2 == 0 ? u'\xdc00' : u'\xd800';
+        }
+
+        for (std::endian order : { std::endian::big, std::endian::little })
+        {
+            auto b16 = to_bytes(u16, order);
+            auto b32 = to_bytes(u32, order);
+
+            if (order == std::endian::big)
+            {
+                check_transcode_via_u8<xtual::b16be_codec<std::byte>, xtual::u16_codec>(b16);
+                check_transcode_via_u8<xtual::b32be_codec<std::byte>, xtual::u32_codec>(b32);
+                check_transcode_via_u8<xtual::u16_codec, xtual::b16be_codec<std::byte>>(u16);
+                check_transcode_via_u8<xtual::u32_codec, xtual::b32be_codec<std::byte>>(u32);
+                check_transcode_via_u8<xtual::b16be_codec<std::byte>, xtual::b16le_codec<char>>(b16);
+                check_transcode_via_u8<xtual::b32be_codec<std::byte>, xtual::b32be_codec<std::byte>>(b32);
+            }
+            else
+            {
+                check_transcode_via_u8<xtual::b16le_codec<std::byte>, xtual::u16_codec>(b16);
+                check_transcode_via_u8<xtual::b32le_codec<std::byte>, xtual::u32_codec>(b32);
+                check_transcode_via_u8<xtual::u16_codec, xtual::b16le_codec<std::byte>>(u16);
+                check_transcode_via_u8<xtual::u32_codec, xtual::b32le_codec<std::byte>>(u32);
+                check_transcode_via_u8<xtual::b16le_codec<std::byte>, xtual::b16le_codec<std::byte>>(b16);
+                check_transcode_via_u8<xtual::b32le_codec<std::byte>, xtual::b32be_codec<char>>(b32);
+            }
+        }
+    }
+}
+
+void test_transcode_byte_order_astral()
+{
+    const xtual::simd_level levels[] = { xtual::simd_level::sse2, xtual::simd_level::ssse3, xtual::simd_level::avx2 };
+
+    std::vector<char16_t> text;
+
+    for (std::size_t k = 0; k < 150; ++k)
+    {
+        if (k % 3 == 2)
+        {
+            text.push_back(u'a');
+        }
+        else
+        {
+            text.push_back(u'\xd83d');
+            text.push_back(static_cast<char16_t>(0xde00 + k % 64));
+        }
+    }
+
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::size_t k = 0; k <= 60; ++k)
+        {
+            std::vector<char16_t> u16 = text;
+
+            if (k < 60)
+            {
+                u16[k * 3] = k % 2 == 0 ? u'\xdc00' : u'\xd800';
+            }
+
+            for (std::endian order : { std::endian::big, std::endian::little })
+            {
+                auto b16 = to_bytes(u16, order);
+
+                if (order == std::endian::big)
+                {
+                    check_transcode_via_u8<xtual::b16be_codec<std::byte>, xtual::u16_codec>(b16);
+                    check_transcode_via_u8<xtual::u16_codec, xtual::b16be_codec<std::byte>>(u16);
+                    check_transcode_via_u8<xtual::b16be_codec<std::byte>, xtual::b16le_codec<char>>(b16);
+                }
+                else
+                {
+                    check_transcode_via_u8<xtual::b16le_codec<std::byte>, xtual::u16_codec>(b16);
+                    check_transcode_via_u8<xtual::u16_codec, xtual::b16le_codec<std::byte>>(u16);
+                }
+            }
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+void test_transcode_dfa()
+{
+    const char8_t *in = u8"aыあ𩸽\xed\xa0\x80";
+    char16_t out[16];
+
+    auto r = xtual::transcode_u8_to_u16<xtual::utf8_dfa>({ in, 13 }, out);
+
+    assert(r.status == xtual::transcode_status::invalid);
+    assert(r.read == 10);
+    assert(r.written == 5);
+
+    r = xtual::transcode_u8_to_u16<xtual::utf8_dfa>({ in, 13 }, out, xtual::error_policy::replace);
+
+    assert(r.status == xtual::transcode_status::ok);
+    assert(r.written == 8);
+
+    const char16_t *expect = u"aыあ𩸽\xfffd\xfffd\xfffd";
+    assert(std::equal(out, out + r.written, expect, expect + 8));
+
+    const char *b8 = "\xe3\x81";
+    char32_t u32[4];
+
+    assert((xtual::transcode_b8_to_u32<char, xtual::utf8_dfa>({ b8, 2 }, u32).status == xtual::transcode_status::incomplete));
+}
+
+void test_find_code_point_boundary()
+{
+    const char8_t *u8 = u8"aыあ𩸽";
+    const std::size_t u8_expect[] = { 0, 1, 1, 3, 3, 3, 6, 6, 6, 6, 10, 10 };
+
+    for (std::size_t n = 0; n < std::size(u8_expect); ++n)
+    {
+        assert(xtual::find_code_point_boundary<xtual::u8_codec>({ u8, 10 }, n) == u8_expect[n]);
+    }
+
+    const char8_t stray[] = { 0xf0, 0x90, 0x80, 0x80, 0x80, 0x80 };
+    const std::size_t stray_expect[] = { 0, 0, 0, 0, 4, 5 };
+
+    for (std::size_t n = 0; n < 6; ++n)
+    {
+        assert(xtual::find_code_point_boundary<xtual::u8_codec>(stray, n) == stray_expect[n]);
+    }
+
+    const char16_t *u16 = u"a𩸽b";
+    assert(xtual::find_code_point_boundary<xtual::u16_codec>({ u16, 4 }, 2) == 1);
+    assert(xtual::find_code_point_boundary<xtual::u16_codec>({ u16, 4 }, 3) == 3);
+
+    const char *b16 = "\x00" "a\xd8\x42\xdf\xb7";
+    assert(xtual::find_code_point_boundary<xtual::b16be_codec<char>>({ b16, 6 }, 5) == 2);
+    assert(xtual::find_code_point_boundary<xtual::b16be_codec<char>>({ b16, 6 }, 3) == 2);
+
+    std::vector<char> odd = { 'a', '\xdc', '\x00' };
+    assert(xtual::find_code_point_boundary<xtual::b16be_codec<char>>(std::span<const char>(odd), 2) == 2);
+    assert(xtual::find_code_point_boundary<xtual::b16le_codec<char>>(std::span<const char>(odd), 1) == 0);
+
+    static_assert(xtual::find_code_point_boundary<xtual::u8_codec>(std::span<const char8_t>(u8"\xe3\x81\x82", 3), 2) == 0);
+}
+
+int main()
+{
+    test_transcode_u8_to_u16_normal();
+    test_transcode_u16_to_u8_normal();
+    test_transcode_u32_to_b16be_normal();
+    test_transcode_b16le_to_b32be_normal();
+    test_transcode_b8_to_b32le_normal();
+
+    test_transcode_invalid();
+    test_transcode_incomplete();
+    test_transcode_insufficient();
+
+    test_transcode_matches_decode_from_u8();
+    test_transcode_byte_order();
+    test_transcode_byte_order_astral();
+    test_transcode_dfa();
+
+    test_transcode_replace();
+    test_transcode_replace_insufficient();
+
+    test_find_code_point_boundary();
+
+    std::cout << "OK" << std::endl;
+}
@@ -0,0 +1,251 @@
+#include <xtual.hxx>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+const xtual::simd_level levels[] = { xtual::simd_level::scalar, xtual::simd_level::sse2, xtual::simd_level::ssse3, xtual::simd_level::avx2 };
+
+std::u32string make_text(std::uint32_t seed, std::size_t n, std::size_t mix)
+{
+    const char32_t samples[] = { U'a', U'Z', U'0', U' ', U'é', U'ß', U'Ж', U'߿', U'ࠀ', U'野', U'あ', U'\xffff', U'😀', U'\x10ffff' };
+    const std::size_t spans[] = { 4, 8, 11, 14 };
+    std::u32string text;
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        seed = seed * 1103515245 + 12345;
+
+        std::size_t span = (seed >> 8) % 8 == 0 ? spans[mix] : spans[mix > 0 ? mix - 1 : 0];
+
+        text.push_back(samples[(seed >> 16) % span]);
+    }
+
+    return text;
+}
+
+template <typename Codec>
+std::vector<typename Codec::unit_type> encode(const std::u32string &text)
+{
+    std::vector<typename Codec::unit_type> out(text.size() * Codec::max_length);
+    auto *o = out.data();
+
+    for (char32_t ch : text)
+    {
+        assert(Codec::encode(o, out.data() + out.size(), ch));
+    }
+
+    out.resize(o - out.data());
+
+    return out;
+}
+
+template <typename From, typename To>
+void check_against_scalar(const std::vector<typename From::unit_type> &in, std::size_t capacity, xtual::error_policy policy)
+{
+    std::vector<typename To::unit_type> expected(capacity);
+    std::vector<typename To::unit_type> actual(capacity);
+
+    auto level = xtual::active_simd_level();
+
+    xtual::set_simd_level(xtual::simd_level::scalar);
+    auto e = xtual::transcode<From, To>(std::span<const typename From::unit_type>(in), expected, policy);
+
+    xtual::set_simd_level(level);
+    auto a = xtual::transcode<From, To>(std::span<const typename From::unit_type>(in), actual, policy);
+
+    assert(a.status == e.status && a.read == e.read && a.written == e.written);
+    assert(std::equal(actual.begin(), actual.begin() + a.written, expected.begin()));
+}
+
+template <typename From, typename To>
+void check_round(const std::u32string &text)
+{
+    auto in = encode<From>(text);
+    auto expected = encode<To>(text);
+
+    std::vector<typename To::unit_type> out(expected.size() + 64);
+    auto r = xtual::transcode<From, To>(std::span<const typename From::unit_type>(in), out);
+
+    assert(r.status == xtual::transcode_status::ok && r.read == in.size() && r.written == expected.size());
+    assert(std::equal(expected.begin(), expected.end(), out.begin()));
+
+    for (std::size_t capacity : { expected.size() / 2, expected.size() > 0 ? expected.size() - 1 : 0 })
+    {
+        check_against_scalar<From, To>(in, capacity, xtual::error_policy::strict);
+    }
+}
+
+void test_round_trip()
+{
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::size_t mix = 0; mix < 4; ++mix)
+        {
+            for (std::size_t n : { 0, 1, 7, 8, 15, 16, 17, 31, 32, 33, 100, 1000 })
+            {
+                for (std::uint32_t seed = 0; seed < 4; ++seed)
+                {
+                    auto text = make_text(seed, n, mix);
+
+                    check_round<xtual::u16_codec, xtual::u8_codec>(text);
+                    check_round<xtual::u16_codec, xtual::b8_codec<char>>(text);
+                    check_round<xtual::b16le_codec<std::byte>, xtual::u8_codec>(text);
+                    check_round<xtual::b16be_codec<unsigned char>, xtual::b8_codec<std::byte>>(text);
+                    check_round<xtual::u8_codec, xtual::u16_codec>(text);
+                    check_round<xtual::b8_codec<char>, xtual::u16_codec>(text);
+                    check_round<xtual::u8_codec, xtual::b16le_codec<std::byte>>(text);
+                    check_round<xtual::b8_codec<std::byte>, xtual::b16be_codec<char>>(text);
+                }
+            }
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+void test_ill_formed_utf8()
+{
+    const std::u8string errors[] = {
+        u8"\x80", u8"\xbf", u8"\xc0\x80", u8"\xc1\xbf", u8"\xc3", u8"\xc3\xc3", u8"\xe0\x80\x80", u8"\xe0\x9f\xbf",
+        u8"\xed\xa0\x80", u8"\xed\xbf\xbf", u8"\xe3\x81", u8"\xe3\x81\x81\x81", u8"\xf0\x9f\x98\x80", u8"\xf0\x80\x80\x80",
+        u8"\xf4\x90\x80\x80", u8"\xf8\x88\x80\x80\x80", u8"\xff", u8"\x00",
+    };
+
+    const std::u8string contexts[] = { u8"abcdefgh", u8"éßЖé", u8"野あ野", u8"aé野b" };
+
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (const auto &error : errors)
+        {
+            for (const auto &context : contexts)
+            {
+                for (std::size_t k = 0; k < 80; ++k)
+                {
+                    std::u8string text;
+
+                    while (text.size() < k)
+                    {
+                        text += context;
+                    }
+
+                    text += error;
+
+                    while (text.size() < 160)
+                    {
+                        text += context;
+                    }
+
+                    std::vector<char8_t> in(text.begin(), text.end());
+
+                    check_against_scalar<xtual::u8_codec, xtual::u16_codec>(in, in.size(), xtual::error_policy::strict);
+                    check_against_scalar<xtual::u8_codec, xtual::u16_codec>(in, in.size(), xtual::error_policy::replace);
+                    check_against_scalar<xtual::u8_codec, xtual::b16be_codec<std::byte>>(in, in.size() * 2, xtual::error_policy::replace);
+                }
+            }
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+void test_ill_formed_utf16()
+{
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::size_t mix = 0; mix < 4; ++mix)
+        {
+            auto u16 = encode<xtual::u16_codec>(make_text(mix, 120, mix));
+
+            for (std::size_t k = 0; k < 80; ++k)
+            {
+                for (char16_t unit : { u'\xd800', u'\xdbff', u'\xdc00', u'\xdfff' })
+                {
+                    auto in = u16;
+                    in[k] = unit;
+
+                    check_against_scalar<xtual::u16_codec, xtual::u8_codec>(in, in.size() * 3, xtual::error_policy::strict);
+                    check_against_scalar<xtual::u16_codec, xtual::u8_codec>(in, in.size() * 3, xtual::error_policy::replace);
+                }
+            }
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+void test_astral_blocks()
+{
+    const char32_t samples[] = { U'😀', U'\x10000', U'\x10ffff', U'\x20000', U'é', U'野', U'a' };
+
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::size_t lead = 0; lead < 10; ++lead)
+        {
+            for (std::size_t span : { 4, 7 })
+            {
+                std::u32string text(lead, U'a');
+
+                for (std::size_t k = 0; k < 100; ++k)
+                {
+                    text.push_back(samples[(k * 5 + lead) % span]);
+                }
+
+                check_round<xtual::u16_codec, xtual::u8_codec>(text);
+                check_round<xtual::b16be_codec<std::byte>, xtual::u8_codec>(text);
+            }
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+void test_random_bytes()
+{
+    std::uint32_t seed = 1;
+
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::size_t round = 0; round < 2000; ++round)
+        {
+            auto in = encode<xtual::u8_codec>(make_text(static_cast<std::uint32_t>(round), 60, round % 4));
+
+            for (std::size_t k = 0; k < 2; ++k)
+            {
+                seed = seed * 1103515245 + 12345;
+                in[(seed >> 8) % in.size()] = static_cast<char8_t>(seed >> 16);
+            }
+
+            check_against_scalar<xtual::u8_codec, xtual::u16_codec>(in, in.size(), xtual::error_policy::replace);
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+int main()
+{
+    test_round_trip();
+    test_ill_formed_utf8();
+    test_ill_formed_utf16();
+    test_astral_blocks();
+    test_random_bytes();
+
+    std::cout << "OK" << std::endl;
+}
@@ -2,7 +2,11 @@
 #include <xtual.hxx>
 
 #include <algorithm>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <list>
+#include <optional>
 
 #undef NDEBUG
 #include <cassert>
@@ -211,6 +215,204 @@ void test_decode_b16le_unexpected_end()
     assert(!xtual::decode_from_b16le<char>(buf, buf + 3).has_value());
 }
 
+void test_decode_lossy_u16()
+{
+    const char16_t buf[] = { u'a', u'\xdc00', u'\xd800', u'b', u'\xd83d', u'\xde00', u'\xd800' };
+    const char16_t *i = buf;
+    const char16_t *s = buf + 7;
+
+    const char32_t expect[] = { U'a', U'\xfffd', U'\xfffd', U'b', U'😀', U'\xfffd' };
+
+    for (char32_t ch : expect)
+    {
+        assert(xtual::decode_lossy_from_u16(i, s) == ch);
+    }
+
+    assert(i == s);
+    assert(!xtual::decode_lossy_from_u16(i, s).has_value());
+}
+
+void test_decode_lossy_b16le()
+{
+    const char *buf = "a\x00\x00\xd8" "b\x00z";
+    const char *i = buf;
+    const char *s = buf + 7;
+
+    const char32_t expect[] = { U'a', U'\xfffd', U'b', U'\xfffd' };
+
+    for (char32_t ch : expect)
+    {
+        assert(xtual::decode_lossy_from_b16le<char>(i, s) == ch);
+    }
+
+    assert(i == s);
+}
+
+void test_decode_u16_contiguous()
+{
+    const char16_t buf[] = { u'a', u'\xd842', u'\xdfb7', u'\xdc00', u'\xd800', u'b', u'\xd842' };
+    std::list<char16_t> list(std::begin(buf), std::end(buf));
+
+    for (std::size_t n = 0; n <= std::size(buf); ++n)
+    {
+        for (std::size_t k = 0; k <= n; ++k)
+        {
+            const char16_t *i = buf + k;
+            auto j = std::next(list.begin(), k);
+
+            assert(xtual::decode_from_u16(i, buf + n) == xtual::decode_from_u16(j, std::next(list.begin(), n)));
+            assert(i - buf == std::distance(list.begin(), j));
+        }
+    }
+}
+
+void test_encode_u16_contiguous()
+{
+    for (char32_t ch : { U'a', U'\xe9', U'\x3042', U'\x20bb7', U'\xd800' })
+    {
+        for (std::size_t n = 0; n <= 4; ++n)
+        {
+            char16_t buf[4] = {};
+            std::list<char16_t> list(4);
+            char16_t *i = buf;
+            auto j = list.begin();
+
+            assert(xtual::encode_as_u16(i, buf + n, ch) == xtual::encode_as_u16(j, std::next(list.begin(), n), ch));
+            assert(i - buf == std::distance(list.begin(), j));
+            assert(std::equal(buf, buf + 4, list.begin()));
+        }
+    }
+}
+
+void test_decode_b16be_contiguous()
+{
+    const char buf[] = "\x00" "a\xd8\x42\xdf\xb7\xdc\x00\xd8\x00\x30\x42\xd8";
+    std::list<char> list(std::begin(buf), std::end(buf));
+
+    for (std::size_t n = 0; n <= std::size(buf); ++n)
+    {
+        for (std::size_t k = 0; k <= n; ++k)
+        {
+            const char *i = buf + k;
+            auto j = std::next(list.begin(), k);
+
+            assert(xtual::decode_from_b16be<char>(i, buf + n) == xtual::decode_from_b16be<char>(j, std::next(list.begin(), n)));
+            assert(i - buf == std::distance(list.begin(), j));
+        }
+    }
+}
+
+void test_encode_b16be_contiguous()
+{
+    for (char32_t ch : { U'a', U'\xe9', U'\x3042', U'\x20bb7', U'\xd800' })
+    {
+        for (std::size_t n = 0; n <= 4; ++n)
+        {
+            char buf[4] = {};
+            std::list<char> list(4);
+            char *i = buf;
+            auto j = list.begin();
+
+            assert(xtual::encode_as_b16be<char>(i, buf + n, ch) == xtual::encode_as_b16be<char>(j, std::next(list.begin(), n), ch));
+            assert(i - buf == std::distance(list.begin(), j));
+            assert(std::equal(buf, buf + 4, list.begin()));
+        }
+    }
+}
+
+void test_decode_b16le_contiguous()
+{
+    const char buf[] = "a\x00\x42\xd8\xb7\xdf\x00\xdc\x00\xd8\x42\x30\x42";
+    std::list<char> list(std::begin(buf), std::end(buf));
+
+    for (std::size_t n = 0; n <= std::size(buf); ++n)
+    {
+        for (std::size_t k = 0; k <= n; ++k)
+        {
+            const char *i = buf + k;
+            auto j = std::next(list.begin(), k);
+
+            assert(xtual::decode_from_b16le<char>(i, buf + n) == xtual::decode_from_b16le<char>(j, std::next(list.begin(), n)));
+            assert(i - buf == std::distance(list.begin(), j));
+        }
+    }
+}
+
+void test_encode_b16le_contiguous()
+{
+    for (char32_t ch : { U'a', U'\xe9', U'\x3042', U'\x20bb7', U'\xd800' })
+    {
+        for (std::size_t n = 0; n <= 4; ++n)
+        {
+            char buf[4] = {};
+            std::list<char> list(4);
+            char *i = buf;
+            auto j = list.begin();
+
+            assert(xtual::encode_as_b16le<char>(i, buf + n, ch) == xtual::encode_as_b16le<char>(j, std::next(list.begin(), n), ch));
+            assert(i - buf == std::distance(list.begin(), j));
+            assert(std::equal(buf, buf + 4, list.begin()));
+        }
+    }
+}
+
+void test_decode_backward_u16()
+{
+    const char16_t buf[] = { u'a', u'\xd842', u'\xdfb7', u'\xdc00', u'\xd800', u'b', u'\xd842' };
+    std::list<char16_t> list(std::begin(buf), std::end(buf));
+
+    for (std::size_t n = 0; n <= std::size(buf); ++n)
+    {
+        std::optional<char32_t> expect;
+        std::size_t start = n;
+
+        for (std::size_t len = 1; len <= 2 && len <= n; ++len)
+        {
+            const char16_t *j = buf + n - len;
+
+            if (auto ch = xtual::decode_from_u16(j, buf + n); ch && j == buf + n)
+            {
+                expect = ch;
+                start = n - len;
+            }
+        }
+
+        const char16_t *i = buf + n;
+        assert(xtual::decode_backward_from_u16(i, buf) == expect);
+        assert(i == buf + start);
+
+        auto j = std::next(list.begin(), n);
+        assert(xtual::decode_backward_from_u16(j, list.begin()) == expect);
+        assert(std::distance(list.begin(), j) == static_cast<std::ptrdiff_t>(start));
+    }
+}
+
+void test_decode_backward_b16()
+{
+    const char be[] = "\x00" "a\xd8\x42\xdf\xb7\xdc\x00";
+    const char *i = be + 6;
+
+    assert(xtual::decode_backward_from_b16be<char>(i, be) == U'\x20bb7');
+    assert(i == be + 2);
+    assert(xtual::decode_backward_from_b16be<char>(i, be) == U'a');
+    assert(i == be);
+
+    i = be + 8;
+    assert(!xtual::decode_backward_from_b16be<char>(i, be).has_value());
+    assert(i == be + 8);
+
+    const char le[] = "a\x00\x42\xd8\xb7\xdf";
+    std::list<char> list(le, le + 6);
+    auto j = list.end();
+
+    assert(xtual::decode_backward_from_b16le<char>(j, list.begin()) == U'\x20bb7');
+    assert(xtual::decode_backward_from_b16le<char>(j, list.begin()) == U'a');
+    assert(j == list.begin());
+
+    j = std::prev(list.end(), 2);
+    assert(!xtual::decode_backward_from_b16le<char>(j, list.begin()).has_value());
+}
+
 int main()
 {
     test_encode_u16_normal();
@@ -236,6 +438,20 @@ int main()
     test_decode_u16_unexpected_end();
     test_decode_b16be_unexpected_end();
     test_decode_b16le_unexpected_end();
+
+    test_decode_lossy_u16();
+    test_decode_lossy_b16le();
     
+    test_decode_u16_contiguous();
+    test_decode_b16be_contiguous();
+    test_decode_b16le_contiguous();
+
+    test_encode_u16_contiguous();
+    test_encode_b16be_contiguous();
+    test_encode_b16le_contiguous();
+
+    test_decode_backward_u16();
+    test_decode_backward_b16();
+
     std::cout << "OK" << std::endl;
 }
@@ -2,7 +2,10 @@
 #include <xtual.hxx>
 
 #include <algorithm>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <list>
 
 #undef NDEBUG
 #include <cassert>
@@ -184,6 +187,146 @@ void test_decode_b32le_unexpected_end()
     assert(!xtual::decode_from_b32le<char>(i, buf + 3).has_value());
 }
 
+void test_decode_lossy_u32()
+{
+    const char32_t buf[] = { U'a', U'\xd800', U'\x110000', U'b' };
+    const char32_t *i = buf;
+    const char32_t *s = buf + 4;
+
+    const char32_t expect[] = { U'a', U'\xfffd', U'\xfffd', U'b' };
+
+    for (char32_t ch : expect)
+    {
+        assert(xtual::decode_lossy_from_u32(i, s) == ch);
+    }
+
+    assert(i == s);
+}
+
+void test_decode_lossy_b32be()
+{
+    const char *buf = "\x00\x00\x00" "a\x00\x11\x00\x00\x00\x00";
+    const char *i = buf;
+    const char *s = buf + 10;
+
+    const char32_t expect[] = { U'a', U'\xfffd', U'\xfffd' };
+
+    for (char32_t ch : expect)
+    {
+        assert(xtual::decode_lossy_from_b32be<char>(i, s) == ch);
+    }
+
+    assert(i == s);
+}
+
+void test_decode_u32_contiguous()
+{
+    const char32_t buf[] = { U'a', U'\xd800', U'\x20bb7', U'\x110000' };
+    std::list<char32_t> list(std::begin(buf), std::end(buf));
+
+    for (std::size_t n = 0; n <= std::size(buf); ++n)
+    {
+        for (std::size_t k = 0; k <= n; ++k)
+        {
+            const char32_t *i = buf + k;
+            auto j = std::next(list.begin(), k);
+
+            assert(xtual::decode_from_u32(i, buf + n) == xtual::decode_from_u32(j, std::next(list.begin(), n)));
+            assert(i - buf == std::distance(list.begin(), j));
+        }
+    }
+}
+
+void test_encode_u32_contiguous()
+{
+    for (char32_t ch : { U'a', U'\xe9', U'\x3042', U'\x20bb7', U'\xd800' })
+    {
+        for (std::size_t n = 0; n <= 4; ++n)
+        {
+            char32_t buf[4] = {};
+            std::list<char32_t> list(4);
+            char32_t *i = buf;
+            auto j = list.begin();
+
+            assert(xtual::encode_as_u32(i, buf + n, ch) == xtual::encode_as_u32(j, std::next(list.begin(), n), ch));
+            assert(i - buf == std::distance(list.begin(), j));
+            assert(std::equal(buf, buf + 4, list.begin()));
+        }
+    }
+}
+
+void test_decode_b32be_contiguous()
+{
+    const char buf[] = "\x00\x00\x00" "a\x00\x00\xd8\x00\x00\x02\x0b\xb7\x00\x11\x00\x00\x00\x00";
+    std::list<char> list(std::begin(buf), std::end(buf));
+
+    for (std::size_t n = 0; n <= std::size(buf); ++n)
+    {
+        for (std::size_t k = 0; k <= n; ++k)
+        {
+            const char *i = buf + k;
+            auto j = std::next(list.begin(), k);
+
+            assert(xtual::decode_from_b32be<char>(i, buf + n) == xtual::decode_from_b32be<char>(j, std::next(list.begin(), n)));
+            assert(i - buf == std::distance(list.begin(), j));
+        }
+    }
+}
+
+void test_encode_b32be_contiguous()
+{
+    for (char32_t ch : { U'a', U'\xe9', U'\x3042', U'\x20bb7', U'\xd800' })
+    {
+        for (std::size_t n = 0; n <= 4; ++n)
+        {
+            char buf[4] = {};
+            std::list<char> list(4);
+            char *i = buf;
+            auto j = list.begin();
+
+            assert(xtual::encode_as_b32be<char>(i, buf + n, ch) == xtual::encode_as_b32be<char>(j, std::next(list.begin(), n), ch));
+            assert(i - buf == std::distance(list.begin(), j));
+            assert(std::equal(buf, buf + 4, list.begin()));
+        }
+    }
+}
+
+void test_decode_b32le_contiguous()
+{
+    const char buf[] = "a\x00\x00\x00\x00\xd8\x00\x00\xb7\x0b\x02\x00\x00\x00\x11\x00\x00\x00";
+    std::list<char> list(std::begin(buf), std::end(buf));
+
+    for (std::size_t n = 0; n <= std::size(buf); ++n)
+    {
+        for (std::size_t k = 0; k <= n; ++k)
+        {
+            const char *i = buf + k;
+            auto j = std::next(list.begin(), k);
+
+            assert(xtual::decode_from_b32le<char>(i, buf + n) == xtual::decode_from_b32le<char>(j, std::next(list.begin(), n)));
+            assert(i - buf == std::distance(list.begin(), j));
+        }
+    }
+}
+
+void test_encode_b32le_contiguous()
+{
+    for (char32_t ch : { U'a', U'\xe9', U'\x3042', U'\x20bb7', U'\xd800' })
+    {
+        for (std::size_t n = 0; n <= 4; ++n)
+        {
+            char buf[4] = {};
+            std::list<char> list(4);
+            char *i = buf;
+            auto j = list.begin();
+
+            assert(xtual::encode_as_b32le<char>(i, buf + n, ch) == xtual::encode_as_b32le<char>(j, std::next(list.begin(), n), ch));
+            assert(i - buf == std::distance(list.begin(), j));
+            assert(std::equal(buf, buf + 4, list.begin()));
+        }
+    }
+}
+
 int main()
 {
     test_encode_u32_normal();
@@ -209,6 +352,17 @@ int main()
     test_decode_u32_unexpected_end();
     test_decode_b32be_unexpected_end();
     test_decode_b32le_unexpected_end();
+
+    test_decode_lossy_u32();
+    test_decode_lossy_b32be();
     
+    test_decode_u32_contiguous();
+    test_decode_b32be_contiguous();
+    test_decode_b32le_contiguous();
+
+    test_encode_u32_contiguous();
+    test_encode_b32be_contiguous();
+    test_encode_b32le_contiguous();
+
     std::cout << "OK" << std::endl;
 }
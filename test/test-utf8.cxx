@@ -2,7 +2,11 @@
 #include <xtual.hxx>
 
 #include <algorithm>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <list>
+#include <optional>
 
 #undef NDEBUG
 #include <cassert>
@@ -249,6 +253,233 @@ void test_decode_b8_invalid_range()
     assert(!xtual::decode_from_b8<char>(buf, buf + 4).has_value());
 }
 
+void test_decode_lossy_u8()
+{
+    const char8_t *buf = u8"\x61\xf1\x80\x80\xe1\x80\xc2\x62\x80\x63\x80\xbf\x64";
+    const char8_t *i = buf;
+    const char8_t *s = buf + 13;
+
+    const char32_t expect[] = { U'a', U'\xfffd', U'\xfffd', U'\xfffd', U'b', U'\xfffd', U'c', U'\xfffd', U'\xfffd', U'd' };
+
+    for (char32_t ch : expect)
+    {
+        assert(xtual::decode_lossy_from_u8(i, s) == ch);
+    }
+
+    assert(i == s);
+    assert(!xtual::decode_lossy_from_u8(i, s).has_value());
+}
+
+void test_decode_lossy_b8()
+{
+    const char *buf = "\xed\xa0\x80\xc0\xafz\xf0\x9f\x98";
+    const char *i = buf;
+    const char *s = buf + 9;
+
+    const char32_t expect[] = { U'\xfffd', U'\xfffd', U'\xfffd', U'\xfffd', U'\xfffd', U'z', U'\xfffd' };
+
+    for (char32_t ch : expect)
+    {
+        assert(xtual::decode_lossy_from_b8<char>(i, s) == ch);
+    }
+
+    assert(i == s);
+}
+
+void test_decode_u8_contiguous()
+{
+    const char8_t buf[] = { 0x61, 0xe3, 0x81, 0x82, 0xf0, 0xa0, 0xae, 0xb7, 0xe0, 0x80, 0xc3, 0xff, 0xc3, 0xa9 };
+    std::list<char8_t> list(std::begin(buf), std::end(buf));
+
+    for (std::size_t n = 0; n <= std::size(buf); ++n)
+    {
+        for (std::size_t k = 0; k <= n; ++k)
+        {
+            const char8_t *i = buf + k;
+            auto j = std::next(list.begin(), k);
+
+            assert(xtual::decode_from_u8(i, buf + n) == xtual::decode_from_u8(j, std::next(list.begin(), n)));
+            assert(i - buf == std::distance(list.begin(), j));
+        }
+    }
+}
+
+void test_encode_u8_contiguous()
+{
+    for (char32_t ch : { U'a', U'\xe9', U'\x3042', U'\x20bb7', U'\xd800' })
+    {
+        for (std::size_t n = 0; n <= 4; ++n)
+        {
+            char8_t buf[4] = {};
+            std::list<char8_t> list(4);
+            char8_t *i = buf;
+            auto j = list.begin();
+
+            assert(xtual::encode_as_u8(i, buf + n, ch) == xtual::encode_as_u8(j, std::next(list.begin(), n), ch));
+            assert(i - buf == std::distance(list.begin(), j));
+            assert(std::equal(buf, buf + 4, list.begin()));
+        }
+    }
+}
+
+void test_decode_b8_contiguous()
+{
+    const char buf[] = "a\xe3\x81\x82\xf0\xa0\xae\xb7\xed\xa0\x80\xc3\xa9";
+    std::list<char> list(std::begin(buf), std::end(buf));
+
+    for (std::size_t n = 0; n <= std::size(buf); ++n)
+    {
+        for (std::size_t k = 0; k <= n; ++k)
+        {
+            const char *i = buf + k;
+            auto j = std::next(list.begin(), k);
+
+            assert(xtual::decode_from_b8<char>(i, buf + n) == xtual::decode_from_b8<char>(j, std::next(list.begin(), n)));
+            assert(i - buf == std::distance(list.begin(), j));
+        }
+    }
+}
+
+void test_encode_b8_contiguous()
+{
+    for (char32_t ch : { U'a', U'\xe9', U'\x3042', U'\x20bb7', U'\xd800' })
+    {
+        for (std::size_t n = 0; n <= 4; ++n)
+        {
+            char buf[4] = {};
+            std::list<char> list(4);
+            char *i = buf;
+            auto j = list.begin();
+
+            assert(xtual::encode_as_b8<char>(i, buf + n, ch) == xtual::encode_as_b8<char>(j, std::next(list.begin(), n), ch));
+            assert(i - buf == std::distance(list.begin(), j));
+            assert(std::equal(buf, buf + 4, list.begin()));
+        }
+    }
+}
+
+void test_decode_u8_dfa()
+{
+    const char8_t tails[] = { 0x00, 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0, 0xbf, 0xc0, 0xff };
+
+    for (int w1 = 0; w1 < 256; ++w1)
+    {
+        for (int w2 = 0; w2 < 256; ++w2)
+        {
+            for (char8_t w3 : tails)
+            {
+                for (char8_t w4 : tails)
+                {
+                    const char8_t in[] = { static_cast<char8_t>(w1), static_cast<char8_t>(w2), w3, w4 };
+
+                    for (std::size_t n = 1; n <= 4; ++n)
+                    {
+                        const char8_t *p = in;
+                        const char8_t *q = in;
+                        char32_t c1 = 0;
+                        char32_t c2 = 0;
+
+                        auto s1 = xtual::u8_codec::decode(p, in + n, c1);
+                        auto s2 = xtual::utf8_codec<char8_t, xtual::utf8_dfa>::decode(q, in + n, c2);
+
+                        assert(s1 == s2);
+                        assert(p == q);
+                        assert(c1 == c2);
+
+                        std::list<char8_t> list(in, in + n);
+                        auto i = list.begin();
+                        const char8_t *j = in;
+
+                        assert(xtual::decode_from_u8<xtual::utf8_dfa>(i, list.end()) == xtual::decode_from_u8(j, in + n));
+                    }
+                }
+            }
+        }
+    }
+}
+
+void test_decode_b8_dfa()
+{
+    const char *buf = "a\xd1\x8b\xe3\x81\x82\xf0\xa9\xb8\xbd\xed\xa0\x80";
+    const char *i = buf;
+    const char *s = buf + 13;
+
+    assert((xtual::decode_from_b8<char, xtual::utf8_dfa>(i, s) == U'a'));
+    assert((xtual::decode_from_b8<char, xtual::utf8_dfa>(i, s) == U'ы'));
+    assert((xtual::decode_from_b8<char, xtual::utf8_dfa>(i, s) == U'あ'));
+    assert((xtual::decode_from_b8<char, xtual::utf8_dfa>(i, s) == U'𩸽'));
+    assert(!(xtual::decode_from_b8<char, xtual::utf8_dfa>(i, s).has_value()));
+}
+
+void test_decode_backward_u8()
+{
+    const char8_t *buf = u8"aыあ𩸽";
+    const char8_t *i = buf + 10;
+
+    for (char32_t ch : { U'𩸽', U'あ', U'ы', U'a' })
+    {
+        assert(xtual::decode_backward_from_u8(i, buf) == ch);
+    }
+
+    assert(i == buf);
+    assert(!xtual::decode_backward_from_u8(i, buf).has_value());
+
+    const char8_t noise[] = { 0x41, 0x80, 0xbf, 0xc2, 0xe0, 0xe3, 0xed, 0xf0, 0xf4, 0xff };
+
+    for (char8_t w1 : noise)
+    {
+        for (char8_t w2 : noise)
+        {
+            for (char8_t w3 : noise)
+            {
+                for (char8_t w4 : noise)
+                {
+                    const char8_t in[] = { w1, w2, w3, w4, 0x80, 0x80 };
+
+                    for (std::size_t n = 0; n <= 6; ++n)
+                    {
+                        std::optional<char32_t> expect;
+                        std::size_t start = n;
+
+                        for (std::size_t len = 1; len <= 4 && len <= n; ++len)
+                        {
+                            const char8_t *j = in + n - len;
+
+                            if (auto ch = xtual::decode_from_u8(j, in + n); ch && j == in + n)
+                            {
+                                expect = ch;
+                                start = n - len;
+                            }
+                        }
+
+                        const char8_t *k = in + n;
+                        assert(xtual::decode_backward_from_u8(k, in) == expect);
+                        assert(k == in + start);
+
+                        std::list<char8_t> list(in, in + n);
+                        auto l = list.end();
+                        assert(xtual::decode_backward_from_u8(l, list.begin()) == expect);
+                        assert(std::distance(list.begin(), l) == static_cast<std::ptrdiff_t>(start));
+                    }
+                }
+            }
+        }
+    }
+}
+
+void test_decode_backward_b8()
+{
+    const char *buf = "a\xed\x9f\xbf\xed\xa0\x80";
+    const char *i = buf + 4;
+
+    assert(xtual::decode_backward_from_b8<char>(i, buf) == U'\xd7ff');
+    assert(i == buf + 1);
+
+    i = buf + 7;
+    assert(!xtual::decode_backward_from_b8<char>(i, buf).has_value());
+    assert(i == buf + 7);
+}
+
 int main()
 {
     test_encode_u8_normal();
@@ -271,6 +502,21 @@ int main()
 
     test_decode_u8_invalid_range();
     test_decode_b8_invalid_range();    
+
+    test_decode_lossy_u8();
+    test_decode_lossy_b8();
     
+    test_decode_u8_contiguous();
+    test_decode_b8_contiguous();
+
+    test_encode_u8_contiguous();
+    test_encode_b8_contiguous();
+
+    test_decode_u8_dfa();
+    test_decode_b8_dfa();
+
+    test_decode_backward_u8();
+    test_decode_backward_b8();
+
     std::cout << "OK" << std::endl;
 }
@@ -0,0 +1,288 @@
+#include <xtual.hxx>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+std::size_t reference_u8(const std::vector<char8_t> &buf)
+{
+    const char8_t *i = buf.data();
+    const char8_t *s = buf.data() + buf.size();
+
+    while (i != s)
+    {
+        const char8_t *j = i;
+
+        if (!xtual::decode_from_u8(j, s).has_value())
+        {
+            break;
+        }
+
+        i = j;
+    }
+
+    return i - buf.data();
+}
+
+std::vector<char8_t> make_text(std::uint32_t seed, std::size_t n)
+{
+    const char32_t samples[] = { U'a', U'Z', U'é', U'я', U'ا', U'あ', U'野', U'\xffff', U'𩸽', U'😀', U'\x10ffff' };
+    std::vector<char8_t> buf(n * 4);
+    char8_t *i = buf.data();
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        seed = seed * 1103515245 + 12345;
+        xtual::encode_as_u8(i, buf.data() + buf.size(), samples[(seed >> 16) % 11]);
+    }
+
+    buf.resize(i - buf.data());
+
+    return buf;
+}
+
+void test_validate_u8_valid()
+{
+    const char8_t *buf = u8"aыあ𩸽";
+
+    assert(xtual::validate_u8({ buf, 10 }) == 10);
+    assert(xtual::validate_u8({ buf, 0 }) == 0);
+
+    for (std::uint32_t seed = 0; seed < 16; ++seed)
+    {
+        auto text = make_text(seed, 300);
+
+        assert(xtual::validate_u8(text) == text.size());
+    }
+}
+
+void test_validate_b8_valid()
+{
+    const char *buf = "The quick brown fox jumps over the lazy dog. いろはにほへと ちりぬるを";
+
+    assert(xtual::validate_b8<char>({ buf, std::char_traits<char>::length(buf) }) == std::char_traits<char>::length(buf));
+}
+
+void test_validate_u8_invalid()
+{
+    const char8_t *buf1 = u8"abc\xc0\x80";
+    assert(xtual::validate_u8({ buf1, 5 }) == 3);
+
+    const char8_t *buf2 = u8"abc\xed\xa0\x80";
+    assert(xtual::validate_u8({ buf2, 6 }) == 3);
+
+    const char8_t *buf3 = u8"abc\xf4\x90\x80\x80";
+    assert(xtual::validate_u8({ buf3, 7 }) == 3);
+
+    const char8_t *buf4 = u8"ab\xe3\x81";
+    assert(xtual::validate_u8({ buf4, 4 }) == 2);
+
+    const char8_t *buf5 = u8"\x80";
+    assert(xtual::validate_u8({ buf5, 1 }) == 0);
+}
+
+void test_validate_u8_matches_decode_from_u8()
+{
+    const char8_t noise[] = { 0x00, 0x41, 0x80, 0x9f, 0xa0, 0xbf, 0xc0, 0xc2, 0xe0, 0xed, 0xef, 0xf0, 0xf4, 0xf5, 0xff };
+
+    for (std::uint32_t seed = 0; seed < 8; ++seed)
+    {
+        auto text = make_text(seed, 120);
+
+        for (std::size_t k = 0; k < text.size(); ++k)
+        {
+            for (char8_t ch : noise)
+            {
+                auto copy = text;
+                copy[k] = ch;
+
+                assert(xtual::validate_u8(copy) == reference_u8(copy));
+
+                copy.resize(k + 1);
+
+                assert(xtual::validate_u8(copy) == reference_u8(copy));
+            }
+        }
+    }
+}
+
+const xtual::simd_level levels[] = { xtual::simd_level::scalar, xtual::simd_level::sse2, xtual::simd_level::ssse3, xtual::simd_level::avx2 };
+
+template <typename Codec>
+std::size_t reference(const std::vector<typename Codec::unit_type> &buf)
+{
+    const auto *i = buf.data();
+    const auto *s = buf.data() + buf.size();
+
+    while (i != s)
+    {
+        char32_t ch;
+
+        if (Codec::decode(i, s, ch) != xtual::transcode_status::ok)
+        {
+            break;
+        }
+    }
+
+    return i - buf.data();
+}
+
+std::vector<std::uint32_t> make_units(std::uint32_t seed, std::size_t n, bool utf16)
+{
+    const char32_t samples[] = { U'a', U'é', U'あ', U'\xd7ff', U'\xe000', U'\xffff', U'𩸽', U'😀', U'\x10ffff' };
+    std::vector<std::uint32_t> units;
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        seed = seed * 1103515245 + 12345;
+
+        char32_t ch = samples[(seed >> 16) % 9];
+
+        if (utf16 && ch >= 0x10000)
+        {
+            units.push_back(0xd800 + ((ch - 0x10000) >> 10));
+            units.push_back(0xdc00 + (ch & 0x3ff));
+        }
+        else
+        {
+            units.push_back(ch);
+        }
+    }
+
+    return units;
+}
+
+template <typename unitT, std::size_t width, std::endian order>
+std::vector<unitT> pack(const std::vector<std::uint32_t> &units)
+{
+    std::vector<unitT> buf;
+
+    for (std::uint32_t u : units)
+    {
+        if constexpr (sizeof(unitT) != 1)
+        {
+            buf.push_back(static_cast<unitT>(u));
+        }
+        else
+        {
+            for (std::size_t k = 0; k < width; ++k)
+            {
+                std::size_t shift = order == std::endian::big ? (width - 1 - k) * 8 : k * 8;
+
+                buf.push_back(static_cast<unitT>(u >> shift));
+            }
+        }
+    }
+
+    return buf;
+}
+
+template <typename Codec, std::size_t width, std::endian order, typename F>
+void check_validator(F validate, std::initializer_list<std::uint32_t> noise)
+{
+    using unit_type = typename Codec::unit_type;
+
+    for (auto level : levels)
+    {
+        xtual::set_simd_level(level);
+
+        for (std::uint32_t seed = 0; seed < 4; ++seed)
+        {
+            auto units = make_units(seed, 90, width == 2);
+            auto buf = pack<unit_type, width, order>(units);
+
+            assert(validate(buf) == buf.size());
+
+            for (std::size_t k = 0; k < units.size(); ++k)
+            {
+                for (std::uint32_t value : noise)
+                {
+                    auto copy = units;
+                    copy[k] = value;
+
+                    buf = pack<unit_type, width, order>(copy);
+                    assert(validate(buf) == reference<Codec>(buf));
+
+                    buf.resize(pack<unit_type, width, order>({ copy.begin(), copy.begin() + k + 1 }).size());
+                    assert(validate(buf) == reference<Codec>(buf));
+
+                    if constexpr (sizeof(unit_type) == 1)
+                    {
+                        buf.pop_back();
+                        assert(validate(buf) == reference<Codec>(buf));
+                    }
+                }
+            }
+        }
+    }
+
+    xtual::set_simd_level(xtual::simd_level::avx2);
+}
+
+void test_validate_utf16()
+{
+    const std::initializer_list<std::uint32_t> noise = { 0x41, 0xd7ff, 0xd800, 0xdbff, 0xdc00, 0xdfff, 0xe000 };
+
+    check_validator<xtual::u16_codec, 2, std::endian::native>([](const std::vector<char16_t> &buf) { return xtual::validate_u16(buf); }, noise);
+    check_validator<xtual::b16be_codec<unsigned char>, 2, std::endian::big>([](const std::vector<unsigned char> &buf) { return xtual::validate_b16be<unsigned char>(buf); }, noise);
+    check_validator<xtual::b16le_codec<std::byte>, 2, std::endian::little>([](const std::vector<std::byte> &buf) { return xtual::validate_b16le<std::byte>(buf); }, noise);
+
+    std::u16string pair = u"😀";
+
+    for (std::size_t n = 1; n < 80; ++n)
+    {
+        std::u16string text(n, u'a');
+        text += pair;
+        text += u"bc";
+
+        assert(xtual::validate_u16(text) == text.size());
+
+        text.insert(text.begin() + n + 1, u'x');
+        assert(xtual::validate_u16(text) == n);
+
+        text.erase(text.begin() + n, text.begin() + n + 2);
+        assert(xtual::validate_u16(text) == n);
+    }
+}
+
+void test_validate_utf32()
+{
+    const std::initializer_list<std::uint32_t> noise = { 0x41, 0xd7ff, 0xd800, 0xdfff, 0xe000, 0x10ffff, 0x110000, 0x80000000, 0xffffffff };
+
+    check_validator<xtual::u32_codec, 4, std::endian::native>([](const std::vector<char32_t> &buf) { return xtual::validate_u32(buf); }, noise);
+    check_validator<xtual::b32be_codec<char>, 4, std::endian::big>([](const std::vector<char> &buf) { return xtual::validate_b32be<char>(buf); }, noise);
+    check_validator<xtual::b32le_codec<unsigned char>, 4, std::endian::little>([](const std::vector<unsigned char> &buf) { return xtual::validate_b32le<unsigned char>(buf); }, noise);
+}
+
+void test_validate_constexpr()
+{
+    static_assert(xtual::validate_u8(std::span<const char8_t>(u8"aыあ𩸽", 10)) == 10);
+    static_assert(xtual::validate_u8(std::span<const char8_t>(u8"ab\xe3\x81", 4)) == 2);
+    static_assert(xtual::validate_u16(std::span<const char16_t>(u"a😀\xdc00", 4)) == 3);
+    static_assert(xtual::validate_u32(std::span<const char32_t>(U"ab\x110000", 3)) == 2);
+    static_assert(xtual::validate_units<xtual::u8_codec>(std::span<const char8_t>(u8"a\xff" u8"b", 3)) == 1);
+    static_assert(xtual::validate_units<xtual::u16_codec>(std::span<const char16_t>(u"a😀\xdc00", 4)) == 3);
+}
+
+int main()
+{
+    test_validate_u8_valid();
+    test_validate_b8_valid();
+
+    test_validate_u8_invalid();
+
+    test_validate_u8_matches_decode_from_u8();
+
+    test_validate_utf16();
+    test_validate_utf32();
+
+    test_validate_constexpr();
+
+    std::cout << "OK" << std::endl;
+}
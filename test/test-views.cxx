@@ -0,0 +1,104 @@
+#include <xtual.hxx>
+
+#include <algorithm>
+#include <cstddef>
+#include <forward_list>
+#include <iostream>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#undef NDEBUG
+#include <cassert>
+
+template <std::ranges::range R>
+auto collect(R &&r)
+{
+    std::vector<std::ranges::range_value_t<R>> result;
+
+    for (auto x : r)
+    {
+        result.push_back(x);
+    }
+
+    return result;
+}
+
+void test_views_decode_u8()
+{
+    std::u8string text = u8"aыあ𩸽";
+    auto cps = collect(text | xtual::views::decode_u8);
+
+    assert((cps == std::vector<char32_t> { U'a', U'ы', U'あ', U'𩸽' }));
+
+    static_assert(std::ranges::forward_range<decltype(text | xtual::views::decode_u8)>);
+}
+
+void test_views_decode_u8_forward_list()
+{
+    std::forward_list<char8_t> text = { 0x61, 0xe3, 0x81, 0x82, 0xff, 0x62 };
+    auto cps = collect(xtual::views::decode_u8(text));
+
+    assert((cps == std::vector<char32_t> { U'a', U'あ', U'\xfffd', U'b' }));
+}
+
+void test_views_decode_replace()
+{
+    std::u8string text = u8"\x61\xf1\x80\x80\xe1\x80\xc2\x62\x80\x63\x80\xbf\x64";
+    auto cps = collect(text | xtual::views::decode_u8);
+
+    assert((cps == std::vector<char32_t> { U'a', U'\xfffd', U'\xfffd', U'\xfffd', U'b', U'\xfffd', U'c', U'\xfffd', U'\xfffd', U'd' }));
+}
+
+void test_views_decode_b16le()
+{
+    std::vector<std::byte> bytes;
+
+    for (int b : { 0x42, 0xd8, 0xb7, 0xdf, 0xce, 0x91 })
+    {
+        bytes.push_back(static_cast<std::byte>(b));
+    }
+
+    auto cps = collect(bytes | xtual::views::decode_b16le<std::byte>);
+
+    assert((cps == std::vector<char32_t> { U'𠮷', U'野' }));
+}
+
+void test_views_encode_u16()
+{
+    std::u32string text = U"a𩸽\xd800";
+    auto units = collect(text | xtual::views::encode_u16);
+
+    assert((units == std::vector<char16_t> { u'a', u'\xd867', u'\xde3d', u'\xfffd' }));
+}
+
+void test_views_compose()
+{
+    std::u8string text = u8"Grüße, 世界!";
+
+    auto upper = text
+        | xtual::views::decode_u8
+        | std::views::filter([](char32_t ch) { return ch != U','; })
+        | std::views::transform([](char32_t ch) { return ch >= U'a' && ch <= U'z' ? ch - 0x20 : ch; })
+        | xtual::views::encode_b8<char>;
+
+    std::string result;
+    std::ranges::copy(upper, std::back_inserter(result));
+
+    assert(result == "GRüßE 世界!");
+}
+
+int main()
+{
+    test_views_decode_u8();
+    test_views_decode_u8_forward_list();
+    test_views_decode_replace();
+    test_views_decode_b16le();
+
+    test_views_encode_u16();
+
+    test_views_compose();
+
+    std::cout << "OK" << std::endl;
+}
@@ -0,0 +1,357 @@
+#include <xtual.hxx>
+
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct options
+{
+    std::string from;
+    std::string to;
+    std::string input = "-";
+    std::string output = "-";
+    xtual::error_policy policy = xtual::error_policy::strict;
+};
+
+template <typename F>
+bool with_codec(std::string_view name, F f)
+{
+    if (name == "u8" || name == "b8")
+    {
+        f(std::type_identity<xtual::b8_codec<char>>());
+    }
+    else if (name == "u16")
+    {
+        f(std::type_identity<xtual::b16_codec<char, std::endian::native>>());
+    }
+    else if (name == "b16be")
+    {
+        f(std::type_identity<xtual::b16be_codec<char>>());
+    }
+    else if (name == "b16le")
+    {
+        f(std::type_identity<xtual::b16le_codec<char>>());
+    }
+    else if (name == "u32")
+    {
+        f(std::type_identity<xtual::b32_codec<char, std::endian::native>>());
+    }
+    else if (name == "b32be")
+    {
+        f(std::type_identity<xtual::b32be_codec<char>>());
+    }
+    else if (name == "b32le")
+    {
+        f(std::type_identity<xtual::b32le_codec<char>>());
+    }
+    else if (name == "latin1")
+    {
+        f(std::type_identity<xtual::latin1_codec<char>>());
+    }
+    else if (name == "ascii")
+    {
+        f(std::type_identity<xtual::ascii_codec<char>>());
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void fail(const std::string &what, const std::string &path)
+{
+    std::cerr << "xtual-iconv: " << what << ": " << path << ": " << std::strerror(errno) << std::endl;
+}
+
+class writer
+{
+public:
+    explicit writer(int fd)
+        : fd(fd)
+    {
+    }
+
+    bool write(const char *p, std::size_t n)
+    {
+        while (n != 0)
+        {
+            ssize_t k = ::write(fd, p, n);
+
+            if (k < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                return false;
+            }
+
+            p += k;
+            n -= static_cast<std::size_t>(k);
+        }
+
+        return true;
+    }
+
+private:
+    int fd;
+};
+
+template <typename From, typename To>
+class converter
+{
+public:
+    converter(writer &out, xtual::error_policy policy)
+        : out(out), buf(1 << 20), policy(policy)
+    {
+    }
+
+    bool convert(std::span<const char> in, bool final)
+    {
+        std::size_t pos = 0;
+
+        while (true)
+        {
+            auto r = xtual::transcode<From, To>(in.subspan(pos), buf, policy);
+
+            if (!out.write(buf.data(), r.written))
+            {
+                error = "write error";
+                return false;
+            }
+
+            pos += r.read;
+
+            if (r.status == xtual::transcode_status::ok)
+            {
+                offset += in.size();
+
+                return true;
+            }
+
+            if (r.status != xtual::transcode_status::insufficient)
+            {
+                offset += pos;
+                error = final && r.status == xtual::transcode_status::incomplete ? "incomplete input" : "invalid input";
+
+                return false;
+            }
+        }
+    }
+
+    std::size_t offset = 0;
+    const char *error = nullptr;
+
+private:
+    writer &out;
+    std::vector<char> buf;
+    xtual::error_policy policy;
+};
+
+template <typename From, typename To>
+int convert_mapped(const char *data, std::size_t size, writer &out, xtual::error_policy policy)
+{
+    converter<From, To> c(out, policy);
+
+    if (!c.convert({ data, size }, true))
+    {
+        std::cerr << "xtual-iconv: " << c.error << " at byte " << c.offset << std::endl;
+
+        return 1;
+    }
+
+    return 0;
+}
+
+template <typename From, typename To>
+int convert_stream(int fd, writer &out, xtual::error_policy policy)
+{
+    constexpr std::size_t block = 1 << 20;
+
+    converter<From, To> c(out, policy);
+    std::vector<char> buf(block + From::max_length);
+    std::size_t carry = 0;
+
+    while (true)
+    {
+        ssize_t n = ::read(fd, buf.data() + carry, block);
+
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            return -1;
+        }
+
+        std::size_t end = carry + static_cast<std::size_t>(n);
+        bool final = n == 0;
+        std::size_t stop = end;
+
+        if (!final && end != 0)
+        {
+            stop = static_cast<std::size_t>(From::resync(buf.data(), buf.data() + end - 1, buf.data() + end) - buf.data());
+        }
+
+        if (!c.convert({ buf.data(), stop }, final))
+        {
+            std::cerr << "xtual-iconv: " << c.error << " at byte " << c.offset << std::endl;
+
+            return 1;
+        }
+
+        if (final)
+        {
+            return 0;
+        }
+
+        std::memmove(buf.data(), buf.data() + stop, end - stop);
+        carry = end - stop;
+    }
+}
+
+template <typename From, typename To>
+int run(const options &opts, int in, int out_fd)
+{
+    writer out(out_fd);
+    struct stat st;
+
+    if (fstat(in, &st) == 0 && S_ISREG(st.st_mode))
+    {
+        std::size_t size = static_cast<std::size_t>(st.st_size);
+
+        if (size == 0)
+        {
+            return convert_mapped<From, To>(nullptr, 0, out, opts.policy);
+        }
+
+        void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, in, 0);
+
+        if (map != MAP_FAILED)
+        {
+            madvise(map, size, MADV_SEQUENTIAL);
+
+            int status = convert_mapped<From, To>(static_cast<const char *>(map), size, out, opts.policy);
+
+            munmap(map, size);
+
+            return status;
+        }
+    }
+
+    int status = convert_stream<From, To>(in, out, opts.policy);
+
+    if (status < 0)
+    {
+        fail("cannot read", opts.input);
+
+        return 1;
+    }
+
+    return status;
+}
+
+int main(int argc, char **argv)
+{
+    options opts;
+    std::vector<std::string> paths;
+
+    for (int k = 1; k < argc; ++k)
+    {
+        std::string arg = argv[k];
+
+        if (arg == "-f" && k + 1 < argc)
+        {
+            opts.from = argv[++k];
+        }
+        else if (arg == "-t" && k + 1 < argc)
+        {
+            opts.to = argv[++k];
+        }
+        else if (arg == "-r" || arg == "--replace")
+        {
+            opts.policy = xtual::error_policy::replace;
+        }
+        else if (arg == "-s" || arg == "--strict")
+        {
+            opts.policy = xtual::error_policy::strict;
+        }
+        else if ((arg == "-" || arg[0] != '-') && paths.size() < 2)
+        {
+            paths.push_back(arg);
+        }
+        else
+        {
+            paths.resize(3);
+            break;
+        }
+    }
+
+    bool known = with_codec(opts.from, [](auto) {}) && with_codec(opts.to, [](auto) {});
+
+    if (!known || paths.size() > 2)
+    {
+        std::cerr << "usage: " << argv[0] << " -f FROM -t TO [-r|--replace] [-s|--strict] [INPUT [OUTPUT]]" << std::endl;
+        std::cerr << "encodings: u8 b8 u16 b16be b16le u32 b32be b32le latin1 ascii" << std::endl;
+        return 2;
+    }
+
+    if (paths.size() >= 1)
+    {
+        opts.input = paths[0];
+    }
+
+    if (paths.size() >= 2)
+    {
+        opts.output = paths[1];
+    }
+
+    int in = opts.input == "-" ? STDIN_FILENO : open(opts.input.c_str(), O_RDONLY);
+
+    if (in < 0)
+    {
+        fail("cannot open", opts.input);
+        return 1;
+    }
+
+    int out = opts.output == "-" ? STDOUT_FILENO : open(opts.output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+    if (out < 0)
+    {
+        fail("cannot open", opts.output);
+        return 1;
+    }
+
+    int status = 0;
+
+    with_codec(opts.from, [&](auto from) {
+        with_codec(opts.to, [&](auto to) {
+            status = run<typename decltype(from)::type, typename decltype(to)::type>(opts, in, out);
+        });
+    });
+
+    if (out != STDOUT_FILENO && close(out) != 0)
+    {
+        fail("cannot close", opts.output);
+        return 1;
+    }
+
+    return status;
+}